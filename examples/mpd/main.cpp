@@ -72,14 +72,15 @@ int main(int argc, char *argv[])
     comp.setVolumeGridSpacing(1.0, 1.0, 1.0);
     comp.setRestrictionToDetectorArea(false);
 
+    const auto res = comp(pMatsGold, pMats); // parallelized over all views
     std::vector<double> mPD(nbPmats);
-    std::transform(pMatsGold.begin(), pMatsGold.end(), pMats.begin(), mPD.begin(),
-                   [&comp](const CTL::SingleViewGeometry& p1, const CTL::SingleViewGeometry& p2)
+    std::transform(res.views.cbegin(), res.views.cend(), mPD.begin(),
+                   [](const CTL::mat::PMatComparator::Eval& viewRes)
     {
-        auto res = comp(p1.module(0), p2.module(0));
-        qDebug() << res.meanError << "(" << res.minError << "..." << res.maxError << ")";
-        return res.meanError;
+        qDebug() << viewRes.meanError << "(" << viewRes.minError << "..." << viewRes.maxError << ")";
+        return viewRes.meanError;
     });
+    qDebug() << "total mPD:" << res.total.meanError;
 
     // save result
     QString fnOut = parser.isSet("o") ? parser.value("o") : "mpd.den";
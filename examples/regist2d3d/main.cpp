@@ -13,7 +13,7 @@ int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
 
-    QCoreApplication::setApplicationVersion("1.3");
+    QCoreApplication::setApplicationVersion("1.4");
 
     QCommandLineParser parser;
     parser.setApplicationDescription("Grangeat-based 2D/3D Registration with pre-computed derivative of the 3D Radon space.");
@@ -33,8 +33,11 @@ int main(int argc, char *argv[])
         { { "l", "lower-bound" }, "Lower bound of opimization [mm/deg]. Default: -30.0", "value" },
         { { "u", "upper-bound" }, "Upper bound of opimization [mm/deg]. Default: 30.0", "value" },
         { { "m", "gmc-metric" }, "Parameter of the GMC metric. Default: 50.0", "value" },
+        { { "t", "starts" }, "Number of starts of the optimization per frame. Default: 1", "number" },
+        { { "c", "coarse-to-fine" }, "Enable coarse-to-fine optimization (preceding level with a quarter of the sub-sampling level and doubled line distance)." },
 
         { { "j", "device-number" }, "Use only a specific OpenCL device with index 'number'.", "number" },
+        { { "x", "cpu" }, "Evaluate the consistency conditions on the CPU (no OpenCL)." },
 
         { { "o", "output" }, "Output directory.", "path" }
     });
@@ -97,7 +100,11 @@ int main(int argc, char *argv[])
     }
 
     // Init resampler
-    CTL::OCL::VolumeResampler radonSpaceSampler(radon3d);
+    std::unique_ptr<CTL::AbstractVolumeResampler> radonSpaceSampler;
+    if(parser.isSet("x"))
+        radonSpaceSampler.reset(new CTL::VolumeResamplerCPU(radon3d));
+    else
+        radonSpaceSampler.reset(new CTL::OCL::VolumeResampler(radon3d));
 
     // Init optimizer
     CTL::NLOPT::GrangeatRegistration2D3D reg;
@@ -115,6 +122,15 @@ int main(int argc, char *argv[])
                        : 0.1f;
     if(!parser.isSet("n"))
         reg.setSubSamplingLevel(subSampling);
+    if(parser.isSet("c"))
+    {
+        const auto fineLevel = parser.isSet("n") ? 1.0f : subSampling;
+        reg.setResolutionSchedule({ { 0.25f * fineLevel, 2.0f }, { fineLevel, 1.0f } });
+    }
+
+    // multi-start
+    if(parser.isSet("t"))
+        reg.setNbStarts(parser.value("t").toUInt());
 
     // init algorithm
     auto& opt = reg.optObject();
@@ -147,12 +163,21 @@ int main(int argc, char *argv[])
     QVector<double> rot, transl;
     QElapsedTimer time; time.start();
 
+    std::vector<CTL::Chunk2D<float>> projs;
+    std::vector<CTL::mat::ProjectionMatrix> pMats;
+    projs.reserve(nbViews);
+    pMats.reserve(nbViews);
     for(uint v = 0; v < nbViews; ++v)
     {
-        auto proj = projDataIO(fnProjImg)->readSingleView(fnProjImg, v, 1).module(0);
-        auto& pMat = Ps.view(v).module(0);
+        projs.push_back(projDataIO(fnProjImg)->readSingleView(fnProjImg, v, 1).module(0));
+        pMats.push_back(Ps.view(v).module(0));
+    }
+
+    // batch registration of all frames (shares the 3D Radon space sampler)
+    const auto optHomos = reg.optimize(projs, *radonSpaceSampler, pMats);
 
-        auto optHomo = reg.optimize(proj, radonSpaceSampler, pMat);
+    for(const auto& optHomo : optHomos)
+    {
         auto rotAxis = CTL::mat::rotationAxis(optHomo.subMat<0,2, 0,2>());
         auto translVec = optHomo.subMat<0,2, 3,3>();
 
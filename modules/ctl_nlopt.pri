@@ -11,7 +11,8 @@
 #   cmake ..
 #   cmake --build . --target install
 #
-# Note that this module depends on the CTL OpenCL module.
+# Note that this module uses the CTL OpenCL module if it is included beforehand. Otherwise, only the
+# CPU implementation of the Grangeat consistency chain is available.
 
 !GRANGEAT_2D3D_REGIST_MODULE: include(submodules/grangeat_2d3d_regist.pri)
 
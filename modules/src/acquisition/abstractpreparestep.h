@@ -3,6 +3,7 @@
 
 #include "io/serializationinterface.h"
 #include <QDebug>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -65,6 +66,80 @@ protected:
     AbstractPrepareStep& operator=(AbstractPrepareStep&&) = default;
 };
 
+/*!
+ * \class AbstractPrepareStepTable
+ *
+ * \brief Base class for a compact (column-wise) representation of the prepare steps of many views.
+ *
+ * Preparation protocols that create the same kind of prepare step for every view (e.g. a gantry
+ * rotation that only differs in its angle) can store the parameters of all views in a table, with
+ * one column per parameter and one row per view. This avoids the creation of individual prepare
+ * step objects (each in its own heap allocation) for every view.
+ *
+ * The rows of the table can be accessed as prepare steps via row(). These are lightweight objects
+ * stored contiguously inside the table; the returned shared pointers share ownership of the entire
+ * table. Preparing a system with a row invokes prepare(SimpleCTSystem&, uint) const of the table,
+ * i.e. it reduces to a lookup of the parameters in the corresponding row. A row reports the type of
+ * its expanded step (see stepType()), such that type-based lookups in an AcquisitionSetup::View
+ * (e.g. View::prepareStep(int)) treat rows and the equivalent individual steps alike.
+ *
+ * A row must specify the complete state of all parameters of its table, i.e. the effect of
+ * preparing a system with a row must not depend on rows of the same table applied before (no
+ * incremental changes). This allows AcquisitionSetup::forEachView() to prepare views in any order.
+ *
+ * Sub-classes implement prepare(), isApplicableTo() and expandedStep(). The latter creates a
+ * regular (self-contained) prepare step that is equivalent to a certain row. It is used for
+ * serialization of the rows, such that a serialized AcquisitionSetup does not depend on whether
+ * the compact representation has been used or not.
+ *
+ * Tables must be owned by a `std::shared_ptr`. They are typically created by the
+ * AbstractPreparationProtocol::prepareStepTable() method of a protocol.
+ */
+class AbstractPrepareStepTable : public std::enable_shared_from_this<AbstractPrepareStepTable>
+{
+public:
+    class Row final : public AbstractPrepareStep
+    {
+    public:
+        Row(const AbstractPrepareStepTable* table, uint rowNb);
+
+        int type() const override; // type of the expanded step
+
+        void prepare(SimpleCTSystem& system) const override;
+        bool isApplicableTo(const CTSystem& system) const override;
+        QVariant toVariant() const override; // serialization (as expandedStep())
+
+        const AbstractPrepareStepTable* table() const;
+        uint rowNb() const;
+
+    private:
+        const AbstractPrepareStepTable* _table; //!< Table that holds the data of this row.
+        uint _rowNb; //!< Index of this row in the table.
+    };
+
+    // abstract interface
+    public:virtual void prepare(SimpleCTSystem& system, uint rowNb) const = 0;
+    public:virtual bool isApplicableTo(const CTSystem& system) const = 0;
+    public:virtual std::unique_ptr<AbstractPrepareStep> expandedStep(uint rowNb) const = 0;
+
+public:
+    virtual ~AbstractPrepareStepTable() = default;
+
+    uint nbRows() const;
+    std::shared_ptr<const AbstractPrepareStep> row(uint rowNb) const;
+    int stepType() const;
+
+protected:
+    explicit AbstractPrepareStepTable(uint nbRows);
+    // non-copyable (rows refer to this table)
+    AbstractPrepareStepTable(const AbstractPrepareStepTable&) = delete;
+    AbstractPrepareStepTable& operator=(const AbstractPrepareStepTable&) = delete;
+
+private:
+    std::vector<Row> _rows; //!< Rows (as prepare steps) of the table.
+    mutable std::atomic<int> _stepType{ -1 }; //!< Cached type of the expanded steps (-1: unknown).
+};
+
 /*!
  * \class AbstractPreparationProtocol
  *
@@ -89,6 +164,8 @@ class AbstractPreparationProtocol
 
 public:
     virtual bool isApplicableTo(const AcquisitionSetup& setup) const;
+    virtual std::shared_ptr<const AbstractPrepareStepTable>
+    prepareStepTable(const AcquisitionSetup& setup) const;
     virtual ~AbstractPreparationProtocol() = default;
 
 protected:
@@ -105,6 +182,115 @@ inline bool AbstractPreparationProtocol::isApplicableTo(const AcquisitionSetup&)
     return true;
 }
 
+/*!
+ * Returns a compact representation of the prepare steps of this protocol for all views in \a setup
+ * (one row per view), or a nullptr if the protocol does not provide such a representation
+ * (default).
+ *
+ * Re-implement this method in sub-classes that create a single prepare step of the same kind for
+ * each view. The rows of the table must be equivalent to the steps returned by prepareSteps().
+ * AcquisitionSetup::applyPreparationProtocol() uses the table, if available.
+ */
+inline std::shared_ptr<const AbstractPrepareStepTable>
+AbstractPreparationProtocol::prepareStepTable(const AcquisitionSetup&) const
+{
+    return nullptr;
+}
+
+/*!
+ * Creates a table with \a nbRows rows.
+ */
+inline AbstractPrepareStepTable::AbstractPrepareStepTable(uint nbRows)
+{
+    _rows.reserve(nbRows);
+    for(uint r = 0; r < nbRows; ++r)
+        _rows.emplace_back(this, r);
+}
+
+/*!
+ * Returns the number of rows in this table.
+ */
+inline uint AbstractPrepareStepTable::nbRows() const { return static_cast<uint>(_rows.size()); }
+
+/*!
+ * Returns row \a rowNb of this table as a prepare step. The returned pointer shares ownership of
+ * this table (no additional allocation takes place). This table must be owned by a
+ * `std::shared_ptr`.
+ */
+inline std::shared_ptr<const AbstractPrepareStep> AbstractPrepareStepTable::row(uint rowNb) const
+{
+    return { shared_from_this(), &_rows[rowNb] };
+}
+
+/*!
+ * Returns the type id of the prepare steps represented by the rows of this table, i.e. the type of
+ * expandedStep() (all rows of a table are of the same kind). The type is determined from the first
+ * row on first request and cached afterwards. Returns AbstractPrepareStep::Type for an empty table.
+ */
+inline int AbstractPrepareStepTable::stepType() const
+{
+    auto type = _stepType.load(std::memory_order_relaxed);
+    if(type < 0)
+    {
+        type = _rows.empty() ? int(AbstractPrepareStep::Type) : expandedStep(0)->type();
+        _stepType.store(type, std::memory_order_relaxed);
+    }
+    return type;
+}
+
+/*!
+ * Creates a Row that refers to row \a rowNb of \a table.
+ */
+inline AbstractPrepareStepTable::Row::Row(const AbstractPrepareStepTable* table, uint rowNb)
+    : _table(table)
+    , _rowNb(rowNb)
+{
+}
+
+/*!
+ * Returns the type id of the self-contained prepare step that is equivalent to this row (see
+ * AbstractPrepareStepTable::stepType()).
+ */
+inline int AbstractPrepareStepTable::Row::type() const { return _table->stepType(); }
+
+/*!
+ * Prepares \a system with the parameters stored in the corresponding row of the table.
+ */
+inline void AbstractPrepareStepTable::Row::prepare(SimpleCTSystem& system) const
+{
+    _table->prepare(system, _rowNb);
+}
+
+/*!
+ * Returns true if the table of this row can be applied to \a system.
+ */
+inline bool AbstractPrepareStepTable::Row::isApplicableTo(const CTSystem& system) const
+{
+    return _table->isApplicableTo(system);
+}
+
+/*!
+ * Stores the row in a QVariant. This is the serialized form of the equivalent self-contained
+ * prepare step (see AbstractPrepareStepTable::expandedStep()).
+ */
+inline QVariant AbstractPrepareStepTable::Row::toVariant() const
+{
+    return _table->expandedStep(_rowNb)->toVariant();
+}
+
+/*!
+ * Returns the table that holds the data of this row.
+ */
+inline const AbstractPrepareStepTable* AbstractPrepareStepTable::Row::table() const
+{
+    return _table;
+}
+
+/*!
+ * Returns the index of this row in its table.
+ */
+inline uint AbstractPrepareStepTable::Row::rowNb() const { return _rowNb; }
+
 /*!
  * \fn AbstractPrepareStep::prepare(SimpleCTSystem* system) const
  *
@@ -171,6 +357,8 @@ inline bool AbstractPreparationProtocol::isApplicableTo(const AcquisitionSetup&)
  * SourceParam::Type             | 300
  * XrayLaserParam::Type          | 310
  * XrayTubeParam::Type           | 320
+ *
+ * Rows of an AbstractPrepareStepTable report the type of their expanded step.
  */
 
 /*!
@@ -1,6 +1,52 @@
 #include <QDebug>
 
 #include "acquisitionsetup.h"
+#include "processing/threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace {
+
+// minimum number of views processed by a single thread in `AcquisitionSetup::forEachView()`
+constexpr uint MIN_NB_VIEWS_PER_THREAD = 16u;
+
+// returns true if all prepare steps of all views are rows of prepare step tables and all views
+// refer to the same tables in the same order; since a row specifies the complete state of the
+// parameters of its table, each view can then be prepared independently of the preceding views
+bool isRandomAccessible(const std::vector<CTL::AcquisitionSetup::View>& views)
+{
+    using Row = CTL::AbstractPrepareStepTable::Row;
+
+    if(views.empty())
+        return false;
+
+    std::vector<const CTL::AbstractPrepareStepTable*> tables;
+    for(const auto& step : views.front().prepareSteps())
+    {
+        const auto row = dynamic_cast<const Row*>(step.get());
+        if(!row)
+            return false;
+        tables.push_back(row->table());
+    }
+
+    return std::all_of(views.cbegin(), views.cend(), [&tables](const CTL::AcquisitionSetup::View& v)
+    {
+        const auto& steps = v.prepareSteps();
+        if(steps.size() != tables.size())
+            return false;
+        for(size_t s = 0; s < steps.size(); ++s)
+        {
+            const auto row = dynamic_cast<const Row*>(steps[s].get());
+            if(!row || row->table() != tables[s])
+                return false;
+        }
+        return true;
+    });
+}
+
+} // unnamed namespace
 
 namespace CTL {
 
@@ -314,6 +360,7 @@ AcquisitionSetup::AcquisitionSetup(const AcquisitionSetup& other)
     : SerializationInterface(other)
     , _system(other._system ? static_cast<SimpleCTSystem*>(other._system->clone()) : nullptr)
     , _views(other._views)
+    , _revision(other._revision)
 {
 }
 
@@ -325,17 +372,51 @@ AcquisitionSetup& AcquisitionSetup::operator=(const AcquisitionSetup& other)
 {
     _system.reset(other._system ? static_cast<SimpleCTSystem*>(other._system->clone()) : nullptr);
     _views = other._views;
+    _revision = other._revision;
+    return *this;
+}
+
+/*!
+ * Move constructor. \a other is left without system and views; its revision is renewed (see
+ * revision()).
+ */
+AcquisitionSetup::AcquisitionSetup(AcquisitionSetup&& other) noexcept
+    : SerializationInterface(std::move(other))
+    , _system(std::move(other._system))
+    , _views(std::move(other._views))
+    , _revision(other._revision)
+{
+    other._revision = nextRevision();
+}
+
+/*!
+ * Move assignment operator. \a other is left in a valid but unspecified state; its revision is
+ * renewed (see revision()).
+ */
+AcquisitionSetup& AcquisitionSetup::operator=(AcquisitionSetup&& other) noexcept
+{
+    _system = std::move(other._system);
+    _views = std::move(other._views);
+    _revision = other._revision;
+    other._revision = nextRevision();
     return *this;
 }
 
 /*!
  * Adds the View \a view to this setup.
  */
-void AcquisitionSetup::addView(AcquisitionSetup::View view) { _views.push_back(std::move(view)); }
+void AcquisitionSetup::addView(AcquisitionSetup::View view)
+{
+    _views.push_back(std::move(view));
+    _revision = nextRevision();
+}
 
 /*!
  * Applies the prepration protocol \a preparation to this setup. This means that the prepare steps
  * created by AbstractPreparationProtocol::prepareSteps() are appended to all views in this setup.
+ * If the protocol provides a compact representation of its prepare steps (see
+ * AbstractPreparationProtocol::prepareStepTable()), the rows of that table are appended instead.
+ * These share a single allocation for all views and are equivalent to the individual steps.
  * The consequences of this aspect are, in particular, that application of multiple preparation
  * protocols is cumulative. When this is not desired, consider removing all prepare steps with
  * removeAllPrepareSteps() before applying a new preparation protocol.
@@ -352,11 +433,24 @@ void AcquisitionSetup::applyPreparationProtocol(const AbstractPreparationProtoco
         qWarning() << "AcquisitionSetup::applyPreparationProtocol: trying to apply protocol to "
                       "setup with number of views = 0. This has no effect!";
 
-    for(uint view = 0, nbViews = this->nbViews(); view < nbViews; ++view)
+    const auto nbViews = this->nbViews();
+    _revision = nextRevision();
+
+    // use compact representation (one table row per view) if provided by the protocol
+    const auto table = nbViews ? preparation.prepareStepTable(*this) : nullptr;
+    if(table && table->nbRows() >= nbViews)
     {
-        auto prepareSteps = preparation.prepareSteps(view, *this);
-        for(auto& step : prepareSteps)
-            _views[view].addPrepareStep(std::move(step));
+        for(uint view = 0; view < nbViews; ++view)
+            _views[view].addPrepareStep(table->row(view));
+    }
+    else
+    {
+        for(uint view = 0; view < nbViews; ++view)
+        {
+            auto prepareSteps = preparation.prepareSteps(view, *this);
+            for(auto& step : prepareSteps)
+                _views[view].addPrepareStep(std::move(step));
+        }
     }
 
     qDebug() << "AcquisitionSetup --- addPreparationProtocol\n"
@@ -398,10 +492,104 @@ void AcquisitionSetup::prepareView(uint viewNb)
     if(!_system)
         return;
 
+    _revision = nextRevision();
     for(const auto& step : _views[viewNb].prepareSteps())
         step->prepare(*_system);
 }
 
+/*!
+ * Calls \a fct for all views of this setup, passing a system that has been prepared for the
+ * corresponding view (see prepareView()) together with the view index.
+ *
+ * If the prepare steps of all views are rows of the same prepare step tables (see
+ * AbstractPreparationProtocol::prepareStepTable(); e.g. a HelicalTrajectory), each view can be
+ * prepared independently of the preceding views. In that case, the views are divided into (at most)
+ * \a nbThreads disjoint ranges of consecutive views, which are processed concurrently. If
+ * \a nbThreads is zero, `std::thread::hardware_concurrency()` is used. Each range works on its own
+ * clone of the (current) system of this setup. Hence, \a fct must be safe to be called
+ * concurrently for different views.
+ *
+ * Otherwise, the state of a view may depend on the prepare steps of all preceding views (e.g.
+ * incremental steps such as a GantryDisplacementParam). Then, and for small numbers of views (or
+ * \a nbThreads = 1), all views are processed sequentially in the calling thread using the system
+ * of this setup. In any case, the system state passed to \a fct is identical to the one obtained by
+ * calling prepareView() for all views in sequential order.
+ *
+ * After the call, the system of this setup is in the state of the last view (same as after calling
+ * prepareView() for all views in sequential order). An exception thrown by \a fct is rethrown
+ * after all ranges have been finished.
+ *
+ * Example: collect the source positions of all views
+ * \code
+ * std::vector<Vector3x1> sourcePositions(setup.nbViews());
+ * setup.forEachView([&sourcePositions](const SimpleCTSystem& system, uint view) {
+ *     sourcePositions[view] = system.gantry()->sourcePosition();
+ * });
+ * \endcode
+ */
+void AcquisitionSetup::forEachView(
+    const std::function<void(const SimpleCTSystem& system, uint viewNb)>& fct, uint nbThreads)
+{
+    if(!_system)
+        return;
+
+    _revision = nextRevision();
+    const auto nbViews = this->nbViews();
+    if(nbThreads == 0)
+        nbThreads = std::max(1u, std::thread::hardware_concurrency());
+    const auto nbRanges = std::min(nbThreads, nbViews / MIN_NB_VIEWS_PER_THREAD);
+
+    if(nbRanges < 2u || !isRandomAccessible(_views)) // sequential processing
+    {
+        for(uint view = 0; view < nbViews; ++view)
+        {
+            prepareView(view);
+            fct(*_system, view);
+        }
+        return;
+    }
+
+    std::vector<std::unique_ptr<SimpleCTSystem>> systems(nbRanges);
+    std::vector<std::exception_ptr> errors(nbRanges);
+
+    auto processRange = [this, &fct](SimpleCTSystem* system, uint first, uint last,
+                                     std::exception_ptr* error)
+    {
+        try
+        {
+            for(uint view = first; view < last; ++view)
+            {
+                for(const auto& step : _views[view].prepareSteps())
+                    step->prepare(*system);
+                fct(*system, view);
+            }
+        } catch(...)
+        {
+            *error = std::current_exception();
+        }
+    };
+
+    for(auto& system : systems)
+        system.reset(static_cast<SimpleCTSystem*>(_system->clone()));
+
+    {
+        ThreadPool tp(nbRanges);
+        for(uint range = 0; range < nbRanges; ++range)
+        {
+            const auto first = uint(quint64(nbViews) * range / nbRanges);
+            const auto last  = uint(quint64(nbViews) * (range + 1) / nbRanges);
+            tp.enqueueThread(processRange, systems[range].get(), first, last, &errors[range]);
+        }
+    } // blocking dtor of `tp`
+
+    // final state of this setup's system
+    prepareView(nbViews - 1);
+
+    for(const auto& error : errors)
+        if(error)
+            std::rethrow_exception(error);
+}
+
 /*!
  * Removes all prepare steps from all views of this setup. This leaves the setup with the same
  * number of views as it had beforehand. If \a keepTimeStamps is \c true, the time stamps from
@@ -437,6 +625,7 @@ void AcquisitionSetup::prepareView(uint viewNb)
  */
 void AcquisitionSetup::removeAllPrepareSteps(bool keepTimeStamps)
 {
+    _revision = nextRevision();
     if(keepTimeStamps)
     {
         for(auto& view : _views)
@@ -463,6 +652,7 @@ void AcquisitionSetup::removeAllViews() { setNbViews(0); }
  */
 bool AcquisitionSetup::resetSystem(const CTSystem& system)
 {
+    _revision = nextRevision();
     bool ok;
     auto clonedSystem = static_cast<SimpleCTSystem*>(
                 SimpleCTSystem::fromCTSystem(system, &ok).clone());
@@ -483,6 +673,7 @@ bool AcquisitionSetup::resetSystem(const CTSystem& system)
  */
 bool AcquisitionSetup::resetSystem(CTSystem&& system)
 {
+    _revision = nextRevision();
     bool ok;
     auto clonedSystem = static_cast<SimpleCTSystem*>(
         SimpleCTSystem::fromCTSystem(std::move(system), &ok).clone());
@@ -522,6 +713,20 @@ bool AcquisitionSetup::isValid() const
  */
 uint AcquisitionSetup::nbViews() const { return static_cast<uint>(_views.size()); }
 
+/*!
+ * Returns the revision of this setup, i.e. a number that identifies its current content.
+ *
+ * Each setup receives a new, globally unique revision on construction and whenever it is accessed
+ * through a non-const method (including the non-const accessors system(), view() and views()).
+ * Copies share the revision of their origin. This allows for a cheap identification of a setup
+ * (e.g. by the SetupArtifactCache). Note, however, that modifications through pointers or
+ * references that have been obtained by a non-const accessor *before* the revision was queried
+ * (e.g. a pointer to a component of the system) do not renew the revision. Hence, setups with equal
+ * revision may still differ in the state of their system; users of the revision must account for
+ * that (the SetupArtifactCache compares a hash of the system state in addition).
+ */
+quint64 AcquisitionSetup::revision() const { return _revision; }
+
 /*!
  * Sets the number of views in this setup to \a nbViews. Depending on the current number of views,
  * this has either of the following effects:
@@ -533,6 +738,7 @@ uint AcquisitionSetup::nbViews() const { return static_cast<uint>(_views.size())
  */
 void AcquisitionSetup::setNbViews(uint nbViews)
 {
+    _revision = nextRevision();
     if(nbViews <= this->nbViews())
     {
         _views.resize(nbViews);
@@ -556,6 +762,7 @@ void AcquisitionSetup::setNbViews(uint nbViews)
  */
 SimpleCTSystem* AcquisitionSetup::system()
 {
+    _revision = nextRevision();
     if(_system == nullptr)
         qWarning("No CT system has been set for the AcquisitionSetup.");
     return _system.get();
@@ -576,7 +783,11 @@ const SimpleCTSystem* AcquisitionSetup::system() const
  *
  * This does not perform boundary checks.
  */
-AcquisitionSetup::View& AcquisitionSetup::view(uint viewNb) { return _views[viewNb]; }
+AcquisitionSetup::View& AcquisitionSetup::view(uint viewNb)
+{
+    _revision = nextRevision();
+    return _views[viewNb];
+}
 
 /*!
  * Returns a constant reference to the View \a viewNb of this setup.
@@ -588,7 +799,11 @@ const AcquisitionSetup::View& AcquisitionSetup::view(uint viewNb) const { return
 /*!
  * Returns a reference to the vector of views of this setup.
  */
-std::vector<AcquisitionSetup::View>& AcquisitionSetup::views() { return _views; }
+std::vector<AcquisitionSetup::View>& AcquisitionSetup::views()
+{
+    _revision = nextRevision();
+    return _views;
+}
 
 /*!
  * Returns a constant reference to the vector of views of this setup.
@@ -601,6 +816,7 @@ const std::vector<AcquisitionSetup::View>& AcquisitionSetup::views() const { ret
 void AcquisitionSetup::fromVariant(const QVariant &variant)
 {
     auto varMap = variant.toMap();
+    _revision = nextRevision();
 
     CTSystem system;
     system.fromVariant(varMap.value("CT system"));
@@ -633,16 +849,11 @@ QVariant AcquisitionSetup::toVariant() const
     return ret;
 }
 
-/*!
- * \fn AcquisitionSetup::AcquisitionSetup(AcquisitionSetup&& other)
- *
- * Default move constructor.
- */
-
-/*!
- * \fn AcquisitionSetup& AcquisitionSetup::operator=(AcquisitionSetup&& other)
- *
- * Default move assignment operator.
- */
+// returns a new (globally unique) revision number
+quint64 AcquisitionSetup::nextRevision()
+{
+    static std::atomic<quint64> lastRevision{ 0 };
+    return ++lastRevision;
+}
 
 } // namespace CTL
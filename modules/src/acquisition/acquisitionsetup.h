@@ -4,6 +4,8 @@
 #include "abstractpreparestep.h"
 #include "simplectsystem.h"
 
+#include <functional>
+
 namespace CTL {
 
 /*!
@@ -20,7 +22,8 @@ namespace CTL {
  * in full detail at the end of this description (see *How to configure the views:*).
  *
  * To bring the system managed by the setup into the state for a certain view, use prepareView().
- * This will apply all preparation steps associated with that particular view.
+ * This will apply all preparation steps associated with that particular view. To process all views
+ * of the setup (possibly in parallel), forEachView() can be used.
  *
  * When using the 'ctl_qtgui.pri' module (or the submodule 'gui_widgets_3d.pri') within the project,
  * you can use the gui::AcquisitionSetupView class to visualize the setup.
@@ -228,13 +231,16 @@ public:
     // cp/mv cstor/assignment
     AcquisitionSetup(const AcquisitionSetup& other);
     AcquisitionSetup& operator=(const AcquisitionSetup& other);
-    AcquisitionSetup(AcquisitionSetup&& other) = default;
-    AcquisitionSetup& operator=(AcquisitionSetup&& other) = default;
+    AcquisitionSetup(AcquisitionSetup&& other) noexcept;
+    AcquisitionSetup& operator=(AcquisitionSetup&& other) noexcept;
 
     void addView(View view);
     void applyPreparationProtocol(const AbstractPreparationProtocol& preparation);
+    void forEachView(const std::function<void(const SimpleCTSystem& system, uint viewNb)>& fct,
+                     uint nbThreads = 0);
     bool isValid() const;
     uint nbViews() const;
+    quint64 revision() const;
     void prepareView(uint viewNb);
     void removeAllPrepareSteps(bool keepTimeStamps = true);
     void removeAllViews();
@@ -254,6 +260,9 @@ public:
 private:
     std::unique_ptr<SimpleCTSystem> _system; //!< CTSystem used for the acquisition.
     std::vector<View> _views; //!< List of all views of the acquisition.
+    quint64 _revision = nextRevision(); //!< Identifies the content (renewed by non-const access).
+
+    static quint64 nextRevision();
 };
 
 } // namespace CTL
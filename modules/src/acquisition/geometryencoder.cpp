@@ -79,22 +79,22 @@ SingleViewGeometry GeometryEncoder::encodeSingleViewGeometry() const
  * The conceptual work flow is as follows:
  *
  * \htmlinclude pseudo_geometryEncoder.html
+ *
+ * If the views of \a setup can be prepared independently of each other (see
+ * AcquisitionSetup::forEachView()), they are encoded in parallel using \a nbThreads threads (zero:
+ * hardware concurrency). Each thread processes a disjoint range of views with its own clone of the
+ * system. The result is written directly into a pre-sized container.
  */
-FullGeometry GeometryEncoder::encodeFullGeometry(AcquisitionSetup setup)
+FullGeometry GeometryEncoder::encodeFullGeometry(AcquisitionSetup setup, uint nbThreads)
 {
-    const auto nbViews = setup.nbViews();
-    FullGeometry ret;
-    ret.reserve(nbViews);
+    QVector<SingleViewGeometry> viewGeometries(int(setup.nbViews()));
+    const auto viewGeoPtr = viewGeometries.data(); // detach before concurrent writes
 
-    GeometryEncoder geoEncoder(setup.system());
+    setup.forEachView([viewGeoPtr](const SimpleCTSystem& system, uint view) {
+        viewGeoPtr[view] = encodeSingleViewGeometry(system);
+    }, nbThreads);
 
-    for(uint view = 0; view < nbViews; ++view)
-    {
-        setup.prepareView(view);
-        ret.append(geoEncoder.encodeSingleViewGeometry());
-    }
-
-    return ret;
+    return FullGeometry(std::move(viewGeometries));
 }
 
 /*!
@@ -64,7 +64,7 @@ public:
     Vector3x1WCS finalSourcePosition() const;
 
     // static methods
-    static FullGeometry encodeFullGeometry(AcquisitionSetup setup);
+    static FullGeometry encodeFullGeometry(AcquisitionSetup setup, uint nbThreads = 0);
     static SingleViewGeometry encodeSingleViewGeometry(const SimpleCTSystem& system);
     static float effectivePixelArea(const SimpleCTSystem& system, uint module);
     static std::vector<float> effectivePixelAreas(const SimpleCTSystem& system);
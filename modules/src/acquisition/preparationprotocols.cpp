@@ -94,5 +94,11 @@ bool TubeCurrentModulation::isApplicableTo(const AcquisitionSetup &setup) const
            (_currents.size() == setup.nbViews());
 }
 
+std::shared_ptr<const AbstractPrepareStepTable>
+TubeCurrentModulation::prepareStepTable(const AcquisitionSetup&) const
+{
+    return std::make_shared<prepare::XrayTubeParamTable>(_currents);
+}
+
 } // namespace protocols
 } // namespace CTL
@@ -326,6 +326,11 @@ void SourceParam::fromVariant(const QVariant &variant)
     }
     if(varMap.contains("flux modifier"))
         _newFluxModifier = { true, varMap.value("flux modifier").toDouble() };
+    if(varMap.contains("energy range restriction"))
+    {
+        auto range = varMap.value("energy range restriction").toList();
+        _energyRangeRestr = { true, { range.at(0).toFloat(), range.at(1).toFloat() } };
+    }
 }
 
 QVariant SourceParam::toVariant() const
@@ -349,6 +354,9 @@ QVariant SourceParam::toVariant() const
     }
     if(_newFluxModifier.first)
         ret.insert("flux modifier",_newFluxModifier.second);
+    if(_energyRangeRestr.first)
+        ret.insert("energy range restriction", QVariantList{ _energyRangeRestr.second.start(),
+                                                             _energyRangeRestr.second.end() });
 
     return ret;
 }
@@ -525,6 +533,75 @@ QVariant GenericDetectorParam::toVariant() const
     return ret;
 }
 
+// ### ### ### ###
+// ### TABLES  ###
+// ### ### ### ###
+
+/*!
+ * Creates a table of TubularGantryParam rows, where row `r` sets the rotation angle
+ * \a rotationAngles[r] and the pitch position \a pitchPositions[r]. Both vectors must have the
+ * same size.
+ */
+TubularGantryParamTable::TubularGantryParamTable(std::vector<double> rotationAngles,
+                                                 std::vector<double> pitchPositions)
+    : AbstractPrepareStepTable(static_cast<uint>(rotationAngles.size()))
+    , _rotationAngles(std::move(rotationAngles))
+    , _pitchPositions(std::move(pitchPositions))
+{
+    if(_rotationAngles.size() != _pitchPositions.size())
+        throw std::domain_error("TubularGantryParamTable: number of rotation angles and pitch "
+                                "positions differ.");
+}
+
+void TubularGantryParamTable::prepare(SimpleCTSystem& system, uint rowNb) const
+{
+    auto gantryPtr = static_cast<TubularGantry*>(system.gantry());
+
+    gantryPtr->setRotationAngle(_rotationAngles[rowNb]);
+    gantryPtr->setPitchPosition(_pitchPositions[rowNb]);
+}
+
+bool TubularGantryParamTable::isApplicableTo(const CTSystem& system) const
+{
+    return TubularGantryParam().isApplicableTo(system);
+}
+
+std::unique_ptr<AbstractPrepareStep> TubularGantryParamTable::expandedStep(uint rowNb) const
+{
+    auto ret = new TubularGantryParam;
+    ret->setRotationAngle(_rotationAngles[rowNb]);
+    ret->setPitchPosition(_pitchPositions[rowNb]);
+
+    return std::unique_ptr<AbstractPrepareStep>(ret);
+}
+
+/*!
+ * Creates a table of XrayTubeParam rows, where row `r` sets the emission current (in mAs)
+ * \a emissionCurrents[r].
+ */
+XrayTubeParamTable::XrayTubeParamTable(std::vector<double> emissionCurrents)
+    : AbstractPrepareStepTable(static_cast<uint>(emissionCurrents.size()))
+    , _emissionCurrents(std::move(emissionCurrents))
+{
+}
+
+void XrayTubeParamTable::prepare(SimpleCTSystem& system, uint rowNb) const
+{
+    static_cast<XrayTube*>(system.source())->setMilliampereSeconds(_emissionCurrents[rowNb]);
+}
+
+bool XrayTubeParamTable::isApplicableTo(const CTSystem& system) const
+{
+    return XrayTubeParam().isApplicableTo(system);
+}
+
+std::unique_ptr<AbstractPrepareStep> XrayTubeParamTable::expandedStep(uint rowNb) const
+{
+    auto ret = new XrayTubeParam;
+    ret->setEmissionCurrent(_emissionCurrents[rowNb]);
+
+    return std::unique_ptr<AbstractPrepareStep>(ret);
+}
 
 } // namespace prepare
 } // namespace CTL
@@ -191,6 +191,39 @@ private:
     QPair<bool,double> _newSkewCoefficient                 = {false, 0.0};
 };
 
+// ### ### ### ###
+// ### TABLES  ###
+// ### ### ### ###
+
+class TubularGantryParamTable : public AbstractPrepareStepTable
+{
+public:
+    TubularGantryParamTable(std::vector<double> rotationAngles, std::vector<double> pitchPositions);
+
+    // AbstractPrepareStepTable interface
+    void prepare(SimpleCTSystem& system, uint rowNb) const override;
+    bool isApplicableTo(const CTSystem& system) const override;
+    std::unique_ptr<AbstractPrepareStep> expandedStep(uint rowNb) const override;
+
+private:
+    std::vector<double> _rotationAngles; //!< Rotation angle for each row.
+    std::vector<double> _pitchPositions; //!< Pitch position for each row.
+};
+
+class XrayTubeParamTable : public AbstractPrepareStepTable
+{
+public:
+    explicit XrayTubeParamTable(std::vector<double> emissionCurrents);
+
+    // AbstractPrepareStepTable interface
+    void prepare(SimpleCTSystem& system, uint rowNb) const override;
+    bool isApplicableTo(const CTSystem& system) const override;
+    std::unique_ptr<AbstractPrepareStep> expandedStep(uint rowNb) const override;
+
+private:
+    std::vector<double> _emissionCurrents; //!< Emission current (in mAs) for each row.
+};
+
 } // namespace prepare
 } // namespace CTL
 
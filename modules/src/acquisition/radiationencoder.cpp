@@ -5,10 +5,19 @@
 #include "models/stepfunctionmodels.h"
 #include "models/xydataseries.h"
 
+#include <QJsonDocument>
+#include <algorithm>
+
 namespace CTL {
 
-RadiationEncoder::RadiationEncoder(const SimpleCTSystem* system)
+/*!
+ * Creates a RadiationEncoder for \a system. If \a cache is not `nullptr`, spectra and flux
+ * transmissions are looked up in (and added to) \a cache (see SpectrumCache). This instance does
+ * not take ownership of \a system or \a cache.
+ */
+RadiationEncoder::RadiationEncoder(const SimpleCTSystem* system, SpectrumCache* cache)
     : _system(system)
+    , _cache(cache)
 {
 }
 
@@ -28,15 +37,25 @@ void RadiationEncoder::assignSystem(const SimpleCTSystem* system)
  *
  * The spectrum will by samples with \a nbSamples points over the interval defined by the
  * energyRange() method of the source component.
+ *
+ * If a spectrum cache is set (see setSpectrumCache()), a spectrum that has already been computed
+ * for the same spectral state of the system is taken from the cache.
  */
 IntervalDataSeries RadiationEncoder::finalSpectrum(uint nbSamples) const
 {
-    auto spectrum = _system->source()->spectrum(nbSamples);
+    const auto stateKey = spectralStateKey();
+    if(stateKey.isEmpty())
+        return computeFinalSpectrum(_system->source()->spectrum(nbSamples));
 
-    for(const auto& modifier : _system->modifiers())
-        spectrum = modifier->modifiedSpectrum(spectrum);
+    const auto key = stateKey + QStringLiteral("|spectrum|") + QString::number(nbSamples);
+    IntervalDataSeries ret;
+    if(!_cache->spectrum(key, ret))
+    {
+        ret = computeFinalSpectrum(_system->source()->spectrum(nbSamples));
+        _cache->insertSpectrum(key, ret);
+    }
 
-    return spectrum;
+    return ret;
 }
 
 /*!
@@ -45,34 +64,70 @@ IntervalDataSeries RadiationEncoder::finalSpectrum(uint nbSamples) const
  *
  * The spectrum will by samples with \a nbSamples points equally distributed over the interval
  * specified by \a range.
+ *
+ * If a spectrum cache is set (see setSpectrumCache()), a spectrum that has already been computed
+ * for the same spectral state of the system is taken from the cache.
  */
 IntervalDataSeries RadiationEncoder::finalSpectrum(EnergyRange range, uint nbSamples) const
 {
-    auto spectrum = _system->source()->spectrum(range, nbSamples);
-
-    for(const auto& modifier : _system->modifiers())
-        spectrum = modifier->modifiedSpectrum(spectrum);
+    const auto stateKey = spectralStateKey();
+    if(stateKey.isEmpty())
+        return computeFinalSpectrum(_system->source()->spectrum(range, nbSamples));
+
+    const auto key = stateKey + QStringLiteral("|spectrum|")
+        + QString::number(range.start(), 'g', 9) + QStringLiteral("|")
+        + QString::number(range.end(), 'g', 9) + QStringLiteral("|") + QString::number(nbSamples);
+    IntervalDataSeries ret;
+    if(!_cache->spectrum(key, ret))
+    {
+        ret = computeFinalSpectrum(_system->source()->spectrum(range, nbSamples));
+        _cache->insertSpectrum(key, ret);
+    }
 
-    return spectrum;
+    return ret;
 }
 
 /*!
  * Returns the final photon flux (i.e. photons per cm² in 1m distance) of the system. This considers
  * all properties of the source component as well as all modifications caused by beam modifiers
  * (e.g. filters).
+ *
+ * If a spectrum cache is set (see setSpectrumCache()), the fraction of the flux that passes all
+ * beam modifiers is taken from the cache if it has already been computed for the same spectral
+ * state of the system. In that case, only the photon flux of the source needs to be evaluated
+ * (e.g. for a tube current modulation).
  */
 double RadiationEncoder::finalPhotonFlux() const
 {
-    auto spectrum = _system->source()->spectrum(_system->source()->spectrumDiscretizationHint());
-    auto flux = _system->source()->photonFlux();
+    const auto source = _system->source();
 
-    for(const auto& modifier : _system->modifiers())
+    auto transmittedFlux = [this, source](double inputFlux) {
+        auto spectrum = source->spectrum(source->spectrumDiscretizationHint());
+        auto flux = inputFlux;
+
+        for(const auto& modifier : _system->modifiers())
+        {
+            flux = modifier->modifiedFlux(flux, spectrum);
+            spectrum = modifier->modifiedSpectrum(spectrum);
+        }
+
+        return flux;
+    };
+
+    const auto stateKey = spectralStateKey();
+    if(stateKey.isEmpty())
+        return transmittedFlux(source->photonFlux());
+
+    const auto key = stateKey + QStringLiteral("|flux|")
+        + QString::number(source->spectrumDiscretizationHint());
+    double transmission;
+    if(!_cache->fluxTransmission(key, transmission))
     {
-        flux = modifier->modifiedFlux(flux, spectrum);
-        spectrum = modifier->modifiedSpectrum(spectrum);
+        transmission = transmittedFlux(1.0);
+        _cache->insertFluxTransmission(key, transmission);
     }
 
-    return flux;
+    return source->photonFlux() * transmission;
 }
 
 /*!
@@ -165,6 +220,24 @@ const SimpleCTSystem* RadiationEncoder::system() const
     return _system;
 }
 
+/*!
+ * Returns the spectrum cache used by this instance (or `nullptr` if no cache is used).
+ */
+SpectrumCache* RadiationEncoder::spectrumCache() const
+{
+    return _cache;
+}
+
+/*!
+ * Sets the spectrum cache used by this instance to \a cache. Pass `nullptr` to disable caching.
+ *
+ * This instance does not take ownership of \a cache.
+ */
+void RadiationEncoder::setSpectrumCache(SpectrumCache* cache)
+{
+    _cache = cache;
+}
+
 SpectralInformation RadiationEncoder::spectralInformation(AcquisitionSetup setup,
                                                           float energyResolution)
 {
@@ -175,17 +248,22 @@ SpectralInformation RadiationEncoder::spectralInformation(AcquisitionSetup setup
     SpectralInformation ret;
 
     const auto nbViews = setup.nbViews();
-    const auto srcPtr = setup.system()->source();
 
     // find highest resolution and determine energy interval covering spectra of all views
+    std::vector<EnergyRange> viewEnergyRanges(nbViews, EnergyRange(0.0f, 0.0f));
+    std::vector<float> viewResos(nbViews);
+    setup.forEachView([&viewEnergyRanges, &viewResos](const SimpleCTSystem& system, uint view) {
+        const auto srcPtr = system.source();
+        viewEnergyRanges[view] = srcPtr->energyRange();
+        viewResos[view] = viewEnergyRanges[view].width()
+                        / float(srcPtr->spectrumDiscretizationHint());
+    });
     for(auto view = 0u; view < nbViews; ++view)
     {
-        setup.prepareView(view);
-        const auto viewEnergyRange = srcPtr->energyRange();
-        const auto viewReso = viewEnergyRange.width() / float(srcPtr->spectrumDiscretizationHint());
-        ret._bestReso = std::min(ret._bestReso, viewReso);
-        ret._fullCoverage.start() = std::min(ret._fullCoverage.start(), viewEnergyRange.start());
-        ret._fullCoverage.end()   = std::max(ret._fullCoverage.end(), viewEnergyRange.end());
+        ret._bestReso = std::min(ret._bestReso, viewResos[view]);
+        ret._fullCoverage.start() = std::min(ret._fullCoverage.start(),
+                                             viewEnergyRanges[view].start());
+        ret._fullCoverage.end()   = std::max(ret._fullCoverage.end(), viewEnergyRanges[view].end());
     }
 
     qDebug() << "highestResolution: " << ret._bestReso;
@@ -203,16 +281,131 @@ SpectralInformation RadiationEncoder::spectralInformation(AcquisitionSetup setup
 
     ret.reserveMemory(nbEnergyBins, nbViews); // reserve memory
 
-    const RadiationEncoder radiationEnc(setup.system());
+    // get (view-dependent) spectra (views are processed concurrently; see extractViewSpectrum())
+    // views sharing the same spectral state (e.g. with tube current modulation) share the spectrum
+    SpectrumCache cache;
+    setup.forEachView([&ret, &cache](const SimpleCTSystem& system, uint view) {
+        const RadiationEncoder radiationEnc(&system, &cache);
+        ret.extractViewSpectrum(&radiationEnc, view);
+    });
 
-    // get (view-dependent) spectra
-    for(auto view = 0u; view < nbViews; ++view)
+    return ret;
+}
+
+// key identifying the spectral state of the system; empty if no cache is used or the spectral state
+// of any component is unknown
+QString RadiationEncoder::spectralStateKey() const
+{
+    if(!_cache)
+        return {};
+
+    QVariantList state{ _system->source()->spectralState() };
+    for(const auto& modifier : _system->modifiers())
+        state.append(modifier->spectralState());
+
+    if(std::any_of(state.cbegin(), state.cend(), [](const QVariant& s) { return !s.isValid(); }))
+        return {};
+
+    return QString::fromUtf8(QJsonDocument::fromVariant(state).toJson(QJsonDocument::Compact));
+}
+
+// applies all beam modifiers of the system to `spectrum`
+IntervalDataSeries RadiationEncoder::computeFinalSpectrum(IntervalDataSeries spectrum) const
+{
+    for(const auto& modifier : _system->modifiers())
+        spectrum = modifier->modifiedSpectrum(spectrum);
+
+    return spectrum;
+}
+
+/*!
+ * Copies the spectrum stored for \a key to \a spectrum and returns true. Returns false if no
+ * spectrum is stored for \a key (\a spectrum remains unchanged).
+ */
+bool SpectrumCache::spectrum(const QString& key, IntervalDataSeries& spectrum) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _spectra.constFind(key);
+    if(it == _spectra.constEnd())
     {
-        setup.prepareView(view);
-        ret.extractViewSpectrum(&radiationEnc, view);
+        ++_nbMisses;
+        return false;
     }
 
-    return ret;
+    ++_nbHits;
+    spectrum = it.value();
+    return true;
+}
+
+/*!
+ * Copies the flux transmission stored for \a key to \a transmission and returns true. Returns
+ * false if no transmission is stored for \a key (\a transmission remains unchanged).
+ */
+bool SpectrumCache::fluxTransmission(const QString& key, double& transmission) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _fluxTransmissions.constFind(key);
+    if(it == _fluxTransmissions.constEnd())
+    {
+        ++_nbMisses;
+        return false;
+    }
+
+    ++_nbHits;
+    transmission = it.value();
+    return true;
+}
+
+/*!
+ * Stores \a spectrum for \a key.
+ */
+void SpectrumCache::insertSpectrum(const QString& key, const IntervalDataSeries& spectrum)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _spectra.insert(key, spectrum);
+}
+
+/*!
+ * Stores the flux transmission (i.e. the ratio of output and input flux) \a transmission for
+ * \a key.
+ */
+void SpectrumCache::insertFluxTransmission(const QString& key, double transmission)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _fluxTransmissions.insert(key, transmission);
+}
+
+/*!
+ * Removes all entries from the cache and resets the lookup statistics (see nbHits() and
+ * nbMisses()).
+ */
+void SpectrumCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _spectra.clear();
+    _fluxTransmissions.clear();
+    _nbHits = 0;
+    _nbMisses = 0;
+}
+
+/*!
+ * Returns the number of lookups (of spectra and flux transmissions) that have been answered from
+ * the cache.
+ */
+uint SpectrumCache::nbHits() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _nbHits;
+}
+
+/*!
+ * Returns the number of lookups (of spectra and flux transmissions) for which no entry has been
+ * found in the cache.
+ */
+uint SpectrumCache::nbMisses() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _nbMisses;
 }
 
 uint SpectralInformation::nbEnergyBins() const
@@ -255,6 +448,10 @@ void SpectralInformation::reserveMemory(uint nbBins, uint nbViews)
     _totalIntensities = std::vector<double>(nbViews, 0.0);
 }
 
+// Writes the spectral information of view `viewIdx` based on the current state of the system in
+// `encoder`. Only entries belonging to `viewIdx` are written, except for the view-independent bin
+// energies and bin width, which are set by view zero. Hence, different views may be extracted
+// concurrently.
 void SpectralInformation::extractViewSpectrum(const RadiationEncoder* encoder, uint viewIdx)
 {
     static const auto constModel = makeDataModel<ConstantModel>();
@@ -271,11 +468,15 @@ void SpectralInformation::extractViewSpectrum(const RadiationEncoder* encoder, u
         const auto E = spectrum.samplingPoint(bin);
         _bins[bin].intensities[viewIdx] = spectrum.value(bin) * E;
         _bins[bin].adjustedFluxMods[viewIdx] = globalFluxMod * spectrum.value(bin) * spectralResponse->valueAt(E);
-        _bins[bin].energy = E;
         _totalIntensities[viewIdx] += _bins[bin].intensities[viewIdx] * spectralResponse->valueAt(E);
     }
 
-    _binWidth = spectrum.binWidth();
+    if(viewIdx == 0)
+    {
+        for(auto bin = 0u, nbBins = nbEnergyBins(); bin < nbBins; ++bin)
+            _bins[bin].energy = spectrum.samplingPoint(bin);
+        _binWidth = spectrum.binWidth();
+    }
 }
 
 } // namespace CTL
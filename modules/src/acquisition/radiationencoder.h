@@ -5,6 +5,9 @@
 #include "models/intervaldataseries.h"
 #include "components/abstractsource.h"
 
+#include <QHash>
+#include <mutex>
+
 namespace CTL {
 
 class RadiationEncoder;
@@ -40,10 +43,51 @@ private:
     friend class RadiationEncoder;
 };
 
+/*!
+ * \class SpectrumCache
+ *
+ * \brief The SpectrumCache class stores spectra and flux transmissions computed by
+ * RadiationEncoder for reuse.
+ *
+ * Entries are identified by the spectral state of a system, i.e. by the spectral states of its
+ * source and beam modifiers (see AbstractSource::spectralState() and
+ * AbstractBeamModifier::spectralState()), along with the sampling of the spectrum. Hence, systems
+ * that differ only in properties which do not affect the spectrum (e.g. geometry or photon flux)
+ * share entries.
+ *
+ * A cache is meant to be used for a limited scope, such as all views of an acquisition (see
+ * RadiationEncoder::spectralInformation()). Since attenuation models are identified by their
+ * address, a cache must not outlive the models used by the systems it has been used with.
+ *
+ * The numbers of successful and failed lookups are available through nbHits() and nbMisses().
+ *
+ * All methods are thread-safe.
+ */
+class SpectrumCache
+{
+public:
+    bool spectrum(const QString& key, IntervalDataSeries& spectrum) const;
+    bool fluxTransmission(const QString& key, double& transmission) const;
+
+    void insertSpectrum(const QString& key, const IntervalDataSeries& spectrum);
+    void insertFluxTransmission(const QString& key, double transmission);
+    void clear();
+
+    uint nbHits() const;
+    uint nbMisses() const;
+
+private:
+    mutable std::mutex _mutex;
+    QHash<QString, IntervalDataSeries> _spectra;
+    QHash<QString, double> _fluxTransmissions;
+    mutable uint _nbHits = 0;   //!< number of successful lookups
+    mutable uint _nbMisses = 0; //!< number of failed lookups
+};
+
 class RadiationEncoder
 {
 public:
-    RadiationEncoder(const SimpleCTSystem* system);
+    RadiationEncoder(const SimpleCTSystem* system, SpectrumCache* cache = nullptr);
 
     void assignSystem(const SimpleCTSystem* system);
     IntervalDataSeries finalSpectrum(uint nbSamples) const;
@@ -58,12 +102,18 @@ public:
     float detectiveMeanEnergy() const;
 
     const SimpleCTSystem* system() const;
+    SpectrumCache* spectrumCache() const;
+    void setSpectrumCache(SpectrumCache* cache);
 
     static SpectralInformation spectralInformation(AcquisitionSetup setup, float energyResolution = 0.0f);
 
 private:
     // member variables
     const SimpleCTSystem* _system; //!< Pointer to system whose radiation shall be encoded.
+    SpectrumCache* _cache; //!< Optional cache for spectra and flux transmissions (not owned).
+
+    QString spectralStateKey() const;
+    IntervalDataSeries computeFinalSpectrum(IntervalDataSeries spectrum) const;
 };
 
 } // namespace CTL
@@ -0,0 +1,377 @@
+#include "setupartifactcache.h"
+#include "components/abstractdetector.h"
+#include "components/abstractgantry.h"
+#include "components/abstractsource.h"
+#include "geometryencoder.h"
+#include "io/binaryserializer.h"
+#include "preparesteps.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <algorithm>
+#include <map>
+
+namespace {
+
+// maximum number of setup revisions that are remembered for a single entry
+constexpr size_t MAX_NB_REVISIONS_PER_ENTRY = 8u;
+
+bool isSourceStep(const CTL::AbstractPrepareStep& step)
+{
+    const auto type = step.type();
+    return type == CTL::prepare::SourceParam::Type || type == CTL::prepare::XrayLaserParam::Type
+        || type == CTL::prepare::XrayTubeParam::Type;
+}
+
+// writes the state of `system` that determines the projection geometry, i.e. gantry, detector and
+// the position of the focal spot
+void writeGeometryState(QDataStream& stream, const CTL::SimpleCTSystem& system)
+{
+    const auto focalSpot = system.source()->focalSpotPosition();
+    stream << system.gantry()->toVariant() << system.detector()->toVariant()
+           << focalSpot.get<0>() << focalSpot.get<1>() << focalSpot.get<2>();
+}
+
+// hash of the current state of the system of `setup` (or of its geometry-related part only);
+// this is used to detect changes made through pointers to components obtained earlier
+QByteArray systemHash(const CTL::AcquisitionSetup& setup, bool geometryOnly)
+{
+    QByteArray serialized;
+    QDataStream stream(&serialized, QIODevice::WriteOnly);
+    if(geometryOnly)
+        writeGeometryState(stream, *setup.system());
+    else
+        stream << setup.system()->toVariant();
+
+    return QCryptographicHash::hash(serialized, QCryptographicHash::Sha1);
+}
+
+} // unnamed namespace
+
+namespace CTL {
+
+/*!
+ * Holds the artifacts of a single setup. Each artifact is computed once under the lock of `mutex`,
+ * such that concurrent requests for the same setup wait for the first computation.
+ */
+struct SetupArtifactCache::Entry
+{
+    //! known revisions of setups with this content, along with the hash of their system state at
+    //! the time of the lookup (guarded by the mutex of the cache)
+    std::vector<std::pair<quint64, QByteArray>> revisions;
+    std::mutex mutex;
+
+    bool hasGeometry = false;
+    FullGeometry geometry;
+
+    std::map<float, SpectralInformation> spectralInfos; //!< key: requested energy resolution
+
+    bool hasPhotonCounts = false;
+    std::vector<std::vector<float>> photonsPerPixel; //!< for each view and module
+};
+
+/*!
+ * Returns the global instance of the SetupArtifactCache.
+ */
+SetupArtifactCache& SetupArtifactCache::instance()
+{
+    static SetupArtifactCache theInstance;
+    return theInstance;
+}
+
+/*!
+ * Returns a hash of the content of \a setup, i.e. of its serialized form in the compact binary
+ * format (see BinarySerializer::writeCompact()). This covers the current state of the system as
+ * well as all views with their prepare steps.
+ *
+ * Returns an empty QByteArray if (parts of) the setup cannot be serialized to a binary stream. Such
+ * setups are not cached.
+ */
+QByteArray SetupArtifactCache::contentHash(const AcquisitionSetup& setup)
+{
+    QByteArray serialized;
+    QDataStream stream(&serialized, QIODevice::WriteOnly);
+
+    if(!BinarySerializer::writeCompact(stream, setup))
+        return {};
+
+    return QCryptographicHash::hash(serialized, QCryptographicHash::Sha1);
+}
+
+/*!
+ * Returns a hash of the part of the content of \a setup that determines its geometry, i.e. of the
+ * state of gantry and detector, the focal spot position and all prepare steps of all views. Of
+ * prepare steps for the source (prepare::SourceParam and sub classes), only the focal spot position
+ * is considered. Hence, setups that differ only in spectral properties or the flux of the source
+ * (e.g. the energy bins processed by the SpectralEffectsExtension) have the same geometry hash.
+ *
+ * Returns an empty QByteArray if \a setup has no system.
+ */
+QByteArray SetupArtifactCache::geometryHash(const AcquisitionSetup& setup)
+{
+    if(!setup.system())
+        return {};
+
+    QByteArray serialized;
+    QDataStream stream(&serialized, QIODevice::WriteOnly);
+
+    writeGeometryState(stream, *setup.system());
+    stream << quint32(setup.nbViews());
+    for(const auto& view : setup.views())
+    {
+        stream << quint32(view.nbPrepareSteps());
+        for(const auto& step : view.prepareSteps())
+        {
+            if(isSourceStep(*step))
+                stream << step->toVariant().toMap().value(QStringLiteral("focal spot position"));
+            else
+                stream << step->toVariant();
+        }
+    }
+
+    return QCryptographicHash::hash(serialized, QCryptographicHash::Sha1);
+}
+
+/*!
+ * Returns the full geometry (i.e. the projection matrices of all views) of \a setup. The geometry
+ * is computed using GeometryEncoder::encodeFullGeometry() if it is not yet in the cache.
+ *
+ * Note that FullGeometry is implicitly shared; the returned object does not copy the cached data.
+ */
+FullGeometry SetupArtifactCache::fullGeometry(const AcquisitionSetup& setup)
+{
+    const auto e = entry(setup, true);
+    if(!e)
+    {
+        ++_nbComputations;
+        return GeometryEncoder::encodeFullGeometry(setup);
+    }
+
+    std::lock_guard<std::mutex> lock(e->mutex);
+    if(!e->hasGeometry)
+    {
+        ++_nbComputations;
+        e->geometry = GeometryEncoder::encodeFullGeometry(setup);
+        e->hasGeometry = true;
+    }
+
+    return e->geometry;
+}
+
+/*!
+ * Returns the spectral information of \a setup for the energy resolution \a energyResolution. The
+ * information is computed using RadiationEncoder::spectralInformation() if it is not yet in the
+ * cache.
+ */
+SpectralInformation SetupArtifactCache::spectralInformation(const AcquisitionSetup& setup,
+                                                            float energyResolution)
+{
+    const auto e = entry(setup, false);
+    if(!e)
+    {
+        ++_nbComputations;
+        return RadiationEncoder::spectralInformation(setup, energyResolution);
+    }
+
+    std::lock_guard<std::mutex> lock(e->mutex);
+    auto it = e->spectralInfos.find(energyResolution);
+    if(it == e->spectralInfos.end())
+    {
+        ++_nbComputations;
+        it = e->spectralInfos.emplace(energyResolution,
+                                      RadiationEncoder::spectralInformation(setup,
+                                                                            energyResolution)).first;
+    }
+
+    return it->second;
+}
+
+/*!
+ * Returns the average number of photons incident on a detector pixel for all views and modules of
+ * \a setup, i.e. `photonsPerPixel(setup)[view][module]`. The photon counts are computed using
+ * RadiationEncoder::photonsPerPixel() if they are not yet in the cache.
+ */
+std::vector<std::vector<float>> SetupArtifactCache::photonsPerPixel(const AcquisitionSetup& setup)
+{
+    auto compute = [&setup]
+    {
+        AcquisitionSetup tmpSetup(setup);
+        std::vector<std::vector<float>> ret(tmpSetup.nbViews());
+        SpectrumCache spectrumCache;
+        tmpSetup.forEachView([&ret, &spectrumCache](const SimpleCTSystem& system, uint view) {
+            ret[view] = RadiationEncoder(&system, &spectrumCache).photonsPerPixel();
+        });
+        return ret;
+    };
+
+    const auto e = entry(setup, false);
+    if(!e)
+    {
+        ++_nbComputations;
+        return compute();
+    }
+
+    std::lock_guard<std::mutex> lock(e->mutex);
+    if(!e->hasPhotonCounts)
+    {
+        ++_nbComputations;
+        e->photonsPerPixel = compute();
+        e->hasPhotonCounts = true;
+    }
+
+    return e->photonsPerPixel;
+}
+
+/*!
+ * Returns the maximum number of setups whose artifacts are held in the cache.
+ */
+uint SetupArtifactCache::capacity() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _capacity;
+}
+
+/*!
+ * Sets the maximum number of setups whose artifacts are held in the cache to \a capacity. If the
+ * cache currently contains more entries, the least recently used ones are removed. A capacity of
+ * zero disables caching, i.e. all artifacts are computed on each request.
+ */
+void SetupArtifactCache::setCapacity(uint capacity)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _capacity = capacity;
+    while(_entries.size() > _capacity)
+        _entries.pop_back();
+    while(_geometryEntries.size() > _capacity)
+        _geometryEntries.pop_back();
+}
+
+/*!
+ * Removes all entries from the cache.
+ */
+void SetupArtifactCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _geometryEntries.clear();
+}
+
+/*!
+ * Returns the total number of content (or geometry) hashes that have been computed (i.e. lookups of
+ * setups whose revision was unknown to the cache or whose system has been modified) since program
+ * start.
+ */
+uint SetupArtifactCache::nbContentHashes() const
+{
+    return _nbContentHashes;
+}
+
+/*!
+ * Returns the number of entries currently held in the cache. Since geometries are held separately
+ * (see geometryHash()), this is the number of distinct setups plus the number of distinct
+ * geometries whose artifacts are in the cache.
+ */
+uint SetupArtifactCache::nbEntries() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return static_cast<uint>(_entries.size() + _geometryEntries.size());
+}
+
+/*!
+ * Returns the total number of artifacts that have been computed (i.e. requests that could not be
+ * served from the cache) since program start.
+ */
+uint SetupArtifactCache::nbComputations() const
+{
+    return _nbComputations;
+}
+
+/*!
+ * Returns the entry that belongs to \a setup. If \a geometryOnly is `true`, the entry holds only
+ * the geometry and is identified by the geometry hash (see geometryHash()); otherwise, it is
+ * identified by the content hash (see contentHash()). A new (empty) entry is created if none
+ * exists yet. The entry is moved to the front of the list of entries (most recently used).
+ *
+ * The entry is looked up by the revision of \a setup first. Since the system of a setup can be
+ * modified through pointers to its components that have been obtained before the revision was
+ * renewed (see AcquisitionSetup::revision()), a revision only matches if the (cheap) hash of the
+ * current system state equals the one recorded with the revision. Otherwise, the hash of \a setup
+ * is computed and the revision is added to the entry with that hash.
+ *
+ * Returns a nullptr if caching is disabled or the hash of \a setup cannot be computed.
+ */
+std::shared_ptr<SetupArtifactCache::Entry> SetupArtifactCache::entry(const AcquisitionSetup& setup,
+                                                                     bool geometryOnly)
+{
+    if(!setup.system())
+        return nullptr;
+
+    const auto revision = setup.revision();
+    const auto sysHash = systemHash(setup, geometryOnly);
+    auto& entries = geometryOnly ? _geometryEntries : _entries;
+
+    auto moveToFront = [&entries](EntryList::iterator it)
+    {
+        entries.splice(entries.begin(), entries, it);
+        return entries.front().second;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(_capacity == 0u)
+            return nullptr;
+
+        const auto it = std::find_if(entries.begin(), entries.end(),
+                                     [&](const EntryList::value_type& e) {
+                                         const auto& revs = e.second->revisions;
+                                         return std::find(revs.cbegin(), revs.cend(),
+                                                          std::make_pair(revision, sysHash))
+                                             != revs.cend();
+                                     });
+        if(it != entries.end())
+            return moveToFront(it);
+    }
+
+    // unknown revision (or modified system): identify the setup by its content (without lock)
+    ++_nbContentHashes;
+    const auto hash = geometryOnly ? geometryHash(setup) : contentHash(setup);
+    if(hash.isEmpty())
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_capacity == 0u)
+        return nullptr;
+
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [&hash](const EntryList::value_type& e) { return e.first == hash; });
+    if(it == entries.end())
+    {
+        entries.emplace_front(hash, std::make_shared<Entry>());
+        it = entries.begin();
+    }
+
+    // a revision belongs to a single entry (the content of entries with an earlier record of the
+    // revision has been modified through pointers to components)
+    for(auto& e : entries)
+    {
+        auto& revs = e.second->revisions;
+        revs.erase(std::remove_if(revs.begin(), revs.end(),
+                                  [revision](const std::pair<quint64, QByteArray>& rev) {
+                                      return rev.first == revision;
+                                  }),
+                   revs.end());
+    }
+
+    auto& revisions = it->second->revisions;
+    if(revisions.size() == MAX_NB_REVISIONS_PER_ENTRY)
+        revisions.erase(revisions.begin());
+    revisions.emplace_back(revision, sysHash);
+
+    const auto ret = moveToFront(it);
+    while(entries.size() > _capacity)
+        entries.pop_back();
+
+    return ret;
+}
+
+} // namespace CTL
@@ -0,0 +1,103 @@
+#ifndef CTL_SETUPARTIFACTCACHE_H
+#define CTL_SETUPARTIFACTCACHE_H
+
+#include "acquisitionsetup.h"
+#include "radiationencoder.h"
+#include "viewgeometry.h"
+
+#include <QByteArray>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace CTL {
+
+/*!
+ * \class SetupArtifactCache
+ *
+ * \brief Singleton that caches quantities derived from an AcquisitionSetup.
+ *
+ * Several stages of a projection pipeline (e.g. SpectralEffectsExtension, PoissonNoiseExtension,
+ * DetectorSaturationExtension and the final projector) require information that is derived from
+ * the same AcquisitionSetup during their configuration. Querying this information from the
+ * SetupArtifactCache ensures that it is computed only once per setup.
+ *
+ * The cached artifacts are:
+ * \li the FullGeometry (see GeometryEncoder::encodeFullGeometry()),
+ * \li the SpectralInformation for a certain energy resolution (see
+ * RadiationEncoder::spectralInformation()),
+ * \li the incident photon counts per pixel for all views and modules (see
+ * RadiationEncoder::photonsPerPixel()).
+ *
+ * Artifacts are computed lazily on first request. Setups are identified by their revision (see
+ * AcquisitionSetup::revision()), which is shared by copies and renewed by each non-const access
+ * to a setup, together with a hash of the current state of their system. The latter detects
+ * modifications through pointers to components that have been obtained earlier. Only if this pair
+ * is unknown to the cache, the (more expensive) hash of the serialized content is computed (see
+ * contentHash()), which includes the state of the system and all prepare steps. Hence, two setups
+ * with equal content share their artifacts, independently of whether they are the same object.
+ *
+ * The geometry is held separately and identified by the part of the content that determines the
+ * geometry only (see geometryHash()). Thus, setups that differ only in spectral properties of the
+ * source (e.g. the energy bins processed by a SpectralEffectsExtension) share their geometry.
+ *
+ * The cache holds artifacts of up to capacity() setups (and geometries of up to capacity() setups
+ * with distinct geometry); the least recently used setup is discarded when the capacity is
+ * exceeded. A capacity of zero disables caching. All methods are thread-safe.
+ *
+ * Example:
+ * \code
+ * AcquisitionSetup setup(CTSystemBuilder::createFromBlueprint(blueprints::GenericCarmCT()), 100);
+ * setup.applyPreparationProtocol(protocols::ShortScanTrajectory(750.0));
+ *
+ * auto& cache = SetupArtifactCache::instance();
+ * auto geo1 = cache.fullGeometry(setup);            // computes the geometry
+ * auto geo2 = cache.fullGeometry(setup);            // taken from the cache
+ * auto geo3 = cache.fullGeometry(AcquisitionSetup(setup)); // taken from the cache (equal content)
+ *
+ * qInfo() << cache.nbComputations();                // output: 1 (on a fresh cache)
+ * \endcode
+ */
+class SetupArtifactCache
+{
+public:
+    static SetupArtifactCache& instance();
+    static QByteArray contentHash(const AcquisitionSetup& setup);
+    static QByteArray geometryHash(const AcquisitionSetup& setup);
+
+    FullGeometry fullGeometry(const AcquisitionSetup& setup);
+    SpectralInformation spectralInformation(const AcquisitionSetup& setup,
+                                            float energyResolution = 0.0f);
+    std::vector<std::vector<float>> photonsPerPixel(const AcquisitionSetup& setup);
+
+    uint capacity() const;
+    void setCapacity(uint capacity);
+    void clear();
+    uint nbEntries() const;
+    uint nbComputations() const;
+    uint nbContentHashes() const;
+
+private:
+    struct Entry;
+
+    SetupArtifactCache() = default;
+    // non-copyable
+    SetupArtifactCache(const SetupArtifactCache&) = delete;
+    SetupArtifactCache& operator=(const SetupArtifactCache&) = delete;
+
+    using EntryList = std::list<std::pair<QByteArray, std::shared_ptr<Entry>>>;
+
+    std::shared_ptr<Entry> entry(const AcquisitionSetup& setup, bool geometryOnly);
+
+    mutable std::mutex _mutex; //!< Protects the lists of entries and the capacity.
+    EntryList _entries; //!< Entries by content hash, most recently used first.
+    EntryList _geometryEntries; //!< Entries by geometry hash, most recently used first.
+    uint _capacity = 4u; //!< Maximum number of setups whose artifacts are held.
+    std::atomic<uint> _nbComputations{ 0u }; //!< Number of computed artifacts (i.e. cache misses).
+    std::atomic<uint> _nbContentHashes{ 0u }; //!< Number of lookups with an unknown revision.
+};
+
+} // namespace CTL
+
+#endif // CTL_SETUPARTIFACTCACHE_H
@@ -55,6 +55,22 @@ bool HelicalTrajectory::isApplicableTo(const AcquisitionSetup &setup) const
     return tmp.isApplicableTo(*setup.system());
 }
 
+std::shared_ptr<const AbstractPrepareStepTable>
+HelicalTrajectory::prepareStepTable(const AcquisitionSetup& setup) const
+{
+    const auto nbViews = setup.nbViews();
+    std::vector<double> rotationAngles(nbViews);
+    std::vector<double> pitchPositions(nbViews);
+    for(uint view = 0; view < nbViews; ++view)
+    {
+        rotationAngles[view] = view * _angleIncrement + _startAngle;
+        pitchPositions[view] = view * _pitchIncrement + _startPitch;
+    }
+
+    return std::make_shared<prepare::TubularGantryParamTable>(std::move(rotationAngles),
+                                                              std::move(pitchPositions));
+}
+
 WobbleTrajectory::WobbleTrajectory(double angleSpan,
                                    double sourceToIsocenter,
                                    double startAngle,
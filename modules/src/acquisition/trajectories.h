@@ -17,6 +17,7 @@ public:
 
     std::vector<std::shared_ptr<AbstractPrepareStep>> prepareSteps(uint viewNb, const AcquisitionSetup& setup) const override;
     bool isApplicableTo(const AcquisitionSetup& setup) const override;
+    std::shared_ptr<const AbstractPrepareStepTable> prepareStepTable(const AcquisitionSetup& setup) const override;
 
     void setAngleIncrement(double angleIncrement);
     void setPitchIncrement(double pitchIncrement);
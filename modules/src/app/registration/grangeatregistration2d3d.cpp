@@ -1,6 +1,15 @@
 #include "grangeatregistration2d3d.h"
+#include "processing/consistencycpu.h"
+#include "processing/radon3dcoordtransformcpu.h"
+#include "processing/threadpool.h"
+#ifdef OCL_ROUTINES_MODULE_AVAILABLE
 #include "processing/consistency.h"
+#endif
 #include <QDebug>
+#include <QElapsedTimer>
+#include <limits>
+#include <mutex>
+#include <random>
 
 namespace CTL {
 namespace NLOPT {
@@ -10,55 +19,88 @@ namespace {
 struct DataForOptimization
 {
     const std::shared_ptr<const std::vector<float>>& projIntermedFct;
-    const OCL::VolumeResampler& volumeIntermedResampler;
-    const OCL::Radon3DCoordTransform& radon3DCoordTransform;
+    const AbstractVolumeResampler& volumeIntermedResampler;
+    const AbstractRadon3DCoordTransform& radon3DCoordTransform;
     const imgproc::AbstractErrorMetric& metric;
 };
 
-float computeDeltaS(const OCL::VolumeResampler& volIntermedFct, const mat::ProjectionMatrix& pMat);
+float computeDeltaS(const AbstractVolumeResampler& volIntermedFct, const mat::ProjectionMatrix& pMat);
+std::mutex& oclMutex();
+bool isOpenCLResampler(const AbstractVolumeResampler& resampler);
+IntermediateFctPair initialIntermedFctPair(const Chunk2D<float>& projectionImage,
+                                           const AbstractVolumeResampler& volumeIntermedResampler,
+                                           const mat::ProjectionMatrix& pMat,
+                                           float lineDistance, float subSamplingLevel,
+                                           std::unique_ptr<AbstractRadon3DCoordTransform>& transf);
+std::vector<std::shared_ptr<const AbstractRadon3DCoordTransform>>
+transformsForStarts(std::unique_ptr<AbstractRadon3DCoordTransform> transf, size_t nbStarts);
 double objFct(const std::vector<double>& x, std::vector<double>& grad, void* data);
 Matrix3x3 rotationMatrix(const Vector3x1& axis);
+mat::Homography3D toHomography(const std::vector<double>& param);
 void generateMsg(nlopt::result errCode);
 
 } // unnamed namespace
 
 mat::Homography3D GrangeatRegistration2D3D::optimize(const Chunk2D<float>& projectionImage,
-                                                     const OCL::VolumeResampler& volumeIntermedResampler,
+                                                     const AbstractVolumeResampler& volumeIntermedResampler,
                                                      const mat::ProjectionMatrix& pMat)
 {
     // calculate s spacing in sinogram
     const auto deltaS = computeDeltaS(volumeIntermedResampler, pMat);
     Q_ASSERT(deltaS > 0.0f);
 
-    // initialize IntermedGen2D3D
-    OCL::IntermedGen2D3D gen;
-    gen.setLineDistance(deltaS);
-    if(_subSamplingLevel != 1.0f)
-        gen.setSubsampleLevel(_subSamplingLevel);
-
-    // calculate initial intermediate functions
-    auto initalIntermedFctPair = gen.intermedFctPair(projectionImage, pMat, volumeIntermedResampler);
-    qDebug() << "initial inconsistency:" << initalIntermedFctPair.inconsistency(*_metric);
-
-    // initialize transformation of 3d Radon coordinates
-    const OCL::Radon3DCoordTransform transf(gen.lastSampling());
+    // coarse-to-fine optimization (initial guess is the identity transform)
+    std::vector<double> param(6, 0.0);
+    for(const auto& level : resolutionSchedule())
+        param = optimizeLevel(projectionImage, volumeIntermedResampler, pMat, deltaS, level, param,
+                              _nbThreads);
 
-    // initialize optimization
-    DataForOptimization data{ initalIntermedFctPair.ptrToFirst(), volumeIntermedResampler, transf,
-                              *_metric };
-    _opt.set_min_objective(objFct, &data);
+    return toHomography(param);
+}
 
-    // perform optimization
-    std::vector<double> param(6, 0.0);
-    double remainInconsistency;
-    auto errCode = _opt.optimize(param, remainInconsistency);
+std::vector<mat::Homography3D>
+GrangeatRegistration2D3D::optimize(const std::vector<Chunk2D<float>>& projectionImages,
+                                   const AbstractVolumeResampler& volumeIntermedResampler,
+                                   const std::vector<mat::ProjectionMatrix>& pMats)
+{
+    if(projectionImages.size() != pMats.size())
+        throw std::runtime_error("GrangeatRegistration2D3D::optimize: number of projection images "
+                                 "and projection matrices do not match.");
 
-    // output messages
-    qDebug() << "remaining inconsistency:" << remainInconsistency;
-    generateMsg(errCode);
+    const auto nbFrames = projectionImages.size();
+    const auto schedule = resolutionSchedule();
+    std::vector<mat::Homography3D> ret(nbFrames);
 
-    return Homography3D(rotationMatrix({ param[0], param[1], param[2] }), // rotation matrix
-                        Vector3x1{ param[3], param[4], param[5] });       // translation vector
+    QElapsedTimer time;
+    time.start();
+    {
+        // parallelization over frames, multi-starts of each frame are processed serially
+        ThreadPool tp(std::min(size_t(_nbThreads == 0 ? ThreadBudget::nbThreads() : _nbThreads),
+                               nbFrames));
+        // share the threads among the frames (nested parallel routines of the CPU implementation)
+        const auto budgetPerFrame = ThreadBudget::nbThreads() / tp.nbThreads();
+        for(size_t f = 0; f < nbFrames; ++f)
+            tp.enqueueThread([&, f]
+            {
+                ThreadBudget budget(budgetPerFrame);
+                const auto deltaS = computeDeltaS(volumeIntermedResampler, pMats[f]);
+                Q_ASSERT(deltaS > 0.0f);
+
+                std::vector<double> param(6, 0.0);
+                for(const auto& level : schedule)
+                    param = optimizeLevel(projectionImages[f], volumeIntermedResampler, pMats[f],
+                                          deltaS, level, param, 1u);
+
+                ret[f] = toHomography(param);
+            });
+    } // blocking dtor of `tp`
+
+    const auto elapsedSec = std::max(time.elapsed(), qint64(1)) * 1.0e-3;
+    _lastThroughput = double(nbFrames) / elapsedSec;
+    qInfo().noquote() << "registered" << nbFrames << "frames in" << elapsedSec << "s ("
+                      << _lastThroughput << "frames/s)";
+
+    return ret;
 }
 
 nlopt::opt& GrangeatRegistration2D3D::optObject() { return _opt; }
@@ -80,9 +122,182 @@ void GrangeatRegistration2D3D::setSubSamplingLevel(float subSamplingLevel)
     _subSamplingLevel = subSamplingLevel;
 }
 
+/*!
+ * Returns the resolution schedule used by optimize(). If no schedule has been set, a single level
+ * with the subSamplingLevel() and the default line distance is returned.
+ */
+std::vector<GrangeatRegistration2D3D::ResolutionLevel>
+GrangeatRegistration2D3D::resolutionSchedule() const
+{
+    if(_schedule.empty())
+        return { { _subSamplingLevel, 1.0f } };
+
+    return _schedule;
+}
+
+/*!
+ * Sets the resolution schedule that is processed by optimize(), starting with the first level.
+ * Typically, the levels grow in subsampling level and decrease in line distance factor
+ * (coarse-to-fine). Levels with a subsampling level outside (0, 1] or a non-positive line distance
+ * factor are ignored. An empty \a schedule restores the single level default.
+ */
+void GrangeatRegistration2D3D::setResolutionSchedule(std::vector<ResolutionLevel> schedule)
+{
+    auto invalidLevel = [](const ResolutionLevel& level)
+    {
+        return level.subSamplingLevel <= 0.0f || level.subSamplingLevel > 1.0f ||
+               level.lineDistanceFactor <= 0.0f;
+    };
+    const auto newEnd = std::remove_if(schedule.begin(), schedule.end(), invalidLevel);
+    if(newEnd != schedule.end())
+        qWarning("Invalid levels of the resolution schedule are ignored.");
+    schedule.erase(newEnd, schedule.end());
+
+    _schedule = std::move(schedule);
+}
+
+uint GrangeatRegistration2D3D::nbStarts() const { return _nbStarts; }
+
+/*!
+ * Sets the number of starts of the optimization on each resolution level. The first start always
+ * uses the current estimate, all further starts are randomly distributed around it.
+ */
+void GrangeatRegistration2D3D::setNbStarts(uint nbStarts)
+{
+    if(nbStarts == 0)
+        qWarning("Number of starts of zero is ignored.");
+    else
+        _nbStarts = nbStarts;
+}
+
+double GrangeatRegistration2D3D::startSpread() const { return _startSpread; }
+
+/*!
+ * Sets the range of the random initial guesses to +-\a startSpread [mm/deg] around the current
+ * estimate.
+ */
+void GrangeatRegistration2D3D::setStartSpread(double startSpread)
+{
+    _startSpread = std::abs(startSpread);
+}
+
+uint GrangeatRegistration2D3D::nbThreads() const { return _nbThreads; }
+
+/*!
+ * Sets the number of threads that are used for the parallel evaluation of multiple starts (or
+ * multiple frames). A value of zero defaults to `std::thread::hardware_concurrency()`.
+ *
+ * The available threads (see ThreadBudget) are shared among the concurrent starts (or frames), i.e.
+ * the parallel routines of the CPU implementation of the consistency chain do not create more
+ * threads than available.
+ */
+void GrangeatRegistration2D3D::setNbThreads(uint nbThreads) { _nbThreads = nbThreads; }
+
+/*!
+ * Returns the throughput [frames/s] of the last batch registration.
+ */
+double GrangeatRegistration2D3D::lastThroughput() const { return _lastThroughput; }
+
+std::vector<double>
+GrangeatRegistration2D3D::optimizeLevel(const Chunk2D<float>& projectionImage,
+                                        const AbstractVolumeResampler& volumeIntermedResampler,
+                                        const mat::ProjectionMatrix& pMat,
+                                        float deltaS,
+                                        const ResolutionLevel& level,
+                                        const std::vector<double>& initialParam,
+                                        uint nbThreads) const
+{
+    const auto useOpenCL = isOpenCLResampler(volumeIntermedResampler);
+
+    auto params = startingPoints(initialParam);
+
+    // calculate initial intermediate functions and initialize transformation of 3d Radon coords
+    // (one transformation per start, such that the starts do not share OpenCL resources)
+    std::unique_ptr<AbstractRadon3DCoordTransform> transf;
+    std::unique_lock<std::mutex> oclLock(oclMutex(), std::defer_lock);
+    if(useOpenCL)
+        oclLock.lock();
+    auto initalIntermedFctPair = initialIntermedFctPair(projectionImage, volumeIntermedResampler,
+                                                        pMat, deltaS * level.lineDistanceFactor,
+                                                        level.subSamplingLevel, transf);
+    const auto transfs = transformsForStarts(std::move(transf), params.size());
+    if(useOpenCL)
+        oclLock.unlock();
+
+    // perform optimization from all starting points
+    std::vector<DataForOptimization> data;
+    data.reserve(params.size());
+    for(const auto& startTransf : transfs)
+        data.push_back({ initalIntermedFctPair.ptrToFirst(), volumeIntermedResampler, *startTransf,
+                         *_metric });
+    std::vector<double> remainInconsistency(params.size(), std::numeric_limits<double>::max());
+    std::vector<nlopt::result> errCodes(params.size(), nlopt::result::FAILURE);
+
+    auto optimizeStart = [this, &data, &params, &remainInconsistency, &errCodes](size_t start,
+                                                                                size_t threadBudget)
+    {
+        ThreadBudget budget(threadBudget);
+        auto opt = _opt;
+        opt.set_min_objective(objFct, &data[start]);
+        try
+        {
+            errCodes[start] = opt.optimize(params[start], remainInconsistency[start]);
+        } catch(const std::exception& e)
+        {
+            qCritical() << "Optimization of start" << start << "failed:" << e.what();
+        }
+    };
+
+    if(params.size() == 1)
+        optimizeStart(0, ThreadBudget::nbThreads());
+    else
+    {
+        ThreadPool tp(std::min(size_t(nbThreads == 0 ? ThreadBudget::nbThreads() : nbThreads),
+                               params.size()));
+        // share the threads among the concurrent starts
+        const auto budgetPerStart = ThreadBudget::nbThreads() / tp.nbThreads();
+        for(size_t start = 0; start < params.size(); ++start)
+            tp.enqueueThread(optimizeStart, start, budgetPerStart);
+    }
+
+    const auto best = size_t(std::distance(remainInconsistency.cbegin(),
+                                           std::min_element(remainInconsistency.cbegin(),
+                                                            remainInconsistency.cend())));
+
+    // output messages
+    generateMsg(errCodes[best]);
+
+    return params[best];
+}
+
+std::vector<std::vector<double>>
+GrangeatRegistration2D3D::startingPoints(const std::vector<double>& center) const
+{
+    std::vector<std::vector<double>> ret(_nbStarts, center);
+
+    const auto lowerBounds = _opt.get_lower_bounds();
+    const auto upperBounds = _opt.get_upper_bounds();
+
+    // fixed seed for reproducible results
+    std::mt19937 rng;
+    std::uniform_real_distribution<double> offset(-_startSpread, _startSpread);
+    for(auto start = 1u; start < _nbStarts; ++start)
+        for(auto i = 0u; i < 6u; ++i)
+        {
+            auto& x = ret[start][i];
+            x += offset(rng);
+            if(i < lowerBounds.size())
+                x = std::max(x, lowerBounds[i]);
+            if(i < upperBounds.size())
+                x = std::min(x, upperBounds[i]);
+        }
+
+    return ret;
+}
+
 namespace {
 
-float computeDeltaS(const OCL::VolumeResampler& volIntermedFct, const mat::ProjectionMatrix& pMat)
+float computeDeltaS(const AbstractVolumeResampler& volIntermedFct, const mat::ProjectionMatrix& pMat)
 {
     Q_ASSERT(volIntermedFct.volDim().z > 1);
     const auto& dRange = volIntermedFct.rangeDim3();
@@ -91,14 +306,86 @@ float computeDeltaS(const OCL::VolumeResampler& volIntermedFct, const mat::Proje
     return magnification * deltaD;
 }
 
+// the OpenCL setup (registration and compilation of kernels in `OpenCLConfig`) is not thread-safe,
+// hence the creation of OpenCL resources for concurrent optimizations needs to be serialized
+std::mutex& oclMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+bool isOpenCLResampler(const AbstractVolumeResampler& resampler)
+{
+#ifdef OCL_ROUTINES_MODULE_AVAILABLE
+    return dynamic_cast<const OCL::VolumeResampler*>(&resampler) != nullptr;
+#else
+    Q_UNUSED(resampler)
+    return false;
+#endif
+}
+
+// computes the initial intermediate function pair using the backend that corresponds to
+// `volumeIntermedResampler` and creates the matching transformation of the sampled 3d Radon coords
+IntermediateFctPair initialIntermedFctPair(const Chunk2D<float>& projectionImage,
+                                           const AbstractVolumeResampler& volumeIntermedResampler,
+                                           const mat::ProjectionMatrix& pMat,
+                                           float lineDistance, float subSamplingLevel,
+                                           std::unique_ptr<AbstractRadon3DCoordTransform>& transf)
+{
+#ifdef OCL_ROUTINES_MODULE_AVAILABLE
+    if(isOpenCLResampler(volumeIntermedResampler))
+    {
+        OCL::IntermedGen2D3D gen;
+        gen.setLineDistance(lineDistance);
+        if(subSamplingLevel != 1.0f)
+            gen.setSubsampleLevel(subSamplingLevel);
+
+        auto ret = gen.intermedFctPair(projectionImage, pMat, volumeIntermedResampler);
+        transf.reset(new OCL::Radon3DCoordTransform(gen.lastSampling()));
+        return ret;
+    }
+#endif
+
+    IntermedGen2D3DCPU gen;
+    gen.setLineDistance(lineDistance);
+    if(subSamplingLevel != 1.0f)
+        gen.setSubsampleLevel(subSamplingLevel);
+
+    auto ret = gen.intermedFctPair(projectionImage, pMat, volumeIntermedResampler);
+    transf.reset(new Radon3DCoordTransformCPU(gen.lastSampling()));
+    return ret;
+}
+
+// returns the transformation of the sampled 3d Radon coords for each of `nbStarts` concurrent
+// starts: the CPU implementation is thread-safe and shared by all starts, whereas each start gets
+// its own instance of the OpenCL implementation (own kernel objects and command queue)
+std::vector<std::shared_ptr<const AbstractRadon3DCoordTransform>>
+transformsForStarts(std::unique_ptr<AbstractRadon3DCoordTransform> transf, size_t nbStarts)
+{
+    std::vector<std::shared_ptr<const AbstractRadon3DCoordTransform>> ret(nbStarts);
+    ret[0] = std::move(transf);
+
+#ifdef OCL_ROUTINES_MODULE_AVAILABLE
+    if(const auto oclTransf = dynamic_cast<const OCL::Radon3DCoordTransform*>(ret[0].get()))
+    {
+        const auto initialCoords = oclTransf->initialHomCoords();
+        for(size_t start = 1; start < nbStarts; ++start)
+            ret[start] = std::make_shared<OCL::Radon3DCoordTransform>(initialCoords);
+        return ret;
+    }
+#endif
+
+    std::fill(ret.begin() + 1, ret.end(), ret[0]);
+    return ret;
+}
+
 double objFct(const std::vector<double>& x, std::vector<double>&, void* data)
 {
     // x = [r_ t_] = [rx ry rz tx ty tz]
     const auto* d = static_cast<DataForOptimization*>(data);
-    const auto H = Homography3D(rotationMatrix({ x[0], x[1], x[2] }), { x[3], x[4], x[5] });
-    const auto& transformedBuf = d->radon3DCoordTransform.transform(H);
-    const IntermediateFctPair intermPair(d->projIntermedFct,
-                                         d->volumeIntermedResampler.sample(transformedBuf),
+    const auto H = toHomography(x);
+    auto volIntermedFct = d->radon3DCoordTransform.sampleTransformed(H, d->volumeIntermedResampler);
+    const IntermediateFctPair intermPair(d->projIntermedFct, std::move(volIntermedFct),
                                          IntermediateFctPair::VolumeDomain);
     return intermPair.inconsistency(d->metric);
 }
@@ -109,6 +396,12 @@ Matrix3x3 rotationMatrix(const Vector3x1& axis)
     return mat::rotationMatrix(axis * (PI / 180.0));
 }
 
+mat::Homography3D toHomography(const std::vector<double>& param)
+{
+    return Homography3D(rotationMatrix({ param[0], param[1], param[2] }), // rotation matrix
+                        Vector3x1{ param[3], param[4], param[5] });       // translation vector
+}
+
 void generateMsg(nlopt::result errCode)
 {
     if(errCode < 0)
@@ -5,7 +5,7 @@
 #include "mat/homography.h"
 #include "mat/projectionmatrix.h"
 #include "processing/errormetrics.h"
-#include "processing/volumeresampler.h"
+#include "processing/abstractvolumeresampler.h"
 #include <nlopt.hpp>
 
 namespace CTL {
@@ -15,14 +15,41 @@ namespace NLOPT {
  * \class GrangeatRegistration2D3D
  *
  * \brief Grangeat-based 2D/3D registration using NLopt for optimization
+ *
+ * The optimization can be performed in a coarse-to-fine manner by means of a resolution schedule
+ * (see setResolutionSchedule()). Each level of the schedule defines a subsampling level and a
+ * factor for the distance of the sampled detector lines (which also determines the angular
+ * density of the sampled planes). The result of each level is used as the initial guess for the
+ * subsequent level.
+ *
+ * On each level, the optimization can be started from several initial guesses (multi-start, see
+ * setNbStarts()). The starts are randomly distributed around the current estimate within a range
+ * of +-startSpread() [mm/deg] and are evaluated in parallel. The best result is passed on.
+ *
+ * A batch of projection images can be registered with one call of optimize(), which shares the
+ * sampler of the 3D intermediate space among all frames and reports the achieved throughput.
+ *
+ * The sampler of the 3D intermediate space may be an OCL::VolumeResampler or any other
+ * AbstractVolumeResampler, e.g. a VolumeResamplerCPU. In the latter case, the whole consistency
+ * chain is evaluated on the CPU and no OpenCL device is required.
  */
 
 class GrangeatRegistration2D3D
 {
 public:
+    struct ResolutionLevel
+    {
+        float subSamplingLevel;   //!< fraction of the sampled subset of available values
+        float lineDistanceFactor; //!< multiple of the line distance (coarser for values > 1)
+    };
+
     CTL::mat::Homography3D optimize(const CTL::Chunk2D<float>& projectionImage,
-                                    const CTL::OCL::VolumeResampler& volumeIntermedResampler,
+                                    const CTL::AbstractVolumeResampler& volumeIntermedResampler,
                                     const CTL::mat::ProjectionMatrix& pMat);
+    std::vector<CTL::mat::Homography3D>
+    optimize(const std::vector<CTL::Chunk2D<float>>& projectionImages,
+             const CTL::AbstractVolumeResampler& volumeIntermedResampler,
+             const std::vector<CTL::mat::ProjectionMatrix>& pMats);
 
     nlopt::opt& optObject();
 
@@ -32,10 +59,36 @@ public:
     float subSamplingLevel() const;
     void setSubSamplingLevel(float subSamplingLevel);
 
+    std::vector<ResolutionLevel> resolutionSchedule() const;
+    void setResolutionSchedule(std::vector<ResolutionLevel> schedule);
+
+    uint nbStarts() const;
+    void setNbStarts(uint nbStarts);
+    double startSpread() const;
+    void setStartSpread(double startSpread);
+    uint nbThreads() const;
+    void setNbThreads(uint nbThreads);
+
+    double lastThroughput() const;
+
 private:
     nlopt::opt _opt{ nlopt::algorithm::LN_SBPLX, 6u };
     const CTL::imgproc::AbstractErrorMetric* _metric = &CTL::metric::L2;
     float _subSamplingLevel = 1.0f;
+    std::vector<ResolutionLevel> _schedule; //!< empty schedule: single level with `_subSamplingLevel`
+    uint _nbStarts = 1u;
+    double _startSpread = 5.0; //!< [mm/deg]
+    uint _nbThreads = 0u; //!< zero: `std::thread::hardware_concurrency()`
+    double _lastThroughput = 0.0; //!< [frames/s]
+
+    std::vector<double> optimizeLevel(const CTL::Chunk2D<float>& projectionImage,
+                                      const CTL::AbstractVolumeResampler& volumeIntermedResampler,
+                                      const CTL::mat::ProjectionMatrix& pMat,
+                                      float deltaS,
+                                      const ResolutionLevel& level,
+                                      const std::vector<double>& initialParam,
+                                      uint nbThreads) const;
+    std::vector<std::vector<double>> startingPoints(const std::vector<double>& center) const;
 };
 
 } // namespace NLOPT
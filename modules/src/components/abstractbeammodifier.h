@@ -55,6 +55,7 @@ class AbstractBeamModifier : public SystemComponent
 public:
     // virtual methods
     QString info() const override;
+    virtual QVariant spectralState() const;
 
     void fromVariant(const QVariant& variant) override; // de-serialization
     QVariant toVariant() const override; // serialization
@@ -92,6 +93,20 @@ inline QString AbstractBeamModifier::info() const
     return ret;
 }
 
+/*!
+ * Returns a description of all properties of this instance that determine its effect on the
+ * spectrum and the photon flux (e.g. material and thickness of a filter). Two modifiers with equal
+ * spectral state must modify the same input spectrum in the same way. This is used to avoid
+ * repeated evaluation of identical spectra (see RadiationEncoder).
+ *
+ * Returning a valid QVariant also declares that modifiedFlux() is proportional to the input flux,
+ * such that the ratio of output and input flux can be reused for different input fluxes.
+ *
+ * By default, this returns an invalid QVariant, meaning that the spectral state is unknown (i.e.
+ * spectra are always evaluated).
+ */
+inline QVariant AbstractBeamModifier::spectralState() const { return QVariant(); }
+
 // Use SerializationInterface::fromVariant() documentation.
 inline void AbstractBeamModifier::fromVariant(const QVariant& variant)
 {
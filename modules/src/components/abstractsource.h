@@ -79,6 +79,7 @@ public:
     // virtual methods  
     virtual IntervalDataSeries spectrum(uint nbSamples) const;
     virtual uint spectrumDiscretizationHint() const;
+    virtual QVariant spectralState() const;
     virtual void setSpectrumModel(AbstractXraySpectrumModel* model);
     QString info() const override;
     void fromVariant(const QVariant& variant) override; // de-serialization
@@ -256,6 +257,18 @@ inline uint AbstractSource::spectrumDiscretizationHint() const
     return DEFAULT_SPECTRUM_RESOLUTION_HINT;
 }
 
+/*!
+ * Returns a description of all properties of this instance that determine its (normalized)
+ * spectrum, e.g. the tube voltage of an X-ray tube. Two sources with equal spectral state must
+ * emit the same spectrum (the photon flux may differ). This is used to avoid repeated evaluation
+ * of identical spectra (see RadiationEncoder).
+ *
+ * By default, this returns an invalid QVariant, meaning that the spectral state is unknown (i.e.
+ * spectra are always evaluated). Re-implement this method in sub-classes whose spectrum is
+ * determined by a few parameters.
+ */
+inline QVariant AbstractSource::spectralState() const { return QVariant(); }
+
 /*!
  * Returns the focal spot size of this instance.
  *
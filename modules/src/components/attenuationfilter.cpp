@@ -1,5 +1,6 @@
 #include "attenuationfilter.h"
 #include <cmath>
+#include <typeinfo>
 
 namespace CTL {
 
@@ -117,5 +118,29 @@ QString AttenuationFilter::info() const
     return ret;
 }
 
+/*!
+ * Returns the spectral state of the filter, which consists of thickness, density and attenuation
+ * model (see AbstractBeamModifier::spectralState()).
+ *
+ * The attenuation model is identified by its address, since it is shared between copies of the
+ * filter.
+ *
+ * Sub classes may attenuate differently; for their instances, an invalid QVariant is returned.
+ */
+QVariant AttenuationFilter::spectralState() const
+{
+    if(typeid(*this) != typeid(AttenuationFilter))
+        return QVariant();
+
+    QVariantMap ret;
+    ret.insert("type-id", type());
+    ret.insert("thickness", _mm);
+    ret.insert("density", _density);
+    ret.insert("attenuation model",
+               QString::number(reinterpret_cast<quintptr>(_attenuationModel.get()), 16));
+
+    return ret;
+}
+
 
 } // namespace CTL
@@ -37,6 +37,7 @@ public:
     // SystemComponent interface
 public:
     QString info() const override;
+    QVariant spectralState() const override;
 
 private:
     AttenuationFilter();
@@ -1,5 +1,7 @@
 #include "genericbeammodifier.h"
 
+#include <typeinfo>
+
 namespace CTL {
 
 DECLARE_SERIALIZABLE_TYPE(GenericBeamModifier)
@@ -40,6 +42,23 @@ QString GenericBeamModifier::info() const
     return ret;
 }
 
+/*!
+ * Returns the spectral state of this instance (see AbstractBeamModifier::spectralState()). Since
+ * the spectrum is not modified at all, this only contains the type.
+ *
+ * Returns an invalid QVariant for instances of sub classes, since their spectral effect is unknown.
+ */
+QVariant GenericBeamModifier::spectralState() const
+{
+    if(typeid(*this) != typeid(GenericBeamModifier))
+        return QVariant();
+
+    QVariantMap ret;
+    ret.insert("type-id", type());
+
+    return ret;
+}
+
 /*!
  * Returns the default name for the component: "Generic beam modifier".
  */
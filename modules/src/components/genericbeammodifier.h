@@ -31,6 +31,7 @@ public:
     // virtual methods
     SystemComponent* clone() const override;
     QString info() const override;
+    QVariant spectralState() const override;
     void fromVariant(const QVariant& variant) override; // de-serialization
     QVariant toVariant() const override; // serialization
 
@@ -1,6 +1,8 @@
 #include "xraylaser.h"
 #include "models/xrayspectrummodels.h"
 
+#include <typeinfo>
+
 namespace CTL {
 
 DECLARE_SERIALIZABLE_TYPE(XrayLaser)
@@ -93,6 +95,28 @@ uint XrayLaser::spectrumDiscretizationHint() const
     return 1;
 }
 
+/*!
+ * Returns the spectral state of the laser, which consists of the photon energy and a possible
+ * restriction of the energy range (see AbstractSource::spectralState()).
+ *
+ * Returns an invalid QVariant for instances of sub classes, since their spectrum may depend on
+ * further properties.
+ */
+QVariant XrayLaser::spectralState() const
+{
+    if(typeid(*this) != typeid(XrayLaser))
+        return QVariant();
+
+    QVariantMap ret;
+    ret.insert("type-id", type());
+    ret.insert("energy", _energy);
+    if(_hasRestrictedEnergyWindow)
+        ret.insert("energy window", QVariantList{ _restrictedEnergyWindow.start(),
+                                                  _restrictedEnergyWindow.end() });
+
+    return ret;
+}
+
 // Use SystemComponent::fromVariant() documentation.
 void XrayLaser::fromVariant(const QVariant& variant)
 {
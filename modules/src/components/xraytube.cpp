@@ -1,6 +1,8 @@
 #include "xraytube.h"
 #include "models/xrayspectrummodels.h"
 
+#include <typeinfo>
+
 namespace CTL {
 
 DECLARE_SERIALIZABLE_TYPE(XrayTube)
@@ -203,4 +205,26 @@ uint XrayTube::spectrumDiscretizationHint() const
     return static_cast<uint>(std::max(ret, 1));
 }
 
+/*!
+ * Returns the spectral state of the tube, which consists of the tube voltage and a possible
+ * restriction of the energy range (see AbstractSource::spectralState()).
+ *
+ * Returns an invalid QVariant for instances of sub classes, since their spectrum may depend on
+ * further properties.
+ */
+QVariant XrayTube::spectralState() const
+{
+    if(typeid(*this) != typeid(XrayTube))
+        return QVariant();
+
+    QVariantMap ret;
+    ret.insert("type-id", type());
+    ret.insert("tube voltage", _tubeVoltage);
+    if(_hasRestrictedEnergyWindow)
+        ret.insert("energy window", QVariantList{ _restrictedEnergyWindow.start(),
+                                                  _restrictedEnergyWindow.end() });
+
+    return ret;
+}
+
 } // namespace CTL
@@ -30,6 +30,7 @@ public:
     QVariant toVariant() const override; // serialization
     //void setSpectrumModel(AbstractXraySpectrumModel* model) override; //deprecated
     uint spectrumDiscretizationHint() const override;
+    QVariant spectralState() const override;
 
     // getter methods
     double tubeVoltage() const;
@@ -18,6 +18,7 @@
 #include "acquisition/preparationprotocols.h"
 #include "acquisition/preparesteps.h"
 #include "acquisition/radiationencoder.h"
+#include "acquisition/setupartifactcache.h"
 #include "acquisition/simplectsystem.h"
 #include "acquisition/systemblueprints.h"
 #include "acquisition/trajectories.h"
@@ -42,11 +43,15 @@
 #include "components/xraytube.h"
 #include "img/abstractdynamicvolumedata.h"
 #include "img/basisfunctionvolume.h"
+#include "img/bufferpool.h"
 #include "img/chunk2d.h"
 #include "img/compositevolume.h"
+#include "img/datastatistics.h"
+#include "img/elementwise.h"
 #include "img/lineardynamicvolume.h"
 #include "img/modulelayout.h"
 #include "img/projectiondata.h"
+#include "img/reduction.h"
 #include "img/singleviewdata.h"
 #include "img/spectralvolumedata.h"
 #include "img/trivialdynamicvolume.h"
@@ -59,8 +64,10 @@
 #include "io/jsonserializer.h"
 #include "io/messagehandler.h"
 #include "io/metainfokeys.h"
+#include "io/rawfilewriter.h"
 #include "io/serializationhelper.h"
 #include "io/serializationinterface.h"
+#include "io/tracer.h"
 #include "mat/homography.h"
 #include "mat/mat.h"
 #include "mat/matrix_algorithm.h"
@@ -74,23 +81,32 @@
 #include "models/datamodeloperations.h"
 #include "models/detectorsaturationmodels.h"
 #include "models/intervaldataseries.h"
+#include "models/lookuptablemodel.h"
 #include "models/pointseriesbase.h"
 #include "models/stepfunctionmodels.h"
 #include "models/tabulateddatamodel.h"
 #include "models/xrayspectrummodels.h"
 #include "models/xydataseries.h"
+#include "processing/abstractradon3dcoordtransform.h"
 #include "processing/abstractvolumedecomposer.h"
+#include "processing/abstractvolumeresampler.h"
+#include "processing/consistencycpu.h"
 #include "processing/diff.h"
 #include "processing/errormetrics.h"
 #include "processing/filter.h"
 #include "processing/imageprocessing.h"
+#include "processing/intermediatefctpair.h"
 #include "processing/modelbasedvolumedecomposer.h"
+#include "processing/radon3dcoordtransformcpu.h"
+#include "processing/radontransform2dcpu.h"
 #include "processing/threadpool.h"
+#include "processing/volumeresamplercpu.h"
 #include "projectors/abstractprojector.h"
 #include "projectors/arealfocalspotextension.h"
 #include "projectors/detectorsaturationextension.h"
 #include "projectors/dynamicprojectorextension.h"
 #include "projectors/poissonnoiseextension.h"
+#include "projectors/projectionjob.h"
 #include "projectors/projectionpipeline.h"
 #include "projectors/projectorextension.h"
 #include "projectors/raycasterprojectorcpu.h"
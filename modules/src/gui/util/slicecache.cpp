@@ -0,0 +1,228 @@
+#include "slicecache.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace CTL {
+namespace gui {
+
+/*!
+ * Returns true if \a other refers to the same slice as this key.
+ */
+bool SliceCache::Key::operator==(const Key& other) const
+{
+    return volume == other.volume && direction == other.direction && slice == other.slice;
+}
+
+/*!
+ * Creates a SliceCache and starts its worker thread. A provider must be set with setProvider()
+ * before slices can be requested.
+ */
+SliceCache::SliceCache()
+    : _worker(&SliceCache::work, this)
+{
+}
+
+/*!
+ * Stops the worker thread (after a running computation has finished) and deletes the object.
+ */
+SliceCache::~SliceCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        _pending.clear();
+    }
+    _workAvailable.notify_one();
+    _worker.join();
+}
+
+/*!
+ * Returns the slice specified by \a key. The slice is taken from the cache if available; otherwise,
+ * it is computed by the provider (in the calling thread). In case the requested slice is just being
+ * prefetched, this waits for the prefetch to finish.
+ *
+ * Afterwards, the prefetch of the neighbouring slices of \a key is scheduled, where \a nbSlices is
+ * the total number of slices (in the direction of \a key), i.e. valid slice indices are in
+ * [0, \a nbSlices - 1]. Prefetches scheduled by previous calls are discarded if they have not
+ * been started yet.
+ *
+ * Throws std::runtime_error if no provider has been set. Exceptions thrown by the provider are
+ * propagated.
+ */
+Chunk2D<float> SliceCache::slice(const Key& key, int nbSlices)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if(!_provider)
+        throw std::runtime_error("SliceCache::slice: no provider set");
+
+    _pending.clear();
+    _workDone.wait(lock, [this, &key] { return !(_busy && _inProgress == key); });
+
+    Chunk2D<float> ret(0, 0);
+    if(auto cached = cachedSlice(key))
+        ret = *cached;
+    else
+    {
+        const auto provider = _provider;
+        lock.unlock();
+        ret = provider(key);
+        lock.lock();
+        insert(key, ret);
+    }
+
+    // schedule prefetch (nearest neighbours first)
+    for(auto dist = 1; dist <= _prefetchRadius; ++dist)
+        for(auto idx : { key.slice + dist, key.slice - dist })
+            if(idx >= 0 && idx < nbSlices)
+                _pending.push_back({ key.volume, key.direction, idx });
+    lock.unlock();
+    _workAvailable.notify_one();
+
+    return ret;
+}
+
+/*!
+ * Removes all slices from the cache and discards pending prefetches. If the worker thread is
+ * currently computing a slice, this waits until it has finished. Afterwards, data accessed by the
+ * provider may be modified safely (until the next call of slice()).
+ */
+void SliceCache::clear()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _pending.clear();
+    _workDone.wait(lock, [this] { return !_busy; });
+
+    _entries.clear();
+    _usedMemory = 0;
+}
+
+/*!
+ * Sets the maximum amount of memory used for cached slices to \a bytes. If necessary, least
+ * recently used slices are removed from the cache. The most recently used slice is always kept.
+ *
+ * By default, the cache uses up to 512 MiB.
+ */
+void SliceCache::setMaximumMemory(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxMemory = bytes;
+    shrinkToMaximumMemory();
+}
+
+/*!
+ * Sets the number of slices prefetched in each direction of a requested slice to \a nbSlices. A
+ * value of zero disables prefetching. By default, four slices on each side are prefetched.
+ */
+void SliceCache::setPrefetchRadius(int nbSlices)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _prefetchRadius = std::max(nbSlices, 0);
+}
+
+/*!
+ * Sets the function that computes a slice for a given Key to \a provider. This clears the cache
+ * (see clear()).
+ */
+void SliceCache::setProvider(Provider provider)
+{
+    clear();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _provider = std::move(provider);
+}
+
+/*!
+ * Returns the maximum amount of memory (in bytes) used for cached slices.
+ */
+size_t SliceCache::maximumMemory() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxMemory;
+}
+
+/*!
+ * Returns the number of slices prefetched in each direction of a requested slice.
+ */
+int SliceCache::prefetchRadius() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _prefetchRadius;
+}
+
+// returns the cached slice for `key` (or nullptr if not available) and marks it as most recently
+// used; must be called with locked mutex
+const Chunk2D<float>* SliceCache::cachedSlice(const Key& key)
+{
+    auto it = std::find_if(_entries.begin(), _entries.end(),
+                           [&key](const Entry& entry) { return entry.key == key; });
+    if(it == _entries.end())
+        return nullptr;
+
+    _entries.splice(_entries.begin(), _entries, it);
+    return &_entries.front().slice;
+}
+
+// must be called with locked mutex
+void SliceCache::insert(const Key& key, Chunk2D<float> slice)
+{
+    if(cachedSlice(key))
+        return;
+
+    _usedMemory += slice.allocatedElements() * sizeof(float);
+    _entries.push_front({ key, std::move(slice) });
+    shrinkToMaximumMemory();
+}
+
+// removes least recently used slices until the maximum memory is respected; must be called with
+// locked mutex
+void SliceCache::shrinkToMaximumMemory()
+{
+    while(_usedMemory > _maxMemory && _entries.size() > 1)
+    {
+        _usedMemory -= _entries.back().slice.allocatedElements() * sizeof(float);
+        _entries.pop_back();
+    }
+}
+
+// processes the prefetch requests (executed by the worker thread)
+void SliceCache::work()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(true)
+    {
+        _workAvailable.wait(lock, [this] { return _stop || !_pending.empty(); });
+        if(_stop)
+            return;
+
+        const auto key = _pending.front();
+        _pending.pop_front();
+        if(cachedSlice(key))
+            continue;
+
+        _busy = true;
+        _inProgress = key;
+        const auto provider = _provider;
+        lock.unlock();
+
+        Chunk2D<float> slice(0, 0);
+        bool success = true;
+        try
+        {
+            slice = provider(key);
+        } catch(...)
+        {
+            // failed prefetch; the error is reported if the slice gets requested
+            success = false;
+        }
+
+        lock.lock();
+        if(success)
+            insert(key, std::move(slice));
+        _busy = false;
+        _workDone.notify_all();
+    }
+}
+
+} // namespace gui
+} // namespace CTL
@@ -0,0 +1,100 @@
+#ifndef CTL_SLICECACHE_H
+#define CTL_SLICECACHE_H
+
+#include "img/chunk2d.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+
+namespace CTL {
+namespace gui {
+
+/*!
+ * \class SliceCache
+ *
+ * \brief The SliceCache class provides 2D slices of a dataset, prefetching neighbouring slices in
+ * the background.
+ *
+ * Slices are identified by a Key, consisting of the index of the (sub)volume, the slicing direction
+ * and the slice index. They are computed by a provider function (see setProvider()) and kept in a
+ * least recently used (LRU) cache with a limited amount of memory (see setMaximumMemory()).
+ *
+ * Each request of a slice through slice() triggers the prefetch of the neighbouring slices (within
+ * prefetchRadius() slices of the requested one). Prefetching is done by a worker thread in the
+ * order of increasing distance to the requested slice. Scrolling through the slices of a dataset
+ * thus typically results in cache hits. Pending prefetches are discarded with each new request.
+ *
+ * The provider is called from the worker thread, concurrently to the thread that uses the cache.
+ * Hence, it must not access any data that is modified in the meantime. Call clear() before
+ * modifying data that is accessed by the provider; clear() waits until a running computation has
+ * finished.
+ *
+ * This class is used by VolumeViewer and ProjectionViewer.
+ */
+class SliceCache
+{
+public:
+    struct Key
+    {
+        int volume;    //!< index of the (sub)volume
+        int direction; //!< slicing direction
+        int slice;     //!< slice index
+
+        bool operator==(const Key& other) const;
+    };
+
+    using Provider = std::function<Chunk2D<float>(const Key&)>;
+
+    SliceCache();
+    ~SliceCache();
+
+    SliceCache(const SliceCache&) = delete;
+    SliceCache& operator=(const SliceCache&) = delete;
+
+    Chunk2D<float> slice(const Key& key, int nbSlices);
+
+    void clear();
+    void setMaximumMemory(size_t bytes);
+    void setPrefetchRadius(int nbSlices);
+    void setProvider(Provider provider);
+
+    size_t maximumMemory() const;
+    int prefetchRadius() const;
+
+private:
+    struct Entry
+    {
+        Key key;
+        Chunk2D<float> slice;
+    };
+
+    Provider _provider;
+    size_t _maxMemory = size_t(512) * 1024 * 1024; // 512 MiB
+    int _prefetchRadius = 4;
+
+    std::list<Entry> _entries; // most recently used first
+    size_t _usedMemory = 0;
+    std::deque<Key> _pending; // slices to prefetch
+    bool _busy = false; // the worker is computing a slice
+    Key _inProgress = { 0, 0, 0 }; // the slice that is computed by the worker (if `_busy`)
+    bool _stop = false;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _workDone;
+    std::thread _worker;
+
+    const Chunk2D<float>* cachedSlice(const Key& key);
+    void insert(const Key& key, Chunk2D<float> slice);
+    void shrinkToMaximumMemory();
+    void work();
+};
+
+} // namespace gui
+} // namespace CTL
+
+#endif // CTL_SLICECACHE_H
@@ -1,4 +1,6 @@
 #include "chunk2dview.h"
+#include "img/reduction.h"
+#include "processing/threadpool.h"
 
 #ifdef GUI_WIDGETS_CHARTS_MODULE_AVAILABLE
 #include "gui/widgets/lineseriesview.h"
@@ -6,19 +8,291 @@
 #include <QMessageBox>
 #endif
 
-#include <cmath>
+#include <QCache>
 #include <QDebug>
 #include <QFileDialog>
 #include <QGraphicsLineItem>
-#include <QGraphicsPixmapItem>
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QGuiApplication>
 #include <QClipboard>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
 
 namespace CTL {
 namespace gui {
 
+namespace {
+
+// edge length (in pixels) of the tiles that are rendered (and cached) individually
+constexpr int TILE_SIZE = 256;
+// maximum memory for cached tiles [KiB]
+constexpr int TILE_CACHE_SIZE = 128 * 1024;
+
+// maps a row of `n` values to colors; the loop is vectorizable up to the color lookup
+void windowRow(const float* src, QRgb* dst, int n, float scale, float offset, const QRgb* colors)
+{
+    uchar idx[TILE_SIZE];
+    for(int begin = 0; begin < n; begin += TILE_SIZE)
+    {
+        const auto len = qMin(TILE_SIZE, n - begin);
+        for(int i = 0; i < len; ++i)
+        {
+            auto val = src[begin + i] * scale + offset;
+            val = val < 255.0f ? val : 255.0f; // clamp to interval [0, 255] (NaN -> 255)
+            val = val > 0.0f ? val : 0.0f;
+            idx[i] = static_cast<uchar>(val);
+        }
+        for(int i = 0; i < len; ++i)
+            dst[begin + i] = colors[idx[i]];
+    }
+}
+
+// 2x2 box filter (the last row/column is replicated for odd dimensions)
+Chunk2D<float> downsampled(const Chunk2D<float>& level)
+{
+    const auto inW = level.width();
+    const auto inH = level.height();
+    const auto outW = (inW + 1) / 2;
+    const auto outH = (inH + 1) / 2;
+
+    Chunk2D<float> ret(outW, outH);
+    ret.allocateMemory();
+
+    const auto in = level.rawData();
+    const auto outData = ret.rawData();
+    auto downsampleRows = [in, outData, inW, inH, outW](uint yBegin, uint yEnd) {
+        auto out = outData + size_t(yBegin) * outW;
+        for(auto y = yBegin; y < yEnd; ++y)
+        {
+            const auto row0 = in + size_t(2 * y) * inW;
+            const auto row1 = in + size_t(qMin(2 * y + 1, inH - 1)) * inW;
+            for(uint x = 0; x < outW; ++x)
+            {
+                const auto x0 = 2 * x;
+                const auto x1 = qMin(2 * x + 1, inW - 1);
+                *out++ = 0.25f * (row0[x0] + row0[x1] + row1[x0] + row1[x1]);
+            }
+        }
+    };
+
+    {
+        ThreadPool tp;
+        const auto nbThreads = uint(qMin(size_t(outH), tp.nbThreads()));
+        const auto rowsPerThread = outH / nbThreads;
+        for(uint t = 0; t < nbThreads; ++t)
+            tp.enqueueThread(downsampleRows, t * rowsPerThread,
+                             (t == nbThreads - 1) ? outH : (t + 1) * rowsPerThread);
+    } // wait for all threads
+
+    return ret;
+}
+
+// smallest and largest value in `data` (cached on `data`); (0, 0) for empty data
+QPair<double, double> valueRange(const Chunk2D<float>& data)
+{
+    if(data.allocatedElements() == 0)
+        return { 0.0, 0.0 };
+
+    const auto stats = reduction::cachedStatistics(data);
+    return { stats.min, stats.max };
+}
+
+} // unnamed namespace
+
+/*
+ * Graphics item that renders the data of a Chunk2DView. Only the tiles in the exposed region are
+ * rendered (see paint()); rendered tiles are cached until the appearance changes.
+ */
+class Chunk2DView::ImageItem : public QGraphicsItem
+{
+public:
+    explicit ImageItem(const Chunk2DView* view);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) override;
+
+    QImage render(const QRect& region, int level) const;
+    void resetAppearance();
+    void resetData();
+    void setZoom(double zoom);
+
+private:
+    const Chunk2DView* _view;
+    double _zoom = 1.0;
+
+    std::vector<Chunk2D<float>> _mipmaps; // level `i` is stored at index `i-1`
+    QCache<quint64, QImage> _tiles;
+    QVector<QRgb> _colors; // premultiplied color table
+
+    const Chunk2D<float>& levelData(int level);
+    int levelForZoom() const;
+};
+
+Chunk2DView::ImageItem::ImageItem(const Chunk2DView* view)
+    : _view(view)
+    , _tiles(TILE_CACHE_SIZE)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+QRectF Chunk2DView::ImageItem::boundingRect() const
+{
+    return { 0.0, 0.0, _view->_data.width() * _zoom, _view->_data.height() * _zoom };
+}
+
+void Chunk2DView::ImageItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
+                                   QWidget*)
+{
+    if(_view->_data.allocatedElements() == 0)
+        return;
+
+    const auto level = levelForZoom();
+    const auto& data = levelData(level);
+    const auto levelScale = _zoom * double(1 << level); // screen pixels per pixel of the level
+
+    // tiles in the exposed region
+    const auto exposed = option->exposedRect.intersected(boundingRect());
+    const auto maxTileX = (int(data.width()) - 1) / TILE_SIZE;
+    const auto maxTileY = (int(data.height()) - 1) / TILE_SIZE;
+    const auto tileX0 = qBound(0, int(exposed.left() / levelScale) / TILE_SIZE, maxTileX);
+    const auto tileX1 = qBound(0, int(exposed.right() / levelScale) / TILE_SIZE, maxTileX);
+    const auto tileY0 = qBound(0, int(exposed.top() / levelScale) / TILE_SIZE, maxTileY);
+    const auto tileY1 = qBound(0, int(exposed.bottom() / levelScale) / TILE_SIZE, maxTileY);
+
+    auto tileKey = [level](int tx, int ty) {
+        return (quint64(level) << 48) | (quint64(ty) << 24) | quint64(tx);
+    };
+    auto tileRegion = [&data](int tx, int ty) {
+        return QRect(tx * TILE_SIZE, ty * TILE_SIZE, TILE_SIZE, TILE_SIZE)
+            .intersected(QRect(0, 0, int(data.width()), int(data.height())));
+    };
+
+    // render missing tiles (in parallel)
+    QVector<QPoint> missing;
+    for(auto ty = tileY0; ty <= tileY1; ++ty)
+        for(auto tx = tileX0; tx <= tileX1; ++tx)
+            if(!_tiles.contains(tileKey(tx, ty)))
+                missing.append({ tx, ty });
+
+    QVector<QImage> rendered(missing.size());
+    auto renderTiles = [this, &missing, &rendered, &tileRegion, level](int first, int stride) {
+        for(auto t = first; t < missing.size(); t += stride)
+            rendered[t] = render(tileRegion(missing[t].x(), missing[t].y()), level);
+    };
+    if(!missing.isEmpty())
+    {
+        ThreadPool tp;
+        const auto nbThreads = qMin(missing.size(), int(tp.nbThreads()));
+        for(auto t = 0; t < nbThreads; ++t)
+            tp.enqueueThread(renderTiles, t, nbThreads);
+    }
+    for(auto t = 0; t < missing.size(); ++t)
+    {
+        const auto cost = qMax(1, rendered[t].width() * rendered[t].height() * 4 / 1024);
+        _tiles.insert(tileKey(missing[t].x(), missing[t].y()), new QImage(rendered[t]), cost);
+    }
+
+    // draw tiles
+    painter->save();
+    painter->setClipRect(boundingRect());
+    for(auto ty = tileY0; ty <= tileY1; ++ty)
+        for(auto tx = tileX0; tx <= tileX1; ++tx)
+        {
+            const auto region = tileRegion(tx, ty);
+            const QRectF target(region.x() * levelScale, region.y() * levelScale,
+                                region.width() * levelScale, region.height() * levelScale);
+            if(const auto tile = _tiles.object(tileKey(tx, ty)))
+                painter->drawImage(target, *tile);
+            else // cache too small for the exposed region
+                painter->drawImage(target, render(region, level));
+        }
+    painter->restore();
+}
+
+/*
+ * Renders the pixels in `region` of mipmap level `level` using the current windowing and color
+ * table of the view. Level 0 refers to the data itself. The level must have been created before
+ * (see levelData()).
+ */
+QImage Chunk2DView::ImageItem::render(const QRect& region, int level) const
+{
+    const auto& data = level ? _mipmaps[level - 1] : _view->_data;
+
+    QImage ret(region.size(), QImage::Format_ARGB32_Premultiplied);
+
+    const auto minGrayValue = static_cast<float>(_view->_window.first);
+    const auto maxGrayValue = static_cast<float>(_view->_window.second);
+    const auto grayScale = 255.0f / float(maxGrayValue - minGrayValue);
+    const auto offset = - minGrayValue * grayScale + 0.5f; // 0.5 for rounding
+
+    for(int y = 0; y < region.height(); ++y)
+    {
+        const auto dataRow = data.rawData() + size_t(region.y() + y) * data.width() + region.x();
+        windowRow(dataRow, reinterpret_cast<QRgb*>(ret.scanLine(y)), region.width(), grayScale,
+                  offset, _colors.constData());
+    }
+
+    return ret;
+}
+
+/*
+ * Discards all rendered tiles, e.g. due to a change of the windowing or the color table.
+ */
+void Chunk2DView::ImageItem::resetAppearance()
+{
+    _tiles.clear();
+
+    _colors = _view->_colorTable;
+    _colors.resize(256);
+    for(auto& color : _colors)
+        color = qPremultiply(color);
+
+    update();
+}
+
+/*
+ * Discards all rendered tiles and mipmaps due to a change of the data.
+ */
+void Chunk2DView::ImageItem::resetData()
+{
+    prepareGeometryChange();
+    _mipmaps.clear();
+    resetAppearance();
+}
+
+void Chunk2DView::ImageItem::setZoom(double zoom)
+{
+    prepareGeometryChange();
+    _zoom = zoom;
+}
+
+// returns the data of mipmap level `level` (created on demand)
+const Chunk2D<float>& Chunk2DView::ImageItem::levelData(int level)
+{
+    while(int(_mipmaps.size()) < level)
+        _mipmaps.push_back(downsampled(_mipmaps.empty() ? _view->_data : _mipmaps.back()));
+
+    return level ? _mipmaps[level - 1] : _view->_data;
+}
+
+// the coarsest mipmap level whose pixels are not smaller than half a screen pixel
+int Chunk2DView::ImageItem::levelForZoom() const
+{
+    auto level = 0;
+    auto levelWidth = _view->_data.width();
+    auto levelHeight = _view->_data.height();
+    while(_zoom * double(2 << level) <= 1.0 && levelWidth > 1 && levelHeight > 1)
+    {
+        ++level;
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+
+    return level;
+}
+
+
 /*!
  * Creates a Chunk2DView and sets its parent widget to \a parent. Note that you need to call show()
  * to display the window.
@@ -27,10 +301,11 @@ namespace gui {
  */
 Chunk2DView::Chunk2DView(QWidget* parent)
     : QGraphicsView(parent)
-    , _imageItem(new QGraphicsPixmapItem)
+    , _imageItem(new ImageItem(this))
     , _contrastLineItem(new QGraphicsLineItem)
 {
     setGrayscaleColorTable();
+    updateImage();
 
     setScene(&_scene);
     _scene.addItem(_imageItem);
@@ -132,7 +407,9 @@ void Chunk2DView::setColorTable(const QVector<QRgb>& colorTable)
  */
 void Chunk2DView::setData(Chunk2D<float> data)
 {
+    _imageItem->resetData();
     _data = std::move(data);
+    updateSceneRect();
 
     if(_window == qMakePair(0.0, 0.0)) // still default values -> window min/max
         setWindowingMinMax(); // this includes updateImage()
@@ -243,7 +520,16 @@ const Chunk2D<float>& Chunk2DView::data() const { return _data; }
 /*!
  * Returns the currently shown pixmap.
  */
-QPixmap Chunk2DView::pixmap() const { return _imageItem->pixmap(); }
+QPixmap Chunk2DView::pixmap() const
+{
+    if(_data.allocatedElements() == 0)
+        return {};
+
+    const auto imgHeight = int(_data.height());
+    const auto image = _imageItem->render(QRect(0, 0, int(_data.width()), imgHeight), 0);
+
+    return QPixmap::fromImage(image).scaledToHeight(qRound(imgHeight * _zoom));
+}
 
 /*!
  * Returns the current data windowing as a pair specifying the window start and end point.
@@ -316,8 +602,9 @@ void Chunk2DView::setWindowing(double from, double to)
  */
 void Chunk2DView::setWindowingMinMax()
 {
-    const auto dataMin = static_cast<double>(_data.min());
-    const auto dataMax = static_cast<double>(_data.max());
+    const auto range = valueRange(_data);
+    const auto dataMin = range.first;
+    const auto dataMax = range.second;
 
     setWindowing(dataMin, dataMax);
 }
@@ -352,7 +639,7 @@ void Chunk2DView::setZoom(double zoom)
     }
 
     _zoom = zoom;
-    updateImage();
+    updateSceneRect();
 
     emit zoomChanged(zoom);
 }
@@ -372,8 +659,9 @@ void Chunk2DView::setAutoMouseWindowScaling()
 {
     static const auto percentageOfFull = 0.01;
 
-    const auto dataMin = static_cast<double>(_data.min());
-    const auto dataMax = static_cast<double>(_data.max());
+    const auto range = valueRange(_data);
+    const auto dataMin = range.first;
+    const auto dataMax = range.second;
 
     const auto dataWidth = dataMax - dataMin;
 
@@ -596,33 +884,13 @@ void Chunk2DView::setGrayscaleColorTable()
 
 void Chunk2DView::updateImage()
 {
-    const auto imgWidth  = int(_data.width());
-    const auto imgHeight = int(_data.height());
-
-    QImage image(imgWidth, imgHeight, QImage::Format_Indexed8);
-    image.setColorTable(_colorTable);
-
-    const auto minGrayValue = static_cast<float>(_window.first);
-    const auto maxGrayValue = static_cast<float>(_window.second);
-    const auto grayScale = 255.0f / float(maxGrayValue - minGrayValue);
-    const auto offset = - minGrayValue * grayScale + 0.5f; // 0.5 for rounding
-
-    auto dataIt = _data.data().cbegin();
-    for(int y = 0; y < imgHeight; ++y)
-    {
-        auto linePtr = image.scanLine(y);
-        for(int x = 0; x < imgWidth; ++x)
-        {
-            *linePtr = static_cast<uchar>(qMax(qMin( // clamp to interval [0, 255]
-                std::fma(*dataIt, grayScale, offset), 255.f), 0.f)); // projVal * grayScale + offset
-            ++linePtr;
-            ++dataIt;
-        }
-    }
+    _imageItem->resetAppearance();
+}
 
-    auto pixmap = QPixmap::fromImage(image).scaledToHeight(qRound(imgHeight * _zoom));
-    _imageItem->setPixmap(pixmap);
-    _scene.setSceneRect(QRectF({0, 0}, pixmap.size()));
+void Chunk2DView::updateSceneRect()
+{
+    _imageItem->setZoom(_zoom);
+    _scene.setSceneRect(_imageItem->boundingRect());
 }
 
 } // namespace gui
@@ -24,6 +24,12 @@ namespace gui {
  * Data will be visualized in 256 discrete value steps - according to the current window - using the
  * colormap specified by setColorTable(). By default, a grayscale colormap is used.
  *
+ * To keep windowing and zooming interactive also for large images, only the visible part of the
+ * image is rendered. Rendering is done in tiles (using multiple threads) that are cached until the
+ * windowing or colormap changes. For zoom factors below 0.5, the image is rendered from a
+ * pyramid of downsampled versions of the data (mipmaps), such that the effort depends on the size
+ * of the viewport rather than on the size of the data.
+ *
  * The following IO operations are supported by this class:
  * - Zooming:
  *    - Hold CTRL + scroll mouse wheel up/down to zoom in/out.
@@ -144,8 +150,10 @@ signals:
     void zoomChanged(double zoom);
 
 private:
+    class ImageItem;
+
     QGraphicsScene _scene;
-    QGraphicsPixmapItem* _imageItem;
+    ImageItem* _imageItem;
     QGraphicsLineItem* _contrastLineItem;
 
     Chunk2D<float> _data = Chunk2D<float>(0,0);
@@ -167,6 +175,7 @@ private:
     QPoint pixelIdxFromPos(const QPoint& pos);
     void setGrayscaleColorTable();
     void updateImage();
+    void updateSceneRect();
 
     template<typename T>
     static Chunk2D<float> convertedToFloat(const Chunk2D<T>& in);
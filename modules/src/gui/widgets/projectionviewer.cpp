@@ -34,6 +34,8 @@ ProjectionViewer::ProjectionViewer(QWidget *parent) :
     ui->_W_dataView->setLivePixelDataEnabled(true);
     ui->_W_dataView->setContrastLinePlotLabels("Position on line", "Extinction");
 
+    _viewCache.setProvider([this](const SliceCache::Key& key) { return combinedView(key); });
+
     setWindowPresets(qMakePair(QStringLiteral("Narrow"), qMakePair(0.0,  2.0)),
                      qMakePair(QStringLiteral("Wide"),   qMakePair(0.0, 10.0)));
 
@@ -105,6 +107,7 @@ Chunk2DView* ProjectionViewer::dataView() const { return ui->_W_dataView; }
  */
 void ProjectionViewer::setData(ProjectionData projections)
 {
+    _viewCache.clear(); // wait for running prefetches (they access `_data`)
     _data = std::move(projections);
 
     updateSliderRange();
@@ -122,6 +125,7 @@ void ProjectionViewer::setData(ProjectionData projections)
  */
 void ProjectionViewer::setModuleLayout(const ModuleLayout& layout)
 {
+    _viewCache.clear();
     _modLayout = layout;
 
     if(_data.nbViews() > 0)
@@ -194,7 +198,7 @@ void ProjectionViewer::setAutoMouseWindowScaling()
 void ProjectionViewer::showView(int view)
 {
     ui->_L_view->setText(QString::number(view));
-    ui->_W_dataView->setData(_data.view(view).combined(_modLayout));
+    ui->_W_dataView->setData(_viewCache.slice({ 0, 0, view }, static_cast<int>(_data.nbViews())));
 }
 
 void ProjectionViewer::keyPressEvent(QKeyEvent* event)
@@ -212,6 +216,12 @@ void ProjectionViewer::keyPressEvent(QKeyEvent* event)
     QWidget::keyPressEvent(event);
 }
 
+// combines the modules of a view in `_data` (called by `_viewCache`, possibly from its worker thread)
+Chunk2D<float> ProjectionViewer::combinedView(const SliceCache::Key& key) const
+{
+    return _data.view(static_cast<uint>(key.slice)).combined(_modLayout);
+}
+
 void ProjectionViewer::changeView(int requestedChange)
 {
     const auto curViewIdx = ui->_VS_projection->value();
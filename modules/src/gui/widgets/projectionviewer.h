@@ -3,6 +3,7 @@
 
 #include <QWidget>
 
+#include "gui/util/slicecache.h"
 #include "img/projectiondata.h"
 
 namespace Ui {
@@ -64,6 +65,10 @@ class Chunk2DView;
  *
  * ![Contrast line plot of the image shown on the top of this section.](gui/CtrLine.png)
  *
+ * Neighbouring views of the currently shown one are combined in a background thread and kept in a
+ * cache (see SliceCache), such that scrolling through the views does not need to wait for the
+ * combination of the detector modules.
+ *
  * Visualization of the projection image itself is done using the Chunk2DView class. The viewport
  * can be accessed with dataView(), in order to adjust its settings. For mouse gesture windowing,
  * a convenience method setAutoMouseWindowScaling() exists to directly set a sensitivity suited
@@ -145,6 +150,9 @@ private:
 
     ProjectionData _data = ProjectionData(0,0,0);
     ModuleLayout _modLayout;
+    SliceCache _viewCache;
+
+    Chunk2D<float> combinedView(const SliceCache::Key& key) const;
 
 private slots:
     void changeView(int requestedChange);
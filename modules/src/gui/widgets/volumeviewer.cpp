@@ -8,6 +8,8 @@
 namespace CTL {
 namespace gui {
 
+enum SliceDirection { DirectionX, DirectionY, DirectionZ };
+
 static const QVector<QPair<QString, QPair<double, double>>> WINDOW_PRESETS {
     qMakePair(QStringLiteral("Abdomen"), qMakePair( -140.0,  260.0)),
     qMakePair(QStringLiteral("Angio"),   qMakePair(    0.0,  600.0)),
@@ -54,6 +56,8 @@ VolumeViewer::VolumeViewer(QWidget* parent)
     ui->_W_dataView->setContrastLinePlotLabels("Position on line", "Attenuation");
     ui->_W_dataView->setLivePixelDataEnabled(true);
 
+    _sliceCache.setProvider([this](const SliceCache::Key& key) { return computeSlice(key); });
+
     resize(900, 600);
     setWindowTitle("Volume Viewer");
 }
@@ -145,6 +149,7 @@ void VolumeViewer::setData(SpectralVolumeData data)
  */
 void VolumeViewer::setData(CompositeVolume data)
 {
+    _sliceCache.clear(); // wait for running prefetches (they access `_compData`)
     _compData = std::move(data);
 
     bool needsAutoWindow = (ui->_W_windowing->windowFromTo() == qMakePair(0.0, 0.0));
@@ -293,12 +298,30 @@ void VolumeViewer::setAutoMouseWindowScaling()
 void VolumeViewer::showSlice(int slice)
 {
     ui->_L_slice->setNum(slice);
+
+    const auto& nbVoxels = selectedVolume().nbVoxels();
+    SliceDirection direction;
+    uint nbSlices;
     if(ui->_RB_directionX->isChecked())
-        ui->_W_dataView->setData(selectedVolume().sliceX(static_cast<uint>(slice)));
+    {
+        direction = DirectionX;
+        nbSlices = nbVoxels.x;
+    }
     else if(ui->_RB_directionY->isChecked())
-        ui->_W_dataView->setData(selectedVolume().sliceY(static_cast<uint>(slice)));
+    {
+        direction = DirectionY;
+        nbSlices = nbVoxels.y;
+    }
     else if(ui->_RB_directionZ->isChecked())
-        ui->_W_dataView->setData(selectedVolume().sliceZ(static_cast<uint>(slice)));
+    {
+        direction = DirectionZ;
+        nbSlices = nbVoxels.z;
+    }
+    else
+        return;
+
+    const SliceCache::Key key{ selectedVolumeIndex(), direction, slice };
+    ui->_W_dataView->setData(_sliceCache.slice(key, static_cast<int>(nbSlices)));
 }
 
 /*!
@@ -324,9 +347,31 @@ void VolumeViewer::keyPressEvent(QKeyEvent* event)
     QWidget::keyPressEvent(event);
 }
 
+// extracts a slice from `_compData` (called by `_sliceCache`, possibly from its worker thread)
+Chunk2D<float> VolumeViewer::computeSlice(const SliceCache::Key& key) const
+{
+    const auto& volume = _compData.subVolume(static_cast<uint>(key.volume));
+    const auto slice = static_cast<uint>(key.slice);
+
+    switch(key.direction)
+    {
+    case DirectionX:
+        return volume.sliceX(slice);
+    case DirectionY:
+        return volume.sliceY(slice);
+    default:
+        return volume.sliceZ(slice);
+    }
+}
+
 const SpectralVolumeData& VolumeViewer::selectedVolume() const
 {
-    return _compData.subVolume(ui->_TW_volumeOverview->selectedItems().first()->row());
+    return _compData.subVolume(selectedVolumeIndex());
+}
+
+int VolumeViewer::selectedVolumeIndex() const
+{
+    return ui->_TW_volumeOverview->selectedItems().first()->row();
 }
 
 void VolumeViewer::changeSlice(int requestedChange)
@@ -2,6 +2,7 @@
 #define CTL_VOLUMEVIEWER_H
 
 #include <QWidget>
+#include "gui/util/slicecache.h"
 #include "img/compositevolume.h"
 
 namespace Ui {
@@ -67,6 +68,10 @@ class Chunk2DView;
  * Contrast line plots are opened in separate windows (see LineSeriesView for details on the
  * corresponding widget).
  *
+ * Slices are extracted from the volume in a background thread: neighbouring slices of the currently
+ * shown one are prefetched into a cache (see SliceCache), such that scrolling through the volume
+ * does not need to wait for the extraction of the slices.
+ *
  * Visualization of the slice image itself is done using the Chunk2DView class. The viewport can be
  * accessed with dataView(), in order to adjust its settings. For mouse gesture windowing, a
  * convenience method setAutoMouseWindowScaling() exists to directly set a sensitivity suited
@@ -157,8 +162,11 @@ private:
     Ui::VolumeViewer *ui;
 
     CompositeVolume _compData;
+    SliceCache _sliceCache;
 
+    Chunk2D<float> computeSlice(const SliceCache::Key& key) const;
     const SpectralVolumeData& selectedVolume() const;
+    int selectedVolumeIndex() const;
 
     template <typename T>
     static VoxelVolume<float> convertedToFloat(const VoxelVolume<T>& in);
@@ -0,0 +1,114 @@
+#ifndef CTL_BUFFERPOOL_H
+#define CTL_BUFFERPOOL_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace CTL {
+
+/*!
+ * \class BufferPool
+ *
+ * \brief The BufferPool class recycles the data buffers of Chunk2D and VoxelVolume objects.
+ *
+ * Repeated computations with data of the same size (e.g. repeated projections in an iterative
+ * reconstruction) typically allocate and free large buffers over and over again. When the pool is
+ * enabled, Chunk2D and VoxelVolume (and hence ProjectionData and SpectralVolumeData) hand their
+ * data buffers over to the pool when they are destroyed (or their memory is freed) and draw new
+ * buffers from the pool when they allocate memory. After a warm-up phase, no data buffers need to
+ * be allocated from the heap anymore.
+ *
+ * Buffers are organized in size classes (eight classes per power of two), such that a buffer can
+ * be reused for requests of slightly different size. Note that this means that a buffer drawn from
+ * the pool may have a capacity that is up to 12.5% larger than requested.
+ *
+ * There is one pool per element type `T`, accessible through instance(). The pool is disabled by
+ * default. The total size of the pooled (i.e. currently unused) buffers is limited by
+ * setCapacity(); buffers that would exceed this limit are freed. Buffers smaller than
+ * minimumBufferSize() are never pooled.
+ *
+ * On Linux, buffers that are newly allocated by the pool can be advised to be backed by
+ * (transparent) huge pages, see setHugePagesEnabled(). This reduces the number of page faults and
+ * TLB misses for large buffers.
+ *
+ * Example:
+ * \code
+ * BufferPool<float>::instance().setEnabled(true);
+ *
+ * for(uint it = 0; it < nbIterations; ++it)
+ *     projections = projector->project(volume); // buffers of previous result are reused
+ *
+ * qInfo() << BufferPool<float>::instance().statistics().nbHits;
+ * \endcode
+ */
+template <typename T>
+class BufferPool
+{
+public:
+    struct Statistics
+    {
+        size_t nbRequests;      //!< number of buffers requested from the (enabled) pool
+        size_t nbHits;          //!< number of requests served by a pooled buffer
+        size_t nbMisses;        //!< number of requests that required a heap allocation
+        size_t nbRecycled;      //!< number of buffers returned to the pool
+        size_t nbDiscarded;     //!< number of returned buffers that have been freed (pool full)
+        size_t pooledBytes;     //!< total size [bytes] of the currently pooled buffers
+        size_t peakPooledBytes; //!< maximum of pooledBytes
+    };
+
+    static BufferPool& instance();
+
+    // non-copyable
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // settings
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+    size_t capacity() const;
+    void setCapacity(size_t bytes);
+    size_t minimumBufferSize() const;
+    void setMinimumBufferSize(size_t bytes);
+    bool isHugePagesEnabled() const;
+    void setHugePagesEnabled(bool enabled);
+
+    // buffer handling
+    std::vector<T> acquire(size_t nbElements);
+    std::vector<T> filled(size_t nbElements, const T& value);
+    std::vector<T> copyOf(const std::vector<T>& source);
+    void assign(std::vector<T>& target, const std::vector<T>& source);
+    void recycle(std::vector<T>& buffer) noexcept;
+
+    void clear();
+    Statistics statistics() const;
+    void resetStatistics();
+
+    static size_t sizeClass(size_t nbElements);
+
+private:
+    BufferPool() = default;
+
+    bool isPoolable(size_t nbElements) const;
+    void adviseHugePages(std::vector<T>& buffer) const;
+    static size_t floorSizeClass(size_t nbElements);
+
+    std::atomic<bool> _enabled{ false };
+    std::atomic<bool> _hugePages{ false };
+    std::atomic<size_t> _capacity{ size_t(1) << 30 };
+    std::atomic<size_t> _minimumBufferSize{ 16 * 1024 };
+
+    mutable std::mutex _mutex; //!< guards the buckets and the statistics
+    std::map<size_t, std::vector<std::vector<T>>> _buckets; //!< pooled buffers per size class
+    Statistics _stats = {};
+};
+
+} // namespace CTL
+
+#include "bufferpool.tpp"
+
+/*! \file */
+
+#endif // CTL_BUFFERPOOL_H
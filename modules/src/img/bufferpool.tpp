@@ -0,0 +1,319 @@
+#include "bufferpool.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>
+#endif
+
+namespace CTL {
+
+/*!
+ * Returns the global pool for buffers of element type `T`.
+ *
+ * The pool is never destroyed, such that static Chunk2D or VoxelVolume objects can safely return
+ * their buffers during program termination.
+ */
+template <typename T>
+BufferPool<T>& BufferPool<T>::instance()
+{
+    static auto theInstance = new BufferPool<T>;
+    return *theInstance;
+}
+
+/*!
+ * Returns `true` if the pool is enabled.
+ */
+template <typename T>
+bool BufferPool<T>::isEnabled() const
+{
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+/*!
+ * Enables (or disables) the pool. While disabled, buffers are allocated and freed as usual;
+ * buffers that are pooled already remain available when the pool is enabled again (use clear()
+ * to free them).
+ */
+template <typename T>
+void BufferPool<T>::setEnabled(bool enabled)
+{
+    _enabled.store(enabled);
+}
+
+/*!
+ * Returns the maximum total size [bytes] of pooled buffers.
+ */
+template <typename T>
+size_t BufferPool<T>::capacity() const
+{
+    return _capacity.load();
+}
+
+/*!
+ * Sets the maximum total size of pooled buffers to \a bytes (default: 1 GiB). This does not free
+ * buffers that are pooled already.
+ */
+template <typename T>
+void BufferPool<T>::setCapacity(size_t bytes)
+{
+    _capacity.store(bytes);
+}
+
+/*!
+ * Returns the minimum size [bytes] of a buffer to be handled by the pool.
+ */
+template <typename T>
+size_t BufferPool<T>::minimumBufferSize() const
+{
+    return _minimumBufferSize.load(std::memory_order_relaxed);
+}
+
+/*!
+ * Sets the minimum size of a buffer to be handled by the pool to \a bytes (default: 16 KiB).
+ * Smaller buffers are allocated and freed as usual.
+ */
+template <typename T>
+void BufferPool<T>::setMinimumBufferSize(size_t bytes)
+{
+    _minimumBufferSize.store(bytes);
+}
+
+/*!
+ * Returns `true` if newly allocated buffers are advised to be backed by huge pages.
+ */
+template <typename T>
+bool BufferPool<T>::isHugePagesEnabled() const
+{
+    return _hugePages.load(std::memory_order_relaxed);
+}
+
+/*!
+ * Enables (or disables) advising newly allocated buffers (of at least 4 MiB) to be backed by
+ * transparent huge pages. This is only supported on Linux (`madvise(MADV_HUGEPAGE)`) and has no
+ * effect on other platforms or if transparent huge pages are disabled by the system.
+ */
+template <typename T>
+void BufferPool<T>::setHugePagesEnabled(bool enabled)
+{
+    _hugePages.store(enabled);
+}
+
+/*!
+ * Returns a buffer of \a nbElements elements. The content of the buffer is unspecified.
+ *
+ * If the pool is enabled, a pooled buffer of the size class of \a nbElements (see sizeClass()) is
+ * returned if available. Otherwise, a new buffer with a capacity of the size class is allocated.
+ */
+template <typename T>
+std::vector<T> BufferPool<T>::acquire(size_t nbElements)
+{
+    if(!isPoolable(nbElements))
+        return std::vector<T>(nbElements);
+
+    const auto sizeCls = sizeClass(nbElements);
+
+    std::vector<T> ret;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.nbRequests;
+
+        auto bucket = _buckets.find(sizeCls);
+        if(bucket != _buckets.end() && !bucket->second.empty())
+        {
+            ret.swap(bucket->second.back());
+            bucket->second.pop_back();
+            ++_stats.nbHits;
+            _stats.pooledBytes -= ret.capacity() * sizeof(T);
+        }
+        else
+            ++_stats.nbMisses;
+    }
+
+    if(ret.capacity() == 0) // pool miss
+    {
+        ret.reserve(sizeCls);
+        adviseHugePages(ret);
+    }
+    ret.resize(nbElements);
+    return ret;
+}
+
+/*!
+ * Returns a buffer of \a nbElements elements that are all set to \a value.
+ */
+template <typename T>
+std::vector<T> BufferPool<T>::filled(size_t nbElements, const T& value)
+{
+    if(!isPoolable(nbElements))
+        return std::vector<T>(nbElements, value);
+
+    auto ret = acquire(nbElements);
+    std::fill(ret.begin(), ret.end(), value);
+    return ret;
+}
+
+/*!
+ * Returns a buffer with a copy of the content of \a source.
+ */
+template <typename T>
+std::vector<T> BufferPool<T>::copyOf(const std::vector<T>& source)
+{
+    if(!isPoolable(source.size()))
+        return source;
+
+    auto ret = acquire(source.size());
+    std::copy(source.cbegin(), source.cend(), ret.begin());
+    return ret;
+}
+
+/*!
+ * Copies the content of \a source to \a target. If the capacity of \a target is insufficient, its
+ * buffer is replaced by a buffer from the pool (and the former buffer is recycled).
+ */
+template <typename T>
+void BufferPool<T>::assign(std::vector<T>& target, const std::vector<T>& source)
+{
+    if(&target == &source)
+        return;
+
+    if(target.capacity() >= source.size() || !isPoolable(source.size()))
+    {
+        target = source;
+        return;
+    }
+
+    recycle(target);
+    target = copyOf(source);
+}
+
+/*!
+ * Returns the memory of \a buffer to the pool. Afterwards, \a buffer is empty (and has no
+ * capacity).
+ *
+ * The buffer is freed if the pool is disabled, the buffer is smaller than minimumBufferSize() or
+ * the pool would exceed its capacity().
+ */
+template <typename T>
+void BufferPool<T>::recycle(std::vector<T>& buffer) noexcept
+{
+    std::vector<T> buf;
+    buf.swap(buffer);
+
+    if(!isPoolable(buf.capacity()))
+        return; // `buf` is freed
+
+    const auto bytes = buf.capacity() * sizeof(T);
+    try
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.nbRecycled;
+        if(_stats.pooledBytes + bytes > capacity())
+        {
+            ++_stats.nbDiscarded;
+            return;
+        }
+
+        _buckets[floorSizeClass(buf.capacity())].push_back(std::move(buf));
+        _stats.pooledBytes += bytes;
+        _stats.peakPooledBytes = std::max(_stats.peakPooledBytes, _stats.pooledBytes);
+    } catch(...)
+    {
+        // bookkeeping failed (out of memory): `buf` is freed
+    }
+}
+
+/*!
+ * Frees all pooled buffers.
+ */
+template <typename T>
+void BufferPool<T>::clear()
+{
+    std::map<size_t, std::vector<std::vector<T>>> buckets;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        buckets.swap(_buckets);
+        _stats.pooledBytes = 0;
+    }
+}
+
+/*!
+ * Returns the statistics of the pool (since the last call of resetStatistics()).
+ */
+template <typename T>
+typename BufferPool<T>::Statistics BufferPool<T>::statistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+/*!
+ * Resets all counters of the statistics. The number of pooled bytes remains unchanged.
+ */
+template <typename T>
+void BufferPool<T>::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto pooledBytes = _stats.pooledBytes;
+    _stats = {};
+    _stats.pooledBytes = _stats.peakPooledBytes = pooledBytes;
+}
+
+/*!
+ * Returns the size class of a buffer of \a nbElements elements, i.e. the number of elements that
+ * is rounded up to the next number of the form \f$m\cdot2^k\f$ with \f$8\leq m<16\f$.
+ */
+template <typename T>
+size_t BufferPool<T>::sizeClass(size_t nbElements)
+{
+    auto shift = 0u;
+    while((nbElements >> shift) >= 16)
+        ++shift;
+
+    // round up to a multiple of 2^shift
+    const auto step = size_t(1) << shift;
+    return (nbElements + step - 1) & ~(step - 1);
+}
+
+/*!
+ * Returns the largest size class that does not exceed \a nbElements.
+ */
+template <typename T>
+size_t BufferPool<T>::floorSizeClass(size_t nbElements)
+{
+    auto shift = 0u;
+    while((nbElements >> shift) >= 16)
+        ++shift;
+
+    return (nbElements >> shift) << shift;
+}
+
+template <typename T>
+bool BufferPool<T>::isPoolable(size_t nbElements) const
+{
+    return isEnabled() && nbElements && nbElements * sizeof(T) >= minimumBufferSize();
+}
+
+template <typename T>
+void BufferPool<T>::adviseHugePages(std::vector<T>& buffer) const
+{
+#if defined(Q_OS_LINUX) && defined(MADV_HUGEPAGE)
+    const uintptr_t hugePageSize = 2 * 1024 * 1024;
+
+    const auto bytes = buffer.capacity() * sizeof(T);
+    if(!isHugePagesEnabled() || bytes < 2 * hugePageSize)
+        return;
+
+    // advise the huge page aligned part of the buffer
+    const auto begin = reinterpret_cast<uintptr_t>(buffer.data());
+    const auto alignedBegin = (begin + hugePageSize - 1) & ~(hugePageSize - 1);
+    const auto alignedEnd = (begin + bytes) & ~(hugePageSize - 1);
+    if(alignedEnd > alignedBegin)
+        madvise(reinterpret_cast<void*>(alignedBegin), alignedEnd - alignedBegin, MADV_HUGEPAGE);
+#else
+    Q_UNUSED(buffer)
+#endif
+}
+
+} // namespace CTL
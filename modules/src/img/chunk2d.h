@@ -1,6 +1,8 @@
 #ifndef CTL_CHUNK2D_H
 #define CTL_CHUNK2D_H
 
+#include "bufferpool.h"
+#include "datastatistics.h"
 #include <QtGlobal>
 #include <algorithm>
 #include <stdexcept>
@@ -24,6 +26,9 @@ namespace CTL {
  *
  * By default (i.e. for most of the constructor types), memory is not allocated on creation of a
  * Chunk2D object. However, memory allocation can be enforced using allocateMemory().
+ *
+ * If the BufferPool of type `T` is enabled, memory for the data is drawn from the pool and
+ * returned to it when the chunk is destroyed.
  */
 template <typename T>
 class Chunk2D
@@ -51,6 +56,12 @@ public:
     Chunk2D(uint width, uint height, std::vector<T>&& data);
     Chunk2D(uint width, uint height, const std::vector<T>& data);
 
+    Chunk2D(const Chunk2D& other);
+    Chunk2D(Chunk2D&& other) noexcept = default;
+    Chunk2D& operator=(const Chunk2D& other);
+    Chunk2D& operator=(Chunk2D&& other) noexcept;
+    ~Chunk2D();
+
     // getter methods
     size_t allocatedElements() const;
     const std::vector<T>& constData() const;
@@ -92,12 +103,16 @@ public:
     void fill(const T& fillValue);
     void freeMemory();
 
+    const details::DataStatisticsCache& statisticsCache() const;
+
 protected:
     std::vector<T> _data; //!< The internal data of the chunk.
     Dimensions _dim; //!< The dimensions (width x height) of the chunk.
 
 private:
     bool hasEqualSizeAs(const std::vector<T>& other) const;
+
+    details::DataStatisticsCache _statsCache; //!< see reduction::cachedStatistics()
 };
 
 /*!
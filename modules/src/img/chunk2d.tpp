@@ -20,7 +20,7 @@ Chunk2D<T>::Chunk2D(const Dimensions& dimensions)
  */
 template <typename T>
 Chunk2D<T>::Chunk2D(const Dimensions& dimensions, const T& initValue)
-    : _data(size_t(dimensions.height) * size_t(dimensions.width), initValue)
+    : _data(BufferPool<T>::instance().filled(dimensions.totalNbElements(), initValue))
     , _dim(dimensions)
 {
 }
@@ -73,7 +73,7 @@ Chunk2D<T>::Chunk2D(uint width, uint height)
  */
 template <typename T>
 Chunk2D<T>::Chunk2D(uint width, uint height, const T& initValue)
-    : _data(size_t(height) * size_t(width), initValue)
+    : _data(BufferPool<T>::instance().filled(size_t(height) * size_t(width), initValue))
     , _dim({ width, height })
 {
 }
@@ -108,6 +108,55 @@ Chunk2D<T>::Chunk2D(uint width, uint height, const std::vector<T>& data)
     setData(data);
 }
 
+/*!
+ * Constructs a copy of \a other. The memory for the data is drawn from the BufferPool (if enabled).
+ */
+template <typename T>
+Chunk2D<T>::Chunk2D(const Chunk2D& other)
+    : _data(BufferPool<T>::instance().copyOf(other._data))
+    , _dim(other._dim)
+{
+}
+
+/*!
+ * Assigns a copy of \a other to this instance. If the memory of this instance is insufficient, it
+ * is replaced by memory from the BufferPool (if enabled).
+ */
+template <typename T>
+Chunk2D<T>& Chunk2D<T>::operator=(const Chunk2D& other)
+{
+    _statsCache.invalidate();
+    BufferPool<T>::instance().assign(_data, other._data);
+    _dim = other._dim;
+    return *this;
+}
+
+/*!
+ * Move-assigns \a other to this instance. The former data of this instance is returned to the
+ * BufferPool (if enabled).
+ */
+template <typename T>
+Chunk2D<T>& Chunk2D<T>::operator=(Chunk2D&& other) noexcept
+{
+    if(this != &other)
+    {
+        _statsCache.invalidate();
+        BufferPool<T>::instance().recycle(_data);
+        _data = std::move(other._data);
+        _dim = other._dim;
+    }
+    return *this;
+}
+
+/*!
+ * Destroys the chunk. Its data is returned to the BufferPool (if enabled).
+ */
+template <typename T>
+Chunk2D<T>::~Chunk2D()
+{
+    BufferPool<T>::instance().recycle(_data);
+}
+
 /*!
  * Returns the maximum value in this instance.
  *
@@ -119,7 +168,7 @@ T Chunk2D<T>::max() const
     if(allocatedElements() == 0)
         return T(0);
 
-    return *std::max_element(_data.cbegin(), _data.cend());
+    return details::parallelMinMax(_data.data(), _data.size()).second;
 }
 
 /*!
@@ -133,7 +182,7 @@ T Chunk2D<T>::min() const
     if(allocatedElements() == 0)
         return T(0);
 
-    return *std::min_element(_data.cbegin(), _data.cend());
+    return details::parallelMinMax(_data.data(), _data.size()).first;
 }
 
 /*!
@@ -147,6 +196,7 @@ T Chunk2D<T>::min() const
 template <typename T>
 void Chunk2D<T>::setData(std::vector<T>&& data)
 {
+    _statsCache.invalidate();
     if(!hasEqualSizeAs(data))
         throw std::domain_error("data vector has incompatible size for Chunk2D");
 
@@ -164,10 +214,11 @@ void Chunk2D<T>::setData(std::vector<T>&& data)
 template <typename T>
 void Chunk2D<T>::setData(const std::vector<T>& data)
 {
+    _statsCache.invalidate();
     if(!hasEqualSizeAs(data))
         throw std::domain_error("data vector has incompatible size for Chunk2D");
 
-    _data = data;
+    BufferPool<T>::instance().assign(_data, data);
 }
 
 /*!
@@ -189,6 +240,7 @@ bool Chunk2D<T>::hasEqualSizeAs(const std::vector<T>& other) const
 template <typename T>
 Chunk2D<T>& Chunk2D<T>::operator+=(const Chunk2D<T>& other)
 {
+    _statsCache.invalidate();
     Q_ASSERT(_dim == other.dimensions());
     if(_dim != other.dimensions())
         throw std::domain_error("Chunk2D requires same dimensions for '+' operation:\n"
@@ -207,6 +259,7 @@ Chunk2D<T>& Chunk2D<T>::operator+=(const Chunk2D<T>& other)
 template <typename T>
 Chunk2D<T>& Chunk2D<T>::operator-=(const Chunk2D<T>& other)
 {
+    _statsCache.invalidate();
     Q_ASSERT(_dim == other.dimensions());
     if(_dim != other.dimensions())
         throw std::domain_error("Chunk2D requires same dimensions for '-' operation:\n"
@@ -224,6 +277,7 @@ Chunk2D<T>& Chunk2D<T>::operator-=(const Chunk2D<T>& other)
 template <typename T>
 Chunk2D<T>& Chunk2D<T>::operator*=(const T& factor)
 {
+    _statsCache.invalidate();
     for(auto& val : _data)
         val *= factor;
 
@@ -236,6 +290,7 @@ Chunk2D<T>& Chunk2D<T>::operator*=(const T& factor)
 template <typename T>
 Chunk2D<T>& Chunk2D<T>::operator/=(const T& divisor)
 {
+    _statsCache.invalidate();
     for(auto& val : _data)
         val /= divisor;
 
@@ -373,6 +428,7 @@ const std::vector<T>& Chunk2D<T>::data() const
 template <typename T>
 std::vector<T>& Chunk2D<T>::data()
 {
+    _statsCache.invalidate();
     return _data;
 }
 
@@ -418,6 +474,7 @@ size_t Chunk2D<T>::nbElements() const
 template <typename T>
 T* Chunk2D<T>::rawData()
 {
+    _statsCache.invalidate();
     return _data.data();
 }
 
@@ -451,6 +508,13 @@ uint Chunk2D<T>::width() const
 template <typename T>
 void Chunk2D<T>::fill(const T& fillValue)
 {
+    _statsCache.invalidate();
+    if(_data.empty())
+    {
+        _data = BufferPool<T>::instance().filled(nbElements(), fillValue);
+        return;
+    }
+
     if(allocatedElements() != nbElements())
         allocateMemory();
 
@@ -465,8 +529,18 @@ void Chunk2D<T>::fill(const T& fillValue)
 template<typename T>
 void Chunk2D<T>::freeMemory()
 {
-    _data.clear();
-    _data.shrink_to_fit();
+    _statsCache.invalidate();
+    BufferPool<T>::instance().recycle(_data);
+}
+
+/*!
+ * Returns the cache for the statistics of this chunk (see reduction::cachedStatistics()). The
+ * cache is invalidated by all non-const methods that provide access to the data.
+ */
+template <typename T>
+const details::DataStatisticsCache& Chunk2D<T>::statisticsCache() const
+{
+    return _statsCache;
 }
 
 /*!
@@ -476,6 +550,7 @@ void Chunk2D<T>::freeMemory()
 template <typename T>
 typename std::vector<T>::reference Chunk2D<T>::operator()(uint x, uint y)
 {
+    _statsCache.invalidate();
     Q_ASSERT((size_t(y) * size_t(_dim.width) + size_t(x)) < allocatedElements());
     return _data[size_t(y) * size_t(_dim.width) + size_t(x)];
 }
@@ -519,7 +594,7 @@ bool Chunk2D<T>::operator!=(const Chunk2D<T>& other) const
 template <typename T>
 void Chunk2D<T>::allocateMemory()
 {
-    _data.resize(nbElements());
+    allocateMemory(T());
 }
 
 /*!
@@ -531,7 +606,11 @@ void Chunk2D<T>::allocateMemory()
 template <typename T>
 void Chunk2D<T>::allocateMemory(const T& initValue)
 {
-    _data.resize(nbElements(), initValue);
+    _statsCache.invalidate();
+    if(_data.empty())
+        _data = BufferPool<T>::instance().filled(nbElements(), initValue);
+    else
+        _data.resize(nbElements(), initValue);
 }
 
 } // namespace CTL
@@ -0,0 +1,77 @@
+#include "datastatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace CTL {
+
+/*!
+ * Returns the (population) standard deviation, i.e. the square root of the variance.
+ */
+double DataStatistics::standardDeviation() const { return std::sqrt(variance); }
+
+/*!
+ * Returns the statistics of the union of two disjoint sets of values with statistics \a a and
+ * \a b, respectively.
+ *
+ * Means and variances are merged with the pairwise update formula by Chan et al., which is
+ * numerically stable also for sets of very different size.
+ */
+DataStatistics DataStatistics::combined(const DataStatistics& a, const DataStatistics& b)
+{
+    if(a.nbElements == 0)
+        return b;
+    if(b.nbElements == 0)
+        return a;
+
+    const auto nA = double(a.nbElements);
+    const auto nB = double(b.nbElements);
+    const auto n = nA + nB;
+    const auto delta = b.mean - a.mean;
+
+    DataStatistics ret;
+    ret.nbElements = a.nbElements + b.nbElements;
+    ret.min = std::min(a.min, b.min);
+    ret.max = std::max(a.max, b.max);
+    ret.mean = a.mean + delta * nB / n;
+    ret.variance = (a.variance * nA + b.variance * nB + delta * delta * nA * nB / n) / n;
+    return ret;
+}
+
+namespace details {
+
+DataStatisticsCache& DataStatisticsCache::operator=(const DataStatisticsCache&) noexcept
+{
+    invalidate();
+    return *this;
+}
+
+/*!
+ * Copies the cached statistics to \a statistics and returns `true` if the cache is valid. Returns
+ * `false` otherwise (\a statistics remains unchanged).
+ */
+bool DataStatisticsCache::get(DataStatistics& statistics) const
+{
+    if(!_valid.load(std::memory_order_relaxed))
+        return false;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(!_valid.load(std::memory_order_relaxed))
+        return false;
+
+    statistics = _statistics;
+    return true;
+}
+
+/*!
+ * Stores \a statistics in the cache and marks it as valid.
+ */
+void DataStatisticsCache::set(const DataStatistics& statistics) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _statistics = statistics;
+    _valid.store(true, std::memory_order_relaxed);
+}
+
+} // namespace details
+} // namespace CTL
@@ -0,0 +1,97 @@
+#ifndef CTL_DATASTATISTICS_H
+#define CTL_DATASTATISTICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace CTL {
+
+/*!
+ * \struct DataStatistics
+ *
+ * \brief Holds descriptive statistics (extrema, mean and variance) of a set of values.
+ *
+ * Statistics of data containers can be computed with reduction::statistics() (or
+ * reduction::cachedStatistics()). Statistics of disjoint sets of values can be merged using
+ * combined().
+ */
+struct DataStatistics
+{
+    size_t nbElements = 0; //!< Number of values.
+    double min = 0.0;      //!< Smallest value.
+    double max = 0.0;      //!< Largest value.
+    double mean = 0.0;     //!< Arithmetic mean.
+    double variance = 0.0; //!< (Population) variance, i.e. normalized by the number of values.
+
+    double standardDeviation() const;
+
+    static DataStatistics combined(const DataStatistics& a, const DataStatistics& b);
+};
+
+namespace details {
+
+/*!
+ * \class DataStatisticsCache
+ *
+ * \brief Thread-safe storage for the DataStatistics of a Chunk2D or VoxelVolume.
+ *
+ * The owning container invalidates the cache whenever it hands out non-const access to its data.
+ * Copies of a cache (and hence, of the owning container) start invalid.
+ *
+ * Invalidation is an inlined check-and-clear of an atomic flag with relaxed memory ordering; it
+ * writes only if the cache is valid, so that loops over non-const element access touch the flag
+ * only once. As for the data itself, non-const access must not run concurrently with statistics
+ * queries on the same container; threads that write elements in parallel should obtain non-const
+ * access (e.g. via data()) before they are started.
+ */
+class DataStatisticsCache
+{
+public:
+    DataStatisticsCache() = default;
+    DataStatisticsCache(const DataStatisticsCache&) noexcept {}
+    DataStatisticsCache& operator=(const DataStatisticsCache&) noexcept;
+
+    void invalidate() noexcept
+    {
+        if(_valid.load(std::memory_order_relaxed))
+            _valid.store(false, std::memory_order_relaxed);
+    }
+    bool get(DataStatistics& statistics) const;
+    void set(const DataStatistics& statistics) const;
+
+private:
+    mutable std::mutex _mutex;
+    mutable DataStatistics _statistics;
+    mutable std::atomic<bool> _valid{ false };
+};
+
+// serial computations on a contiguous range of values
+template <typename T>
+std::pair<T, T> rangeMinMax(const T* data, size_t nbElements);
+template <typename T>
+DataStatistics blockStatistics(const T* data, size_t nbElements);
+template <typename T>
+DataStatistics rangeStatistics(const T* data, size_t nbElements);
+
+// parallel computation for data consisting of `nbSegments` contiguous segments
+template <class Result, class Segment, class Kernel, class Combine>
+Result parallelSegmentReduction(size_t nbSegments,
+                                size_t segmentSize,
+                                Segment segment,
+                                Kernel kernel,
+                                Combine combine);
+
+template <typename T>
+std::pair<T, T> parallelMinMax(const T* data, size_t nbElements);
+
+} // namespace details
+
+} // namespace CTL
+
+#include "datastatistics.tpp"
+
+/*! \file */
+
+#endif // CTL_DATASTATISTICS_H
@@ -0,0 +1,192 @@
+#include "datastatistics.h"
+#include "processing/threadpool.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace CTL {
+namespace details {
+
+// number of independent accumulators (allows for vectorization and instruction-level parallelism)
+constexpr size_t REDUCTION_LANES = 8;
+// number of values whose statistics are accumulated directly (before merging them)
+constexpr size_t REDUCTION_BLOCK_SIZE = 4096;
+// minimum number of elements processed by a single thread
+constexpr size_t REDUCTION_MIN_ELEMENTS_PER_THREAD = 65536;
+
+/*!
+ * Returns the smallest and the largest value in [\a data, \a data + \a nbElements). The range must
+ * not be empty.
+ */
+template <typename T>
+std::pair<T, T> rangeMinMax(const T* data, size_t nbElements)
+{
+    T mins[REDUCTION_LANES], maxs[REDUCTION_LANES];
+    std::fill(mins, mins + REDUCTION_LANES, data[0]);
+    std::fill(maxs, maxs + REDUCTION_LANES, data[0]);
+
+    size_t i = 0;
+    for(; i + REDUCTION_LANES <= nbElements; i += REDUCTION_LANES)
+        for(size_t l = 0; l < REDUCTION_LANES; ++l)
+        {
+            const auto val = data[i + l];
+            mins[l] = val < mins[l] ? val : mins[l];
+            maxs[l] = val > maxs[l] ? val : maxs[l];
+        }
+    for(; i < nbElements; ++i)
+    {
+        mins[0] = data[i] < mins[0] ? data[i] : mins[0];
+        maxs[0] = data[i] > maxs[0] ? data[i] : maxs[0];
+    }
+
+    return { *std::min_element(mins, mins + REDUCTION_LANES),
+             *std::max_element(maxs, maxs + REDUCTION_LANES) };
+}
+
+// statistics of a block of values; sums are accumulated in double precision relative to the first
+// value, which avoids catastrophic cancellation in the variance for data with a large offset
+template <typename T>
+DataStatistics blockStatistics(const T* data, size_t nbElements)
+{
+    DataStatistics ret;
+    if(nbElements == 0)
+        return ret;
+
+    const auto shift = double(data[0]);
+    double sums[REDUCTION_LANES] = {};
+    double sumsSq[REDUCTION_LANES] = {};
+    T mins[REDUCTION_LANES], maxs[REDUCTION_LANES];
+    std::fill(mins, mins + REDUCTION_LANES, data[0]);
+    std::fill(maxs, maxs + REDUCTION_LANES, data[0]);
+
+    auto accumulate = [&](size_t lane, const T& val) {
+        const auto dev = double(val) - shift;
+        sums[lane] += dev;
+        sumsSq[lane] += dev * dev;
+        mins[lane] = val < mins[lane] ? val : mins[lane];
+        maxs[lane] = val > maxs[lane] ? val : maxs[lane];
+    };
+
+    size_t i = 0;
+    for(; i + REDUCTION_LANES <= nbElements; i += REDUCTION_LANES)
+        for(size_t l = 0; l < REDUCTION_LANES; ++l)
+            accumulate(l, data[i + l]);
+    for(; i < nbElements; ++i)
+        accumulate(0, data[i]);
+
+    double sum = 0.0, sumSq = 0.0;
+    for(size_t l = 0; l < REDUCTION_LANES; ++l)
+    {
+        sum += sums[l];
+        sumSq += sumsSq[l];
+    }
+    const auto n = double(nbElements);
+
+    ret.nbElements = nbElements;
+    ret.min = double(*std::min_element(mins, mins + REDUCTION_LANES));
+    ret.max = double(*std::max_element(maxs, maxs + REDUCTION_LANES));
+    ret.mean = shift + sum / n;
+    ret.variance = std::max(0.0, (sumSq - sum * sum / n) / n);
+    return ret;
+}
+
+/*!
+ * Returns the statistics of the values in [\a data, \a data + \a nbElements) computed in a single
+ * pass. The values are processed in blocks whose statistics are merged with
+ * DataStatistics::combined(), which keeps the variance accurate also for large ranges.
+ */
+template <typename T>
+DataStatistics rangeStatistics(const T* data, size_t nbElements)
+{
+    DataStatistics ret;
+    for(size_t begin = 0; begin < nbElements; begin += REDUCTION_BLOCK_SIZE)
+    {
+        const auto n = std::min(REDUCTION_BLOCK_SIZE, nbElements - begin);
+        ret = DataStatistics::combined(ret, blockStatistics(data + begin, n));
+    }
+    return ret;
+}
+
+/*!
+ * Computes a reduction of data consisting of \a nbSegments contiguous memory segments with
+ * \a segmentSize elements each in parallel. \a segment(i) must return a pointer to the first
+ * element of the i-th segment.
+ *
+ * The flattened data is split into consecutive blocks, one for each thread. \a kernel(ptr, n)
+ * reduces a contiguous range to a `Result`; the partial results of a block (and those of all
+ * blocks) are merged by \a combine(a, b) in the order of the data, such that the result is
+ * deterministic for a fixed number of threads.
+ */
+template <class Result, class Segment, class Kernel, class Combine>
+Result parallelSegmentReduction(size_t nbSegments,
+                                size_t segmentSize,
+                                Segment segment,
+                                Kernel kernel,
+                                Combine combine)
+{
+    const auto nbElements = nbSegments * segmentSize;
+
+    auto reduceBlock = [&](size_t begin, size_t end) {
+        Result ret{};
+        bool first = true;
+        while(begin < end)
+        {
+            const auto seg = begin / segmentSize;
+            const auto offset = begin % segmentSize;
+            const auto n = std::min(segmentSize - offset, end - begin);
+
+            auto partial = kernel(segment(seg) + offset, n);
+            ret = first ? std::move(partial) : combine(std::move(ret), std::move(partial));
+            first = false;
+            begin += n;
+        }
+        return ret;
+    };
+
+    const auto nbThreads = ThreadBudget::nbThreads();
+    const auto nbTasks = std::max(
+        size_t(1), std::min(nbThreads, nbElements / REDUCTION_MIN_ELEMENTS_PER_THREAD));
+
+    if(nbTasks == 1)
+        return reduceBlock(0, nbElements);
+
+    std::vector<Result> partialResults(nbTasks);
+    {
+        ThreadPool tp(nbTasks);
+        const auto elementsPerTask = nbElements / nbTasks;
+        for(size_t t = 0; t < nbTasks; ++t)
+        {
+            const auto begin = t * elementsPerTask;
+            const auto end = (t == nbTasks - 1) ? nbElements : begin + elementsPerTask;
+            tp.enqueueThread([&partialResults, &reduceBlock, t, begin, end] {
+                partialResults[t] = reduceBlock(begin, end);
+            });
+        }
+    } // wait for all threads
+
+    auto ret = std::move(partialResults.front());
+    for(size_t t = 1; t < nbTasks; ++t)
+        ret = combine(std::move(ret), std::move(partialResults[t]));
+    return ret;
+}
+
+/*!
+ * Returns the smallest and the largest value in [\a data, \a data + \a nbElements) computed in
+ * parallel. The range must not be empty.
+ */
+template <typename T>
+std::pair<T, T> parallelMinMax(const T* data, size_t nbElements)
+{
+    using MinMax = std::pair<T, T>;
+
+    return parallelSegmentReduction<MinMax>(
+        1, nbElements, [data](size_t) { return data; },
+        [](const T* ptr, size_t n) { return rangeMinMax(ptr, n); },
+        [](const MinMax& a, const MinMax& b) {
+            return MinMax(b.first < a.first ? b.first : a.first,
+                          b.second > a.second ? b.second : a.second);
+        });
+}
+
+} // namespace details
+} // namespace CTL
@@ -0,0 +1,66 @@
+#ifndef CTL_ELEMENTWISE_H
+#define CTL_ELEMENTWISE_H
+
+#include "projectiondata.h"
+#include "voxelvolume.h"
+
+namespace CTL {
+
+/*!
+ * \namespace CTL::elementwise
+ *
+ * \brief Fused element-wise operations on Chunk2D, VoxelVolume, SingleViewData and ProjectionData.
+ *
+ * The arithmetic operators of the data containers (e.g. VoxelVolume::operator+()) create a full
+ * temporary and pass over the entire data once per operator. Thus, evaluating an expression like
+ * `a * x + b * y` requires several passes over the data and several allocations. The functions in
+ * this namespace evaluate an arbitrary element-wise function of any number of containers within a
+ * single (multithreaded) pass and write the result directly into the destination:
+ *
+ * \code
+ * VoxelVolume<float> x = ..., y = ...;
+ * const float a = 2.0f, b = 0.5f;
+ *
+ * // result = a * x + b * y (one pass, one allocation)
+ * auto result = elementwise::transformed([a, b](float xi, float yi) { return a * xi + b * yi; },
+ *                                        x, y);
+ *
+ * // in-place: x = a * x + b * y (one pass, no allocation)
+ * elementwise::transform(x, [a, b](float xi, float yi) { return a * xi + b * yi; }, x, y);
+ *
+ * // in-place: x = exp(-x)
+ * elementwise::apply(x, [](float xi) { return std::exp(-xi); });
+ * \endcode
+ *
+ * All containers involved in an operation must have the same dimensions; otherwise, an
+ * std::domain_error is thrown. Containers of different types can not be mixed (except for
+ * VoxelVolume and its subclasses, such as SpectralVolumeData). The function is called concurrently
+ * from several threads and hence, must be thread-safe. The loops are written such that the
+ * compiler can vectorize them (provided that the function can be inlined).
+ */
+namespace details {
+template <class Function, class Source, class... Sources>
+struct TransformedContainer;
+} // namespace details
+
+namespace elementwise {
+
+template <class Container, class Function, class... Sources>
+Container& transform(Container& destination, Function f, const Sources&... sources);
+
+template <class Container, class Function>
+Container& apply(Container& container, Function f);
+
+template <class Function, class Source, class... Sources>
+typename details::TransformedContainer<Function, Source, Sources...>::type
+transformed(Function f, const Source& source, const Sources&... sources);
+
+} // namespace elementwise
+
+} // namespace CTL
+
+#include "elementwise.tpp"
+
+/*! \file */
+
+#endif // CTL_ELEMENTWISE_H
@@ -0,0 +1,331 @@
+#include "elementwise.h"
+#include "processing/threadpool.h"
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CTL {
+
+namespace details {
+
+/*!
+ * The data of a container is treated as a sequence of `nbSegments` contiguous memory segments of
+ * `segmentSize` elements each (e.g. the modules of all views of a ProjectionData object).
+ */
+struct ElementwiseLayout
+{
+    size_t nbSegments;
+    size_t segmentSize;
+
+    bool operator==(const ElementwiseLayout& other) const
+    {
+        return nbSegments == other.nbSegments && segmentSize == other.segmentSize;
+    }
+    bool operator!=(const ElementwiseLayout& other) const { return !(*this == other); }
+    size_t nbElements() const { return nbSegments * segmentSize; }
+};
+
+// ### layout of the containers ###
+
+template <typename T>
+ElementwiseLayout elementwiseLayout(const Chunk2D<T>& chunk)
+{
+    if(chunk.allocatedElements() != chunk.nbElements())
+        throw std::domain_error("elementwise: Chunk2D has no allocated memory");
+    return { 1, chunk.nbElements() };
+}
+
+template <typename T>
+ElementwiseLayout elementwiseLayout(const VoxelVolume<T>& volume)
+{
+    if(volume.allocatedElements() != volume.totalVoxelCount())
+        throw std::domain_error("elementwise: VoxelVolume has no allocated memory");
+    return { 1, volume.totalVoxelCount() };
+}
+
+inline ElementwiseLayout elementwiseLayout(const SingleViewData& view)
+{
+    const auto dim = view.dimensions();
+    const auto moduleSize = size_t(dim.nbChannels) * size_t(dim.nbRows);
+    for(uint mod = 0; mod < view.nbModules(); ++mod)
+        if(view.module(mod).allocatedElements() != moduleSize)
+            throw std::domain_error("elementwise: SingleViewData has no allocated memory");
+    return { view.nbModules(), moduleSize };
+}
+
+inline ElementwiseLayout elementwiseLayout(const ProjectionData& projections)
+{
+    if(projections.nbViews() == 0)
+        return { 0, 0 };
+
+    auto viewLayout = elementwiseLayout(projections.view(0));
+    for(uint v = 1; v < projections.nbViews(); ++v)
+        if(elementwiseLayout(projections.view(v)) != viewLayout)
+            throw std::domain_error("elementwise: views of ProjectionData differ in size");
+    viewLayout.nbSegments *= projections.nbViews();
+    return viewLayout;
+}
+
+// ### access to the memory segments ###
+
+template <typename T>
+T* elementwiseSegment(Chunk2D<T>& chunk, size_t) { return chunk.rawData(); }
+template <typename T>
+const T* elementwiseSegment(const Chunk2D<T>& chunk, size_t) { return chunk.rawData(); }
+
+template <typename T>
+T* elementwiseSegment(VoxelVolume<T>& volume, size_t) { return volume.rawData(); }
+template <typename T>
+const T* elementwiseSegment(const VoxelVolume<T>& volume, size_t) { return volume.rawData(); }
+
+inline float* elementwiseSegment(SingleViewData& view, size_t seg)
+{
+    return view.module(uint(seg)).rawData();
+}
+inline const float* elementwiseSegment(const SingleViewData& view, size_t seg)
+{
+    return view.module(uint(seg)).rawData();
+}
+
+inline float* elementwiseSegment(ProjectionData& projections, size_t seg)
+{
+    const auto nbModules = projections.viewDimensions().nbModules;
+    return projections.view(uint(seg / nbModules)).module(uint(seg % nbModules)).rawData();
+}
+inline const float* elementwiseSegment(const ProjectionData& projections, size_t seg)
+{
+    const auto nbModules = projections.viewDimensions().nbModules;
+    return projections.view(uint(seg / nbModules)).module(uint(seg % nbModules)).rawData();
+}
+
+// pointers to all memory segments of a container; these are obtained on the calling thread, such
+// that the worker threads do not access the containers through their (non-const) interface, which
+// invalidates cached statistics
+template <class Container>
+using ElementwiseSegments =
+    std::vector<decltype(elementwiseSegment(std::declval<Container&>(), size_t(0)))>;
+
+template <class Container>
+ElementwiseSegments<Container> elementwiseSegments(Container& container, size_t nbSegments)
+{
+    ElementwiseSegments<Container> ret(nbSegments);
+    for(size_t seg = 0; seg < nbSegments; ++seg)
+        ret[seg] = elementwiseSegment(container, seg);
+    return ret;
+}
+
+// ### preparation of the destination ###
+// allocates memory (w/o initialization) if the destination has none
+
+template <typename T>
+void prepareElementwiseDestination(Chunk2D<T>& chunk)
+{
+    if(chunk.allocatedElements() != chunk.nbElements())
+        chunk.allocateMemory();
+}
+
+template <typename T>
+void prepareElementwiseDestination(VoxelVolume<T>& volume)
+{
+    if(volume.allocatedElements() != volume.totalVoxelCount())
+        volume.allocateMemory();
+}
+
+inline void prepareElementwiseDestination(SingleViewData&) {}
+inline void prepareElementwiseDestination(ProjectionData&) {}
+
+// ### element types and result containers ###
+
+template <typename T>
+T elementTypeOf(const Chunk2D<T>&);
+template <typename T>
+T elementTypeOf(const VoxelVolume<T>&); // also matches subclasses (e.g. SpectralVolumeData)
+float elementTypeOf(const SingleViewData&);
+float elementTypeOf(const ProjectionData&);
+
+template <typename T, typename R>
+Chunk2D<R> resultContainerOf(const Chunk2D<T>&, R*);
+template <typename T, typename R>
+VoxelVolume<R> resultContainerOf(const VoxelVolume<T>&, R*);
+template <typename R>
+SingleViewData resultContainerOf(const SingleViewData&, R*);
+template <typename R>
+ProjectionData resultContainerOf(const ProjectionData&, R*);
+
+template <class Function, class Source, class... Sources>
+struct TransformedContainer
+{
+    using ResultElement = typename std::decay<decltype(std::declval<Function&>()(
+        elementTypeOf(std::declval<const Source&>()),
+        elementTypeOf(std::declval<const Sources&>())...))>::type;
+
+    using type = decltype(resultContainerOf(std::declval<const Source&>(),
+                                            static_cast<ResultElement*>(nullptr)));
+};
+
+// containers shaped like the first source of elementwise::transformed()
+
+template <typename R, typename T>
+Chunk2D<R> elementwiseShapedLike(const Chunk2D<T>& chunk)
+{
+    return Chunk2D<R>(chunk.width(), chunk.height());
+}
+
+template <typename R, typename T>
+VoxelVolume<R> elementwiseShapedLike(const VoxelVolume<T>& volume)
+{
+    const auto& dim = volume.dimensions();
+    const auto& voxSize = volume.voxelSize();
+    const auto& offset = volume.offset();
+
+    VoxelVolume<R> ret(dim.x, dim.y, dim.z, voxSize.x, voxSize.y, voxSize.z);
+    ret.setVolumeOffset(offset.x, offset.y, offset.z);
+    return ret;
+}
+
+template <typename R>
+SingleViewData elementwiseShapedLike(const SingleViewData& view)
+{
+    SingleViewData ret(view.dimensions().nbChannels, view.dimensions().nbRows);
+    ret.allocateMemory(view.nbModules());
+    return ret;
+}
+
+template <typename R>
+ProjectionData elementwiseShapedLike(const ProjectionData& projections)
+{
+    ProjectionData ret(projections.viewDimensions());
+    ret.allocateMemory(projections.nbViews());
+    return ret;
+}
+
+// ### kernel ###
+
+template <typename D, class Function, typename... S>
+void elementwiseKernel(D* dst, size_t n, Function& f, const S*... src)
+{
+    for(size_t i = 0; i < n; ++i)
+        dst[i] = f(src[i]...);
+}
+
+// processes the elements [begin, end) of the flattened data (given by its memory segments)
+template <class DstSegments, class Function, class... SrcSegments>
+void elementwiseTask(const DstSegments& destination,
+                     size_t segmentSize,
+                     size_t begin,
+                     size_t end,
+                     Function f,
+                     const SrcSegments&... sources)
+{
+    while(begin < end)
+    {
+        const auto seg = begin / segmentSize;
+        const auto offset = begin % segmentSize;
+        const auto n = std::min(segmentSize - offset, end - begin);
+
+        elementwiseKernel(destination[seg] + offset, n, f, (sources[seg] + offset)...);
+        begin += n;
+    }
+}
+
+// minimum number of elements processed by a single thread
+constexpr size_t ELEMENTWISE_MIN_ELEMENTS_PER_THREAD = 65536;
+
+} // namespace details
+
+namespace elementwise {
+
+/*!
+ * Evaluates the element-wise function \a f of the \a sources and writes the result to
+ * \a destination, i.e. `destination[i] = f(sources[i]...)` for all elements `i`. Returns a
+ * reference to \a destination.
+ *
+ * The \a destination may also be one of the \a sources (in-place operation). Memory is allocated
+ * for \a destination if it is a Chunk2D or VoxelVolume without allocated memory; SingleViewData
+ * and ProjectionData must contain the correct number of modules and views already.
+ *
+ * Throws std::domain_error if the dimensions of \a destination and the \a sources do not match.
+ */
+template <class Container, class Function, class... Sources>
+Container& transform(Container& destination, Function f, const Sources&... sources)
+{
+    details::prepareElementwiseDestination(destination);
+
+    const auto layout = details::elementwiseLayout(destination);
+    for(const auto& sourceLayout :
+        std::initializer_list<details::ElementwiseLayout>{ details::elementwiseLayout(sources)... })
+        if(sourceLayout != layout)
+            throw std::domain_error("elementwise::transform: inconsistent dimensions");
+
+    const auto nbElements = layout.nbElements();
+    if(nbElements == 0)
+        return destination;
+
+    // non-const access to the destination (invalidates its cached statistics) happens only here
+    const auto dstSegments = details::elementwiseSegments(destination, layout.nbSegments);
+
+    ThreadPool tp;
+    const auto nbTasks = std::max(
+        size_t(1), std::min(tp.nbThreads(),
+                            nbElements / details::ELEMENTWISE_MIN_ELEMENTS_PER_THREAD));
+
+    if(nbTasks == 1)
+    {
+        details::elementwiseTask(dstSegments, layout.segmentSize, 0, nbElements, f,
+                                 details::elementwiseSegments(sources, layout.nbSegments)...);
+        return destination;
+    }
+
+    const auto elementsPerTask = nbElements / nbTasks;
+    for(size_t t = 0; t < nbTasks; ++t)
+    {
+        const auto begin = t * elementsPerTask;
+        const auto end = (t == nbTasks - 1) ? nbElements : begin + elementsPerTask;
+        tp.enqueueThread(details::elementwiseTask<details::ElementwiseSegments<Container>, Function,
+                                                  details::ElementwiseSegments<const Sources>...>,
+                         dstSegments, layout.segmentSize, begin, end, f,
+                         details::elementwiseSegments(sources, layout.nbSegments)...);
+    }
+
+    return destination;
+}
+
+/*!
+ * Applies the element-wise function \a f to \a container (in-place), i.e.
+ * `container[i] = f(container[i])` for all elements `i`. Returns a reference to \a container.
+ */
+template <class Container, class Function>
+Container& apply(Container& container, Function f)
+{
+    return transform(container, f, container);
+}
+
+/*!
+ * Returns a new container with the result of the element-wise function \a f of \a source and
+ * \a sources, i.e. `result[i] = f(source[i], sources[i]...)` for all elements `i`.
+ *
+ * The result has the same dimensions (and for VoxelVolume, the same voxel size and offset) as
+ * \a source. Its element type is the return type of \a f, e.g. a VoxelVolume<double> is returned
+ * if \a f returns `double`. Note that the result of a SpectralVolumeData is a (plain) VoxelVolume.
+ *
+ * Throws std::domain_error if the dimensions of the \a sources do not match.
+ */
+template <class Function, class Source, class... Sources>
+typename details::TransformedContainer<Function, Source, Sources...>::type
+transformed(Function f, const Source& source, const Sources&... sources)
+{
+    using Result = details::TransformedContainer<Function, Source, Sources...>;
+
+    auto ret = details::elementwiseShapedLike<typename Result::ResultElement>(source);
+    transform(ret, f, source, sources...);
+    return ret;
+}
+
+} // namespace elementwise
+
+} // namespace CTL
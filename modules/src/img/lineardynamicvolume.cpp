@@ -1,4 +1,5 @@
 #include "lineardynamicvolume.h"
+#include "elementwise.h"
 
 namespace CTL {
 
@@ -193,8 +194,9 @@ SpectralVolumeData* LinearDynamicVolume::clone() const
  */
 void LinearDynamicVolume::updateVolume()
 {
-    auto updatedVol = _slope * float(time()) + _lag;
-    setData(std::move(updatedVol.data()));
+    const auto t = float(time());
+    elementwise::transform(*this, [t](float slope, float lag) { return slope * t + lag; },
+                           _slope, _lag);
 }
 
 } // namespace CTL
@@ -1,4 +1,5 @@
 #include "projectiondata.h"
+#include "reduction.h"
 #include "processing/threadpool.h"
 
 namespace CTL
@@ -87,17 +88,7 @@ float ProjectionData::max() const
     if(nbViews() == 0)
         return 0.0f;
 
-    auto tmpMax = view(0).max();
-
-    float locMax;
-    for(auto vi = 1u, total = nbViews(); vi < total; ++vi)
-    {
-        locMax = view(vi).max();
-        if(locMax > tmpMax)
-            tmpMax = locMax;
-    }
-
-    return tmpMax;
+    return float(reduction::minMax(*this).second);
 }
 
 /*!
@@ -110,17 +101,7 @@ float ProjectionData::min() const
     if(nbViews() == 0)
         return 0.0f;
 
-    auto tmpMin = view(0).min();
-
-    float locMin;
-    for(auto vi = 1u, total = nbViews(); vi < total; ++vi)
-    {
-        locMin = view(vi).min();
-        if(locMin < tmpMin)
-            tmpMin = locMin;
-    }
-
-    return tmpMin;
+    return float(reduction::minMax(*this).first);
 }
 
 /*!
@@ -0,0 +1,64 @@
+#ifndef CTL_REDUCTION_H
+#define CTL_REDUCTION_H
+
+#include "datastatistics.h"
+#include "elementwise.h"
+
+namespace CTL {
+
+/*!
+ * \namespace CTL::reduction
+ *
+ * \brief Parallel reductions (extrema, mean, variance, histogram, percentiles) of Chunk2D,
+ * VoxelVolume, SingleViewData and ProjectionData.
+ *
+ * All functions process the data in a single multithreaded pass (percentile() needs a few passes).
+ * The inner loops use several independent accumulators, such that they can be vectorized by the
+ * compiler. In particular, statistics() computes minimum, maximum, mean and variance at once:
+ *
+ * \code
+ * const auto stats = reduction::statistics(volume);
+ * qInfo() << stats.min << stats.max << stats.mean << stats.standardDeviation();
+ *
+ * // display window from the 1st to the 99th percentile
+ * const auto lower = reduction::percentile(volume, 1.0);
+ * const auto upper = reduction::percentile(volume, 99.0);
+ * \endcode
+ *
+ * The statistics can be cached on the container with cachedStatistics(). Repeated calls (e.g.
+ * from a viewer) then return immediately as long as the data has not been modified. For
+ * SingleViewData and ProjectionData, the statistics are cached per module, such that after a
+ * modification only the affected modules need to be scanned again.
+ *
+ * Throws std::domain_error if a container contains unallocated data (or, for ProjectionData, views
+ * of different size). NaN values are not supported.
+ */
+namespace reduction {
+
+template <class Container>
+std::pair<double, double> minMax(const Container& data);
+
+template <class Container>
+DataStatistics statistics(const Container& data);
+
+template <class Container>
+DataStatistics cachedStatistics(const Container& data);
+
+template <class Container>
+std::vector<size_t> histogram(const Container& data, uint nbBins, double lower, double upper);
+
+template <class Container>
+std::vector<size_t> histogram(const Container& data, uint nbBins);
+
+template <class Container>
+double percentile(const Container& data, double percent);
+
+} // namespace reduction
+
+} // namespace CTL
+
+#include "reduction.tpp"
+
+/*! \file */
+
+#endif // CTL_REDUCTION_H
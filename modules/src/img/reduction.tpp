@@ -0,0 +1,362 @@
+#include "reduction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+namespace CTL {
+
+namespace details {
+
+// number of bins of the histograms used to locate a percentile
+constexpr uint PERCENTILE_NB_BINS = 4096;
+// maximum number of values that are gathered for the final (exact) selection of a percentile
+constexpr size_t PERCENTILE_MAX_GATHERED_VALUES = size_t(1) << 20;
+
+// maps values in [lower, upper] to `nbBins` equidistant bins (upper bound belongs to last bin)
+struct HistogramBinning
+{
+    HistogramBinning(uint nbBins, double lower, double upper)
+        : lower(lower)
+        , upper(upper)
+        , scale(upper > lower ? double(nbBins) / (upper - lower) : 0.0)
+        , lastBin(nbBins - 1)
+    {
+    }
+
+    bool contains(double value) const { return value >= lower && value <= upper; }
+    size_t bin(double value) const { return std::min(size_t((value - lower) * scale), lastBin); }
+
+    double lower, upper, scale;
+    size_t lastBin;
+};
+
+// reduces `data` (a Chunk2D, VoxelVolume, SingleViewData or ProjectionData) in parallel
+template <class Result, class Container, class Kernel, class Combine>
+Result reduceContainer(const Container& data, Kernel kernel, Combine combine)
+{
+    const auto layout = elementwiseLayout(data);
+
+    return parallelSegmentReduction<Result>(
+        layout.nbSegments, layout.segmentSize,
+        [&data](size_t seg) { return elementwiseSegment(data, seg); }, kernel, combine);
+}
+
+template <class Container>
+std::vector<size_t> histogram(const Container& data, const HistogramBinning& binning)
+{
+    using Counts = std::vector<size_t>;
+
+    return reduceContainer<Counts>(
+        data,
+        [&binning](const decltype(elementTypeOf(data))* ptr, size_t n) {
+            Counts counts(binning.lastBin + 1, 0);
+            for(size_t i = 0; i < n; ++i)
+            {
+                const auto val = double(ptr[i]);
+                if(binning.contains(val))
+                    ++counts[binning.bin(val)];
+            }
+            return counts;
+        },
+        [](Counts a, const Counts& b) {
+            std::transform(a.cbegin(), a.cend(), b.cbegin(), a.begin(), std::plus<size_t>());
+            return a;
+        });
+}
+
+// extrema of all values in bin `bin` of `binning`
+template <class Container>
+std::pair<double, double> binMinMax(const Container& data,
+                                    const HistogramBinning& binning,
+                                    size_t bin)
+{
+    using MinMax = std::pair<double, double>;
+
+    return reduceContainer<MinMax>(
+        data,
+        [&binning, bin](const decltype(elementTypeOf(data))* ptr, size_t n) {
+            MinMax ret(binning.upper, binning.lower);
+            for(size_t i = 0; i < n; ++i)
+            {
+                const auto val = double(ptr[i]);
+                if(binning.contains(val) && binning.bin(val) == bin)
+                {
+                    ret.first = std::min(ret.first, val);
+                    ret.second = std::max(ret.second, val);
+                }
+            }
+            return ret;
+        },
+        [](const MinMax& a, const MinMax& b) {
+            return MinMax(std::min(a.first, b.first), std::max(a.second, b.second));
+        });
+}
+
+// all values in bin `bin` of `binning`
+template <class Container>
+std::vector<double> binValues(const Container& data, const HistogramBinning& binning, size_t bin)
+{
+    using Values = std::vector<double>;
+
+    return reduceContainer<Values>(
+        data,
+        [&binning, bin](const decltype(elementTypeOf(data))* ptr, size_t n) {
+            Values ret;
+            for(size_t i = 0; i < n; ++i)
+            {
+                const auto val = double(ptr[i]);
+                if(binning.contains(val) && binning.bin(val) == bin)
+                    ret.push_back(val);
+            }
+            return ret;
+        },
+        [](Values a, const Values& b) {
+            a.insert(a.end(), b.cbegin(), b.cend());
+            return a;
+        });
+}
+
+// cached statistics of containers with a single cache (Chunk2D and VoxelVolume)
+template <class Container>
+DataStatistics singleCacheStatistics(const Container& data)
+{
+    DataStatistics ret;
+    if(data.statisticsCache().get(ret))
+        return ret;
+
+    ret = reduction::statistics(data);
+    data.statisticsCache().set(ret);
+    return ret;
+}
+
+template <typename T>
+DataStatistics cachedStatisticsOf(const Chunk2D<T>& chunk)
+{
+    return singleCacheStatistics(chunk);
+}
+
+template <typename T>
+DataStatistics cachedStatisticsOf(const VoxelVolume<T>& volume)
+{
+    return singleCacheStatistics(volume);
+}
+
+// cached statistics of data composed of several modules (each with its own cache)
+inline DataStatistics cachedStatisticsOf(const std::vector<const Chunk2D<float>*>& modules)
+{
+    std::vector<DataStatistics> moduleStats(modules.size());
+    std::vector<size_t> outdated;
+    for(size_t mod = 0; mod < modules.size(); ++mod)
+        if(!modules[mod]->statisticsCache().get(moduleStats[mod]))
+            outdated.push_back(mod);
+
+    const auto nbThreads = ThreadBudget::nbThreads();
+    if(outdated.size() < nbThreads)
+    {
+        // few modules: parallelize within the modules
+        for(auto mod : outdated)
+            moduleStats[mod] = cachedStatisticsOf(*modules[mod]);
+    }
+    else
+    {
+        // many modules: parallelize over the modules
+        auto computeModules = [&](size_t begin, size_t end) {
+            for(auto idx = begin; idx < end; ++idx)
+            {
+                const auto& module = *modules[outdated[idx]];
+                auto& stats = moduleStats[outdated[idx]];
+                stats = rangeStatistics(module.rawData(), module.nbElements());
+                module.statisticsCache().set(stats);
+            }
+        };
+
+        ThreadPool tp(nbThreads);
+        const auto modulesPerThread = outdated.size() / nbThreads;
+        for(size_t t = 0; t < nbThreads; ++t)
+            tp.enqueueThread(computeModules, t * modulesPerThread,
+                             (t == nbThreads - 1) ? outdated.size() : (t + 1) * modulesPerThread);
+    }
+
+    DataStatistics ret;
+    for(const auto& stats : moduleStats)
+        ret = DataStatistics::combined(ret, stats);
+    return ret;
+}
+
+inline DataStatistics cachedStatisticsOf(const SingleViewData& view)
+{
+    elementwiseLayout(view); // checks allocation
+
+    std::vector<const Chunk2D<float>*> modules;
+    for(const auto& module : view.constData())
+        modules.push_back(&module);
+    return cachedStatisticsOf(modules);
+}
+
+inline DataStatistics cachedStatisticsOf(const ProjectionData& projections)
+{
+    elementwiseLayout(projections); // checks allocation and consistency
+
+    std::vector<const Chunk2D<float>*> modules;
+    for(const auto& view : projections.constData())
+        for(const auto& module : view.constData())
+            modules.push_back(&module);
+    return cachedStatisticsOf(modules);
+}
+
+} // namespace details
+
+namespace reduction {
+
+/*!
+ * Returns the smallest and the largest value in \a data. Returns (0, 0) for empty data.
+ */
+template <class Container>
+std::pair<double, double> minMax(const Container& data)
+{
+    using MinMax = std::pair<double, double>;
+
+    if(details::elementwiseLayout(data).nbElements() == 0)
+        return { 0.0, 0.0 };
+
+    return details::reduceContainer<MinMax>(
+        data,
+        [](const decltype(details::elementTypeOf(data))* ptr, size_t n) {
+            const auto minMax = details::rangeMinMax(ptr, n);
+            return MinMax(double(minMax.first), double(minMax.second));
+        },
+        [](const MinMax& a, const MinMax& b) {
+            return MinMax(std::min(a.first, b.first), std::max(a.second, b.second));
+        });
+}
+
+/*!
+ * Returns the statistics (extrema, mean and variance) of all values in \a data. The statistics are
+ * computed in a single parallel pass.
+ *
+ * Returns a default-constructed DataStatistics (with `nbElements = 0`) for empty data.
+ */
+template <class Container>
+DataStatistics statistics(const Container& data)
+{
+    if(details::elementwiseLayout(data).nbElements() == 0)
+        return {};
+
+    return details::reduceContainer<DataStatistics>(
+        data,
+        [](const decltype(details::elementTypeOf(data))* ptr, size_t n) {
+            return details::rangeStatistics(ptr, n);
+        },
+        [](const DataStatistics& a, const DataStatistics& b) {
+            return DataStatistics::combined(a, b);
+        });
+}
+
+/*!
+ * Same as statistics(), but the result is cached on \a data. As long as \a data is not modified,
+ * subsequent calls return the cached statistics without scanning the data again.
+ *
+ * The cache is invalidated whenever non-const access to the data is requested, e.g. through
+ * `data()`, `rawData()`, `operator()` or any of the arithmetic assignment operators. Note that
+ * modifications through pointers or references that had been obtained *before* the statistics were
+ * cached can not be detected; request them again after caching.
+ *
+ * For SingleViewData and ProjectionData, the statistics are cached per module.
+ */
+template <class Container>
+DataStatistics cachedStatistics(const Container& data)
+{
+    return details::cachedStatisticsOf(data);
+}
+
+/*!
+ * Returns the histogram of all values in \a data with \a nbBins equidistant bins within the
+ * interval [\a lower, \a upper]. Bin `i` counts the values in
+ * [\a lower + i * w, \a lower + (i+1) * w), where w = (\a upper - \a lower) / \a nbBins; the
+ * largest bin also includes \a upper. Values outside the interval (and NaNs) are not counted.
+ *
+ * Throws std::domain_error if \a nbBins is zero or \a upper is less than \a lower.
+ */
+template <class Container>
+std::vector<size_t> histogram(const Container& data, uint nbBins, double lower, double upper)
+{
+    if(nbBins == 0)
+        throw std::domain_error("reduction::histogram: number of bins must be positive");
+    if(!(upper >= lower))
+        throw std::domain_error("reduction::histogram: invalid interval");
+
+    return details::histogram(data, details::HistogramBinning(nbBins, lower, upper));
+}
+
+/*!
+ * Returns the histogram of all values in \a data with \a nbBins equidistant bins between the
+ * smallest and the largest value in \a data. The range is taken from cachedStatistics().
+ */
+template <class Container>
+std::vector<size_t> histogram(const Container& data, uint nbBins)
+{
+    const auto stats = cachedStatistics(data);
+    return histogram(data, nbBins, stats.min, stats.max);
+}
+
+/*!
+ * Returns the \a percent-th percentile of the values in \a data, i.e. the value of rank
+ * `round(percent / 100 * (N - 1))` among all N values sorted in ascending order (nearest rank).
+ * Hence, `percentile(data, 0.0)` is the minimum, `percentile(data, 50.0)` the median and
+ * `percentile(data, 100.0)` the maximum.
+ *
+ * The result is exact. It is determined by successively narrowing down the value range with
+ * histograms (a few parallel passes over the data) and a final selection among the (few) remaining
+ * candidates. No copy of the entire data is required.
+ *
+ * Throws std::domain_error if \a data is empty or \a percent is not within [0, 100].
+ */
+template <class Container>
+double percentile(const Container& data, double percent)
+{
+    if(!(percent >= 0.0 && percent <= 100.0))
+        throw std::domain_error("reduction::percentile: percent must be within [0, 100]");
+
+    const auto nbElements = details::elementwiseLayout(data).nbElements();
+    if(nbElements == 0)
+        throw std::domain_error("reduction::percentile: empty data");
+
+    const auto rank = size_t(std::round(percent / 100.0 * double(nbElements - 1)));
+
+    auto range = minMax(data);
+    size_t nbBelow = 0; // number of values less than `range.first`
+    while(range.first < range.second)
+    {
+        const details::HistogramBinning binning(details::PERCENTILE_NB_BINS, range.first,
+                                                range.second);
+        const auto counts = details::histogram(data, binning);
+
+        // find the bin that contains `rank`
+        size_t bin = 0;
+        while(bin < binning.lastBin && nbBelow + counts[bin] <= rank)
+            nbBelow += counts[bin++];
+
+        if(counts[bin] <= details::PERCENTILE_MAX_GATHERED_VALUES)
+        {
+            auto candidates = details::binValues(data, binning, bin);
+            if(candidates.empty()) // only if data contains NaNs
+                return binning.upper;
+
+            const auto nth = candidates.begin()
+                + std::min(rank - nbBelow, candidates.size() - 1);
+            std::nth_element(candidates.begin(), nth, candidates.end());
+            return *nth;
+        }
+
+        // too many candidates: continue with the value range of the bin
+        range = details::binMinMax(data, binning, bin);
+    }
+
+    return range.first;
+}
+
+} // namespace reduction
+
+} // namespace CTL
@@ -1,4 +1,5 @@
 #include "spectralvolumedata.h"
+#include "elementwise.h"
 #include "io/ctldatabase.h"
 #include "models/stepfunctionmodels.h"
 #include <cmath>
@@ -531,12 +532,14 @@ SpectralVolumeData SpectralVolumeData::fromHUVolume(VoxelVolume<float> HUValues,
 
     constexpr auto HUscaleFactor = 1000.0f;
 
-    // transform to attenuation values
-    auto muWater = database::attenuationModel(database::Composite::Water)->valueAt(referenceEnergy);
-    HUValues = (HUValues*(muWater/HUscaleFactor)) + muWater;
-
-    // transform to densities (g/cm^3)
-    HUValues /= absorptionModel->valueAt(referenceEnergy);
+    // transform to attenuation values and subsequently to densities (g/cm^3)
+    const auto muWater =
+        database::attenuationModel(database::Composite::Water)->valueAt(referenceEnergy);
+    const auto muMaterial = absorptionModel->valueAt(referenceEnergy);
+    const auto scaleFactor = muWater / HUscaleFactor;
+    elementwise::apply(HUValues, [muWater, muMaterial, scaleFactor](float hu) {
+        return (hu * scaleFactor + muWater) / muMaterial;
+    });
 
     return SpectralVolumeData(std::move(HUValues), absorptionModel, absorptionModel->name());
 }
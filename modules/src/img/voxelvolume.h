@@ -72,13 +72,13 @@ public:
                 float zSize,
                 std::vector<T> data);
 
-    VoxelVolume(const VoxelVolume&) = default;
-    VoxelVolume(VoxelVolume&&) = default;
-    VoxelVolume& operator=(const VoxelVolume&) = default;
-    VoxelVolume& operator=(VoxelVolume&&) = default;
+    VoxelVolume(const VoxelVolume& other);
+    VoxelVolume(VoxelVolume&&) noexcept = default;
+    VoxelVolume& operator=(const VoxelVolume& other);
+    VoxelVolume& operator=(VoxelVolume&& other) noexcept;
 
     // dtor (virtual)
-    virtual ~VoxelVolume() = default;
+    virtual ~VoxelVolume();
 
     // factory
     static VoxelVolume<T> fromChunk2DStack(const std::vector<Chunk2D<T>>& stack);
@@ -125,6 +125,7 @@ public:
     Chunk2D<T> sliceY(uint slice) const;
     Chunk2D<T> sliceZ(uint slice) const;
     float smallestVoxelSize() const;
+    const details::DataStatisticsCache& statisticsCache() const;
 
     typename std::vector<T>::reference operator()(uint x, uint y, uint z);
     typename std::vector<T>::const_reference operator()(uint x, uint y, uint z) const;
@@ -155,6 +156,8 @@ private:
 
     template <class Function>
     void parallelExecution(const Function& f) const;
+
+    details::DataStatisticsCache _statsCache; //!< see reduction::cachedStatistics()
 };
 
 /*!
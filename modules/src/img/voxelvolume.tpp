@@ -134,6 +134,62 @@ VoxelVolume<T>::VoxelVolume(uint nbVoxelX,
     setData(std::move(data));
 }
 
+/*!
+ * Constructs a copy of \a other. The memory for the data is drawn from the BufferPool (if
+ * enabled).
+ */
+template <typename T>
+VoxelVolume<T>::VoxelVolume(const VoxelVolume& other)
+    : _dim(other._dim)
+    , _size(other._size)
+    , _offset(other._offset)
+    , _data(BufferPool<T>::instance().copyOf(other._data))
+{
+}
+
+/*!
+ * Assigns a copy of \a other to this instance. If the memory of this instance is insufficient, it
+ * is replaced by memory from the BufferPool (if enabled).
+ */
+template <typename T>
+VoxelVolume<T>& VoxelVolume<T>::operator=(const VoxelVolume& other)
+{
+    _statsCache.invalidate();
+    BufferPool<T>::instance().assign(_data, other._data);
+    _dim = other._dim;
+    _size = other._size;
+    _offset = other._offset;
+    return *this;
+}
+
+/*!
+ * Move-assigns \a other to this instance. The former data of this instance is returned to the
+ * BufferPool (if enabled).
+ */
+template <typename T>
+VoxelVolume<T>& VoxelVolume<T>::operator=(VoxelVolume&& other) noexcept
+{
+    if(this != &other)
+    {
+        _statsCache.invalidate();
+        BufferPool<T>::instance().recycle(_data);
+        _data = std::move(other._data);
+        _dim = other._dim;
+        _size = other._size;
+        _offset = other._offset;
+    }
+    return *this;
+}
+
+/*!
+ * Destroys the volume. Its data is returned to the BufferPool (if enabled).
+ */
+template <typename T>
+VoxelVolume<T>::~VoxelVolume()
+{
+    BufferPool<T>::instance().recycle(_data);
+}
+
 /*!
  * Constructs a voxelized volume from a stack of slices (vector of Chunk2D). All slices in \a stack
  * will be concatenated in *z*-direction.
@@ -184,7 +240,7 @@ VoxelVolume<T> VoxelVolume<T>::cube(uint nbVoxel, float voxelSize, const T& fill
     const Dimensions dim{ nbVoxel, nbVoxel, nbVoxel };
 
     return { dim, { voxelSize, voxelSize, voxelSize },
-             std::vector<T>(dim.totalNbElements(), fillValue) };
+             BufferPool<T>::instance().filled(dim.totalNbElements(), fillValue) };
 }
 
 /*!
@@ -299,8 +355,8 @@ void VoxelVolume<T>::setVoxelSize(float isotropicSize)
 template <typename T>
 void VoxelVolume<T>::freeMemory()
 {
-    _data.clear();
-    _data.shrink_to_fit();
+    _statsCache.invalidate();
+    BufferPool<T>::instance().recycle(_data);
 }
 
 /*!
@@ -309,6 +365,7 @@ void VoxelVolume<T>::freeMemory()
 template <typename T>
 typename std::vector<T>::reference VoxelVolume<T>::operator()(uint x, uint y, uint z)
 {
+    _statsCache.invalidate();
     const auto voxPerSlice = size_t(_dim.x) * size_t(_dim.y);
     const auto voxPerLine = size_t(_dim.x);
     const auto lup = size_t(z) * voxPerSlice + size_t(y) * voxPerLine + size_t(x);
@@ -478,7 +535,7 @@ T VoxelVolume<T>::max() const
     if(allocatedElements() == 0)
         return T(0);
 
-    return *std::max_element(_data.cbegin(), _data.cend());
+    return details::parallelMinMax(_data.data(), _data.size()).second;
 }
 
 /*!
@@ -490,7 +547,7 @@ T VoxelVolume<T>::min() const
     if(allocatedElements() == 0)
         return T(0);
 
-    return *std::min_element(_data.cbegin(), _data.cend());
+    return details::parallelMinMax(_data.data(), _data.size()).first;
 }
 
 // operators
@@ -503,7 +560,8 @@ T VoxelVolume<T>::min() const
  */
 template <typename T>
 VoxelVolume<T>& VoxelVolume<T>::operator+=(const VoxelVolume<T>& other)
-{    
+{
+    _statsCache.invalidate();
     Q_ASSERT(dimensions() == other.dimensions());
     if(dimensions() != other.dimensions())
         throw std::domain_error("Inconsistent dimensions of VoxelVolumes in '+=' operation.");
@@ -532,6 +590,7 @@ VoxelVolume<T>& VoxelVolume<T>::operator+=(const VoxelVolume<T>& other)
 template <typename T>
 VoxelVolume<T>& VoxelVolume<T>::operator-=(const VoxelVolume<T>& other)
 {
+    _statsCache.invalidate();
     Q_ASSERT(dimensions() == other.dimensions());
     if(dimensions() != other.dimensions())
         throw std::domain_error("Inconsistent dimensions of VoxelVolumes in '-=' operation.");
@@ -556,6 +615,7 @@ VoxelVolume<T>& VoxelVolume<T>::operator-=(const VoxelVolume<T>& other)
 template <typename T>
 VoxelVolume<T>& VoxelVolume<T>::operator+=(const T& additiveShift)
 {
+    _statsCache.invalidate();
     const auto dataIt = _data.begin();
 
     auto threadTask = [dataIt, additiveShift](size_t begin, size_t end)
@@ -576,6 +636,7 @@ VoxelVolume<T>& VoxelVolume<T>::operator+=(const T& additiveShift)
 template <typename T>
 VoxelVolume<T>& VoxelVolume<T>::operator-=(const T& subtractiveShift)
 {
+    _statsCache.invalidate();
     const auto dataIt = _data.begin();
 
     auto threadTask = [dataIt, subtractiveShift](size_t begin, size_t end)
@@ -595,6 +656,7 @@ VoxelVolume<T>& VoxelVolume<T>::operator-=(const T& subtractiveShift)
 template <typename T>
 VoxelVolume<T>& VoxelVolume<T>::operator*=(const T& factor)
 {
+    _statsCache.invalidate();
     const auto dataIt = _data.begin();
 
     auto threadTask = [dataIt, factor](size_t begin, size_t end)
@@ -614,6 +676,7 @@ VoxelVolume<T>& VoxelVolume<T>::operator*=(const T& factor)
 template <typename T>
 VoxelVolume<T>& VoxelVolume<T>::operator/=(const T& divisor)
 {
+    _statsCache.invalidate();
     const auto dataIt = _data.begin();
 
     auto threadTask = [dataIt, divisor](size_t begin, size_t end)
@@ -801,7 +864,7 @@ size_t VoxelVolume<T>::allocatedElements() const
 template <typename T>
 void VoxelVolume<T>::allocateMemory()
 {
-    _data.resize(totalVoxelCount());
+    allocateMemory(T());
 }
 
 /*!
@@ -813,7 +876,11 @@ void VoxelVolume<T>::allocateMemory()
 template <typename T>
 void VoxelVolume<T>::allocateMemory(const T& initValue)
 {
-    _data.resize(totalVoxelCount(), initValue);
+    _statsCache.invalidate();
+    if(_data.empty())
+        _data = BufferPool<T>::instance().filled(totalVoxelCount(), initValue);
+    else
+        _data.resize(totalVoxelCount(), initValue);
 }
 
 /*!
@@ -824,6 +891,13 @@ void VoxelVolume<T>::allocateMemory(const T& initValue)
 template <typename T>
 void VoxelVolume<T>::fill(const T &fillValue)
 {
+    _statsCache.invalidate();
+    if(_data.empty())
+    {
+        _data = BufferPool<T>::instance().filled(totalVoxelCount(), fillValue);
+        return;
+    }
+
     if(allocatedElements() != totalVoxelCount())
         allocateMemory();
 
@@ -854,6 +928,7 @@ const std::vector<T>& VoxelVolume<T>::data() const
 template <typename T>
 std::vector<T>& VoxelVolume<T>::data()
 {
+    _statsCache.invalidate();
     return _data;
 }
 
@@ -896,6 +971,7 @@ const typename VoxelVolume<T>::Offset& VoxelVolume<T>::offset() const
 template <typename T>
 T* VoxelVolume<T>::rawData()
 {
+    _statsCache.invalidate();
     return _data.data();
 }
 
@@ -938,6 +1014,16 @@ float VoxelVolume<T>::smallestVoxelSize() const
     return std::min(std::min(_size.x, _size.y), _size.z);
 }
 
+/*!
+ * Returns the cache for the statistics of this volume (see reduction::cachedStatistics()). The
+ * cache is invalidated by all non-const methods that provide access to the data.
+ */
+template <typename T>
+const details::DataStatisticsCache& VoxelVolume<T>::statisticsCache() const
+{
+    return _statsCache;
+}
+
 /*!
  * Sets the offset of the volume to \a offset. This is expected to be specified in millimeter.
  */
@@ -994,6 +1080,7 @@ const typename VoxelVolume<T>::Dimensions& VoxelVolume<T>::dimensions() const
 template <typename T>
 void VoxelVolume<T>::setData(std::vector<T>&& data)
 {
+    _statsCache.invalidate();
     if(!hasEqualSizeAs(data))
         throw std::domain_error("data vector has incompatible size for VoxelVolume");
 
@@ -1007,10 +1094,11 @@ void VoxelVolume<T>::setData(std::vector<T>&& data)
 template <typename T>
 void VoxelVolume<T>::setData(const std::vector<T>& data)
 {
+    _statsCache.invalidate();
     if(!hasEqualSizeAs(data))
         throw std::domain_error("data vector has incompatible size for VoxelVolume");
 
-    _data = data;
+    BufferPool<T>::instance().assign(_data, data);
 }
 
 /*!
@@ -2,6 +2,8 @@
 #define CTL_BASETYPEIO_H
 
 #include "abstractbasetypeio.h"
+#include "rawfilewriter.h"
+#include <QStringList>
 #include <memory>
 
 namespace CTL {
@@ -61,6 +63,17 @@ namespace io {
  * \li write(): write all data from an std::vector (which contains row-major order sequential data)
  * to a file. This also includes writing all meta information passed in \a metaInfo that is
  * supported by the file type.
+ *
+ * Large volumes and projection data can be written with writeParallel(), which streams the data
+ * directly from the memory of the container using multiple threads and (optionally) direct I/O
+ * (see RawFileWriter). writeSharded() splits projection data into multiple files with a fixed
+ * number of views each. Both require the FileIOImplementer to provide the header of raw encoded
+ * files (`template <typename T> QByteArray rawDataHeader(const QVariantMap& metaInfo) const`);
+ * otherwise, they fall back to the regular write() method.
+ *
+ * For sequential access to individual slices or views of a single file (e.g. view by view in a
+ * reconstruction loop), use a PrefetchingReader (see makePrefetchingReader()). It parses the meta
+ * information only once and reads the subsequent chunks on a background thread.
  */
 
 // generalized version (preferred)
@@ -102,6 +115,18 @@ public:
     bool write(const FullGeometry& data, const QString& fileName,
                QVariantMap supplementaryMetaInfo = {}) const;
 
+    // ### PARALLEL WRITING (raw data streams) ###
+    template <typename T>
+    bool writeParallel(const VoxelVolume<T>& data, const QString& fileName,
+                       QVariantMap supplementaryMetaInfo = {},
+                       const RawFileWriter& writer = RawFileWriter()) const;
+    bool writeParallel(const ProjectionData& data, const QString& fileName,
+                       QVariantMap supplementaryMetaInfo = {},
+                       const RawFileWriter& writer = RawFileWriter()) const;
+    QStringList writeSharded(const ProjectionData& data, const QString& fileName,
+                             uint nbViewsPerShard, QVariantMap supplementaryMetaInfo = {},
+                             const RawFileWriter& writer = RawFileWriter()) const;
+
     // ### IMPLEMENTATION OF ABSTRACT TYPES ###
     class MetaInfoReader : public AbstractMetaInfoReader
     {
@@ -153,17 +178,32 @@ public:
     static auto makeProjectionDataIO() -> std::unique_ptr<ProjectionDataIO>;
     static auto makeProjectionMatrixIO() -> std::unique_ptr<ProjectionMatrixIO>;
 
+    // ### STATEFUL READER FOR SEQUENTIAL ACCESS ###
+    template <typename T>
+    class PrefetchingReader;
+    template <typename T>
+    static auto makePrefetchingReader(const QString& fileName, uint nbPrefetchedChunks = 4)
+        -> std::unique_ptr<PrefetchingReader<T>>;
+
 private:
     FileIOImplementer _implementer;
 
     ProjectionData::Dimensions dimensionsFromMetaInfo(const QVariantMap& info, uint nbModules = 0) const;
     QVariantMap fusedMetaInfo(const QVariantMap& baseInfo, QVariantMap supplementary) const;
+    bool writeViews(const ProjectionData& data, uint firstView, uint nbViews,
+                    const QVariantMap& metaInfo, const QString& fileName,
+                    const RawFileWriter& writer) const;
+
+    template <typename T>
+    static QVariantMap volumeMetaInfo(const VoxelVolume<T>& data);
+    static QVariantMap projectionMetaInfo(const SingleViewData::Dimensions& viewDim, uint nbViews);
 };
 
 } // namespace io
 } // namespace CTL
 
 #include "io/basetypeio.tpp"
+#include "io/prefetchingreader.tpp"
 
 /*! \file */
 ///@{
@@ -1,10 +1,48 @@
 #include "basetypeio.h"
 #include "metainfokeys.h"
+#include "tracer.h"
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
 
 namespace CTL {
 namespace io {
 
+namespace details {
+
+template <typename...>
+struct MakeVoid { typedef void type; };
+
+/*
+ * Provides the header of a raw encoded file for the parallel write functions of BaseTypeIO. This
+ * generic version returns an empty header, i.e. the file format does not support writing of raw
+ * data streams. If the FileIOImplementer provides a method
+ * `template <typename T> QByteArray rawDataHeader(const QVariantMap& metaInfo) const`, the
+ * specialization below forwards to this method.
+ */
+template <class FileIOImplementer, typename T, typename Enable = void>
+struct RawDataHeaderOf
+{
+    static QByteArray get(const FileIOImplementer&, const QVariantMap&) { return {}; }
+};
+
+template <class FileIOImplementer, typename T>
+struct RawDataHeaderOf<FileIOImplementer, T,
+                       typename MakeVoid<decltype(std::declval<const FileIOImplementer&>()
+                                                      .template rawDataHeader<T>(
+                                                          std::declval<const QVariantMap&>()))>::type>
+{
+    static QByteArray get(const FileIOImplementer& implementer, const QVariantMap& metaInfo)
+    {
+        return implementer.template rawDataHeader<T>(metaInfo);
+    }
+};
+
+} // namespace details
+
 // ####### implementation for generalized version ########
 
 /*!
@@ -19,6 +57,8 @@ template <class FileIOImplementer>
 template <typename T>
 VoxelVolume<T> BaseTypeIO<FileIOImplementer>::readVolume(const QString& fileName) const
 {
+    CTL_TRACE_SPAN("io", "BaseTypeIO::readVolume");
+
     QVariantMap metaInfo = _implementer.metaInfo(fileName);
     auto dimList = metaInfo.value(meta_info::dimensions).value<meta_info::Dimensions>();
 
@@ -52,6 +92,8 @@ template <class FileIOImplementer>
 template <typename T>
 Chunk2D<T> BaseTypeIO<FileIOImplementer>::readSlice(const QString& fileName, uint sliceNb) const
 {
+    CTL_TRACE_SPAN("io", "BaseTypeIO::readSlice");
+
     QVariantMap metaInfo = _implementer.metaInfo(fileName);
     auto dimList = metaInfo.value(meta_info::dimensions).value<meta_info::Dimensions>();
 
@@ -106,6 +148,8 @@ template <class FileIOImplementer>
 ProjectionData BaseTypeIO<FileIOImplementer>::readProjections(const QString& fileName,
                                                               uint nbModules) const
 {
+    CTL_TRACE_SPAN("io", "BaseTypeIO::readProjections");
+
     QVariantMap metaInfo = _implementer.metaInfo(fileName);
     auto dim = dimensionsFromMetaInfo(metaInfo, nbModules);
 
@@ -132,6 +176,8 @@ SingleViewData BaseTypeIO<FileIOImplementer>::readSingleView(const QString& file
                                                              uint viewNb,
                                                              uint nbModules) const
 {
+    CTL_TRACE_SPAN("io", "BaseTypeIO::readSingleView");
+
     QVariantMap metaInfo = _implementer.metaInfo(fileName);
     const auto dim = dimensionsFromMetaInfo(metaInfo, nbModules);
 
@@ -272,23 +318,9 @@ bool BaseTypeIO<FileIOImplementer>::write(const VoxelVolume<T>& data,
                                           const QString& fileName,
                                           QVariantMap supplementaryMetaInfo) const
 {
-    QVariantMap metaInfo;
-    meta_info::Dimensions dimensions{ data.nbVoxels().x,
-                                      data.nbVoxels().y,
-                                      data.nbVoxels().z };
-    metaInfo.insert(meta_info::dimensions, QVariant::fromValue(dimensions));
-    metaInfo.insert(meta_info::dim1Type, meta_info::nbVoxelsX);
-    metaInfo.insert(meta_info::dim2Type, meta_info::nbVoxelsY);
-    metaInfo.insert(meta_info::dim3Type, meta_info::nbVoxelsZ);
-    metaInfo.insert(meta_info::voxSizeX, QVariant(data.voxelSize().x));
-    metaInfo.insert(meta_info::voxSizeY, QVariant(data.voxelSize().y));
-    metaInfo.insert(meta_info::voxSizeZ, QVariant(data.voxelSize().z));
-    metaInfo.insert(meta_info::volOffX, QVariant(data.offset().x));
-    metaInfo.insert(meta_info::volOffY, QVariant(data.offset().y));
-    metaInfo.insert(meta_info::volOffZ, QVariant(data.offset().z));
-    metaInfo.insert(meta_info::typeHint, meta_info::type_hint::volume);
+    CTL_TRACE_SPAN("io", "BaseTypeIO::write(VoxelVolume)");
 
-    metaInfo = fusedMetaInfo(metaInfo, std::move(supplementaryMetaInfo));
+    const auto metaInfo = fusedMetaInfo(volumeMetaInfo(data), std::move(supplementaryMetaInfo));
 
     return _implementer.write(data.constData(), metaInfo, fileName);
 }
@@ -344,19 +376,10 @@ bool BaseTypeIO<FileIOImplementer>::write(const ProjectionData& data,
                                           const QString& fileName,
                                           QVariantMap supplementaryMetaInfo) const
 {
-    QVariantMap metaInfo;
-    meta_info::Dimensions dimensions{ data.dimensions().nbChannels,
-                                      data.dimensions().nbRows,
-                                      data.dimensions().nbModules,
-                                      data.dimensions().nbViews };
-    metaInfo.insert(meta_info::dimensions, QVariant::fromValue(dimensions));
-    metaInfo.insert(meta_info::dim1Type, meta_info::nbChans);
-    metaInfo.insert(meta_info::dim2Type, meta_info::nbRows);
-    metaInfo.insert(meta_info::dim3Type, meta_info::nbMods);
-    metaInfo.insert(meta_info::dim4Type, meta_info::nbViews);
-    metaInfo.insert(meta_info::typeHint, meta_info::type_hint::projection);
+    CTL_TRACE_SPAN("io", "BaseTypeIO::write(ProjectionData)");
 
-    metaInfo = fusedMetaInfo(metaInfo, std::move(supplementaryMetaInfo));
+    const auto metaInfo = fusedMetaInfo(projectionMetaInfo(data.viewDimensions(), data.nbViews()),
+                                        std::move(supplementaryMetaInfo));
 
     return _implementer.write(data.toVector(), metaInfo, fileName);
 }
@@ -449,6 +472,217 @@ bool BaseTypeIO<FileIOImplementer>::write(const FullGeometry& data,
     return _implementer.write(dataVec, metaInfo, fileName);
 }
 
+/*!
+ * Writes data from the VoxelVolume<T> \a data to the file \a fileName using the RawFileWriter
+ * \a writer, i.e. with multiple threads and (optionally) direct I/O.
+ *
+ * The voxel data is written directly from the memory of \a data without creating an intermediate
+ * copy. Meta information is forwarded in the same way as in write(const VoxelVolume<T>&, ...) and
+ * the resulting file is identical to the file created by write().
+ *
+ * This requires the FileIOImplementer to provide the header of a raw encoded file by a method
+ * \code
+ * template <typename T>
+ * QByteArray rawDataHeader(const QVariantMap& metaInfo) const;
+ * \endcode
+ * If this method is not available or returns an empty header (e.g. because a compressed encoding has
+ * been requested by \a supplementaryMetaInfo), the data is written by the regular write() method.
+ */
+template <class FileIOImplementer>
+template <typename T>
+bool BaseTypeIO<FileIOImplementer>::writeParallel(const VoxelVolume<T>& data,
+                                                  const QString& fileName,
+                                                  QVariantMap supplementaryMetaInfo,
+                                                  const RawFileWriter& writer) const
+{
+    CTL_TRACE_SPAN("io", "BaseTypeIO::writeParallel(VoxelVolume)");
+
+    const auto metaInfo = fusedMetaInfo(volumeMetaInfo(data), std::move(supplementaryMetaInfo));
+
+    const auto header = details::RawDataHeaderOf<FileIOImplementer, T>::get(_implementer, metaInfo);
+    if(header.isEmpty() || data.constData().size() != data.totalVoxelCount())
+        return _implementer.write(data.constData(), metaInfo, fileName);
+
+    return writer.write(fileName,
+                        { { header.constData(), size_t(header.size()) },
+                          { reinterpret_cast<const char*>(data.rawData()),
+                            data.totalVoxelCount() * sizeof(T) } });
+}
+
+/*!
+ * Writes data from the ProjectionData \a data to the file \a fileName using the RawFileWriter
+ * \a writer, i.e. with multiple threads and (optionally) direct I/O.
+ *
+ * The data of all views and modules is written directly from the memory of \a data without
+ * assembling it in an intermediate buffer (as done by toVector() in write()). Meta information is
+ * forwarded in the same way as in write(const ProjectionData&, ...) and the resulting file is
+ * identical to the file created by write().
+ *
+ * If the FileIOImplementer does not support writing of raw data streams (see
+ * writeParallel(const VoxelVolume<T>&, ...)), the data is written by the regular write() method.
+ */
+template <class FileIOImplementer>
+bool BaseTypeIO<FileIOImplementer>::writeParallel(const ProjectionData& data,
+                                                  const QString& fileName,
+                                                  QVariantMap supplementaryMetaInfo,
+                                                  const RawFileWriter& writer) const
+{
+    CTL_TRACE_SPAN("io", "BaseTypeIO::writeParallel(ProjectionData)");
+
+    const auto metaInfo = fusedMetaInfo(projectionMetaInfo(data.viewDimensions(), data.nbViews()),
+                                        std::move(supplementaryMetaInfo));
+
+    return writeViews(data, 0, data.nbViews(), metaInfo, fileName, writer);
+}
+
+/*!
+ * Writes data from the ProjectionData \a data to multiple files, each of which contains (at most)
+ * \a nbViewsPerShard consecutive views. Returns the names of the written files.
+ *
+ * The file names are created from \a fileName by appending the (zero-padded) index of the shard to
+ * the base name, e.g. "projections_0000.nrrd", "projections_0001.nrrd", ... for \a fileName =
+ * "projections.nrrd". Each shard is a complete file of the format of the FileIOImplementer, i.e. it
+ * can be read with readProjections(). In addition to the meta information forwarded by
+ * write(const ProjectionData&, ...), each shard holds the index of its first view in the full data
+ * set (key: meta_info::firstView).
+ *
+ * The individual shards are written with writeParallel() using the RawFileWriter \a writer.
+ *
+ * Returns an empty list if writing of any shard fails.
+ * Throws std::domain_error if \a nbViewsPerShard is zero.
+ */
+template <class FileIOImplementer>
+QStringList BaseTypeIO<FileIOImplementer>::writeSharded(const ProjectionData& data,
+                                                        const QString& fileName,
+                                                        uint nbViewsPerShard,
+                                                        QVariantMap supplementaryMetaInfo,
+                                                        const RawFileWriter& writer) const
+{
+    CTL_TRACE_SPAN("io", "BaseTypeIO::writeSharded");
+
+    if(nbViewsPerShard == 0)
+        throw std::domain_error("BaseTypeIO::writeSharded: number of views per shard must be "
+                                "greater than zero.");
+
+    const QFileInfo fileInfo(fileName);
+    const auto suffix = fileInfo.suffix().isEmpty() ? QString() : QLatin1Char('.') + fileInfo.suffix();
+
+    QStringList ret;
+    for(uint firstView = 0, shard = 0; firstView < data.nbViews();
+        firstView += nbViewsPerShard, ++shard)
+    {
+        const auto nbViews = std::min(nbViewsPerShard, data.nbViews() - firstView);
+        const auto shardName = fileInfo.dir().filePath(fileInfo.completeBaseName() + QLatin1Char('_')
+                                                       + QString::number(shard).rightJustified(4, '0')
+                                                       + suffix);
+
+        auto supplementary = supplementaryMetaInfo;
+        supplementary.insert(meta_info::firstView, firstView);
+        const auto metaInfo = fusedMetaInfo(projectionMetaInfo(data.viewDimensions(), nbViews),
+                                            std::move(supplementary));
+
+        if(!writeViews(data, firstView, nbViews, metaInfo, shardName, writer))
+            return {};
+
+        ret.append(shardName);
+    }
+
+    return ret;
+}
+
+/*!
+ * Writes the views \a firstView, ..., \a firstView + \a nbViews - 1 of \a data to the file
+ * \a fileName. The data is streamed from the memory of the individual modules by \a writer if the
+ * FileIOImplementer provides a header for raw data; otherwise, the data is collected in a single
+ * vector and passed to the write() method of the FileIOImplementer.
+ */
+template <class FileIOImplementer>
+bool BaseTypeIO<FileIOImplementer>::writeViews(const ProjectionData& data,
+                                               uint firstView,
+                                               uint nbViews,
+                                               const QVariantMap& metaInfo,
+                                               const QString& fileName,
+                                               const RawFileWriter& writer) const
+{
+    const auto nbModules = data.viewDimensions().nbModules;
+    const auto header = details::RawDataHeaderOf<FileIOImplementer, float>::get(_implementer,
+                                                                              metaInfo);
+    if(header.isEmpty())
+    {
+        std::vector<float> dataVec;
+        dataVec.reserve(data.viewDimensions().totalNbElements() * nbViews);
+        for(auto view = firstView; view < firstView + nbViews; ++view)
+            for(uint module = 0; module < nbModules; ++module)
+                dataVec.insert(dataVec.end(), data.view(view).module(module).constData().cbegin(),
+                               data.view(view).module(module).constData().cend());
+
+        return _implementer.write(dataVec, metaInfo, fileName);
+    }
+
+    std::vector<RawFileWriter::Segment> segments;
+    segments.reserve(1u + nbViews * nbModules);
+    segments.push_back({ header.constData(), size_t(header.size()) });
+    for(auto view = firstView; view < firstView + nbViews; ++view)
+        for(uint module = 0; module < nbModules; ++module)
+        {
+            const auto& moduleData = data.view(view).module(module).constData();
+            segments.push_back({ reinterpret_cast<const char*>(moduleData.data()),
+                                 moduleData.size() * sizeof(float) });
+        }
+
+    return writer.write(fileName, segments);
+}
+
+/*!
+ * Returns the meta information of the VoxelVolume \a data that is forwarded to the
+ * FileIOImplementer (see write(const VoxelVolume<T>&, ...)).
+ */
+template <class FileIOImplementer>
+template <typename T>
+QVariantMap BaseTypeIO<FileIOImplementer>::volumeMetaInfo(const VoxelVolume<T>& data)
+{
+    QVariantMap metaInfo;
+    meta_info::Dimensions dimensions{ data.nbVoxels().x,
+                                      data.nbVoxels().y,
+                                      data.nbVoxels().z };
+    metaInfo.insert(meta_info::dimensions, QVariant::fromValue(dimensions));
+    metaInfo.insert(meta_info::dim1Type, meta_info::nbVoxelsX);
+    metaInfo.insert(meta_info::dim2Type, meta_info::nbVoxelsY);
+    metaInfo.insert(meta_info::dim3Type, meta_info::nbVoxelsZ);
+    metaInfo.insert(meta_info::voxSizeX, QVariant(data.voxelSize().x));
+    metaInfo.insert(meta_info::voxSizeY, QVariant(data.voxelSize().y));
+    metaInfo.insert(meta_info::voxSizeZ, QVariant(data.voxelSize().z));
+    metaInfo.insert(meta_info::volOffX, QVariant(data.offset().x));
+    metaInfo.insert(meta_info::volOffY, QVariant(data.offset().y));
+    metaInfo.insert(meta_info::volOffZ, QVariant(data.offset().z));
+    metaInfo.insert(meta_info::typeHint, meta_info::type_hint::volume);
+
+    return metaInfo;
+}
+
+/*!
+ * Returns the meta information of projection data with \a nbViews views of dimensions \a viewDim
+ * that is forwarded to the FileIOImplementer (see write(const ProjectionData&, ...)).
+ */
+template <class FileIOImplementer>
+QVariantMap BaseTypeIO<FileIOImplementer>::projectionMetaInfo(const SingleViewData::Dimensions& viewDim,
+                                                              uint nbViews)
+{
+    QVariantMap metaInfo;
+    meta_info::Dimensions dimensions{ viewDim.nbChannels,
+                                      viewDim.nbRows,
+                                      viewDim.nbModules,
+                                      nbViews };
+    metaInfo.insert(meta_info::dimensions, QVariant::fromValue(dimensions));
+    metaInfo.insert(meta_info::dim1Type, meta_info::nbChans);
+    metaInfo.insert(meta_info::dim2Type, meta_info::nbRows);
+    metaInfo.insert(meta_info::dim3Type, meta_info::nbMods);
+    metaInfo.insert(meta_info::dim4Type, meta_info::nbViews);
+    metaInfo.insert(meta_info::typeHint, meta_info::type_hint::projection);
+
+    return metaInfo;
+}
+
 /*!
  * Constructs a ProjectionData::Dimensions object from the meta information in \a info.
  *
@@ -1,12 +1,264 @@
 #include "binaryserializer.h"
 
 #include "serializationhelper.h"
+#include "projectors/projectionpipeline.h"
+#include "projectors/projectorextension.h"
 
 #include <QFile>
 #include <QDataStream>
+#include <QHash>
 
 namespace CTL {
 
+namespace {
+
+// header of the compact format
+const quint32 COMPACT_MAGIC_NUMBER = 0x43544C42; // "CTLB"
+const quint16 COMPACT_FORMAT_VERSION = 1;
+
+enum CompactObjectKind : quint8 { SystemObject = 1, SetupObject = 2, PipelineObject = 3 };
+
+// tags of an element
+enum CompactElementTag : quint8 { PlainVariant = 0, SchemaMap = 1 };
+
+/*
+ * Writes the elements of an object to the stream. QVariantMaps are stored as a reference to their
+ * set of keys (schema) followed by the values; each schema is stored only when it occurs first.
+ */
+class CompactWriter
+{
+public:
+    explicit CompactWriter(QDataStream& stream) : _stream(stream) {}
+
+    void writeElement(const QVariant& variant);
+    void writeSystem(const CTSystem& system);
+    void writeSetup(const AcquisitionSetup& setup);
+    void writePipeline(const ProjectionPipeline& pipeline);
+
+private:
+    QDataStream& _stream;
+    QHash<QString, quint32> _schemaIndices; // key: keys of a map joined with '\0'
+};
+
+// Counterpart of CompactWriter.
+class CompactReader
+{
+public:
+    explicit CompactReader(QDataStream& stream) : _stream(stream) {}
+
+    QVariant readElement();
+    std::unique_ptr<CTSystem> readSystem();
+    std::unique_ptr<AcquisitionSetup> readSetup();
+    std::unique_ptr<ProjectionPipeline> readPipeline();
+
+private:
+    QDataStream& _stream;
+    std::vector<QStringList> _schemas;
+
+    bool ok() const { return _stream.status() == QDataStream::Ok; }
+};
+
+void CompactWriter::writeElement(const QVariant& variant)
+{
+    if(variant.type() != QVariant::Map)
+    {
+        _stream << quint8(PlainVariant) << variant;
+        return;
+    }
+
+    const auto map = variant.toMap();
+    const auto keys = map.keys();
+    const auto joinedKeys = keys.join(QChar(0));
+
+    _stream << quint8(SchemaMap);
+    auto it = _schemaIndices.constFind(joinedKeys);
+    if(it == _schemaIndices.constEnd())
+    {
+        // new schema: index equals the number of known schemas and is followed by the keys
+        const auto newIdx = quint32(_schemaIndices.size());
+        _schemaIndices.insert(joinedKeys, newIdx);
+        _stream << newIdx << keys;
+    }
+    else
+        _stream << it.value();
+
+    for(auto val = map.cbegin(), end = map.cend(); val != end; ++val)
+        _stream << val.value();
+}
+
+void CompactWriter::writeSystem(const CTSystem& system)
+{
+    _stream << system.name() << quint32(system.nbComponents());
+    for(const auto& comp : system.components())
+        writeElement(comp ? comp->toVariant() : QVariant());
+}
+
+void CompactWriter::writeSetup(const AcquisitionSetup& setup)
+{
+    const auto system = setup.system();
+    _stream << quint8(system != nullptr);
+    if(system)
+        writeSystem(*system);
+
+    _stream << quint32(setup.nbViews());
+    for(const auto& view : setup.views())
+    {
+        const auto& prepSteps = view.prepareSteps();
+        _stream << view.timeStamp() << quint32(prepSteps.size());
+        for(const auto& prep : prepSteps)
+            writeElement(prep->toVariant());
+    }
+}
+
+void CompactWriter::writePipeline(const ProjectionPipeline& pipeline)
+{
+    const auto projector = pipeline.projector();
+    writeElement(pipeline.parameter());
+    writeElement(projector ? projector->toVariant() : QVariant());
+
+    // the extensions are stored without their nested projectors (restored by the pipeline)
+    _stream << quint32(pipeline.nbExtensions());
+    for(uint ext = 0, nbExt = pipeline.nbExtensions(); ext < nbExt; ++ext)
+    {
+        const auto extension = pipeline.extension(ext);
+        auto extVar = extension ? extension->toVariant().toMap() : QVariantMap();
+        extVar.remove("nested projector");
+        writeElement(extension ? QVariant(extVar) : QVariant());
+    }
+}
+
+QVariant CompactReader::readElement()
+{
+    quint8 tag;
+    _stream >> tag;
+
+    QVariant ret;
+    if(tag == PlainVariant)
+        _stream >> ret;
+    else if(tag == SchemaMap)
+    {
+        quint32 schemaIdx;
+        _stream >> schemaIdx;
+        if(schemaIdx == _schemas.size()) // new schema
+        {
+            QStringList keys;
+            _stream >> keys;
+            _schemas.push_back(keys);
+        }
+        if(!ok() || schemaIdx >= _schemas.size())
+        {
+            _stream.setStatus(QDataStream::ReadCorruptData);
+            return ret;
+        }
+
+        QVariantMap map;
+        for(const auto& key : _schemas[schemaIdx])
+        {
+            QVariant val;
+            _stream >> val;
+            map.insert(key, val);
+        }
+        ret = map;
+    }
+    else
+        _stream.setStatus(QDataStream::ReadCorruptData);
+
+    return ret;
+}
+
+std::unique_ptr<CTSystem> CompactReader::readSystem()
+{
+    QString name;
+    quint32 nbComponents;
+    _stream >> name >> nbComponents;
+
+    std::unique_ptr<CTSystem> ret(new CTSystem(name));
+    for(quint32 comp = 0; comp < nbComponents && ok(); ++comp)
+        ret->addComponent(SerializationHelper::parseComponent(readElement()));
+
+    if(!ok())
+        return nullptr;
+
+    return ret;
+}
+
+std::unique_ptr<AcquisitionSetup> CompactReader::readSetup()
+{
+    std::unique_ptr<AcquisitionSetup> ret(new AcquisitionSetup);
+
+    quint8 hasSystem;
+    _stream >> hasSystem;
+    if(hasSystem)
+    {
+        auto system = readSystem();
+        if(!system)
+            return nullptr;
+        ret->resetSystem(std::move(*system));
+    }
+    else
+        ret->resetSystem(CTSystem());
+
+    quint32 nbViews, nbPrepSteps;
+    double timeStamp;
+    _stream >> nbViews;
+    for(quint32 v = 0; v < nbViews && ok(); ++v)
+    {
+        _stream >> timeStamp >> nbPrepSteps;
+        AcquisitionSetup::View view(timeStamp);
+        for(quint32 prep = 0; prep < nbPrepSteps && ok(); ++prep)
+            view.addPrepareStep(AcquisitionSetup::PrepareStep(
+                SerializationHelper::parsePrepareStep(readElement())));
+        ret->addView(std::move(view));
+    }
+
+    if(!ok())
+        return nullptr;
+
+    return ret;
+}
+
+std::unique_ptr<ProjectionPipeline> CompactReader::readPipeline()
+{
+    std::unique_ptr<ProjectionPipeline> ret(new ProjectionPipeline);
+
+    ret->setParameter(readElement().toMap());
+    const auto projVar = readElement();
+    if(!projVar.isNull())
+        ret->setProjector(SerializationHelper::parseProjector(projVar));
+
+    quint32 nbExtensions;
+    _stream >> nbExtensions;
+    for(quint32 ext = 0; ext < nbExtensions && ok(); ++ext)
+    {
+        const auto extVar = readElement();
+        if(!extVar.isNull())
+            ret->appendExtension(
+                static_cast<ProjectorExtension*>(SerializationHelper::parseProjector(extVar)));
+    }
+
+    if(!ok())
+        return nullptr;
+
+    return ret;
+}
+
+// casts the object to `DerivedType`, returns nullptr (and destroys the object) if not possible
+template <class DerivedType>
+std::unique_ptr<DerivedType> downcast(std::unique_ptr<SerializationInterface> object)
+{
+    if(dynamic_cast<DerivedType*>(object.get()))
+        return std::unique_ptr<DerivedType>(static_cast<DerivedType*>(object.release()));
+    return nullptr;
+}
+
+} // unnamed namespace
+
+/*!
+ * Serializes \a serializableObject to the file \a fileName.
+ *
+ * CTSystem, AcquisitionSetup and ProjectionPipeline objects are written in the compact format if
+ * isCompactFormat() is `true` (default: `false`); all other objects are written as QVariant.
+ */
 void BinarySerializer::serialize(const SerializationInterface &serializableObject, const QString &fileName) const
 {
     QFile saveFile(fileName);
@@ -17,10 +269,101 @@ void BinarySerializer::serialize(const SerializationInterface &serializableObjec
         return;
     }
     QDataStream out(&saveFile);
-    out << serializableObject.toVariant();
+    if(_compactFormat && supportsCompactFormat(serializableObject))
+        writeCompact(out, serializableObject);
+    else
+        out << serializableObject.toVariant();
     saveFile.close();
 }
 
+/*!
+ * Returns `true` if CTSystem, AcquisitionSetup and ProjectionPipeline objects are serialized in the
+ * compact format.
+ */
+bool BinarySerializer::isCompactFormat() const { return _compactFormat; }
+
+/*!
+ * Sets the usage of the compact format for CTSystem, AcquisitionSetup and ProjectionPipeline
+ * objects to \a enabled. By default, the compact format is disabled. Enable it only if the files do
+ * not need to be read by a version of the CTL that does not support it.
+ */
+void BinarySerializer::setCompactFormat(bool enabled) { _compactFormat = enabled; }
+
+/*!
+ * Returns `true` if \a serializableObject can be written in the compact format, i.e. if it is a
+ * CTSystem, an AcquisitionSetup or a ProjectionPipeline.
+ */
+bool BinarySerializer::supportsCompactFormat(const SerializationInterface& serializableObject)
+{
+    return dynamic_cast<const AcquisitionSetup*>(&serializableObject) ||
+           dynamic_cast<const CTSystem*>(&serializableObject) ||
+           serializableObject.type() == ProjectionPipeline::Type;
+}
+
+/*!
+ * Writes \a serializableObject in the compact format to \a stream. Returns `false` if the type of
+ * \a serializableObject is not supported by the compact format (see supportsCompactFormat()) or
+ * if writing to the stream failed.
+ */
+bool BinarySerializer::writeCompact(QDataStream& stream,
+                                    const SerializationInterface& serializableObject)
+{
+    CompactWriter writer(stream);
+
+    if(auto setup = dynamic_cast<const AcquisitionSetup*>(&serializableObject))
+    {
+        stream << COMPACT_MAGIC_NUMBER << COMPACT_FORMAT_VERSION << quint16(stream.version())
+               << quint8(SetupObject);
+        writer.writeSetup(*setup);
+    }
+    else if(auto system = dynamic_cast<const CTSystem*>(&serializableObject))
+    {
+        stream << COMPACT_MAGIC_NUMBER << COMPACT_FORMAT_VERSION << quint16(stream.version())
+               << quint8(SystemObject);
+        writer.writeSystem(*system);
+    }
+    else if(serializableObject.type() == ProjectionPipeline::Type)
+    {
+        stream << COMPACT_MAGIC_NUMBER << COMPACT_FORMAT_VERSION << quint16(stream.version())
+               << quint8(PipelineObject);
+        writer.writePipeline(static_cast<const ProjectionPipeline&>(serializableObject));
+    }
+    else
+        return false;
+
+    return stream.status() == QDataStream::Ok;
+}
+
+/*!
+ * Reads an object in the compact format from \a stream. Returns a nullptr if the stream does not
+ * contain a valid object in the compact format.
+ */
+std::unique_ptr<SerializationInterface> BinarySerializer::readCompact(QDataStream& stream)
+{
+    quint32 magicNumber;
+    quint16 formatVersion, streamVersion;
+    quint8 kind;
+    stream >> magicNumber >> formatVersion >> streamVersion >> kind;
+    if(stream.status() != QDataStream::Ok || magicNumber != COMPACT_MAGIC_NUMBER ||
+       formatVersion > COMPACT_FORMAT_VERSION)
+        return nullptr;
+
+    stream.setVersion(streamVersion);
+    CompactReader reader(stream);
+
+    switch(kind)
+    {
+    case SystemObject:
+        return reader.readSystem();
+    case SetupObject:
+        return reader.readSetup();
+    case PipelineObject:
+        return reader.readPipeline();
+    default:
+        return nullptr;
+    }
+}
+
 std::unique_ptr<SystemComponent> BinarySerializer::deserializeComponent(const QString &fileName) const
 {
     return std::unique_ptr<SystemComponent>(
@@ -41,18 +384,27 @@ std::unique_ptr<AbstractPrepareStep> BinarySerializer::deserializePrepareStep(co
 
 std::unique_ptr<AbstractProjector> BinarySerializer::deserializeProjector(const QString& fileName) const
 {
+    if(isCompactFile(fileName))
+        return downcast<AbstractProjector>(objectFromCompactFile(fileName));
+
     return std::unique_ptr<AbstractProjector>(
                 SerializationHelper::parseProjector(variantFromBinaryFile(fileName)));
 }
 
 std::unique_ptr<SerializationInterface> BinarySerializer::deserializeMiscObject(const QString &fileName) const
 {
+    if(isCompactFile(fileName))
+        return objectFromCompactFile(fileName);
+
     return std::unique_ptr<SerializationInterface>(
                 SerializationHelper::parseMiscObject(variantFromBinaryFile(fileName)));
 }
 
 std::unique_ptr<AcquisitionSetup> BinarySerializer::deserializeAquisitionSetup(const QString &fileName) const
 {
+    if(isCompactFile(fileName))
+        return downcast<AcquisitionSetup>(objectFromCompactFile(fileName));
+
     std::unique_ptr<AcquisitionSetup> ret(new AcquisitionSetup);
 
     auto variant = variantFromBinaryFile(fileName);
@@ -65,6 +417,9 @@ std::unique_ptr<AcquisitionSetup> BinarySerializer::deserializeAquisitionSetup(c
 
 std::unique_ptr<CTSystem> BinarySerializer::deserializeSystem(const QString &fileName) const
 {
+    if(isCompactFile(fileName))
+        return downcast<CTSystem>(objectFromCompactFile(fileName));
+
     std::unique_ptr<CTSystem> ret(new CTSystem);
 
     auto variant = variantFromBinaryFile(fileName);
@@ -99,4 +454,37 @@ QVariant BinarySerializer::variantFromBinaryFile(const QString &fileName)
     return ret;
 }
 
+bool BinarySerializer::isCompactFile(const QString& fileName)
+{
+    QFile loadFile(fileName);
+    if(!loadFile.open(QIODevice::ReadOnly))
+        return false;
+
+    quint32 magicNumber = 0;
+    QDataStream in(&loadFile);
+    in >> magicNumber;
+
+    return magicNumber == COMPACT_MAGIC_NUMBER;
+}
+
+std::unique_ptr<SerializationInterface> BinarySerializer::objectFromCompactFile(const QString& fileName)
+{
+    QFile loadFile(fileName);
+    if(!loadFile.open(QIODevice::ReadOnly))
+    {
+        qWarning().noquote() << "BinarySerializer: deserializing failed. File(" + fileName +
+                                ") could not be opened.";
+        return nullptr;
+    }
+
+    QDataStream in(&loadFile);
+    auto ret = readCompact(in);
+
+    if(!ret)
+        qWarning().noquote() << "BinarySerializer: deserializing failed. File(" + fileName +
+                                ") is not a valid compact binary file.";
+
+    return ret;
+}
+
 } // namespace CTL
@@ -3,8 +3,33 @@
 
 #include "abstractserializer.h"
 
+class QDataStream;
+
 namespace CTL {
 
+/*!
+ * \class BinarySerializer
+ *
+ * \brief Serializer that stores objects in a binary file using QDataStream.
+ *
+ * By default, objects are stored by streaming their QVariant representation (see
+ * SerializationInterface::toVariant()).
+ *
+ * Optionally (see setCompactFormat()), CTSystem, AcquisitionSetup and ProjectionPipeline objects
+ * are written in a compact format instead. This format is streamed
+ * object by object and never creates the QVariant representation of the whole object. The
+ * container structure is fixed (e.g. system, views, prepare steps of each view) and the keys of
+ * the QVariantMaps of the individual elements (components, prepare steps, projectors) are stored
+ * only once per distinct key set ("schema"). This is considerably faster and smaller for setups
+ * with a large number of views. The compact format is opt-in, since files in this format cannot be
+ * read by versions of the CTL that do not support it.
+ *
+ * The deserialization functions detect the format of a file automatically. Objects read from
+ * either format are identical, i.e. they have an equal toVariant() representation.
+ *
+ * The compact format can also be used directly on an arbitrary QDataStream by means of
+ * writeCompact() and readCompact().
+ */
 class BinarySerializer : public AbstractSerializer
 {
     // implementation of serialization interface
@@ -21,8 +46,21 @@ class BinarySerializer : public AbstractSerializer
     public: std::unique_ptr<AcquisitionSetup> deserializeAquisitionSetup(const QString& fileName) const override;
     public: std::unique_ptr<CTSystem> deserializeSystem(const QString& fileName) const override;
 
+public:
+    bool isCompactFormat() const;
+    void setCompactFormat(bool enabled);
+
+    // streaming interface of the compact format
+    static bool supportsCompactFormat(const SerializationInterface& serializableObject);
+    static bool writeCompact(QDataStream& stream, const SerializationInterface& serializableObject);
+    static std::unique_ptr<SerializationInterface> readCompact(QDataStream& stream);
+
 private:
+    bool _compactFormat = false; //!< use compact format for supported types
+
     static QVariant variantFromBinaryFile(const QString& fileName);
+    static bool isCompactFile(const QString& fileName);
+    static std::unique_ptr<SerializationInterface> objectFromCompactFile(const QString& fileName);
 };
 
 
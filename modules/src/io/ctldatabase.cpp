@@ -1,8 +1,24 @@
 #include "ctldatabase.h"
+#include "serializationhelper.h"
 #include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
 
 namespace CTL {
 
+namespace {
+
+// header of the binary cache of attenuation models
+const quint32 ATTENUATION_CACHE_MAGIC_NUMBER = 0x43544C44; // "CTLD"
+const quint16 ATTENUATION_CACHE_FORMAT_VERSION = 2;
+const char ATTENUATION_CACHE_FILE_NAME[] = "attenuation_spectra.bin";
+
+// ids in the file map below this value refer to elements and composites
+const int FIRST_SPECTRUM_ID = 2001;
+
+} // unnamed namespace
+
 CTLDatabaseHandler::CTLDatabaseHandler()
 {
     auto fileWithDatabasePath = []
@@ -48,44 +64,134 @@ bool CTLDatabaseHandler::setDatabaseRoot(const QString& path)
         qWarning() << "Directory " << path << " does not exist.";
         return _isComplete = false;
     }
+    std::lock_guard<std::mutex> lock(_mutex);
     _dbRoot.setPath(path);
     _isComplete = makeFileMap();
+    _attenuationEntries.clear();
+    _attenuationCacheChecked = false;
 
     return _isComplete;
 }
 
+/*!
+ * Returns the attenuation model of \a composite. The model is parsed on first access; further
+ * calls return (cheap) copies of the parsed model.
+ */
 std::shared_ptr<AbstractIntegrableDataModel>
 CTLDatabaseHandler::loadAttenuationModel(database::Composite composite)
 {
-    return _serializer.deserialize<AbstractIntegrableDataModel>(_fileMap.value(int(composite)));
+    return attenuationModel(int(composite));
 }
 
+/*!
+ * Returns the attenuation model of \a element. The model is parsed on first access; further
+ * calls return (cheap) copies of the parsed model.
+ */
 std::shared_ptr<AbstractIntegrableDataModel>
 CTLDatabaseHandler::loadAttenuationModel(database::Element element)
 {
-    return _serializer.deserialize<AbstractIntegrableDataModel>(_fileMap.value(int(element)));
+    return attenuationModel(int(element));
 }
 
 std::shared_ptr<TabulatedDataModel>
 CTLDatabaseHandler::loadXRaySpectrum(database::Spectrum spectrum)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
     return _serializer.deserialize<TabulatedDataModel>(_fileMap.value(int(spectrum)));
 }
 
+/*!
+ * Returns the density of \a composite (in g/cm^3) or -1 if it is not available.
+ */
 float CTLDatabaseHandler::loadDensity(database::Composite composite)
 {
-    return JsonSerializer::variantFromJsonFile(_fileMap.value(int(composite)))
-        .toMap()
-        .value("density", -1.0f)
-        .toFloat();
+    return density(int(composite));
 }
 
+/*!
+ * Returns the density of \a element (in g/cm^3) or -1 if it is not available.
+ */
 float CTLDatabaseHandler::loadDensity(database::Element element)
 {
-    return JsonSerializer::variantFromJsonFile(_fileMap.value(int(element)))
-        .toMap()
-        .value("density", -1.0f)
-        .toFloat();
+    return density(int(element));
+}
+
+/*!
+ * Returns the path of the binary cache file that is read on first access to an attenuation model
+ * or density (if it is up to date). This is "attenuation_spectra.bin" in the database root.
+ */
+QString CTLDatabaseHandler::attenuationCacheFile() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _dbRoot.absoluteFilePath(ATTENUATION_CACHE_FILE_NAME);
+}
+
+/*!
+ * Reads the attenuation models and densities from the binary cache \a fileName, which has been
+ * created by writeAttenuationCache(). If \a fileName is empty, attenuationCacheFile() is used.
+ * Returns `false` if the file could not be read or has an invalid format.
+ *
+ * Note that the cache file is read automatically on first access to an attenuation model or
+ * density if it is not older than the JSON files of the database; calling this method is only
+ * required to use a different file.
+ */
+bool CTLDatabaseHandler::readAttenuationCache(const QString& fileName)
+{
+    const auto file = fileName.isEmpty() ? attenuationCacheFile() : fileName;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _attenuationCacheChecked = true;
+    return readAttenuationCacheFile(file);
+}
+
+/*!
+ * Writes the attenuation models and densities of all elements and composites to the binary cache
+ * \a fileName. If \a fileName is empty, attenuationCacheFile() is used, such that the cache is
+ * used automatically from then on. Returns `false` if not all models could be stored or writing
+ * the file failed.
+ *
+ * The cache needs to be rewritten whenever files of the database change; an outdated cache file
+ * (i.e. a file older than any of the JSON files) is ignored.
+ */
+bool CTLDatabaseHandler::writeAttenuationCache(const QString& fileName)
+{
+    const auto file = fileName.isEmpty() ? attenuationCacheFile() : fileName;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    QList<int> ids;
+    for(auto id : _fileMap.keys())
+        if(id < FIRST_SPECTRUM_ID)
+            ids.append(id);
+
+    auto allStored = true;
+    QList<int> storedIds;
+    for(auto id : ids)
+    {
+        if(dynamic_cast<const TabulatedDataModel*>(attenuationEntry(id).model.get()))
+            storedIds.append(id);
+        else
+            allStored = false;
+    }
+
+    QFile cacheFile(file);
+    if(!cacheFile.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "CTLDatabaseHandler::writeAttenuationCache: cannot open " << file;
+        return false;
+    }
+
+    QDataStream stream(&cacheFile);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << ATTENUATION_CACHE_MAGIC_NUMBER << ATTENUATION_CACHE_FORMAT_VERSION
+           << quint16(stream.version()) << quint32(storedIds.size());
+    for(auto id : storedIds)
+    {
+        const auto& entry = _attenuationEntries[id];
+        stream << qint32(id) << entry.density << entry.model->name()
+               << static_cast<const TabulatedDataModel&>(*entry.model).lookupTable();
+    }
+
+    return allStored && stream.status() == QDataStream::Ok;
 }
 
 bool CTLDatabaseHandler::makeFileMap()
@@ -140,6 +246,108 @@ bool CTLDatabaseHandler::makeFileMap()
     return isComplete;
 }
 
+std::shared_ptr<AbstractIntegrableDataModel> CTLDatabaseHandler::attenuationModel(int id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto& model = attenuationEntry(id).model;
+    if(!model)
+        return nullptr;
+
+    // copies of a TabulatedDataModel share the (immutable) compiled table of the cached model
+    return std::shared_ptr<AbstractIntegrableDataModel>(
+        static_cast<AbstractIntegrableDataModel*>(model->clone()));
+}
+
+float CTLDatabaseHandler::density(int id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return attenuationEntry(id).density;
+}
+
+// returns the model and density with `id` (parsed on first access); must be called with locked
+// mutex
+const CTLDatabaseHandler::AttenuationEntry& CTLDatabaseHandler::attenuationEntry(int id)
+{
+    if(!_attenuationCacheChecked)
+    {
+        _attenuationCacheChecked = true;
+
+        // use the binary cache only if it is not older than any of the JSON files
+        const QFileInfo cacheInfo(_dbRoot.absoluteFilePath(ATTENUATION_CACHE_FILE_NAME));
+        auto upToDate = cacheInfo.exists();
+        for(auto it = _fileMap.cbegin(); upToDate && it != _fileMap.cend(); ++it)
+        {
+            const QFileInfo jsonInfo(it.value());
+            if(it.key() < FIRST_SPECTRUM_ID && jsonInfo.exists())
+                upToDate = jsonInfo.lastModified() <= cacheInfo.lastModified();
+        }
+        if(upToDate)
+            readAttenuationCacheFile(cacheInfo.absoluteFilePath());
+    }
+
+    auto it = _attenuationEntries.find(id);
+    if(it != _attenuationEntries.end())
+        return it.value();
+
+    const auto variant = JsonSerializer::variantFromJsonFile(_fileMap.value(id));
+    std::unique_ptr<AbstractDataModel> model(SerializationHelper::parseDataModel(variant));
+
+    AttenuationEntry entry;
+    if(dynamic_cast<AbstractIntegrableDataModel*>(model.get()))
+        entry.model.reset(static_cast<AbstractIntegrableDataModel*>(model.release()));
+    entry.density = variant.toMap().value("density", -1.0f).toFloat();
+
+    return _attenuationEntries.insert(id, std::move(entry)).value();
+}
+
+// must be called with locked mutex
+bool CTLDatabaseHandler::readAttenuationCacheFile(const QString& fileName)
+{
+    QFile cacheFile(fileName);
+    if(!cacheFile.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&cacheFile);
+    quint32 magicNumber, nbEntries;
+    quint16 formatVersion, streamVersion;
+    stream >> magicNumber >> formatVersion >> streamVersion >> nbEntries;
+    if(stream.status() != QDataStream::Ok || magicNumber != ATTENUATION_CACHE_MAGIC_NUMBER ||
+       formatVersion != ATTENUATION_CACHE_FORMAT_VERSION)
+    {
+        qWarning() << "CTLDatabaseHandler: invalid attenuation cache file " << fileName;
+        return false;
+    }
+    stream.setVersion(streamVersion);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    QMap<int, AttenuationEntry> entries;
+    for(quint32 e = 0; e < nbEntries; ++e)
+    {
+        qint32 id;
+        float density;
+        QString name;
+        QMap<float, float> table;
+        stream >> id >> density >> name >> table;
+        if(stream.status() != QDataStream::Ok)
+        {
+            qWarning() << "CTLDatabaseHandler: corrupt attenuation cache file " << fileName;
+            return false;
+        }
+
+        AttenuationEntry entry;
+        auto model = std::make_shared<TabulatedDataModel>(std::move(table));
+        model->setName(name);
+        entry.model = std::move(model);
+        entry.density = density;
+        entries.insert(id, std::move(entry));
+    }
+
+    for(auto it = entries.cbegin(); it != entries.cend(); ++it)
+        _attenuationEntries.insert(it.key(), it.value());
+
+    return true;
+}
+
 namespace database {
 
 std::shared_ptr<AbstractIntegrableDataModel> attenuationModel(database::Element element)
@@ -5,6 +5,7 @@
 #include "models/abstractdatamodel.h"
 #include "models/tabulateddatamodel.h"
 #include <QDir>
+#include <mutex>
 
 #ifdef I
     #define REINSTATE_I_MACRO
@@ -173,6 +174,22 @@ float density(database::Element element);
 
 } // namespace database
 
+/*!
+ * \class CTLDatabaseHandler
+ *
+ * \brief The CTLDatabaseHandler class provides access to the files of the CTL database.
+ *
+ * Attenuation models and densities are parsed on first access and kept in memory. Subsequent
+ * requests return copies of the parsed models; copies of a TabulatedDataModel share their
+ * compiled lookup table (incl. the cumulative integrals used by binIntegral() and meanValue()),
+ * such that repeated requests as well as bin integrals of the returned models are cheap. All
+ * methods may be called concurrently from several threads.
+ *
+ * To avoid parsing the JSON files at all, the attenuation models and densities of all elements and
+ * composites can be stored in a binary cache file with writeAttenuationCache(). On first access to
+ * an attenuation model or density, the handler reads the cache file at attenuationCacheFile() (if
+ * it exists and is not older than any file of the database).
+ */
 class CTLDatabaseHandler
 {
 public:
@@ -189,7 +206,17 @@ public:
     float loadDensity(database::Composite composite);
     float loadDensity(database::Element element);
 
+    QString attenuationCacheFile() const;
+    bool readAttenuationCache(const QString& fileName = QString());
+    bool writeAttenuationCache(const QString& fileName = QString());
+
 private:
+    struct AttenuationEntry
+    {
+        std::shared_ptr<const AbstractIntegrableDataModel> model;
+        float density = -1.0f;
+    };
+
     CTLDatabaseHandler();
     // non-copyable
     CTLDatabaseHandler(const CTLDatabaseHandler&) = delete;
@@ -197,11 +224,20 @@ private:
 
     bool makeFileMap();
 
+    std::shared_ptr<AbstractIntegrableDataModel> attenuationModel(int id);
+    float density(int id);
+    const AttenuationEntry& attenuationEntry(int id);
+    bool readAttenuationCacheFile(const QString& fileName);
+
     QDir _dbRoot;
 
     JsonSerializer _serializer;
     QMap<int, QString> _fileMap;
     bool _isComplete{ false };
+
+    mutable std::mutex _mutex;
+    QMap<int, AttenuationEntry> _attenuationEntries;
+    bool _attenuationCacheChecked{ false };
 };
 
 } // namespace CTL
@@ -30,6 +30,10 @@ public:
     bool write(const std::vector<T>& data,
                const QVariantMap& metaInfo,
                const QString& fileName) const;
+
+    // header of raw encoded files (see BaseTypeIO::writeParallel())
+    template <typename T>
+    QByteArray rawDataHeader(const QVariantMap& metaInfo) const;
 };
 
 // ######## implementation #########
@@ -70,6 +74,29 @@ bool DenFileIO::write(const std::vector<T> &data,
     return dFile.save(data, header);
 }
 
+template <typename T>
+QByteArray DenFileIO::rawDataHeader(const QVariantMap& metaInfo) const
+{
+    auto dimList = metaInfo.value(meta_info::dimensions).value<meta_info::Dimensions>();
+
+    if(dimList.nbDim < 2)
+        throw std::runtime_error("Writing aborted: missing data meta information!");
+
+    den::Header header;
+    header.cols = dimList.dim1;
+    header.rows = dimList.dim2;
+    header.count = (dimList.dim3 ? dimList.dim3 : 1) * (dimList.dim4 ? dimList.dim4 : 1);
+
+    if(header.isZero() || header.isOutOfBounds())
+        return {};
+
+    const ushort fHead[3] = { static_cast<ushort>(header.rows),
+                              static_cast<ushort>(header.cols),
+                              static_cast<ushort>(header.count) };
+
+    return QByteArray(reinterpret_cast<const char*>(fHead), sizeof(fHead));
+}
+
 template <>
 inline std::vector<uchar> DenFileIO::readChunk(const QString& fileName, uint chunkNb) const
 {
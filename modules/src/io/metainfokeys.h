@@ -39,6 +39,7 @@ const QString nbChans = QStringLiteral("num channel");   // value, proj. data
 const QString nbCols = QStringLiteral("num column");     // value, proj. matrices
 const QString nbViews = QStringLiteral("num proj");      // value
 const QString nbMods = QStringLiteral("num det module"); // value
+const QString firstView = QStringLiteral("first proj");  // key, index of first view (sharded data)
 
 // # additional volume info
 const QString voxSizeX = QStringLiteral("vox size x"); // key
@@ -58,6 +59,14 @@ namespace type_hint {
     const QString slice = QStringLiteral("slice");                  // value
 } // namespace type_hint
 
+// # data encoding (only for file formats that support compression, e.g. NRRD)
+const QString encoding = QStringLiteral("encoding"); // key
+namespace encoding_type {
+    const QString raw = QStringLiteral("raw");                // value
+    const QString gzip = QStringLiteral("gzip");              // value, single compressed stream
+    const QString gzipBlocks = QStringLiteral("gzip blocks"); // value, one compressed block per chunk
+} // namespace encoding_type
+
 struct Dimensions
 {
     Dimensions()
@@ -3,10 +3,19 @@
 
 #include "io/basetypeio.h"
 #include <QFile>
+#include <fstream>
 #include <QRegularExpression>
 
 /*
  * NOTE: This is header only.
+ *
+ * Supported encodings are 'raw' and 'gzip'. Gzip encoding requires zlib; it is unavailable if the
+ * CTL has been built without zlib (see isGzipSupported()). The encoding used for writing is
+ * selected by the meta info meta_info::encoding (default: meta_info::encoding_type::raw).
+ * With meta_info::encoding_type::gzipBlocks, each chunk (see readChunk()) is compressed as a
+ * separate gzip member (in parallel). The result is a standard conformant gzip encoded NRRD file
+ * whose header additionally holds the compressed size of each block (key-value pair
+ * "ctl gzip block sizes"). This index allows to decompress individual chunks only.
  */
 
 namespace CTL {
@@ -30,11 +39,33 @@ public:
     bool
     write(const std::vector<T>& data, const QVariantMap& metaInfo, const QString& fileName) const;
 
+    // header of raw encoded files (see BaseTypeIO::writeParallel())
+    template <typename T>
+    QByteArray rawDataHeader(const QVariantMap& metaInfo) const;
+
+    // stateful access to individual chunks of a file (see BaseTypeIO::PrefetchingReader)
+    template <typename T>
+    class ChunkReader
+    {
+    public:
+        explicit ChunkReader(const QString& fileName);
+        ChunkReader(const QString& fileName, const QVariantMap& metaInfo);
+        bool read(uint chunkNb, std::vector<T>& buffer);
+
+    private:
+        std::ifstream _file;
+        int64_t _headerOffset = 0;
+        size_t _nbChunks = 0;
+        bool _isGzip = false;
+        std::vector<int64_t> _blockOffsets; //!< empty if gzip encoded file has no block index
+    };
+
     // specific configuration
     void setSkipComments(bool skipComments);
     void setSkipKeyValuePairs(bool skipKeyValuePairs);
     bool skipComments() const;
     bool skipKeyValuePairs() const;
+    static bool isGzipSupported();
 
 private:
 
@@ -44,7 +75,8 @@ private:
     template <typename T>
     bool checkHeader(const QVariantMap& metaInfo) const;
     template <typename T>
-    bool writeHeader(std::ofstream& file, const QVariantMap& metaInfo) const;
+    bool writeHeader(std::ostream& file, const QVariantMap& metaInfo, const char* encoding,
+                     const std::vector<std::vector<char>>& indexedBlocks) const;
     template <typename T>
     static DataType dataType();
     static DataType dataTypeFromString(const QString& typeString);
@@ -53,6 +85,17 @@ private:
                     QVariantMap* metaInfo, int* nbDimension) const;
     static int sizeOfType(DataType type);
     static const char* stringOfType(DataType type);
+    static size_t nbChunks(const meta_info::Dimensions& dimensions);
+
+    // gzip encoding
+    static bool gzipCompress(const char* data, size_t bytes, std::vector<char>* compressed);
+    static bool gzipDecompress(std::istream& file, char* data, size_t bytes, size_t skipBytes = 0);
+    template <typename T>
+    static std::vector<std::vector<char>> compressedBlocks(const std::vector<T>& data,
+                                                           size_t nbBlocks);
+    std::vector<int64_t> blockOffsets(const QVariantMap& metaInfo, size_t nbBlocks) const;
+    bool readGzipChunks(const QString& fileName, const QVariantMap& metaInfo, size_t chunkBytes,
+                        size_t firstChunk, size_t nbChunksToRead, char* data) const;
 
     // Nrrd fields which are translated to basetype meta info
     const QString _fDimension = QStringLiteral("dimension");
@@ -63,6 +106,9 @@ private:
     const QString _fSpaceOrigin = QStringLiteral("space origin");
     const QString _fSpacings = QStringLiteral("spacings");
     const QString _fType = QStringLiteral("type");
+
+    // key of the key-value pair that holds the compressed block sizes (gzip blocks encoding)
+    const QString _kvBlockSizes = QStringLiteral("ctl gzip block sizes");
 };
 
 } // namespace io
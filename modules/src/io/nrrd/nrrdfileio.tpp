@@ -1,5 +1,15 @@
 #include "nrrdfileio.h"
+#include "processing/threadpool.h"
 #include <fstream>
+#include <limits>
+#include <sstream>
+#ifdef NRRD_GZIP_ENCODING_AVAILABLE
+#ifdef CTL_USE_QT_ZLIB
+#include <QtZlib/zlib.h>
+#else
+#include <zlib.h>
+#endif
+#endif
 
 // checks format of floating point numbers at compile time and leads to a compiler
 // error if the platform does not support floating point numbers according to IEEE 754
@@ -70,6 +80,9 @@ inline QVariantMap NrrdFileIO::metaInfo(const QString& fileName) const
             {
                 if(!_skipKeyValuePairs)
                     ret.insert(mKeyValuePair.captured("key"), mKeyValuePair.captured("value"));
+                else if(line.startsWith(_kvBlockSizes.toLatin1() + ":=")) // block index is required
+                    ret.insert(_kvBlockSizes, QString::fromLatin1(
+                                   line.mid(_kvBlockSizes.size() + 2).trimmed()));
             }
             else
             {
@@ -129,13 +142,34 @@ std::vector<T> NrrdFileIO::readAll(const QString& fileName) const
         return ret;
     }
 
-    // get length data block
-    const int64_t bytesOfFile = file.tellg();
-    const int64_t dataBytes = bytesOfFile - headerOffset;
     const int64_t nbElements = dimensions.dim1 * dimensions.dim2 *
             (dimensions.nbDim >= 3 ? dimensions.dim3 : 1) *
             (dimensions.nbDim == 4 ? dimensions.dim4 : 1);
 
+    // compressed data
+    if(metaInfo.value(_fEncoding).toString() == meta_info::encoding_type::gzip)
+    {
+        file.close();
+        if(!isGzipSupported())
+        {
+            qCritical("gzip encoding unsupported (CTL has been built without zlib)");
+            return ret;
+        }
+        ret.resize(nbElements);
+        const auto nbChunksInFile = nbChunks(dimensions);
+        if(!readGzipChunks(fileName, metaInfo, nbElements / nbChunksInFile * sizeof(T), 0,
+                           nbChunksInFile, reinterpret_cast<char*>(ret.data())))
+        {
+            qCritical() << "compressed data of file does not fit to dimensions in nrrd header";
+            ret.clear();
+        }
+        return ret;
+    }
+
+    // get length data block
+    const int64_t bytesOfFile = file.tellg();
+    const int64_t dataBytes = bytesOfFile - headerOffset;
+
     if(nbElements * int64_t(sizeof(T)) != dataBytes)
     {
         qCritical() << "raw data size of file does not fit to dimensions in nrrd header";
@@ -169,21 +203,16 @@ std::vector<T> NrrdFileIO::readChunk(const QString &fileName, uint chunkNb) cons
     const auto headerOffset = metaInfo.value("nrrd header offset").toLongLong();
     const auto dimensions = metaInfo.value(meta_info::dimensions).value<meta_info::Dimensions>();
 
-    size_t nbChunks;
-    switch (dimensions.nbDim) {
-    case 2: nbChunks = 1;
-        break;
-    case 3: nbChunks = dimensions.dim3;
-        break;
-    case 4: nbChunks = dimensions.dim3 * dimensions.dim4;
-        break;
-    default: qCritical("invalid number of dimensions");
+    const auto nbChunksInFile = nbChunks(dimensions);
+    if(nbChunksInFile == 0)
+    {
+        qCritical("invalid number of dimensions");
         return ret;
     }
-    if(chunkNb >= nbChunks)
+    if(chunkNb >= nbChunksInFile)
     {
         qCritical() << "chunk exceeds total number of chunks in file: "
-                    << chunkNb << '/' << nbChunks;
+                    << chunkNb << '/' << nbChunksInFile;
         return ret;
     }
 
@@ -194,13 +223,33 @@ std::vector<T> NrrdFileIO::readChunk(const QString &fileName, uint chunkNb) cons
         return ret;
     }
 
+    const size_t nbElements = dimensions.dim1 * dimensions.dim2;
+    const size_t bytes2read = nbElements * sizeof(T);
+
+    // compressed data (decompresses only the requested chunk if the file has a block index)
+    if(metaInfo.value(_fEncoding).toString() == meta_info::encoding_type::gzip)
+    {
+        file.close();
+        if(!isGzipSupported())
+        {
+            qCritical("gzip encoding unsupported (CTL has been built without zlib)");
+            return ret;
+        }
+        ret.resize(nbElements);
+        if(!readGzipChunks(fileName, metaInfo, bytes2read, chunkNb, 1,
+                           reinterpret_cast<char*>(ret.data())))
+        {
+            qCritical() << "compressed data of file does not fit to dimensions in nrrd header";
+            ret.clear();
+        }
+        return ret;
+    }
+
     // get length data block
     const int64_t bytesOfFile = file.tellg();
     const int64_t dataBytes = bytesOfFile - headerOffset;
-    const size_t nbElements = dimensions.dim1 * dimensions.dim2;
-    const size_t bytes2read = nbElements * sizeof(T);
 
-    if(nbElements * nbChunks * sizeof(T) != size_t(dataBytes))
+    if(nbElements * nbChunksInFile * sizeof(T) != size_t(dataBytes))
     {
         qCritical() << "raw data size of file does not fit to dimensions in nrrd header";
         return ret;
@@ -222,6 +271,31 @@ bool NrrdFileIO::write(const std::vector<T>& data,
                        const QVariantMap& metaInfo,
                        const QString& fileName) const
 {
+    const auto encoding = metaInfo.value(meta_info::encoding,
+                                         meta_info::encoding_type::raw).toString();
+    const auto isIndexed = encoding == meta_info::encoding_type::gzipBlocks;
+    const auto isRaw = !isIndexed && encoding != meta_info::encoding_type::gzip;
+    if(isRaw && encoding != meta_info::encoding_type::raw)
+        qWarning() << "unsupported data encoding:" << encoding << "- writing raw data instead";
+
+    // compression (single gzip stream or one gzip member per chunk)
+    std::vector<std::vector<char>> blocks;
+    if(!isRaw)
+    {
+        if(!isGzipSupported())
+        {
+            qCritical("gzip encoding unsupported (CTL has been built without zlib)");
+            return false;
+        }
+        const auto dims = metaInfo.value(meta_info::dimensions).value<meta_info::Dimensions>();
+        blocks = compressedBlocks(data, isIndexed ? nbChunks(dims) : size_t(1));
+        if(blocks.empty())
+        {
+            qCritical("compression of data failed");
+            return false;
+        }
+    }
+
     // open file
     std::ofstream file(fileName.toStdString(), std::ios::binary);
     if(!file.is_open())
@@ -231,12 +305,19 @@ bool NrrdFileIO::write(const std::vector<T>& data,
     }
 
     // header
-    if(!writeHeader<T>(file, metaInfo))
+    if(!writeHeader<T>(file, metaInfo, isRaw ? "raw" : "gzip",
+                       isIndexed ? blocks : std::vector<std::vector<char>>{}))
         return false;
 
     // binary data
-    auto bytes2write = data.size() * sizeof(T);
-    file.write(reinterpret_cast<const char*>(data.data()), bytes2write);
+    if(isRaw)
+    {
+        auto bytes2write = data.size() * sizeof(T);
+        file.write(reinterpret_cast<const char*>(data.data()), bytes2write);
+    }
+    else
+        for(const auto& block : blocks)
+            file.write(block.data(), block.size());
 
     file.close();
     if(!file)
@@ -248,8 +329,118 @@ bool NrrdFileIO::write(const std::vector<T>& data,
     return true;
 }
 
+/*
+ * Returns the header of a raw encoded file that holds data of type T with the meta information
+ * \a metaInfo, i.e. the bytes that precede the binary data in such a file. The binary data itself
+ * can then be written without any conversion (e.g. by a RawFileWriter, see
+ * BaseTypeIO::writeParallel()).
+ *
+ * Returns an empty QByteArray if \a metaInfo requests a compressed encoding or if the header cannot
+ * be created.
+ */
+template <typename T>
+QByteArray NrrdFileIO::rawDataHeader(const QVariantMap& metaInfo) const
+{
+    const auto encoding = metaInfo.value(meta_info::encoding,
+                                         meta_info::encoding_type::raw).toString();
+    if(encoding == meta_info::encoding_type::gzip || encoding == meta_info::encoding_type::gzipBlocks)
+        return {};
+
+    std::ostringstream header;
+    if(!writeHeader<T>(header, metaInfo, "raw", {}))
+        return {};
+
+    const auto str = header.str();
+    return QByteArray(str.data(), int(str.size()));
+}
+
+/*
+ * Opens the file \a fileName and parses its header. The file is kept open for subsequent calls of
+ * read(). All subsequent reads fail if the header is invalid or does not fit to the data type T.
+ */
+template <typename T>
+NrrdFileIO::ChunkReader<T>::ChunkReader(const QString& fileName)
+    : ChunkReader(fileName, [&fileName] {
+        NrrdFileIO io;
+        io.setSkipComments(true);
+        io.setSkipKeyValuePairs(true);
+        return io.metaInfo(fileName);
+    }())
+{
+}
+
+/*
+ * Opens the file \a fileName, whose header has already been parsed into \a metaInfo (see
+ * metaInfo()). The file is kept open for subsequent calls of read(). All subsequent reads fail if
+ * the header is invalid or does not fit to the data type T.
+ */
+template <typename T>
+NrrdFileIO::ChunkReader<T>::ChunkReader(const QString& fileName, const QVariantMap& metaInfo)
+{
+    NrrdFileIO io;
+
+    if(!io.checkHeader<T>(metaInfo))
+        return;
+
+    _headerOffset = metaInfo.value("nrrd header offset").toLongLong();
+    _nbChunks = nbChunks(metaInfo.value(meta_info::dimensions).value<meta_info::Dimensions>());
+    _isGzip = metaInfo.value(io._fEncoding).toString() == meta_info::encoding_type::gzip;
+    if(_isGzip && !isGzipSupported())
+    {
+        qCritical("gzip encoding unsupported (CTL has been built without zlib)");
+        return;
+    }
+
+    _file.open(fileName.toStdString(), std::ios::binary | std::ios::ate);
+    if(!_file)
+    {
+        qCritical() << "unable to open file" << fileName;
+        return;
+    }
+
+    if(_isGzip)
+    {
+        _blockOffsets = io.blockOffsets(metaInfo, _nbChunks);
+        if(!_blockOffsets.empty() && _headerOffset + _blockOffsets.back() != int64_t(_file.tellg()))
+            _blockOffsets.clear();
+    }
+}
+
+/*
+ * Reads the chunk \a chunkNb into \a buffer, whose size must match the number of elements of a
+ * chunk. Returns false if reading fails.
+ */
+template <typename T>
+bool NrrdFileIO::ChunkReader<T>::read(uint chunkNb, std::vector<T>& buffer)
+{
+    if(!_file.is_open() || chunkNb >= _nbChunks)
+        return false;
+
+    const auto bytes2read = buffer.size() * sizeof(T);
+    auto data = reinterpret_cast<char*>(buffer.data());
+
+    _file.clear();
+    if(!_isGzip)
+    {
+        _file.seekg(_headerOffset + int64_t(chunkNb) * int64_t(bytes2read));
+        _file.read(data, bytes2read);
+        return bool(_file);
+    }
+
+    // without block index: decompress from the beginning and skip all preceding chunks
+    if(_blockOffsets.empty())
+    {
+        _file.seekg(_headerOffset);
+        return gzipDecompress(_file, data, bytes2read, chunkNb * bytes2read);
+    }
+
+    _file.seekg(_headerOffset + _blockOffsets[chunkNb]);
+    return gzipDecompress(_file, data, bytes2read);
+}
+
 template<typename T>
-bool NrrdFileIO::writeHeader(std::ofstream& file, const QVariantMap& metaInfo) const
+bool NrrdFileIO::writeHeader(std::ostream& file, const QVariantMap& metaInfo, const char* encoding,
+                             const std::vector<std::vector<char>>& indexedBlocks) const
 {
     auto type = dataType<T>();
     auto dims = metaInfo.value(meta_info::dimensions).value<meta_info::Dimensions>();
@@ -288,7 +479,7 @@ bool NrrdFileIO::writeHeader(std::ofstream& file, const QVariantMap& metaInfo) c
 
     file << _fLabels.toStdString() << ": " << dimensionTypes.toStdString() << '\n';
 
-    file << _fEncoding.toStdString() << ": raw\n";
+    file << _fEncoding.toStdString() << ": " << encoding << '\n';
 
     file << _fEndianness.toStdString() << ": " << (isBigEndian() ? "big" : "little") << '\n';
 
@@ -326,12 +517,21 @@ bool NrrdFileIO::writeHeader(std::ofstream& file, const QVariantMap& metaInfo) c
                s == meta_info::dim1Type || s == meta_info::dim2Type || s == meta_info::dim3Type ||
                s == meta_info::dim4Type ||
                s == meta_info::voxSizeX || s == meta_info::voxSizeY || s == meta_info::voxSizeZ ||
-               s == meta_info::volOffX || s == meta_info::volOffY || s == meta_info::volOffZ;
+               s == meta_info::volOffX || s == meta_info::volOffY || s == meta_info::volOffZ ||
+               s == meta_info::encoding || s == _kvBlockSizes;
     };
     for(auto it = metaInfo.begin(), end = metaInfo.end(); it != end; ++it)
         if(it.value().canConvert<QString>() && !isField(it.key()))
             file << it.key().toStdString() << ":=" << it.value().toString().toStdString() << '\n';
 
+    // index of compressed blocks
+    if(!indexedBlocks.empty())
+    {
+        file << _kvBlockSizes.toStdString() << ":=";
+        for(const auto& block : indexedBlocks)
+            file << block.size() << (&block == &indexedBlocks.back() ? '\n' : ' ');
+    }
+
     // end of header
     file.put('\n');
 
@@ -344,6 +544,17 @@ inline void NrrdFileIO::setSkipComments(bool skipComments) { _skipComments = ski
 
 inline bool NrrdFileIO::skipKeyValuePairs() const { return _skipKeyValuePairs; }
 
+// returns true if gzip encoded files can be read and written, i.e. if the CTL has been built with
+// zlib (see nrrd_file_io.pri)
+inline bool NrrdFileIO::isGzipSupported()
+{
+#ifdef NRRD_GZIP_ENCODING_AVAILABLE
+    return true;
+#else
+    return false;
+#endif
+}
+
 inline void NrrdFileIO::setSkipKeyValuePairs(bool skipKeyValuePairs)
 {
     _skipKeyValuePairs = skipKeyValuePairs;
@@ -408,6 +619,8 @@ inline bool NrrdFileIO::parseField(const QString &field, const QString &desc,
 
         if(desc == "raw")
             metaInfo->insert(_fEncoding, "raw");
+        else if(desc == "gzip" || desc == "gz")
+            metaInfo->insert(_fEncoding, "gzip");
         else if(desc == "txt" || desc == "text" || desc == "ascii")
             metaInfo->insert(_fEncoding, "ascii");
     }
@@ -511,8 +724,9 @@ bool NrrdFileIO::checkHeader(const QVariantMap &metaInfo) const
     {
         return fail("insufficient header information");
     }
-    // the only supported encoding so far (TBD: add ascii support)
-    if(metaInfo.value(_fEncoding).toString().compare("raw", Qt::CaseInsensitive) != 0)
+    // the supported encodings so far (TBD: add ascii support)
+    if(metaInfo.value(_fEncoding).toString().compare("raw", Qt::CaseInsensitive) != 0 &&
+       metaInfo.value(_fEncoding).toString().compare("gzip", Qt::CaseInsensitive) != 0)
     {
         return fail("unsupported data encoding: " + metaInfo.value(_fEncoding).toString());
     }
@@ -572,6 +786,18 @@ inline int NrrdFileIO::sizeOfType(DataType type)
     return sizes[type];
 }
 
+// number of two-dimensional chunks (see readChunk()), zero for an invalid number of dimensions
+inline size_t NrrdFileIO::nbChunks(const meta_info::Dimensions& dimensions)
+{
+    switch(dimensions.nbDim)
+    {
+    case 2: return 1;
+    case 3: return dimensions.dim3;
+    case 4: return size_t(dimensions.dim3) * dimensions.dim4;
+    default: return 0;
+    }
+}
+
 inline const char* NrrdFileIO::stringOfType(DataType type)
 {
     static const char* const stringList[] = { "int8",
@@ -632,5 +858,214 @@ inline bool NrrdFileIO::isBigEndian()
     return bint.c[0] == 1;
 }
 
+// compresses `bytes` bytes from `data` into a single gzip member that is stored in `compressed`
+inline bool NrrdFileIO::gzipCompress(const char* data, size_t bytes, std::vector<char>* compressed)
+{
+#ifdef NRRD_GZIP_ENCODING_AVAILABLE
+    static const size_t maxStep = std::numeric_limits<uInt>::max();
+
+    z_stream stream{};
+    // window bits 15 + 16: gzip header and trailer
+    if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY)
+       != Z_OK)
+        return false;
+
+    compressed->resize(deflateBound(&stream, uLong(std::min(bytes, maxStep))));
+    size_t nbCompressed = 0;
+    int flush, err;
+    do
+    {
+        // zlib processes at most 'maxStep' bytes per call
+        const auto step = std::min(bytes, maxStep);
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream.avail_in = uInt(step);
+        data += step;
+        bytes -= step;
+        flush = bytes ? Z_NO_FLUSH : Z_FINISH;
+        do
+        {
+            if(nbCompressed == compressed->size())
+                compressed->resize(compressed->size() + compressed->size() / 2 + 1024);
+            stream.next_out = reinterpret_cast<Bytef*>(compressed->data() + nbCompressed);
+            stream.avail_out = uInt(std::min(compressed->size() - nbCompressed, maxStep));
+            const auto availOut = stream.avail_out;
+            err = deflate(&stream, flush);
+            nbCompressed += availOut - stream.avail_out;
+        } while(stream.avail_out == 0 && err != Z_STREAM_ERROR);
+    } while(flush != Z_FINISH && err != Z_STREAM_ERROR);
+
+    deflateEnd(&stream);
+    compressed->resize(nbCompressed);
+
+    return err == Z_STREAM_END;
+#else
+    Q_UNUSED(data)
+    Q_UNUSED(bytes)
+    Q_UNUSED(compressed)
+    return false;
+#endif
+}
+
+// decompresses gzip data from `file` (starting at the current position) until `bytes` bytes have
+// been written to `data`; the first `skipBytes` decompressed bytes are discarded. Concatenated gzip
+// members are treated as a single stream.
+inline bool NrrdFileIO::gzipDecompress(std::istream& file, char* data, size_t bytes,
+                                       size_t skipBytes)
+{
+#ifdef NRRD_GZIP_ENCODING_AVAILABLE
+    static const size_t maxStep = std::numeric_limits<uInt>::max();
+
+    z_stream stream{};
+    if(inflateInit2(&stream, 15 + 16) != Z_OK)
+        return false;
+
+    std::vector<char> inBuffer(1 << 16);
+    std::vector<char> skipBuffer(skipBytes ? 1 << 16 : 0);
+    auto err = Z_OK;
+    while(bytes > 0)
+    {
+        if(err == Z_STREAM_END) // next member
+            inflateReset(&stream);
+        if(stream.avail_in == 0)
+        {
+            file.read(inBuffer.data(), inBuffer.size());
+            stream.next_in = reinterpret_cast<Bytef*>(inBuffer.data());
+            stream.avail_in = uInt(file.gcount());
+            if(stream.avail_in == 0) // unexpected end of file
+                break;
+        }
+
+        auto& target = skipBytes ? skipBytes : bytes;
+        const auto step = std::min(target, skipBytes ? skipBuffer.size() : maxStep);
+        stream.next_out = reinterpret_cast<Bytef*>(skipBytes ? skipBuffer.data() : data);
+        stream.avail_out = uInt(step);
+        err = inflate(&stream, Z_NO_FLUSH);
+        if(err != Z_OK && err != Z_STREAM_END)
+            break;
+
+        const auto nbDecompressed = step - stream.avail_out;
+        if(&target == &bytes)
+            data += nbDecompressed;
+        target -= nbDecompressed;
+    }
+
+    inflateEnd(&stream);
+
+    return bytes == 0;
+#else
+    Q_UNUSED(file)
+    Q_UNUSED(data)
+    Q_UNUSED(bytes)
+    Q_UNUSED(skipBytes)
+    return false;
+#endif
+}
+
+// compresses `data` in `nbBlocks` blocks of equal size (one gzip member per block) in parallel
+template <typename T>
+std::vector<std::vector<char>> NrrdFileIO::compressedBlocks(const std::vector<T>& data,
+                                                           size_t nbBlocks)
+{
+    if(nbBlocks == 0 || data.size() % nbBlocks)
+        return {};
+
+    const auto blockBytes = data.size() / nbBlocks * sizeof(T);
+    const auto rawData = reinterpret_cast<const char*>(data.data());
+    std::vector<std::vector<char>> ret(nbBlocks);
+    std::vector<char> success(nbBlocks, false);
+
+    auto compressRange = [&](size_t first, size_t last) {
+        for(auto block = first; block < last; ++block)
+            success[block] = gzipCompress(rawData + block * blockBytes, blockBytes, &ret[block]);
+    };
+
+    const auto nbThreads = std::min(nbBlocks,
+                                    size_t(std::max(1u, std::thread::hardware_concurrency())));
+    const auto blocksPerThread = (nbBlocks + nbThreads - 1) / nbThreads;
+    {
+        ThreadPool tp(nbThreads);
+        for(size_t first = 0; first < nbBlocks; first += blocksPerThread)
+            tp.enqueueThread(compressRange, first, std::min(first + blocksPerThread, nbBlocks));
+    }
+
+    if(std::find(success.cbegin(), success.cend(), char(false)) != success.cend())
+        return {};
+
+    return ret;
+}
+
+// offsets of the compressed blocks (relative to the end of the header) including the end of the
+// last block; empty if the file has no (valid) block index for `nbBlocks` blocks
+inline std::vector<int64_t> NrrdFileIO::blockOffsets(const QVariantMap& metaInfo,
+                                                     size_t nbBlocks) const
+{
+    const auto sizes = metaInfo.value(_kvBlockSizes).toString().split(' ');
+    if(size_t(sizes.size()) != nbBlocks)
+        return {};
+
+    std::vector<int64_t> ret(nbBlocks + 1, 0);
+    bool ok;
+    for(size_t block = 0; block < nbBlocks; ++block)
+    {
+        ret[block + 1] = ret[block] + sizes.at(int(block)).toLongLong(&ok);
+        if(!ok)
+            return {};
+    }
+
+    return ret;
+}
+
+// decompresses `nbChunksToRead` chunks of `chunkBytes` bytes each, starting at chunk `firstChunk`,
+// from a gzip encoded file into `data`; uses the block index (in parallel) if available
+inline bool NrrdFileIO::readGzipChunks(const QString& fileName, const QVariantMap& metaInfo,
+                                       size_t chunkBytes, size_t firstChunk, size_t nbChunksToRead,
+                                       char* data) const
+{
+    const auto headerOffset = metaInfo.value("nrrd header offset").toLongLong();
+    const auto dimensions = metaInfo.value(meta_info::dimensions).value<meta_info::Dimensions>();
+    auto offsets = blockOffsets(metaInfo, nbChunks(dimensions));
+
+    std::ifstream file(fileName.toStdString(), std::ios::binary | std::ios::ate);
+    if(!file)
+        return false;
+    if(!offsets.empty() && headerOffset + offsets.back() != int64_t(file.tellg()))
+    {
+        qWarning() << "block index does not fit to file size, decompressing entire file";
+        offsets.clear();
+    }
+
+    // without index: decompress from the beginning and skip all preceding chunks
+    if(offsets.empty())
+    {
+        file.seekg(headerOffset);
+        return gzipDecompress(file, data, nbChunksToRead * chunkBytes, firstChunk * chunkBytes);
+    }
+
+    auto readRange = [&](size_t first, size_t last) {
+        std::ifstream rangeFile(fileName.toStdString(), std::ios::binary);
+        rangeFile.seekg(headerOffset + offsets[first]);
+        return gzipDecompress(rangeFile, data + (first - firstChunk) * chunkBytes,
+                              (last - first) * chunkBytes);
+    };
+
+    if(nbChunksToRead == 1)
+        return readRange(firstChunk, firstChunk + 1);
+
+    const auto nbThreads = std::min(nbChunksToRead,
+                                    size_t(std::max(1u, std::thread::hardware_concurrency())));
+    const auto chunksPerThread = (nbChunksToRead + nbThreads - 1) / nbThreads;
+    const auto lastChunk = firstChunk + nbChunksToRead;
+    std::vector<char> success(nbThreads, true);
+    {
+        ThreadPool tp(nbThreads);
+        for(size_t first = firstChunk, t = 0; first < lastChunk; first += chunksPerThread, ++t)
+            tp.enqueueThread([&, first, t] {
+                success[t] = readRange(first, std::min(first + chunksPerThread, lastChunk));
+            });
+    }
+
+    return std::find(success.cbegin(), success.cend(), char(false)) == success.cend();
+}
+
 } // namespace io
 } // namespace CTL
@@ -0,0 +1,405 @@
+#include "basetypeio.h"
+#include "metainfokeys.h"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace CTL {
+namespace io {
+
+namespace details {
+
+/*
+ * Reads individual chunks of a file on behalf of a PrefetchingReader. This generic version uses the
+ * (stateless) readChunk() method of the FileIOImplementer. If the FileIOImplementer provides a
+ * stateful `ChunkReader<T>` class (with a constructor taking the file name and its already parsed
+ * meta information, and a method `bool read(uint chunkNb, std::vector<T>& buffer)`), the
+ * specialization below is used instead.
+ */
+template <class FileIOImplementer, typename T, typename Enable = void>
+class ChunkReaderOf
+{
+public:
+    ChunkReaderOf(const QString& fileName, const QVariantMap&) : _fileName(fileName) {}
+
+    bool read(uint chunkNb, std::vector<T>& buffer)
+    {
+        auto chunk = _implementer.template readChunk<T>(_fileName, chunkNb);
+        if(chunk.size() != buffer.size())
+            return false;
+
+        buffer.swap(chunk);
+        return true;
+    }
+
+private:
+    FileIOImplementer _implementer;
+    QString _fileName;
+};
+
+template <class FileIOImplementer, typename T>
+class ChunkReaderOf<FileIOImplementer, T,
+                    typename MakeVoid<typename FileIOImplementer::template ChunkReader<T>>::type>
+    : public FileIOImplementer::template ChunkReader<T>
+{
+    typedef typename FileIOImplementer::template ChunkReader<T> Base;
+
+public:
+    ChunkReaderOf(const QString& fileName, const QVariantMap& metaInfo) : Base(fileName, metaInfo) {}
+};
+
+} // namespace details
+
+/*!
+ * \class BaseTypeIO::PrefetchingReader
+ *
+ * \brief Stateful reader for sequential access to the chunks (slices/views) of a single file.
+ *
+ * In contrast to BaseTypeIO::readSlice() and BaseTypeIO::readSingleView(), which open the file and
+ * parse its meta information on each call, a PrefetchingReader does this only once in its
+ * constructor. Subsequently, a background thread reads the chunks that follow the most recently
+ * requested one, such that sequential scans overlap file access with the computations of the
+ * caller.
+ *
+ * The reader holds a fixed pool of nbPrefetchedChunks() chunk slots. The buffer of a chunk is handed
+ * over to the caller without copying; the slot is then refilled by the background thread, which
+ * also allocates its new buffer. Non-sequential requests are served as well: the prefetching then restarts at the
+ * requested chunk. If the FileIOImplementer provides a stateful `ChunkReader<T>` (e.g.
+ * NrrdFileIO::ChunkReader), the file is also kept open during the lifetime of the reader.
+ *
+ * For projection data, choose \a nbPrefetchedChunks of at least the number of detector modules.
+ *
+ * Example:
+ * \code
+ * auto reader = BaseTypeIO<NrrdFileIO>::makePrefetchingReader<float>("projections.nrrd", 8);
+ * for(uint view = 0; view < nbViews; ++view)
+ * {
+ *     auto viewData = reader->readSingleView(view); // next views are read in the background
+ *     // ... process viewData
+ * }
+ * \endcode
+ */
+template <class FileIOImplementer>
+template <typename T>
+class BaseTypeIO<FileIOImplementer>::PrefetchingReader
+{
+public:
+    explicit PrefetchingReader(const QString& fileName, uint nbPrefetchedChunks = 4);
+    ~PrefetchingReader();
+
+    // non-copyable
+    PrefetchingReader(const PrefetchingReader&) = delete;
+    PrefetchingReader& operator=(const PrefetchingReader&) = delete;
+
+    const QVariantMap& metaInfo() const;
+    uint nbChunks() const;
+    uint nbPrefetchedChunks() const;
+
+    Chunk2D<T> readSlice(uint sliceNb);
+    SingleViewData readSingleView(uint viewNb, uint nbModules = 0);
+
+private:
+    struct Slot
+    {
+        enum State { Empty, Loading, Ready } state = Empty;
+        uint chunkNb = 0;
+        bool ok = false;
+        std::exception_ptr error; //!< exception thrown while reading the chunk (if any)
+        std::vector<T> buffer;
+    };
+
+    QVariantMap _metaInfo; //!< meta information of the file (parsed once)
+    uint _chunkWidth = 0;
+    uint _chunkHeight = 0;
+    uint _nbChunks = 0;
+
+    details::ChunkReaderOf<FileIOImplementer, T> _reader; //!< used by the worker thread only
+    std::vector<Slot> _slots; //!< recycled chunk buffers
+    uint _windowStart = 0; //!< first chunk of the prefetch window
+    uint _nextChunk = 0; //!< next chunk to be read by the worker
+    bool _stop = false;
+
+    std::mutex _mutex;
+    std::condition_variable _chunkReady;
+    std::condition_variable _workAvailable;
+    std::thread _worker;
+
+    std::vector<T> takeChunk(uint chunkNb);
+    Slot* nextTask();
+    void releaseOutsideWindow();
+    void prefetchLoop();
+};
+
+/*!
+ * Creates a PrefetchingReader for the file \a fileName that reads up to \a nbPrefetchedChunks
+ * chunks ahead of the most recently requested chunk.
+ */
+template <class FileIOImplementer>
+template <typename T>
+auto BaseTypeIO<FileIOImplementer>::makePrefetchingReader(const QString& fileName,
+                                                          uint nbPrefetchedChunks)
+    -> std::unique_ptr<PrefetchingReader<T>>
+{
+    return std::unique_ptr<PrefetchingReader<T>>(
+        new PrefetchingReader<T>(fileName, nbPrefetchedChunks));
+}
+
+/*!
+ * Constructs a PrefetchingReader for the file \a fileName that reads up to \a nbPrefetchedChunks
+ * (at least one) chunks ahead of the most recently requested chunk. Prefetching of the first chunks
+ * starts immediately.
+ *
+ * Throws an std::runtime_error if the meta information of the file does not specify valid
+ * dimensions.
+ */
+template <class FileIOImplementer>
+template <typename T>
+BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::PrefetchingReader(const QString& fileName,
+                                                                       uint nbPrefetchedChunks)
+    : _metaInfo(FileIOImplementer().metaInfo(fileName))
+    , _reader(fileName, _metaInfo)
+    , _slots(std::max(nbPrefetchedChunks, 1u))
+{
+    const auto dimList = _metaInfo.value(meta_info::dimensions).value<meta_info::Dimensions>();
+    switch(dimList.nbDim)
+    {
+    case 2: _nbChunks = 1u;
+        break;
+    case 3: _nbChunks = dimList.dim3;
+        break;
+    case 4: _nbChunks = dimList.dim3 * dimList.dim4;
+        break;
+    default:
+        throw std::runtime_error("PrefetchingReader: missing file meta information about the "
+                                 "dimensions of the data in " + fileName.toStdString());
+    }
+    _chunkWidth = dimList.dim1;
+    _chunkHeight = dimList.dim2;
+
+    _worker = std::thread(&PrefetchingReader::prefetchLoop, this);
+}
+
+/*!
+ * Stops prefetching and waits for the background thread to finish.
+ */
+template <class FileIOImplementer>
+template <typename T>
+BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::~PrefetchingReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _workAvailable.notify_one();
+    _worker.join();
+}
+
+/*!
+ * Returns the meta information of the file (extracted once during construction).
+ */
+template <class FileIOImplementer>
+template <typename T>
+const QVariantMap& BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::metaInfo() const
+{
+    return _metaInfo;
+}
+
+/*!
+ * Returns the number of chunks in the file, i.e. the number of *z*-slices (volumes) or the number
+ * of views times the number of modules (projections).
+ */
+template <class FileIOImplementer>
+template <typename T>
+uint BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::nbChunks() const
+{
+    return _nbChunks;
+}
+
+/*!
+ * Returns the maximum number of chunks that are read ahead (i.e. the number of chunk buffers).
+ */
+template <class FileIOImplementer>
+template <typename T>
+uint BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::nbPrefetchedChunks() const
+{
+    return uint(_slots.size());
+}
+
+/*!
+ * Reads the slice \a sliceNb of the file (see BaseTypeIO::readSlice()). Waits until the slice is
+ * available and triggers prefetching of the subsequent slices.
+ *
+ * Throws an std::runtime_error if reading the slice fails. Exceptions thrown by the underlying
+ * reader (in the background thread) are rethrown.
+ */
+template <class FileIOImplementer>
+template <typename T>
+Chunk2D<T> BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::readSlice(uint sliceNb)
+{
+    return Chunk2D<T>(_chunkWidth, _chunkHeight, takeChunk(sliceNb));
+}
+
+/*!
+ * Reads projection data of the view \a viewNb (see BaseTypeIO::readSingleView()). Waits until the
+ * data of all \a nbModules modules is available and triggers prefetching of the subsequent
+ * chunks.
+ *
+ * Throws an std::runtime_error if reading the data fails. Exceptions thrown by the underlying
+ * reader (in the background thread) are rethrown.
+ */
+template <class FileIOImplementer>
+template <typename T>
+SingleViewData BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::readSingleView(uint viewNb,
+                                                                                   uint nbModules)
+{
+    static_assert(std::is_same<T, float>::value,
+                  "PrefetchingReader::readSingleView requires a reader for 'float' data.");
+
+    const auto dim = BaseTypeIO().dimensionsFromMetaInfo(_metaInfo, nbModules);
+
+    SingleViewData ret(dim.nbChannels, dim.nbRows);
+    ret.allocateMemory(dim.nbModules);
+
+    uint indexLookup = viewNb * dim.nbModules;
+    for(uint mod = 0; mod < dim.nbModules; ++mod)
+        ret.module(mod).setData(takeChunk(indexLookup++));
+
+    return ret;
+}
+
+// returns the data of chunk `chunkNb` (waits until the chunk has been read by the worker);
+// rethrows the exception of the worker if reading the chunk has thrown
+template <class FileIOImplementer>
+template <typename T>
+std::vector<T> BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::takeChunk(uint chunkNb)
+{
+    if(chunkNb >= _nbChunks)
+        throw std::runtime_error("PrefetchingReader: chunk " + std::to_string(chunkNb) +
+                                 " exceeds total number of chunks in file ("
+                                 + std::to_string(_nbChunks) + ")");
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // non-sequential access: restart prefetching at the requested chunk
+    if(chunkNb < _windowStart || chunkNb >= _windowStart + _slots.size())
+        _nextChunk = chunkNb;
+    _windowStart = chunkNb;
+    _nextChunk = std::max(_nextChunk, chunkNb);
+    releaseOutsideWindow();
+    _workAvailable.notify_one();
+
+    Slot* slot = nullptr;
+    _chunkReady.wait(lock, [this, chunkNb, &slot] {
+        for(auto& s : _slots)
+            if(s.state == Slot::Ready && s.chunkNb == chunkNb)
+            {
+                slot = &s;
+                return true;
+            }
+        return false;
+    });
+
+    const auto ok = slot->ok;
+    const auto error = slot->error;
+    slot->error = nullptr;
+    std::vector<T> ret;
+    if(ok)
+        ret.swap(slot->buffer); // the worker allocates a new buffer when refilling the slot
+
+    // the slot can be reused for the next chunk
+    slot->state = Slot::Empty;
+    _windowStart = chunkNb + 1;
+    lock.unlock();
+    _workAvailable.notify_one();
+
+    if(error)
+        std::rethrow_exception(error);
+    if(!ok)
+        throw std::runtime_error("PrefetchingReader: reading chunk " + std::to_string(chunkNb) +
+                                 " failed");
+
+    return ret;
+}
+
+// returns an empty slot if there is a chunk in the prefetch window that needs to be read (the
+// chunk number is stored in `_nextChunk`), otherwise nullptr; requires the lock of `_mutex`
+template <class FileIOImplementer>
+template <typename T>
+auto BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::nextTask() -> Slot*
+{
+    const auto windowEnd = std::min(size_t(_windowStart) + _slots.size(), size_t(_nbChunks));
+
+    auto isPresent = [this](uint chunkNb) {
+        return std::any_of(_slots.cbegin(), _slots.cend(), [chunkNb](const Slot& s) {
+            return s.state != Slot::Empty && s.chunkNb == chunkNb;
+        });
+    };
+    while(_nextChunk < windowEnd && isPresent(_nextChunk))
+        ++_nextChunk;
+    if(_nextChunk >= windowEnd)
+        return nullptr;
+
+    const auto emptySlot = std::find_if(_slots.begin(), _slots.end(),
+                                        [](const Slot& s) { return s.state == Slot::Empty; });
+
+    return emptySlot != _slots.end() ? &*emptySlot : nullptr;
+}
+
+// releases all read chunks that are not within the prefetch window; requires the lock of `_mutex`
+template <class FileIOImplementer>
+template <typename T>
+void BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::releaseOutsideWindow()
+{
+    for(auto& slot : _slots)
+        if(slot.state == Slot::Ready &&
+           (slot.chunkNb < _windowStart || slot.chunkNb >= _windowStart + _slots.size()))
+            slot.state = Slot::Empty;
+}
+
+// worker thread: reads the chunks of the prefetch window into the empty slots; an exception thrown
+// while reading a chunk is stored in its slot and rethrown by takeChunk() on the consumer thread
+template <class FileIOImplementer>
+template <typename T>
+void BaseTypeIO<FileIOImplementer>::PrefetchingReader<T>::prefetchLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(true)
+    {
+        Slot* slot = nullptr;
+        _workAvailable.wait(lock, [this, &slot] { return _stop || (slot = nextTask()); });
+        if(_stop)
+            return;
+
+        const auto chunkNb = _nextChunk++;
+        slot->state = Slot::Loading;
+        slot->chunkNb = chunkNb;
+
+        // the buffer of a loading slot is accessed by the worker only
+        lock.unlock();
+        auto ok = false;
+        std::exception_ptr error;
+        try
+        {
+            slot->buffer.resize(size_t(_chunkWidth) * _chunkHeight);
+            ok = _reader.read(chunkNb, slot->buffer);
+        } catch(...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        slot->ok = ok;
+        slot->error = error;
+        slot->state = Slot::Ready;
+        releaseOutsideWindow();
+        _chunkReady.notify_all();
+    }
+}
+
+} // namespace io
+} // namespace CTL
@@ -0,0 +1,340 @@
+#include "rawfilewriter.h"
+#include "processing/threadpool.h"
+#include "tracer.h"
+
+#include <QDebug>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CTL {
+namespace io {
+
+namespace {
+
+const size_t BLOCK_SIZE = 4096; // alignment of the file regions (and direct I/O)
+const size_t STAGING_BUFFER_SIZE = 16u * 1024u * 1024u; // per thread (direct I/O)
+const size_t MAX_WRITE_SIZE = 64u * 1024u * 1024u; // maximum size of a single write call
+const size_t MIN_NB_BYTES_PER_THREAD = 32u * 1024u * 1024u;
+
+size_t roundUp(size_t value, size_t multiple) { return (value + multiple - 1) / multiple * multiple; }
+
+// content of the file, i.e. the concatenation of all segments
+class Content
+{
+public:
+    explicit Content(const std::vector<RawFileWriter::Segment>& segments)
+        : _segments(segments)
+        , _starts(1, 0)
+    {
+        for(const auto& seg : segments)
+            _starts.push_back(_starts.back() + seg.size);
+    }
+
+    size_t size() const { return _starts.back(); }
+
+    // calls `f(data, offset, size)` for all contiguous pieces of the content within [begin, end)
+    template <class Function>
+    void forEachPiece(size_t begin, size_t end, Function f) const
+    {
+        auto seg = size_t(std::upper_bound(_starts.cbegin(), _starts.cend(), begin)
+                          - _starts.cbegin()) - 1;
+        for(auto pos = begin; pos < end; ++seg)
+        {
+            const auto segEnd = std::min(_starts[seg + 1], end);
+            if(segEnd > pos)
+                f(_segments[seg].data + (pos - _starts[seg]), pos, segEnd - pos);
+            pos = std::max(pos, segEnd);
+        }
+    }
+
+private:
+    const std::vector<RawFileWriter::Segment>& _segments;
+    std::vector<size_t> _starts; // offset of each segment in the file (plus total size)
+};
+
+// file that supports concurrent writes at arbitrary offsets
+class OutputFile
+{
+public:
+    ~OutputFile();
+
+    // reports the reason if opening fails
+    bool open(const QString& fileName, bool directIO);
+    bool isDirect() const { return _isDirect; }
+    bool resize(size_t size);
+    bool writeAt(const char* data, size_t size, size_t offset) const;
+
+private:
+#ifdef Q_OS_UNIX
+    int _fd = -1;
+#else
+    mutable std::fstream _file;
+    mutable std::mutex _mutex; // serializes the writes to `_file`
+#endif
+    bool _isDirect = false;
+};
+
+#ifdef Q_OS_UNIX
+
+OutputFile::~OutputFile()
+{
+    if(_fd >= 0)
+        ::close(_fd);
+}
+
+bool OutputFile::open(const QString& fileName, bool directIO)
+{
+    const auto name = fileName.toLocal8Bit();
+    const auto flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+    if(directIO)
+    {
+        _fd = ::open(name.constData(), flags | O_DIRECT, 0644);
+        _isDirect = _fd >= 0;
+        // EINVAL: the file system does not support direct I/O
+        if(!_isDirect && errno == EINVAL)
+            qWarning() << "RawFileWriter: direct I/O not supported for" << fileName
+                       << "- using buffered I/O.";
+        else if(!_isDirect)
+        {
+            qCritical() << "RawFileWriter: cannot open file" << fileName << "-"
+                        << std::strerror(errno);
+            return false;
+        }
+    }
+#else
+    Q_UNUSED(directIO)
+#endif
+    if(_fd < 0)
+        _fd = ::open(name.constData(), flags, 0644);
+    if(_fd < 0)
+    {
+        qCritical() << "RawFileWriter: cannot open file" << fileName << "-" << std::strerror(errno);
+        return false;
+    }
+
+    return true;
+}
+
+bool OutputFile::resize(size_t size) { return ::ftruncate(_fd, off_t(size)) == 0; }
+
+bool OutputFile::writeAt(const char* data, size_t size, size_t offset) const
+{
+    while(size > 0)
+    {
+        const auto written = ::pwrite(_fd, data, size, off_t(offset));
+        if(written < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= size_t(written);
+        offset += size_t(written);
+    }
+    return true;
+}
+
+#else // fallback: a single standard stream, writes are serialized
+
+OutputFile::~OutputFile() = default;
+
+bool OutputFile::open(const QString& fileName, bool)
+{
+    _file.open(fileName.toStdString(), std::ios::binary | std::ios::out | std::ios::trunc);
+    if(!_file.is_open())
+    {
+        qCritical() << "RawFileWriter: cannot open file" << fileName;
+        return false;
+    }
+
+    return true;
+}
+
+bool OutputFile::resize(size_t) { return true; }
+
+bool OutputFile::writeAt(const char* data, size_t size, size_t offset) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _file.seekp(std::streamoff(offset));
+    _file.write(data, std::streamsize(size));
+    return bool(_file);
+}
+
+#endif // Q_OS_UNIX
+
+// aligned memory for direct I/O
+std::unique_ptr<char, void (*)(void*)> alignedBuffer(size_t size)
+{
+    void* ptr = nullptr;
+#ifdef Q_OS_UNIX
+    if(::posix_memalign(&ptr, BLOCK_SIZE, size) != 0)
+        ptr = nullptr;
+#else
+    Q_UNUSED(size)
+#endif
+    return { static_cast<char*>(ptr), std::free };
+}
+
+} // unnamed namespace
+
+/*!
+ * Constructs a RawFileWriter that uses \a nbThreads threads (zero:
+ * `std::thread::hardware_concurrency()`) and writes with direct I/O if \a directIO is `true`.
+ */
+RawFileWriter::RawFileWriter(uint nbThreads, bool directIO)
+    : _nbThreads(nbThreads)
+    , _directIO(directIO)
+    , _minNbBytesPerThread(MIN_NB_BYTES_PER_THREAD)
+{
+}
+
+/*!
+ * Writes the concatenation of all \a segments to the file \a fileName. An existing file is
+ * overwritten. Returns `false` if the file could not be opened or writing failed.
+ */
+bool RawFileWriter::write(const QString& fileName, const std::vector<Segment>& segments) const
+{
+    CTL_TRACE_SPAN("io", "RawFileWriter::write");
+
+    const Content content(segments);
+
+    OutputFile file;
+    if(!file.open(fileName, _directIO && isDirectIOSupported()))
+        return false;
+
+    // buffered I/O: the file gets its final size beforehand to avoid concurrent size changes
+    if(!file.isDirect() && !file.resize(content.size()))
+        return false;
+
+    // split into contiguous regions (aligned to the block size)
+    const auto nbThreads = std::max(size_t(1),
+        std::min(size_t(_nbThreads == 0 ? std::thread::hardware_concurrency() : _nbThreads),
+                 content.size() / std::max(_minNbBytesPerThread, size_t(1)) + 1));
+    const auto regionSize = roundUp((content.size() + nbThreads - 1) / nbThreads, BLOCK_SIZE);
+
+    const auto isDirect = file.isDirect();
+    auto writeRegion = [&content, &file, isDirect](size_t begin, size_t end, char* success) {
+        *success = true;
+        if(!isDirect)
+        {
+            content.forEachPiece(begin, end, [&](const char* data, size_t offset, size_t size) {
+                for(size_t written = 0; written < size && *success; written += MAX_WRITE_SIZE)
+                    if(!file.writeAt(data + written, std::min(MAX_WRITE_SIZE, size - written),
+                                     offset + written))
+                        *success = false;
+            });
+            return;
+        }
+
+        // direct I/O: gather the content into an aligned buffer, pad the last block with zeros
+        auto buffer = alignedBuffer(STAGING_BUFFER_SIZE);
+        if(!buffer)
+        {
+            *success = false;
+            return;
+        }
+        for(auto pos = begin; pos < end && *success; pos += STAGING_BUFFER_SIZE)
+        {
+            const auto size = std::min(STAGING_BUFFER_SIZE, end - pos);
+            const auto paddedSize = roundUp(size, BLOCK_SIZE);
+            content.forEachPiece(pos, pos + size, [&](const char* data, size_t offset, size_t n) {
+                std::memcpy(buffer.get() + (offset - pos), data, n);
+            });
+            std::memset(buffer.get() + size, 0, paddedSize - size);
+            *success = file.writeAt(buffer.get(), paddedSize, pos);
+        }
+    };
+
+    std::vector<char> success(nbThreads, true);
+    {
+        ThreadPool tp(success.size());
+        for(size_t t = 0; t * regionSize < content.size(); ++t)
+            tp.enqueueThread(writeRegion, t * regionSize,
+                             std::min((t + 1) * regionSize, content.size()), &success[t]);
+    }
+
+    // direct I/O: remove the padding of the last block
+    if(isDirect && !file.resize(content.size()))
+        success.front() = false;
+
+    if(std::find(success.cbegin(), success.cend(), char(false)) != success.cend())
+    {
+        qCritical() << "RawFileWriter: writing to file" << fileName << "failed";
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * Returns the number of threads used for writing (zero: `std::thread::hardware_concurrency()`).
+ */
+uint RawFileWriter::nbThreads() const { return _nbThreads; }
+
+/*!
+ * Returns `true` if direct I/O is requested (see isDirectIOSupported()).
+ */
+bool RawFileWriter::isDirectIO() const { return _directIO; }
+
+/*!
+ * Returns the minimum number of bytes that is written by a single thread.
+ */
+size_t RawFileWriter::minNbBytesPerThread() const { return _minNbBytesPerThread; }
+
+/*!
+ * Sets the number of threads used for writing to \a nbThreads. A value of zero defaults to
+ * `std::thread::hardware_concurrency()`.
+ */
+void RawFileWriter::setNbThreads(uint nbThreads) { _nbThreads = nbThreads; }
+
+/*!
+ * Sets the usage of direct I/O (i.e. bypassing the page cache) to \a enabled. Has no effect if
+ * direct I/O is not supported by the platform (see isDirectIOSupported()).
+ */
+void RawFileWriter::setDirectIO(bool enabled) { _directIO = enabled; }
+
+/*!
+ * Sets the minimum number of bytes that is written by a single thread to \a nbBytes, i.e. files
+ * smaller than `nbThreads() * nbBytes` are written by fewer threads (default: 32 MiB). Since the
+ * regions of the threads are aligned to blockSize(), values below blockSize() have the same effect
+ * as blockSize().
+ */
+void RawFileWriter::setMinNbBytesPerThread(size_t nbBytes) { _minNbBytesPerThread = nbBytes; }
+
+/*!
+ * Returns `true` if the platform supports direct I/O (`O_DIRECT`).
+ */
+bool RawFileWriter::isDirectIOSupported()
+{
+#if defined(Q_OS_UNIX) && defined(O_DIRECT)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*!
+ * Returns the size (in bytes) to which the file regions of the individual threads are aligned.
+ */
+size_t RawFileWriter::blockSize() { return BLOCK_SIZE; }
+
+/*!
+ * Returns the size (in bytes) of the staging buffer of each thread in case of direct I/O.
+ */
+size_t RawFileWriter::stagingBufferSize() { return STAGING_BUFFER_SIZE; }
+
+} // namespace io
+} // namespace CTL
@@ -0,0 +1,61 @@
+#ifndef CTL_RAWFILEWRITER_H
+#define CTL_RAWFILEWRITER_H
+
+#include <QString>
+#include <vector>
+
+namespace CTL {
+namespace io {
+
+/*!
+ * \class RawFileWriter
+ *
+ * \brief Writes a sequence of memory segments to a file using parallel, large writes.
+ *
+ * The content of the file is the concatenation of all segments passed to write() (e.g. a file
+ * header followed by the data of all views and modules of a ProjectionData object). The segments
+ * are written directly from their memory location, i.e. without assembling the content in an
+ * intermediate buffer. The file is split into contiguous regions (aligned to blockSize()) that are
+ * written concurrently by nbThreads() threads.
+ *
+ * Optionally, the file can be written with direct I/O (`O_DIRECT`, Linux only), which bypasses the
+ * page cache of the operating system. In this case, the data is gathered into aligned staging
+ * buffers of stagingBufferSize() bytes per thread. If the file system does not support direct I/O,
+ * the writer falls back to buffered I/O.
+ *
+ * RawFileWriter is used by BaseTypeIO::writeParallel() and BaseTypeIO::writeSharded().
+ */
+class RawFileWriter
+{
+public:
+    struct Segment
+    {
+        const char* data;
+        size_t size;
+    };
+
+    explicit RawFileWriter(uint nbThreads = 0, bool directIO = false);
+
+    bool write(const QString& fileName, const std::vector<Segment>& segments) const;
+
+    uint nbThreads() const;
+    bool isDirectIO() const;
+    size_t minNbBytesPerThread() const;
+    void setNbThreads(uint nbThreads);
+    void setDirectIO(bool enabled);
+    void setMinNbBytesPerThread(size_t nbBytes);
+
+    static bool isDirectIOSupported();
+    static size_t blockSize();
+    static size_t stagingBufferSize();
+
+private:
+    uint _nbThreads; //!< zero: `std::thread::hardware_concurrency()`
+    bool _directIO;
+    size_t _minNbBytesPerThread; //!< smaller files are written by fewer threads
+};
+
+} // namespace io
+} // namespace CTL
+
+#endif // CTL_RAWFILEWRITER_H
@@ -0,0 +1,294 @@
+#include "tracer.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <map>
+
+#ifdef __GNUG__
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+namespace CTL {
+
+namespace {
+
+// readable name of an event (demangled type name if applicable)
+QString eventName(const Tracer::Event& event)
+{
+#ifdef __GNUG__
+    if(event.isTypeName)
+    {
+        int status = 0;
+        std::unique_ptr<char, void (*)(void*)> demangled(
+            abi::__cxa_demangle(event.name, nullptr, nullptr, &status), std::free);
+        if(status == 0 && demangled)
+            return QString::fromLatin1(demangled.get());
+    }
+#endif
+    return QString::fromLatin1(event.name);
+}
+
+} // unnamed namespace
+
+/*!
+ * Holds the events recorded by a single thread. The buffer is shared between the thread (thread
+ * local storage) and the Tracer, such that events remain available after the thread has finished.
+ */
+struct Tracer::ThreadBuffer
+{
+    std::mutex mutex; //!< only contended while the tracer exports the events
+    std::vector<Event> events;
+    uint threadIndex;
+};
+
+Tracer::Tracer()
+    : _epoch(std::chrono::steady_clock::now())
+{
+}
+
+/*!
+ * Returns the global instance of the Tracer.
+ */
+Tracer& Tracer::instance()
+{
+    static Tracer theInstance;
+    return theInstance;
+}
+
+/*!
+ * Enables (or disables) recording of spans.
+ */
+void Tracer::setEnabled(bool enabled) { _enabled.store(enabled); }
+
+/*!
+ * Removes all recorded events.
+ */
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // drop buffers of finished threads
+    _buffers.erase(std::remove_if(_buffers.begin(), _buffers.end(),
+                                  [](const std::shared_ptr<ThreadBuffer>& buf) {
+                                      return buf.use_count() == 1;
+                                  }),
+                   _buffers.end());
+
+    for(const auto& buf : _buffers)
+    {
+        std::lock_guard<std::mutex> bufLock(buf->mutex);
+        buf->events.clear();
+    }
+}
+
+/*!
+ * Returns the total number of recorded events (of all threads).
+ */
+size_t Tracer::nbEvents() const
+{
+    size_t ret = 0;
+    for(const auto& thread : eventsPerThread())
+        ret += thread.second.size();
+    return ret;
+}
+
+/*!
+ * Returns all recorded events in the Chrome trace event format (JSON object format with complete
+ * events, i.e. phase "X"). Timestamps and durations are given in microseconds. The argument of a
+ * span (if any) is stored as `args.index`.
+ */
+QByteArray Tracer::chromeTraceJson() const
+{
+    const auto pid = QCoreApplication::applicationPid();
+
+    QJsonArray traceEvents;
+    for(const auto& thread : eventsPerThread())
+    {
+        // metadata: name of the thread
+        const QJsonObject threadName{ { "name", QStringLiteral("thread %1").arg(thread.first) } };
+        traceEvents.append(QJsonObject{ { "name", "thread_name" },
+                                        { "ph", "M" },
+                                        { "pid", pid },
+                                        { "tid", int(thread.first) },
+                                        { "args", threadName } });
+
+        for(const auto& event : thread.second)
+        {
+            QJsonObject obj{ { "name", eventName(event) },
+                             { "cat", QString::fromLatin1(event.category) },
+                             { "ph", "X" },
+                             { "ts", double(event.start) * 1.0e-3 },
+                             { "dur", double(event.duration) * 1.0e-3 },
+                             { "pid", pid },
+                             { "tid", int(thread.first) } };
+            if(event.arg >= 0)
+                obj.insert("args", QJsonObject{ { "index", double(event.arg) } });
+
+            traceEvents.append(obj);
+        }
+    }
+
+    QJsonObject root{ { "traceEvents", traceEvents }, { "displayTimeUnit", "ms" } };
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+/*!
+ * Writes all recorded events in the Chrome trace event format (see chromeTraceJson()) to the file
+ * \a fileName. Returns `false` if the file could not be written.
+ */
+bool Tracer::writeChromeTrace(const QString& fileName) const
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        qCritical() << "Tracer: cannot open file" << fileName;
+        return false;
+    }
+
+    return file.write(chromeTraceJson()) >= 0;
+}
+
+/*!
+ * Returns the recorded spans aggregated per stage (i.e. per category and name), sorted by their
+ * total time in descending order.
+ *
+ * The self time of a span is its duration minus the durations of all spans that are directly
+ * nested within it on the same thread. Work that a span delegates to other threads (e.g. the
+ * individual views computed by a ThreadPool) is therefore part of its self time.
+ */
+std::vector<Tracer::StageSummary> Tracer::summary() const
+{
+    std::map<std::pair<QString, QString>, StageSummary> stages;
+
+    for(auto& thread : eventsPerThread())
+    {
+        auto& events = thread.second;
+        std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+            return a.start < b.start || (a.start == b.start && a.duration > b.duration);
+        });
+
+        // self time: subtract the duration of each span from its enclosing span
+        std::vector<int64_t> selfTime(events.size());
+        std::vector<size_t> stack;
+        for(size_t e = 0; e < events.size(); ++e)
+        {
+            while(!stack.empty() && events[stack.back()].start + events[stack.back()].duration
+                                        <= events[e].start)
+                stack.pop_back();
+            if(!stack.empty())
+                selfTime[stack.back()] -= events[e].duration;
+
+            selfTime[e] += events[e].duration;
+            stack.push_back(e);
+        }
+
+        for(size_t e = 0; e < events.size(); ++e)
+        {
+            const auto category = QString::fromLatin1(events[e].category);
+            const auto name = eventName(events[e]);
+            const auto durationMs = double(events[e].duration) * 1.0e-6;
+
+            auto it = stages.find({ category, name });
+            if(it == stages.end())
+            {
+                const StageSummary init{ category, name, 0, 0.0, 0.0, durationMs, durationMs };
+                it = stages.insert({ { category, name }, init }).first;
+            }
+
+            auto& stage = it->second;
+            ++stage.count;
+            stage.totalMs += durationMs;
+            stage.selfMs += double(selfTime[e]) * 1.0e-6;
+            stage.minMs = std::min(stage.minMs, durationMs);
+            stage.maxMs = std::max(stage.maxMs, durationMs);
+        }
+    }
+
+    std::vector<StageSummary> ret;
+    ret.reserve(stages.size());
+    for(const auto& stage : stages)
+        ret.push_back(stage.second);
+
+    std::sort(ret.begin(), ret.end(), [](const StageSummary& a, const StageSummary& b) {
+        return a.totalMs > b.totalMs;
+    });
+
+    return ret;
+}
+
+/*!
+ * Returns the summary() as a human-readable table (one line per stage).
+ */
+QString Tracer::summaryTable() const
+{
+    auto number = [](double value) { return QString::number(value, 'f', 3).rightJustified(12); };
+
+    QString ret = QStringLiteral("category").leftJustified(12)
+                  + QStringLiteral("name").leftJustified(40)
+                  + QStringLiteral("count").rightJustified(8);
+    for(const auto& column : { "total [ms]", "self [ms]", "mean [ms]", "min [ms]", "max [ms]" })
+        ret += QString::fromLatin1(column).rightJustified(12);
+    ret += '\n';
+
+    for(const auto& stage : summary())
+        ret += stage.category.leftJustified(12) + stage.name.leftJustified(40)
+               + QString::number(stage.count).rightJustified(8) + number(stage.totalMs)
+               + number(stage.selfMs) + number(stage.totalMs / stage.count) + number(stage.minMs)
+               + number(stage.maxMs) + '\n';
+
+    return ret;
+}
+
+/*!
+ * Adds \a event to the buffer of the calling thread.
+ */
+void Tracer::record(const Event& event)
+{
+    auto& buf = threadBuffer();
+    std::lock_guard<std::mutex> lock(buf.mutex);
+    buf.events.push_back(event);
+}
+
+/*!
+ * Returns the buffer of the calling thread. The buffer is created (and registered) on first use.
+ */
+Tracer::ThreadBuffer& Tracer::threadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if(!buffer)
+    {
+        buffer = std::make_shared<ThreadBuffer>();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        buffer->threadIndex = _nbThreads++;
+        _buffers.push_back(buffer);
+    }
+
+    return *buffer;
+}
+
+/*!
+ * Returns a copy of the events of all threads (together with the thread index).
+ */
+std::vector<std::pair<uint, std::vector<Tracer::Event>>> Tracer::eventsPerThread() const
+{
+    std::vector<std::pair<uint, std::vector<Event>>> ret;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(const auto& buf : _buffers)
+    {
+        std::lock_guard<std::mutex> bufLock(buf->mutex);
+        if(!buf->events.empty())
+            ret.emplace_back(buf->threadIndex, buf->events);
+    }
+
+    return ret;
+}
+
+} // namespace CTL
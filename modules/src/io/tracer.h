@@ -0,0 +1,204 @@
+#ifndef CTL_TRACER_H
+#define CTL_TRACER_H
+
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <typeinfo>
+#include <vector>
+
+namespace CTL {
+
+/*!
+ * \class Tracer
+ *
+ * \brief Collects timing spans of the individual stages of a simulation (e.g. the projection
+ * pipeline) for performance analysis.
+ *
+ * Spans are recorded by TraceSpan objects (or the macros CTL_TRACE_SPAN and
+ * CTL_TRACE_SPAN_ARG), which measure the time between their construction and destruction. Each
+ * span has a category (e.g. "projector", "io", "ocl") and a name; optionally, an integer argument
+ * (e.g. the view index) can be attached. Spans recorded by the same thread can be nested.
+ *
+ * Recording is disabled by default and has to be enabled with setEnabled(). While disabled, a
+ * TraceSpan only performs a single (relaxed) atomic load. While enabled, each thread records into
+ * its own buffer, i.e. threads do not contend for a common lock.
+ *
+ * The recorded spans can be exported in the Chrome trace event format (see writeChromeTrace()),
+ * which can be inspected e.g. with `chrome://tracing` or Perfetto, or aggregated per stage (see
+ * summary() and summaryTable()).
+ *
+ * Example:
+ * \code
+ * Tracer::instance().setEnabled(true);
+ *
+ * auto projections = pipeline.project(volume);
+ *
+ * Tracer::instance().writeChromeTrace("trace.json");
+ * qInfo().noquote() << Tracer::instance().summaryTable();
+ * \endcode
+ *
+ * To remove all instrumentation from the library at compile time, define CTL_DISABLE_TRACING
+ * (e.g. `DEFINES += CTL_DISABLE_TRACING` in your qmake project). The macros then expand to no-ops.
+ */
+class Tracer
+{
+public:
+    struct Event
+    {
+        const char* category; //!< static string
+        const char* name;     //!< static string (or mangled type name, see isTypeName)
+        int64_t start;        //!< start time [ns] (relative to creation of the tracer)
+        int64_t duration;     //!< duration [ns]
+        int64_t arg;          //!< optional argument (e.g. view index), negative if unused
+        bool isTypeName;      //!< `name` is the name of a std::type_info
+    };
+
+    struct StageSummary
+    {
+        QString category;
+        QString name;
+        uint count;     //!< number of spans
+        double totalMs; //!< total time [ms], including nested spans
+        double selfMs;  //!< total time [ms], excluding nested spans (of the same thread)
+        double minMs;   //!< minimum duration of a single span [ms]
+        double maxMs;   //!< maximum duration of a single span [ms]
+    };
+
+    // non-copyable
+    Tracer(const Tracer&) = delete;
+    Tracer(Tracer&&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+    Tracer& operator=(Tracer&&) = delete;
+    ~Tracer() = default;
+
+    static Tracer& instance();
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+    void clear();
+
+    size_t nbEvents() const;
+    QByteArray chromeTraceJson() const;
+    bool writeChromeTrace(const QString& fileName) const;
+    std::vector<StageSummary> summary() const;
+    QString summaryTable() const;
+
+    int64_t now() const;
+    void record(const Event& event);
+
+private:
+    struct ThreadBuffer;
+
+    Tracer();
+    ThreadBuffer& threadBuffer();
+    std::vector<std::pair<uint, std::vector<Event>>> eventsPerThread() const;
+
+    std::atomic<bool> _enabled{ false };
+    const std::chrono::steady_clock::time_point _epoch;
+    mutable std::mutex _mutex; //!< guards _buffers
+    std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+    uint _nbThreads = 0;
+};
+
+/*!
+ * \class TraceSpan
+ *
+ * \brief Records the time from its construction to its destruction as a span of the Tracer.
+ *
+ * The \a category and \a name must be strings with static storage duration (e.g. string literals).
+ * Nothing is recorded if the Tracer is disabled at construction time.
+ */
+class TraceSpan
+{
+public:
+    TraceSpan(const char* category, const char* name, int64_t arg = -1);
+    TraceSpan(const char* category, const std::type_info& type, int64_t arg = -1);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    Tracer::Event _event;
+};
+
+// ### inline definitions ###
+
+/*!
+ * Returns `true` if recording of spans is enabled.
+ */
+inline bool Tracer::isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+/*!
+ * Returns the current time [ns] relative to the creation of the tracer.
+ */
+inline int64_t Tracer::now() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()
+                                                                - _epoch).count();
+}
+
+inline TraceSpan::TraceSpan(const char* category, const char* name, int64_t arg)
+    : _event{ category, name, -1, 0, arg, false }
+{
+    auto& tracer = Tracer::instance();
+    if(tracer.isEnabled())
+        _event.start = tracer.now();
+}
+
+inline TraceSpan::TraceSpan(const char* category, const std::type_info& type, int64_t arg)
+    : _event{ category, type.name(), -1, 0, arg, true }
+{
+    auto& tracer = Tracer::instance();
+    if(tracer.isEnabled())
+        _event.start = tracer.now();
+}
+
+inline TraceSpan::~TraceSpan()
+{
+    if(_event.start < 0)
+        return;
+
+    auto& tracer = Tracer::instance();
+    _event.duration = tracer.now() - _event.start;
+    tracer.record(_event);
+}
+
+} // namespace CTL
+
+/*! \file */
+///@{
+
+#define CTL_TRACE_CONCAT_IMPL(a, b) a##b
+#define CTL_TRACE_CONCAT(a, b) CTL_TRACE_CONCAT_IMPL(a, b)
+
+/*!
+ * \def CTL_TRACE_SPAN(category, name)
+ * Records a span (see TraceSpan) of \a category and \a name that lasts until the end of the
+ * enclosing scope. \a name may also be a std::type_info (e.g. `typeid(*this)`).
+ * Expands to nothing if CTL_DISABLE_TRACING is defined.
+ */
+
+/*!
+ * \def CTL_TRACE_SPAN_ARG(category, name, arg)
+ * Same as CTL_TRACE_SPAN, but attaches the integer \a arg (e.g. a view index) to the span.
+ */
+
+#ifndef CTL_DISABLE_TRACING
+#define CTL_TRACE_SPAN(category, name) \
+    ::CTL::TraceSpan CTL_TRACE_CONCAT(ctlTraceSpan, __LINE__)(category, name)
+#define CTL_TRACE_SPAN_ARG(category, name, arg) \
+    ::CTL::TraceSpan CTL_TRACE_CONCAT(ctlTraceSpan, __LINE__)(category, name, int64_t(arg))
+#else
+#define CTL_TRACE_SPAN(category, name) static_cast<void>(0)
+#define CTL_TRACE_SPAN_ARG(category, name, arg) static_cast<void>(0)
+#endif
+
+///@}
+
+#endif // CTL_TRACER_H
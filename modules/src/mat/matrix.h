@@ -44,60 +44,72 @@ template <uint VecDim> constexpr uint vecRangeDim(uint from, uint to);
  * Basic algebraic operations are provided and dimension checks are carried out during compilation.
  * No heap allocation is performed.
  * Elements are stored in row major order.
+ *
+ * The element type \a T defaults to `double`. Single precision matrices (e.g. `Matrix<3, 4, float>`)
+ * can be used in hot code paths that tolerate the reduced precision; conversion between element
+ * types is done by the explicit converting constructor. Matrix products of the common geometry
+ * sizes (3x3, 3x4, 4x4 and the corresponding vectors) are computed with SSE/AVX instructions if
+ * available for the target. This can be disabled by defining `CTL_MATRIX_NO_SIMD` before
+ * including `matrix.h`.
  */
 
 // Base class for uniform interface and ressource
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T = double>
 class MatrixBase
 {
 public:
+    // element type
+    typedef T value_type;
+
     // construction
     MatrixBase() = default;
-    explicit MatrixBase(double fillValue);
-    explicit MatrixBase(const double (&initArray)[Rows * Cols]);
-    template <typename... Doubles>
-    MatrixBase(double firstElement, Doubles... matrixElements);
+    explicit MatrixBase(T fillValue);
+    explicit MatrixBase(const T (&initArray)[Rows * Cols]);
+    template <typename... Elements>
+    constexpr MatrixBase(T firstElement, Elements... matrixElements);
+    template <typename T2>
+    explicit MatrixBase(const MatrixBase<Rows, Cols, T2>& other);
 
     // select row
-    double* operator[](uint row);
-    const double* operator[](uint row) const;
+    T* operator[](uint row);
+    const T* operator[](uint row) const;
 
     // individual element access with 2 indizes
     // -> standard access (without boundary check)
-    double& operator()(uint row, uint column);
-    double operator()(uint row, uint column) const;
+    T& operator()(uint row, uint column);
+    T operator()(uint row, uint column) const;
     // -> run time boundary check (throws out_of_range)
-    double& at(uint row, uint column) noexcept(false);
-    double at(uint row, uint column) const noexcept(false);
+    T& at(uint row, uint column) noexcept(false);
+    T at(uint row, uint column) const noexcept(false);
     // -> compile time boundary check (never fails)
     template <uint row, uint column>
-    double& get() noexcept;
+    T& get() noexcept;
     template <uint row, uint column>
-    double get() const noexcept;
+    T get() const noexcept;
 
     // individual element access with 1 index
     // -> standard access (without boundary check)
-    double& operator()(uint n);
-    double operator()(uint n) const;
+    T& operator()(uint n);
+    T operator()(uint n) const;
     // -> run time boundary check (throws out_of_range)
-    double& at(uint n);
-    double at(uint n) const;
+    T& at(uint n);
+    T at(uint n) const;
     // -> compile time boundary check (never fails)
     template <uint n>
-    double& get() noexcept;
+    T& get() noexcept;
     template <uint n>
-    double get() const noexcept;
+    T get() const noexcept;
 
     // pointer access to array (row-major order)
-    double* data();
-    const double* data() const;
-    const double* constData() const;
-    double* begin();
-    const double* begin() const;
-    const double* constBegin() const;
-    double* end();
-    const double* end() const;
-    const double* constEnd() const;
+    T* data();
+    const T* data() const;
+    const T* constData() const;
+    T* begin();
+    const T* begin() const;
+    const T* constBegin() const;
+    T* end();
+    const T* end() const;
+    const T* constEnd() const;
 
     // size
     constexpr size_t size() const;
@@ -107,111 +119,119 @@ public:
     std::string info(const char* lineModifier = "") const;
 
     // Euclidean norm of a vector or absolute value of a scalar
-    double norm() const;
+    T norm() const;
 
     // equality operator
-    bool operator==(const MatrixBase<Rows, Cols>& rhs) const;
-    bool operator!=(const MatrixBase<Rows, Cols>& rhs) const;
+    bool operator==(const MatrixBase<Rows, Cols, T>& rhs) const;
+    bool operator!=(const MatrixBase<Rows, Cols, T>& rhs) const;
 
 private:
     // the data
-    double _m[Rows * Cols];
+    T _m[Rows * Cols];
 };
 
 // Actual Matrix class for matrices and vectors
-template <uint Rows, uint Cols>
-class Matrix : public MatrixBase<Rows, Cols>
+template <uint Rows, uint Cols, typename T = double>
+class Matrix : public MatrixBase<Rows, Cols, T>
 {
 public:
     Matrix() = default;
-    explicit Matrix(double fillValue);
-    explicit Matrix(const double (&initArray)[Rows * Cols]);
-    template <typename... Doubles,
-              typename = typename std::enable_if<sizeof...(Doubles) + 1u == Rows * Cols>::type>
-    Matrix(double firstElement, Doubles... matrixElements);
+    explicit Matrix(T fillValue);
+    explicit Matrix(const T (&initArray)[Rows * Cols]);
+    template <typename... Elements,
+              typename = typename std::enable_if<sizeof...(Elements) + 1u == Rows * Cols>::type>
+    constexpr Matrix(T firstElement, Elements... matrixElements);
+    // conversion from a matrix with another element type (e.g. double <-> float)
+    template <typename T2>
+    explicit Matrix(const Matrix<Rows, Cols, T2>& other);
 
     // factory function that copies (+ cast if necessary) the 'NthMat' matrix from
     // a Container (stack of matrices)
     template <class Container>
-    static Matrix<Rows, Cols>
+    static Matrix<Rows, Cols, T>
     fromContainer(const Container& vector, size_t NthMat, bool* ok = nullptr);
 
     // sub-matrix extraction
     template <uint fromRow, uint toRow, uint fromCol, uint toCol>
     auto subMat() const -> Matrix<details::rangeDim(fromRow, toRow),
-                                  details::rangeDim(fromCol, toCol)>;
+                                  details::rangeDim(fromCol, toCol), T>;
     // sub-vector extraction
     template <uint from, uint to>
     auto subMat() const -> Matrix<details::vecRangeDim<Rows>(from, to),
-                                  details::vecRangeDim<Cols>(from, to)>;
+                                  details::vecRangeDim<Cols>(from, to), T>;
 
     // single vector extraction
     template <uint i>
-    Matrix<1, Cols> row() const;
+    Matrix<1, Cols, T> row() const;
     template <uint j>
-    Matrix<Rows, 1> column() const;
+    Matrix<Rows, 1, T> column() const;
 
     // unary operators etc.
     void normalize();
-    Matrix<Rows, Cols> normalized() const;
-    Matrix<Cols, Rows> transposed() const;
-    Matrix<Rows, Cols> operator-() const;
+    Matrix<Rows, Cols, T> normalized() const;
+    Matrix<Cols, Rows, T> transposed() const;
+    Matrix<Rows, Cols, T> operator-() const;
     // compound assignment
-    Matrix<Rows, Cols>& operator*=(double scalar);
-    Matrix<Rows, Cols>& operator/=(double scalar);
-    Matrix<Rows, Cols>& operator+=(const Matrix<Rows, Cols>& rhs);
-    Matrix<Rows, Cols>& operator-=(const Matrix<Rows, Cols>& rhs);
+    Matrix<Rows, Cols, T>& operator*=(T scalar);
+    Matrix<Rows, Cols, T>& operator/=(T scalar);
+    Matrix<Rows, Cols, T>& operator+=(const Matrix<Rows, Cols, T>& rhs);
+    Matrix<Rows, Cols, T>& operator-=(const Matrix<Rows, Cols, T>& rhs);
     // binary operators
-    Matrix<Rows, Cols> operator*(double scalar) const;
-    Matrix<Rows, Cols> operator/(double scalar) const;
-    Matrix<Rows, Cols> operator+(const Matrix<Rows, Cols>& rhs) const;
-    Matrix<Rows, Cols> operator-(const Matrix<Rows, Cols>& rhs) const;
+    Matrix<Rows, Cols, T> operator*(T scalar) const;
+    Matrix<Rows, Cols, T> operator/(T scalar) const;
+    Matrix<Rows, Cols, T> operator+(const Matrix<Rows, Cols, T>& rhs) const;
+    Matrix<Rows, Cols, T> operator-(const Matrix<Rows, Cols, T>& rhs) const;
     template <uint Cols2> // standard matrix multiplication
-    Matrix<Rows, Cols2> operator*(const Matrix<Cols, Cols2>& rhs) const;
+    Matrix<Rows, Cols2, T> operator*(const Matrix<Cols, Cols2, T>& rhs) const;
 };
 
 // Scalar specialization
-template <>
-class Matrix<1, 1> : public MatrixBase<1, 1>
+template <typename T>
+class Matrix<1, 1, T> : public MatrixBase<1, 1, T>
 {
 public:
     Matrix() = default;
-    Matrix(double value);
+    Matrix(T value);
+    template <typename T2>
+    explicit Matrix(const Matrix<1, 1, T2>& other);
 
     // dedicated access to scalar value
-    double value() const;
-    double& ref();
-    const double& ref() const;
+    T value() const;
+    T& ref();
+    const T& ref() const;
 
-    // implicit conversion to 'double'
-    operator double() const;
+    // implicit conversion to the element type (e.g. 'double')
+    operator T() const;
 
     // operations
-    Matrix<1, 1>& operator*=(double scalar);
-    Matrix<1, 1>& operator/=(double scalar);
-    Matrix<1, 1>& operator+=(double scalar);
-    Matrix<1, 1>& operator-=(double scalar);
+    Matrix<1, 1, T>& operator*=(T scalar);
+    Matrix<1, 1, T>& operator/=(T scalar);
+    Matrix<1, 1, T>& operator+=(T scalar);
+    Matrix<1, 1, T>& operator-=(T scalar);
 };
 
 // Free operators
-template <uint Rows, uint Cols>
-CTL::mat::Matrix<Rows, Cols> operator*(double scalar, const CTL::mat::Matrix<Rows, Cols>& rhs);
+template <uint Rows, uint Cols, typename T>
+CTL::mat::Matrix<Rows, Cols, T> operator*(typename CTL::mat::Matrix<Rows, Cols, T>::value_type scalar,
+                                          const CTL::mat::Matrix<Rows, Cols, T>& rhs);
 
 // Free functions
 // diagonal squared matrix
-template <uint N>
-Matrix<N, N> diag(const Matrix<N, 1>& diagElements);
+template <uint N, typename T>
+Matrix<N, N, T> diag(const Matrix<N, 1, T>& diagElements);
 
 // NxN identity matrix
-template <uint N>
-Matrix<N, N> eye();
+template <uint N, typename T = double>
+Matrix<N, N, T> eye();
 
 // concatenation
-template <uint Rows, uint Cols1, uint Cols2>
-Matrix<Rows, Cols1 + Cols2> horzcat(const Matrix<Rows, Cols1>& m1, const Matrix<Rows, Cols2>& m2);
+template <uint Rows, uint Cols1, uint Cols2, typename T>
+Matrix<Rows, Cols1 + Cols2, T> horzcat(const Matrix<Rows, Cols1, T>& m1,
+                                       const Matrix<Rows, Cols2, T>& m2);
 
-template <uint Rows1, uint Rows2, uint Cols>
-Matrix<Rows1 + Rows2, Cols> vertcat(const Matrix<Rows1, Cols>& m1, const Matrix<Rows2, Cols>& m2);
+template <uint Rows1, uint Rows2, uint Cols, typename T>
+Matrix<Rows1 + Rows2, Cols, T> vertcat(const Matrix<Rows1, Cols, T>& m1,
+                                       const Matrix<Rows2, Cols, T>& m2);
 
 } // namespace mat
 } // namespace CTL
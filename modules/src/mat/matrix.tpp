@@ -8,6 +8,7 @@
 ******************************************************************************/
 
 #include "matrix.h" // optional, only for the IDE
+#include "matrix_simd.h"
 
 namespace CTL {
 namespace mat {
@@ -32,8 +33,8 @@ constexpr uint vecRangeDim(uint from, uint to)
 /*!
  * Construct an instance and initialize all elements with a \a fillValue.
  */
-template <uint Rows, uint Cols>
-inline MatrixBase<Rows, Cols>::MatrixBase(double fillValue)
+template <uint Rows, uint Cols, typename T>
+inline MatrixBase<Rows, Cols, T>::MatrixBase(T fillValue)
 {
     std::fill(this->begin(), this->end(), fillValue);
 }
@@ -42,29 +43,42 @@ inline MatrixBase<Rows, Cols>::MatrixBase(double fillValue)
  * Construct an instance from a C-style array. The array length must match the total number of
  * matrix elements, otherwise it results in a compilation error.
  */
-template <uint Rows, uint Cols>
-inline MatrixBase<Rows, Cols>::MatrixBase(const double (&initArray)[Rows * Cols])
+template <uint Rows, uint Cols, typename T>
+inline MatrixBase<Rows, Cols, T>::MatrixBase(const T (&initArray)[Rows * Cols])
 {
     std::copy_n(initArray, Rows * Cols, _m);
 }
 
 /*!
- * Directly initialize the underlying C-style array `double[]` using the passed elements.
+ * Directly initialize the underlying C-style array `T[]` using the passed elements.
  */
-template <uint Rows, uint Cols>
-template <typename... Doubles>
-inline MatrixBase<Rows, Cols>::MatrixBase(double firstElement, Doubles... matrixElements)
+template <uint Rows, uint Cols, typename T>
+template <typename... Elements>
+constexpr MatrixBase<Rows, Cols, T>::MatrixBase(T firstElement, Elements... matrixElements)
     : _m{ firstElement, matrixElements... }
 {
 }
 
+/*!
+ * Construct an instance from a matrix \a other with another element type `T2`. All elements are
+ * converted using `static_cast<T>`.
+ */
+template <uint Rows, uint Cols, typename T>
+template <typename T2>
+inline MatrixBase<Rows, Cols, T>::MatrixBase(const MatrixBase<Rows, Cols, T2>& other)
+{
+    std::transform(other.constBegin(), other.constEnd(), _m, [](T2 val) {
+        return static_cast<T>(val);
+    });
+}
+
 // accessors
 /*!
  * Returns a pointer to the first element in a \a row. A run time boundary check is not performed.
  * Elements are stored in row major order.
  */
-template <uint Rows, uint Cols>
-double* MatrixBase<Rows, Cols>::operator[](uint row)
+template <uint Rows, uint Cols, typename T>
+T* MatrixBase<Rows, Cols, T>::operator[](uint row)
 {
     return _m + row * Cols;
 }
@@ -72,8 +86,8 @@ double* MatrixBase<Rows, Cols>::operator[](uint row)
  * Returns a pointer to the first element in a \a row. A run time boundary check is not performed.
  * Elements are stored in row major order.
  */
-template <uint Rows, uint Cols>
-const double* MatrixBase<Rows, Cols>::operator[](uint row) const
+template <uint Rows, uint Cols, typename T>
+const T* MatrixBase<Rows, Cols, T>::operator[](uint row) const
 {
     return _m + row * Cols;
 }
@@ -82,8 +96,8 @@ const double* MatrixBase<Rows, Cols>::operator[](uint row) const
  * Returns a reference to the element with index (\a row, \a column). A run time boundary check
  * is not performed.
  */
-template <uint Rows, uint Cols>
-double& MatrixBase<Rows, Cols>::operator()(uint row, uint column)
+template <uint Rows, uint Cols, typename T>
+T& MatrixBase<Rows, Cols, T>::operator()(uint row, uint column)
 {
     return (*this)[row][column];
 }
@@ -91,8 +105,8 @@ double& MatrixBase<Rows, Cols>::operator()(uint row, uint column)
  * Returns the element with index (\a row, \a column). A run time boundary check
  * is not performed.
  */
-template <uint Rows, uint Cols>
-double MatrixBase<Rows, Cols>::operator()(uint row, uint column) const
+template <uint Rows, uint Cols, typename T>
+T MatrixBase<Rows, Cols, T>::operator()(uint row, uint column) const
 {
     return (*this)[row][column];
 }
@@ -102,8 +116,8 @@ double MatrixBase<Rows, Cols>::operator()(uint row, uint column) const
  * is performed and an exception is thrown if an index exceeds the matrix dimensions (throws
  * out_of_range).
  */
-template <uint Rows, uint Cols>
-double& MatrixBase<Rows, Cols>::at(uint row, uint column) noexcept(false)
+template <uint Rows, uint Cols, typename T>
+T& MatrixBase<Rows, Cols, T>::at(uint row, uint column) noexcept(false)
 {
     if(row >= Rows)
         throw std::out_of_range("row index exceeds matrix dimensions");
@@ -116,8 +130,8 @@ double& MatrixBase<Rows, Cols>::at(uint row, uint column) noexcept(false)
  * is performed and an exception is thrown if an index exceeds the matrix dimensions (throws
  * out_of_range).
  */
-template <uint Rows, uint Cols>
-double MatrixBase<Rows, Cols>::at(uint row, uint column) const noexcept(false)
+template <uint Rows, uint Cols, typename T>
+T MatrixBase<Rows, Cols, T>::at(uint row, uint column) const noexcept(false)
 {
     if(row >= Rows)
         throw std::out_of_range("row index exceeds matrix dimensions");
@@ -131,9 +145,9 @@ double MatrixBase<Rows, Cols>::at(uint row, uint column) const noexcept(false)
  * is performed.
  * This function never fails.
  */
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 template <uint row, uint column>
-double& MatrixBase<Rows, Cols>::get() noexcept
+T& MatrixBase<Rows, Cols, T>::get() noexcept
 {
     static_assert(row < Rows, "row index must not exceed matrix dimension");
     static_assert(column < Cols, "column index must not exceed matrix dimension");
@@ -144,9 +158,9 @@ double& MatrixBase<Rows, Cols>::get() noexcept
  * is performed.
  * This function never fails.
  */
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 template <uint row, uint column>
-double MatrixBase<Rows, Cols>::get() const noexcept
+T MatrixBase<Rows, Cols, T>::get() const noexcept
 {
     static_assert(row < Rows, "row index must not exceed matrix dimension");
     static_assert(column < Cols, "column index must not exceed matrix dimension");
@@ -158,8 +172,8 @@ double MatrixBase<Rows, Cols>::get() const noexcept
  * stored in row major order. This function is handy in particular when dealing with vectors.
  * A run time boundary check is not performed.
  */
-template <uint Rows, uint Cols>
-double& MatrixBase<Rows, Cols>::operator()(uint n)
+template <uint Rows, uint Cols, typename T>
+T& MatrixBase<Rows, Cols, T>::operator()(uint n)
 {
     return _m[n];
 }
@@ -168,8 +182,8 @@ double& MatrixBase<Rows, Cols>::operator()(uint n)
  * stored in row major order. This function is handy in particular when dealing with vectors.
  * A run time boundary check is not performed.
  */
-template <uint Rows, uint Cols>
-double MatrixBase<Rows, Cols>::operator()(uint n) const
+template <uint Rows, uint Cols, typename T>
+T MatrixBase<Rows, Cols, T>::operator()(uint n) const
 {
     return _m[n];
 }
@@ -182,8 +196,8 @@ double MatrixBase<Rows, Cols>::operator()(uint n) const
  *
  * \sa at(uint row, uint column)
  */
-template <uint Rows, uint Cols>
-double& MatrixBase<Rows, Cols>::at(uint n) noexcept(false)
+template <uint Rows, uint Cols, typename T>
+T& MatrixBase<Rows, Cols, T>::at(uint n) noexcept(false)
 {
     if(n >= Rows * Cols)
         throw std::out_of_range("index exceeds matrix dimensions");
@@ -197,8 +211,8 @@ double& MatrixBase<Rows, Cols>::at(uint n) noexcept(false)
  *
  * \sa at(uint row, uint column) const
  */
-template <uint Rows, uint Cols>
-double MatrixBase<Rows, Cols>::at(uint n) const noexcept(false)
+template <uint Rows, uint Cols, typename T>
+T MatrixBase<Rows, Cols, T>::at(uint n) const noexcept(false)
 {
     if(n >= Rows * Cols)
         throw std::out_of_range("index exceeds matrix dimensions");
@@ -210,9 +224,9 @@ double MatrixBase<Rows, Cols>::at(uint n) const noexcept(false)
  * stored in row major order. This function is handy in particular when dealing with vectors.
  * A compile time boundary check is performed. This function never fails.
  */
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 template <uint n>
-double& MatrixBase<Rows, Cols>::get() noexcept
+T& MatrixBase<Rows, Cols, T>::get() noexcept
 {
     static_assert(n < Rows * Cols, "index must not exceed matrix dimensions");
     return _m[n];
@@ -222,9 +236,9 @@ double& MatrixBase<Rows, Cols>::get() noexcept
  * stored in row major order. This function is handy in particular when dealing with vectors.
  * A compile time boundary check is performed. This function never fails.
  */
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 template <uint n>
-double MatrixBase<Rows, Cols>::get() const noexcept
+T MatrixBase<Rows, Cols, T>::get() const noexcept
 {
     static_assert(n < Rows * Cols, "index must not exceed matrix dimensions");
     return _m[n];
@@ -235,8 +249,8 @@ double MatrixBase<Rows, Cols>::get() const noexcept
  * The elements are internally stored in a linear array in row major order.
  * Same as begin().
  */
-template <uint Rows, uint Cols>
-double* MatrixBase<Rows, Cols>::data() { return _m; }
+template <uint Rows, uint Cols, typename T>
+T* MatrixBase<Rows, Cols, T>::data() { return _m; }
 
 /*!
  * Returns a pointer to the first element of the matrix. This `const` version prohibits
@@ -244,8 +258,8 @@ double* MatrixBase<Rows, Cols>::data() { return _m; }
  * The elements are internally stored in a linear array in row major order.
  * Same as begin().
  */
-template <uint Rows, uint Cols>
-const double* MatrixBase<Rows, Cols>::data() const { return _m; }
+template <uint Rows, uint Cols, typename T>
+const T* MatrixBase<Rows, Cols, T>::data() const { return _m; }
 
 /*!
  * Returns a pointer to the first element of the matrix. This `const` version prohibits
@@ -254,16 +268,16 @@ const double* MatrixBase<Rows, Cols>::data() const { return _m; }
  * The elements are internally stored in a linear array in row major order.
  * Same as constBegin().
  */
-template <uint Rows, uint Cols>
-const double* MatrixBase<Rows, Cols>::constData() const { return _m; }
+template <uint Rows, uint Cols, typename T>
+const T* MatrixBase<Rows, Cols, T>::constData() const { return _m; }
 
 /*!
  * Returns a pointer to the first element of the matrix.
  * The elements are internally stored in a linear array in row major order.
  * Same as data().
  */
-template <uint Rows, uint Cols>
-double* MatrixBase<Rows, Cols>::begin() { return _m; }
+template <uint Rows, uint Cols, typename T>
+T* MatrixBase<Rows, Cols, T>::begin() { return _m; }
 
 /*!
  * Returns a pointer to the first element of the matrix. This `const` version prohibits
@@ -271,8 +285,8 @@ double* MatrixBase<Rows, Cols>::begin() { return _m; }
  * The elements are internally stored in a linear array in row major order.
  * Same as data().
  */
-template <uint Rows, uint Cols>
-const double* MatrixBase<Rows, Cols>::begin() const { return _m; }
+template <uint Rows, uint Cols, typename T>
+const T* MatrixBase<Rows, Cols, T>::begin() const { return _m; }
 
 /*!
  * Returns a pointer to the first element of the matrix. This `const` version prohibits
@@ -281,24 +295,24 @@ const double* MatrixBase<Rows, Cols>::begin() const { return _m; }
  * The elements are internally stored in a linear array in row major order.
  * Same as constData().
  */
-template <uint Rows, uint Cols>
-const double* MatrixBase<Rows, Cols>::constBegin() const { return _m; }
+template <uint Rows, uint Cols, typename T>
+const T* MatrixBase<Rows, Cols, T>::constBegin() const { return _m; }
 
 /*!
  * Returns a pointer to the element following the last element of the matrix.
  * This pointer is useful for having a boundary when looping over the matrix elements.
  * However, attempting to access it results in undefined behavior.
  */
-template <uint Rows, uint Cols>
-double* MatrixBase<Rows, Cols>::end() { return std::end(_m); }
+template <uint Rows, uint Cols, typename T>
+T* MatrixBase<Rows, Cols, T>::end() { return std::end(_m); }
 
 /*!
  * Returns a pointer to the element following the last element of the matrix.
  * This pointer is useful for having a boundary when looping over the matrix elements.
  * However, attempting to access it results in undefined behavior.
  */
-template <uint Rows, uint Cols>
-const double* MatrixBase<Rows, Cols>::end() const { return std::end(_m); }
+template <uint Rows, uint Cols, typename T>
+const T* MatrixBase<Rows, Cols, T>::end() const { return std::end(_m); }
 
 /*!
  * Returns a pointer to the element following the last element of the matrix. This `const` version
@@ -307,14 +321,14 @@ const double* MatrixBase<Rows, Cols>::end() const { return std::end(_m); }
  * This pointer is useful for having a boundary when looping over the matrix elements.
  * However, attempting to access it results in undefined behavior.
  */
-template <uint Rows, uint Cols>
-const double* MatrixBase<Rows, Cols>::constEnd() const { return std::end(_m); }
+template <uint Rows, uint Cols, typename T>
+const T* MatrixBase<Rows, Cols, T>::constEnd() const { return std::end(_m); }
 
 /*!
  * Returns the total number of elements that is `Rows*Cols`.
  */
-template <uint Rows, uint Cols>
-constexpr size_t MatrixBase<Rows, Cols>::size() const
+template <uint Rows, uint Cols, typename T>
+constexpr size_t MatrixBase<Rows, Cols, T>::size() const
 {
     return static_cast<size_t>(Rows) * static_cast<size_t>(Cols);
 }
@@ -344,8 +358,8 @@ constexpr size_t MatrixBase<Rows, Cols>::size() const
  *  std::setlocale(LC_NUMERIC, "de_DE.UTF-8");
  * \endcode
  */
-template <uint Rows, uint Cols>
-std::string MatrixBase<Rows, Cols>::info(const char* lineModifier) const
+template <uint Rows, uint Cols, typename T>
+std::string MatrixBase<Rows, Cols, T>::info(const char* lineModifier) const
 {
     // number of spaces (SEPARATOR_CHARACTER_FOR_INFO_STRING) between numbers
     // -> must be at least 3, otherwise last column will be truncated
@@ -398,8 +412,8 @@ std::string MatrixBase<Rows, Cols>::info(const char* lineModifier) const
  * arbitrary matrices. In this case it computes the Frobenius norm of the matrix (sqrt of the sum
  * of squared elements).
  */
-template <uint Rows, uint Cols>
-double MatrixBase<Rows, Cols>::norm() const
+template <uint Rows, uint Cols, typename T>
+T MatrixBase<Rows, Cols, T>::norm() const
 {
 #ifndef ENABLE_FROBENIUS_NORM
     static_assert(Rows == 1 || Cols == 1,
@@ -408,7 +422,7 @@ double MatrixBase<Rows, Cols>::norm() const
                   "please define 'ENABLE_FROBENIUS_NORM' before including 'matrix.h'.");
 #endif
     const auto ret = std::inner_product(this->constBegin(), this->constEnd(), this->constBegin(),
-                                        0.0);
+                                        T(0));
     return std::sqrt(ret);
 }
 
@@ -416,8 +430,8 @@ double MatrixBase<Rows, Cols>::norm() const
  * Returns `true` if all elements are equal, which means they have the equal (byte) representation
  * of all elements; otherwise false.
  */
-template <uint Rows, uint Cols>
-bool MatrixBase<Rows, Cols>::operator==(const MatrixBase<Rows, Cols>& rhs) const
+template <uint Rows, uint Cols, typename T>
+bool MatrixBase<Rows, Cols, T>::operator==(const MatrixBase<Rows, Cols, T>& rhs) const
 {
     auto rhsPtr = rhs.begin();
 
@@ -435,8 +449,8 @@ bool MatrixBase<Rows, Cols>::operator==(const MatrixBase<Rows, Cols>& rhs) const
  * Returns `true` if there is at least one element that is not equal for both matrices, which means
  * the matrices does not have the equal (byte) representation.
  */
-template <uint Rows, uint Cols>
-bool MatrixBase<Rows, Cols>::operator!=(const MatrixBase<Rows, Cols>& rhs) const
+template <uint Rows, uint Cols, typename T>
+bool MatrixBase<Rows, Cols, T>::operator!=(const MatrixBase<Rows, Cols, T>& rhs) const
 {
     return !(*this == rhs);
 }
@@ -451,9 +465,9 @@ bool MatrixBase<Rows, Cols>::operator!=(const MatrixBase<Rows, Cols>& rhs) const
  *  Matrix<4, 4> M{ 1.0 };
  * \endcode
  */
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols>::Matrix(double fillValue)
-    : MatrixBase<Rows, Cols>(fillValue)
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T>::Matrix(T fillValue)
+    : MatrixBase<Rows, Cols, T>(fillValue)
 {
 }
 
@@ -466,9 +480,9 @@ Matrix<Rows, Cols>::Matrix(double fillValue)
     Matrix<2, 2> M{ ar };
  * \endcode
  */
-template <uint Rows, uint Cols>
-inline Matrix<Rows, Cols>::Matrix(const double (&initArray)[Rows * Cols])
-    : MatrixBase<Rows, Cols>(initArray)
+template <uint Rows, uint Cols, typename T>
+inline Matrix<Rows, Cols, T>::Matrix(const T (&initArray)[Rows * Cols])
+    : MatrixBase<Rows, Cols, T>(initArray)
 {
 }
 
@@ -483,10 +497,27 @@ inline Matrix<Rows, Cols>::Matrix(const double (&initArray)[Rows * Cols])
  *                  3.1, 3.2, 3.3 };
  * \endcode
  */
-template <uint Rows, uint Cols>
-template <typename... Doubles, typename>
-inline Matrix<Rows, Cols>::Matrix(double firstElement, Doubles... matrixElements)
-    : MatrixBase<Rows, Cols>(firstElement, static_cast<double>(matrixElements)...)
+template <uint Rows, uint Cols, typename T>
+template <typename... Elements, typename>
+constexpr Matrix<Rows, Cols, T>::Matrix(T firstElement, Elements... matrixElements)
+    : MatrixBase<Rows, Cols, T>(firstElement, static_cast<T>(matrixElements)...)
+{
+}
+
+/*!
+ * Construct an instance from a matrix \a other with another element type `T2`, e.g. a
+ * single precision copy of a `double` matrix:
+ *
+ * \code
+ *  Matrix<3, 4> P;
+ *  // ...
+ *  Matrix<3, 4, float> Pf(P);
+ * \endcode
+ */
+template <uint Rows, uint Cols, typename T>
+template <typename T2>
+inline Matrix<Rows, Cols, T>::Matrix(const Matrix<Rows, Cols, T2>& other)
+    : MatrixBase<Rows, Cols, T>(other)
 {
 }
 
@@ -499,23 +530,23 @@ inline Matrix<Rows, Cols>::Matrix(double firstElement, Doubles... matrixElements
  * It is set to `false` if the \a vector size would be exceeded. In this case it returns a
  * zero-initialized matrix.
  */
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 template <class Container>
-Matrix<Rows, Cols>
-Matrix<Rows, Cols>::fromContainer(const Container& vector, size_t NthMat, bool* ok)
+Matrix<Rows, Cols, T>
+Matrix<Rows, Cols, T>::fromContainer(const Container& vector, size_t NthMat, bool* ok)
 {
     auto offSet = NthMat * Rows * Cols;
     if(offSet + Rows * Cols > static_cast<size_t>(vector.size()))
     {
         if(ok) *ok = false;
-        return Matrix<Rows, Cols>(0.0);
+        return Matrix<Rows, Cols, T>(T(0));
     }
 
-    Matrix<Rows, Cols> ret;
+    Matrix<Rows, Cols, T> ret;
     auto vecIt = vector.begin() + offSet;
     for(auto& val : ret)
     {
-        val = static_cast<double>(*vecIt);
+        val = static_cast<T>(*vecIt);
         ++vecIt;
     }
 
@@ -544,17 +575,17 @@ Matrix<Rows, Cols>::fromContainer(const Container& vector, size_t NthMat, bool*
  *  bool test = (mat.subMat<1,1, 1,1>() == 22.); // test is `true`
  * \endcode
  */
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 template <uint fromRow, uint toRow, uint fromCol, uint toCol>
-auto Matrix<Rows, Cols>::subMat() const ->
-Matrix<details::rangeDim(fromRow, toRow), details::rangeDim(fromCol, toCol)>
+auto Matrix<Rows, Cols, T>::subMat() const ->
+Matrix<details::rangeDim(fromRow, toRow), details::rangeDim(fromCol, toCol), T>
 {
     static_assert(fromRow < Rows, "`fromRow` exceeds matrix dimension.");
     static_assert(toRow < Rows, "`toRow` exceeds matrix dimension.");
     static_assert(fromCol < Cols, "`fromCol` exceeds matrix dimension.");
     static_assert(toCol < Cols, "`toCol` exceeds matrix dimension.");
 
-    Matrix<details::rangeDim(fromRow, toRow), details::rangeDim(fromCol, toCol)> ret;
+    Matrix<details::rangeDim(fromRow, toRow), details::rangeDim(fromCol, toCol), T> ret;
     constexpr auto rowInc = toRow >= fromRow ? 1u : static_cast<uint>(-1);
     constexpr auto colInc = toCol >= fromCol ? 1u : static_cast<uint>(-1);
 
@@ -585,17 +616,17 @@ Matrix<details::rangeDim(fromRow, toRow), details::rangeDim(fromCol, toCol)>
  * `subMat<from, to, 0, 0>()` for column vectors or
  * `subMat<0, 0, from, to>()` for row vectors.
  */
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 template <uint from, uint to>
-auto Matrix<Rows, Cols>::subMat() const ->
-Matrix<details::vecRangeDim<Rows>(from, to), details::vecRangeDim<Cols>(from, to)>
+auto Matrix<Rows, Cols, T>::subMat() const ->
+Matrix<details::vecRangeDim<Rows>(from, to), details::vecRangeDim<Cols>(from, to), T>
 {
     static_assert(Rows == 1u || Cols == 1u, "`subMat<from, to>()` supports only vectors.");
     constexpr auto nbElem = Rows == 1u ? Cols : Rows;
     static_assert(from < nbElem, "`from` exceeds vector dimension.");
     static_assert(to < nbElem, "`to` exceeds vector dimension.");
 
-    Matrix<details::vecRangeDim<Rows>(from, to), details::vecRangeDim<Cols>(from, to)> ret;
+    Matrix<details::vecRangeDim<Rows>(from, to), details::vecRangeDim<Cols>(from, to), T> ret;
     constexpr auto inc = to >= from ? 1u : static_cast<uint>(-1);
 
     // suppress MSVS compiler warning `4307` caused by an (intended) integer overflow
@@ -619,12 +650,12 @@ Matrix<details::vecRangeDim<Rows>(from, to), details::vecRangeDim<Cols>(from, to
 /*!
  * Returns the \a i'th row of the matrix. Performes compile time boundary check.
  */
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 template <uint i>
-Matrix<1, Cols> Matrix<Rows, Cols>::row() const
+Matrix<1, Cols, T> Matrix<Rows, Cols, T>::row() const
 {
     static_assert(i < Rows, "row index must not exceed matrix dimensions");
-    Matrix<1, Cols> ret;
+    Matrix<1, Cols, T> ret;
 
     std::copy_n((*this)[i], Cols, ret.begin());
 
@@ -634,12 +665,12 @@ Matrix<1, Cols> Matrix<Rows, Cols>::row() const
 /*!
  * Returns the \a j'th column of the matrix. Performes compile time boundary check.
  */
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 template <uint j>
-Matrix<Rows, 1> Matrix<Rows, Cols>::column() const
+Matrix<Rows, 1, T> Matrix<Rows, Cols, T>::column() const
 {
     static_assert(j < Cols, "column index must not exceed matrix dimensions");
-    Matrix<Rows, 1> ret;
+    Matrix<Rows, 1, T> ret;
     auto scrPtr = this->constBegin() + j;
 
     for(auto& val : ret)
@@ -658,8 +689,8 @@ Matrix<Rows, 1> Matrix<Rows, Cols>::column() const
  * this function can be applied for arbitrary matrices (not only vectors). In this case, the matrix
  * is normalized by its Frobenius norm.
  */
-template <uint Rows, uint Cols>
-void Matrix<Rows, Cols>::normalize()
+template <uint Rows, uint Cols, typename T>
+void Matrix<Rows, Cols, T>::normalize()
 {
     *this /= this->norm();
 }
@@ -673,8 +704,8 @@ void Matrix<Rows, Cols>::normalize()
  *
  * \sa normalize()
  */
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols> Matrix<Rows, Cols>::normalized() const
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T> Matrix<Rows, Cols, T>::normalized() const
 {
     return *this / this->norm();
 }
@@ -682,10 +713,10 @@ Matrix<Rows, Cols> Matrix<Rows, Cols>::normalized() const
 /*!
  * Returns the transposed matrix.
  */
-template <uint Rows, uint Cols>
-Matrix<Cols, Rows> Matrix<Rows, Cols>::transposed() const
+template <uint Rows, uint Cols, typename T>
+Matrix<Cols, Rows, T> Matrix<Rows, Cols, T>::transposed() const
 {
-    Matrix<Cols, Rows> ret;
+    Matrix<Cols, Rows, T> ret;
     auto scrPtr = this->constBegin();
 
     for(auto row = 0u; row < Rows; ++row)
@@ -699,12 +730,12 @@ Matrix<Cols, Rows> Matrix<Rows, Cols>::transposed() const
 }
 
 // unary minus operator
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols> Matrix<Rows, Cols>::operator-() const
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T> Matrix<Rows, Cols, T>::operator-() const
 {
-    Matrix<Rows, Cols> ret;
+    Matrix<Rows, Cols, T> ret;
 
-    std::transform(this->constBegin(), this->constEnd(), ret.begin(), [](double val) {
+    std::transform(this->constBegin(), this->constEnd(), ret.begin(), [](T val) {
         return -val;
     });
 
@@ -712,42 +743,42 @@ Matrix<Rows, Cols> Matrix<Rows, Cols>::operator-() const
 }
 
 // compound assignment
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols>& Matrix<Rows, Cols>::operator*=(double scalar)
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T>& Matrix<Rows, Cols, T>::operator*=(T scalar)
 {
-    std::transform(this->constBegin(), this->constEnd(), this->begin(), [scalar](double val) {
+    std::transform(this->constBegin(), this->constEnd(), this->begin(), [scalar](T val) {
         return val * scalar;
     });
 
     return *this;
 }
 
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols>& Matrix<Rows, Cols>::operator/=(double scalar)
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T>& Matrix<Rows, Cols, T>::operator/=(T scalar)
 {
-    std::transform(this->constBegin(), this->constEnd(), this->begin(), [scalar](double val) {
+    std::transform(this->constBegin(), this->constEnd(), this->begin(), [scalar](T val) {
         return val / scalar;
     });
 
     return *this;
 }
 
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols>& Matrix<Rows, Cols>::operator+=(const Matrix<Rows, Cols>& rhs)
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T>& Matrix<Rows, Cols, T>::operator+=(const Matrix<Rows, Cols, T>& rhs)
 {
     std::transform(this->constBegin(), this->constEnd(), rhs.constBegin(), this->begin(),
-                   [](double leftVal, double rightVal) {
+                   [](T leftVal, T rightVal) {
         return leftVal + rightVal;
     });
 
     return *this;
 }
 
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols>& Matrix<Rows, Cols>::operator-=(const Matrix<Rows, Cols>& rhs)
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T>& Matrix<Rows, Cols, T>::operator-=(const Matrix<Rows, Cols, T>& rhs)
 {
     std::transform(this->constBegin(), this->constEnd(), rhs.constBegin(), this->begin(),
-                   [](double leftVal, double rightVal) {
+                   [](T leftVal, T rightVal) {
         return leftVal - rightVal;
     });
 
@@ -755,79 +786,68 @@ Matrix<Rows, Cols>& Matrix<Rows, Cols>::operator-=(const Matrix<Rows, Cols>& rhs
 }
 
 // binary operators
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols> Matrix<Rows, Cols>::operator*(double scalar) const
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T> Matrix<Rows, Cols, T>::operator*(T scalar) const
 {
-    Matrix<Rows, Cols> ret;
+    Matrix<Rows, Cols, T> ret;
 
-    std::transform(this->constBegin(), this->constEnd(), ret.begin(), [scalar](double val) {
+    std::transform(this->constBegin(), this->constEnd(), ret.begin(), [scalar](T val) {
         return val * scalar;
     });
 
     return ret;
 }
 
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols> Matrix<Rows, Cols>::operator/(double scalar) const
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T> Matrix<Rows, Cols, T>::operator/(T scalar) const
 {
-    Matrix<Rows, Cols> ret;
+    Matrix<Rows, Cols, T> ret;
 
-    std::transform(this->constBegin(), this->constEnd(), ret.begin(), [scalar](double val) {
+    std::transform(this->constBegin(), this->constEnd(), ret.begin(), [scalar](T val) {
         return val / scalar;
     });
 
     return ret;
 }
 
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols> Matrix<Rows, Cols>::operator+(const Matrix<Rows, Cols>& rhs) const
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T> Matrix<Rows, Cols, T>::operator+(const Matrix<Rows, Cols, T>& rhs) const
 {
-    Matrix<Rows, Cols> ret;
+    Matrix<Rows, Cols, T> ret;
 
     std::transform(this->constBegin(), this->constEnd(), rhs.constBegin(), ret.begin(),
-                   std::plus<double>());
+                   std::plus<T>());
 
     return ret;
 }
 
-template <uint Rows, uint Cols>
-Matrix<Rows, Cols> Matrix<Rows, Cols>::operator-(const Matrix<Rows, Cols>& rhs) const
+template <uint Rows, uint Cols, typename T>
+Matrix<Rows, Cols, T> Matrix<Rows, Cols, T>::operator-(const Matrix<Rows, Cols, T>& rhs) const
 {
-    Matrix<Rows, Cols> ret;
+    Matrix<Rows, Cols, T> ret;
 
     std::transform(this->constBegin(), this->constEnd(), rhs.constBegin(), ret.begin(),
-                   std::minus<double>());
+                   std::minus<T>());
 
     return ret;
 }
 
 /*!
  * Returns the result of a standard matrix multiplication.
+ *
+ * For the small sizes that dominate geometry computations (products with 3x3, 3x4 and 4x4 matrices
+ * and the corresponding vectors), the product is computed by an SSE/AVX kernel if the target
+ * supports it (see matrix_simd.h). The kernels accumulate in the same order as the generic
+ * implementation.
  */
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 template <uint Cols2>
-Matrix<Rows, Cols2>
-Matrix<Rows, Cols>::operator*(const Matrix<Cols, Cols2>& rhs) const
+Matrix<Rows, Cols2, T>
+Matrix<Rows, Cols, T>::operator*(const Matrix<Cols, Cols2, T>& rhs) const
 {
-    const Matrix<Rows, Cols>& lhs = *this;
-    Matrix<Rows, Cols2> ret;
-    auto retPtr = ret.begin();
+    Matrix<Rows, Cols2, T> ret;
 
-    for(auto row = 0u; row < Rows; ++row)
-        for(auto column = 0u; column < Cols2; ++column)
-        {
-            auto val = 0.0;
-            auto* lhsPtr = lhs[row];
-            auto* rhsPtr = rhs[0] + column;
-            for(auto i = 0u; i < Cols; ++i)
-            {
-                val += *lhsPtr * *rhsPtr;
-                lhsPtr += 1;
-                rhsPtr += Cols2;
-            }
-            *retPtr = val;
-            ++retPtr;
-        }
+    details::MatMul<Rows, Cols, Cols2, T>::apply(this->constBegin(), rhs.constBegin(), ret.begin());
 
     return ret;
 }
@@ -837,50 +857,69 @@ Matrix<Rows, Cols>::operator*(const Matrix<Cols, Cols2>& rhs) const
 /*!
  * Initializes the 1x1 matrix with \a value.
  */
-inline Matrix<1, 1>::Matrix(double value)
-    : MatrixBase<1, 1>(value)
+template <typename T>
+inline Matrix<1, 1, T>::Matrix(T value)
+    : MatrixBase<1, 1, T>(value)
+{
+}
+
+/*!
+ * Initializes the 1x1 matrix with the converted value of \a other.
+ */
+template <typename T>
+template <typename T2>
+inline Matrix<1, 1, T>::Matrix(const Matrix<1, 1, T2>& other)
+    : MatrixBase<1, 1, T>(other)
 {
 }
 
 /*!
  * Returns the value of the 1x1 matrix.
  */
-inline double Matrix<1, 1>::value() const { return *begin(); }
+template <typename T>
+inline T Matrix<1, 1, T>::value() const { return *this->begin(); }
 
 /*!
  * Returns a reference to the value of the 1x1 matrix.
  */
-inline double& Matrix<1, 1>::ref() { return *begin(); }
+template <typename T>
+inline T& Matrix<1, 1, T>::ref() { return *this->begin(); }
 
 /*!
  * Returns a `const` reference to the value of the 1x1 matrix.
  */
-inline const double& Matrix<1, 1>::ref() const { return *begin(); }
+template <typename T>
+inline const T& Matrix<1, 1, T>::ref() const { return *this->begin(); }
 
 /*!
- * Implicit conversion to `double`.
+ * Implicit conversion to the element type `T`.
  */
-inline Matrix<1, 1>::operator double() const { return *begin(); }
+template <typename T>
+inline Matrix<1, 1, T>::operator T() const { return *this->begin(); }
 
-inline Matrix<1, 1>& Matrix<1, 1>::operator*=(double scalar)
+template <typename T>
+inline Matrix<1, 1, T>& Matrix<1, 1, T>::operator*=(T scalar)
 {
     ref() *= scalar;
     return *this;
 }
 
-inline Matrix<1, 1>& Matrix<1, 1>::operator/=(double scalar)
+template <typename T>
+inline Matrix<1, 1, T>& Matrix<1, 1, T>::operator/=(T scalar)
 {
     ref() /= scalar;
     return *this;
 }
 
-inline Matrix<1, 1>& Matrix<1, 1>::operator+=(double scalar)
+template <typename T>
+inline Matrix<1, 1, T>& Matrix<1, 1, T>::operator+=(T scalar)
 {
     ref() += scalar;
     return *this;
 }
 
-inline Matrix<1, 1>& Matrix<1, 1>::operator-=(double scalar)
+template <typename T>
+inline Matrix<1, 1, T>& Matrix<1, 1, T>::operator-=(T scalar)
 {
     ref() -= scalar;
     return *this;
@@ -893,8 +932,9 @@ inline Matrix<1, 1>& Matrix<1, 1>::operator-=(double scalar)
 *
 * \relates Matrix
 */
-template <uint Rows, uint Cols>
-CTL::mat::Matrix<Rows, Cols> operator*(double scalar, const CTL::mat::Matrix<Rows, Cols>& rhs)
+template <uint Rows, uint Cols, typename T>
+CTL::mat::Matrix<Rows, Cols, T> operator*(typename CTL::mat::Matrix<Rows, Cols, T>::value_type scalar,
+                                          const CTL::mat::Matrix<Rows, Cols, T>& rhs)
 {
     return rhs * scalar;
 }
@@ -904,10 +944,10 @@ CTL::mat::Matrix<Rows, Cols> operator*(double scalar, const CTL::mat::Matrix<Row
  *
  * \relates Matrix
  */
-template <uint N>
-Matrix<N, N> diag(const Matrix<N, 1>& diagElements)
+template <uint N, typename T>
+Matrix<N, N, T> diag(const Matrix<N, 1, T>& diagElements)
 {
-    Matrix<N, N> ret(0.0);
+    Matrix<N, N, T> ret(T(0));
     for(uint d = 0; d < N; ++d)
         ret(d, d) = diagElements(d);
     return ret;
@@ -918,15 +958,15 @@ Matrix<N, N> diag(const Matrix<N, 1>& diagElements)
  *
  * \relates Matrix
  */
-template <uint N>
-Matrix<N, N> eye()
+template <uint N, typename T>
+Matrix<N, N, T> eye()
 {
-    static Matrix<N, N> ret(0.0);
+    static Matrix<N, N, T> ret(T(0));
     static bool toBeInit = true;
     if(toBeInit)
     {
         for(uint i = 0; i < N; ++i)
-            ret(i, i) = 1.0;
+            ret(i, i) = T(1);
         toBeInit = false;
     }
     return ret;
@@ -938,10 +978,11 @@ Matrix<N, N> eye()
  *
  * \relates Matrix
  */
-template <uint Rows, uint Cols1, uint Cols2>
-Matrix<Rows, Cols1 + Cols2> horzcat(const Matrix<Rows, Cols1>& m1, const Matrix<Rows, Cols2>& m2)
+template <uint Rows, uint Cols1, uint Cols2, typename T>
+Matrix<Rows, Cols1 + Cols2, T> horzcat(const Matrix<Rows, Cols1, T>& m1,
+                                       const Matrix<Rows, Cols2, T>& m2)
 {
-    Matrix<Rows, Cols1 + Cols2> ret;
+    Matrix<Rows, Cols1 + Cols2, T> ret;
     auto dstPtr = ret.begin();
     for(uint row = 0; row < Rows; ++row)
     {
@@ -959,23 +1000,26 @@ Matrix<Rows, Cols1 + Cols2> horzcat(const Matrix<Rows, Cols1>& m1, const Matrix<
  *
  * \relates Matrix
  */
-template <uint Rows1, uint Rows2, uint Cols>
-Matrix<Rows1 + Rows2, Cols> vertcat(const Matrix<Rows1, Cols>& m1, const Matrix<Rows2, Cols>& m2)
+template <uint Rows1, uint Rows2, uint Cols, typename T>
+Matrix<Rows1 + Rows2, Cols, T> vertcat(const Matrix<Rows1, Cols, T>& m1,
+                                       const Matrix<Rows2, Cols, T>& m2)
 {
-    Matrix<Rows1 + Rows2, Cols> ret;
+    Matrix<Rows1 + Rows2, Cols, T> ret;
     std::copy(m1.begin(), m1.end(), ret[0]);
     std::copy(m2.begin(), m2.end(), ret[Rows1]);
     return ret;
 }
 // variadic versions (auto return type = C++14 feature)
 #if __cplusplus >= 201402L
-template <uint Rows, uint Cols1, uint Cols2, class... Matrices>
-auto horzcat(const Matrix<Rows, Cols1>& m1, const Matrix<Rows, Cols2>& m2, const Matrices&... mats)
+template <uint Rows, uint Cols1, uint Cols2, typename T, class... Matrices>
+auto horzcat(const Matrix<Rows, Cols1, T>& m1, const Matrix<Rows, Cols2, T>& m2,
+             const Matrices&... mats)
 {
     return horzcat(horzcat(m1, m2), mats...);
 }
-template <uint Rows1, uint Rows2, uint Cols, class... Matrices>
-auto vertcat(const Matrix<Rows1, Cols>& m1, const Matrix<Rows2, Cols>& m2, const Matrices&... mats)
+template <uint Rows1, uint Rows2, uint Cols, typename T, class... Matrices>
+auto vertcat(const Matrix<Rows1, Cols, T>& m1, const Matrix<Rows2, Cols, T>& m2,
+             const Matrices&... mats)
 {
     return vertcat(vertcat(m1, m2), mats...);
 }
@@ -0,0 +1,225 @@
+/******************************************************************************
+** SIMD kernels for the matrix multiplication of small 'Matrix' types
+** (3x3, 3x4, 4x4 and the corresponding vectors)
+******************************************************************************/
+
+#ifndef CTL_MATRIX_SIMD_H
+#define CTL_MATRIX_SIMD_H
+
+#include <type_traits>
+
+// detect the available instruction sets (can be disabled by defining `CTL_MATRIX_NO_SIMD`)
+#if !defined(CTL_MATRIX_NO_SIMD) &&                                                                \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CTL_MATRIX_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define CTL_MATRIX_SIMD_AVX
+#include <immintrin.h>
+#endif
+#endif
+
+typedef unsigned int uint;
+
+namespace CTL {
+namespace mat {
+namespace details {
+
+/*
+ * Generic implementation of the matrix product `ret = lhs * rhs` of a Rows x Cols matrix `lhs`
+ * with a Cols x Cols2 matrix `rhs` (all in row major order).
+ * This template is specialized below for the SIMD enabled sizes.
+ */
+template <uint Rows, uint Cols, uint Cols2, typename T, typename Enable = void>
+struct MatMul
+{
+    static void apply(const T* lhs, const T* rhs, T* ret)
+    {
+        for(auto row = 0u; row < Rows; ++row)
+            for(auto column = 0u; column < Cols2; ++column)
+            {
+                auto val = T(0);
+                auto* lhsPtr = lhs + row * Cols;
+                auto* rhsPtr = rhs + column;
+                for(auto i = 0u; i < Cols; ++i)
+                {
+                    val += *lhsPtr * *rhsPtr;
+                    lhsPtr += 1;
+                    rhsPtr += Cols2;
+                }
+                *ret = val;
+                ++ret;
+            }
+    }
+};
+
+#ifdef CTL_MATRIX_SIMD_SSE2
+
+/*
+ * Four lanes of 'float'. `load` and `store` access the first `n` (3 or 4) elements only, i.e. they
+ * never touch memory beyond the last element of a 3-vector.
+ */
+struct Pack4f
+{
+    __m128 v;
+
+    static Pack4f broadcast(float x) { return { _mm_set1_ps(x) }; }
+    static Pack4f set(float a, float b, float c, float d) { return { _mm_setr_ps(a, b, c, d) }; }
+    static Pack4f load(const float* p, uint n)
+    {
+        return { n == 4u ? _mm_loadu_ps(p) : _mm_setr_ps(p[0], p[1], p[2], 0.0f) };
+    }
+    void store(float* p, uint n) const
+    {
+        if(n == 4u)
+            _mm_storeu_ps(p, v);
+        else
+        {
+            _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+            _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+        }
+    }
+
+    Pack4f operator+(const Pack4f& other) const { return { _mm_add_ps(v, other.v) }; }
+    Pack4f operator*(const Pack4f& other) const { return { _mm_mul_ps(v, other.v) }; }
+};
+
+/*
+ * Four lanes of 'double' (one AVX register or two SSE2 registers). `load` and `store` access the
+ * first `n` (3 or 4) elements only.
+ */
+#ifdef CTL_MATRIX_SIMD_AVX
+struct Pack4d
+{
+    __m256d v;
+
+    static Pack4d broadcast(double x) { return { _mm256_set1_pd(x) }; }
+    static Pack4d set(double a, double b, double c, double d)
+    {
+        return { _mm256_setr_pd(a, b, c, d) };
+    }
+    static Pack4d load(const double* p, uint n)
+    {
+        return { n == 4u ? _mm256_loadu_pd(p) : _mm256_setr_pd(p[0], p[1], p[2], 0.0) };
+    }
+    void store(double* p, uint n) const
+    {
+        if(n == 4u)
+            _mm256_storeu_pd(p, v);
+        else
+        {
+            _mm_storeu_pd(p, _mm256_castpd256_pd128(v));
+            _mm_store_sd(p + 2, _mm256_extractf128_pd(v, 1));
+        }
+    }
+
+    Pack4d operator+(const Pack4d& other) const { return { _mm256_add_pd(v, other.v) }; }
+    Pack4d operator*(const Pack4d& other) const { return { _mm256_mul_pd(v, other.v) }; }
+};
+#else
+struct Pack4d
+{
+    __m128d lo, hi;
+
+    static Pack4d broadcast(double x) { return { _mm_set1_pd(x), _mm_set1_pd(x) }; }
+    static Pack4d set(double a, double b, double c, double d)
+    {
+        return { _mm_setr_pd(a, b), _mm_setr_pd(c, d) };
+    }
+    static Pack4d load(const double* p, uint n)
+    {
+        return { _mm_loadu_pd(p), n == 4u ? _mm_loadu_pd(p + 2) : _mm_set_sd(p[2]) };
+    }
+    void store(double* p, uint n) const
+    {
+        _mm_storeu_pd(p, lo);
+        if(n == 4u)
+            _mm_storeu_pd(p + 2, hi);
+        else
+            _mm_store_sd(p + 2, hi);
+    }
+
+    Pack4d operator+(const Pack4d& other) const
+    {
+        return { _mm_add_pd(lo, other.lo), _mm_add_pd(hi, other.hi) };
+    }
+    Pack4d operator*(const Pack4d& other) const
+    {
+        return { _mm_mul_pd(lo, other.lo), _mm_mul_pd(hi, other.hi) };
+    }
+};
+#endif // CTL_MATRIX_SIMD_AVX
+
+template <typename T> struct Pack4 {};
+template <> struct Pack4<float> { typedef Pack4f type; };
+template <> struct Pack4<double> { typedef Pack4d type; };
+
+// sizes and element types that are computed by the SIMD kernels
+template <uint Rows, uint Cols, uint Cols2, typename T>
+struct UseSimdMatMul
+{
+    static constexpr bool value = (std::is_same<T, float>::value || std::is_same<T, double>::value)
+                                  && (Rows == 3u || Rows == 4u) && (Cols == 3u || Cols == 4u)
+                                  && (Cols2 == 1u || Cols2 == 3u || Cols2 == 4u);
+};
+
+/*
+ * Matrix-matrix product (Cols2 = 3 or 4): each row of the result is a linear combination of the
+ * rows of `rhs`, i.e. the lanes hold the columns of a result row.
+ */
+template <uint Rows, uint Cols, uint Cols2, typename T>
+struct MatMul<Rows, Cols, Cols2, T,
+              typename std::enable_if<UseSimdMatMul<Rows, Cols, Cols2, T>::value
+                                      && Cols2 != 1u>::type>
+{
+    static void apply(const T* lhs, const T* rhs, T* ret)
+    {
+        typedef typename Pack4<T>::type Pack;
+
+        for(auto row = 0u; row < Rows; ++row)
+        {
+            auto acc = Pack::broadcast(lhs[0]) * Pack::load(rhs, Cols2);
+            for(auto i = 1u; i < Cols; ++i)
+                acc = acc + Pack::broadcast(lhs[i]) * Pack::load(rhs + i * Cols2, Cols2);
+            acc.store(ret, Cols2);
+
+            lhs += Cols;
+            ret += Cols2;
+        }
+    }
+};
+
+/*
+ * Matrix-vector product (Cols2 = 1): the result is a linear combination of the columns of `lhs`,
+ * i.e. the lanes hold the rows of the result vector.
+ */
+template <uint Rows, uint Cols, uint Cols2, typename T>
+struct MatMul<Rows, Cols, Cols2, T,
+              typename std::enable_if<UseSimdMatMul<Rows, Cols, Cols2, T>::value
+                                      && Cols2 == 1u>::type>
+{
+    static void apply(const T* lhs, const T* rhs, T* ret)
+    {
+        typedef typename Pack4<T>::type Pack;
+
+        auto acc = column(lhs, 0u) * Pack::broadcast(rhs[0]);
+        for(auto i = 1u; i < Cols; ++i)
+            acc = acc + column(lhs, i) * Pack::broadcast(rhs[i]);
+        acc.store(ret, Rows);
+    }
+
+private:
+    static typename Pack4<T>::type column(const T* lhs, uint i)
+    {
+        return Pack4<T>::type::set(lhs[i], lhs[Cols + i], lhs[2u * Cols + i],
+                                   Rows == 4u ? lhs[3u * Cols + i] : T(0));
+    }
+};
+
+#endif // CTL_MATRIX_SIMD_SSE2
+
+} // namespace details
+} // namespace mat
+} // namespace CTL
+
+#endif // CTL_MATRIX_SIMD_H
@@ -1,5 +1,17 @@
 #include "pmatcomparator.h"
+#include "acquisition/viewgeometry.h"
+#include "processing/threadpool.h"
 #include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// number of grid points along z that are projected as one block (independent lanes)
+constexpr uint BLOCK_SIZE = 8u;
+// minimum number of views processed by a single thread in a batch comparison
+constexpr uint MIN_NB_VIEWS_PER_THREAD = 4u;
+
+} // unnamed namespace
 
 namespace CTL {
 namespace mat {
@@ -37,7 +49,68 @@ PMatComparator::PMatComparator(uint nbDetectorPixelsX, uint nbDetectorPixelsY,
 PMatComparator::Eval PMatComparator::operator()(const ProjectionMatrix& P1,
                                                 const ProjectionMatrix& P2) const
 {
-    Eval ret;
+    Accumulator acc;
+    accumulate(P1, P2, acc);
+
+    return evaluation(acc);
+}
+
+PMatComparator::BatchEval PMatComparator::operator()(const FullGeometry& geometry1,
+                                                     const FullGeometry& geometry2,
+                                                     uint nbThreads) const
+{
+    const auto nbViews = geometry1.nbViews();
+    if(geometry2.nbViews() != nbViews)
+        throw std::domain_error("PMatComparator::operator(): number of views do not match.");
+    for(uint view = 0; view < nbViews; ++view)
+        if(geometry1.at(view).nbModules() != geometry2.at(view).nbModules())
+            throw std::domain_error("PMatComparator::operator(): number of modules do not match "
+                                    "in view " + std::to_string(view) + ".");
+
+    // accumulate errors of all modules for each view
+    std::vector<Accumulator> viewAccs(nbViews);
+    auto processRange = [this, &geometry1, &geometry2, &viewAccs](uint first, uint last)
+    {
+        for(auto view = first; view < last; ++view)
+        {
+            const auto& viewGeo1 = geometry1.at(view);
+            const auto& viewGeo2 = geometry2.at(view);
+            for(uint module = 0, nbModules = viewGeo1.nbModules(); module < nbModules; ++module)
+                accumulate(viewGeo1.at(module), viewGeo2.at(module), viewAccs[view]);
+        }
+    };
+
+    if(nbThreads == 0)
+        nbThreads = std::max(1u, std::thread::hardware_concurrency());
+    const auto nbRanges = std::max(1u, std::min(nbThreads, nbViews / MIN_NB_VIEWS_PER_THREAD));
+
+    if(nbRanges == 1u)
+        processRange(0u, nbViews);
+    else
+    {
+        ThreadPool tp(nbRanges);
+        for(uint range = 0; range < nbRanges; ++range)
+            tp.enqueueThread(processRange, range * nbViews / nbRanges,
+                             (range + 1) * nbViews / nbRanges);
+    }
+
+    // evaluation of each view and all views (merged in view order -> deterministic result)
+    BatchEval ret;
+    ret.views.reserve(nbViews);
+    Accumulator totalAcc;
+    for(const auto& acc : viewAccs)
+    {
+        ret.views.push_back(evaluation(acc));
+        totalAcc.merge(acc);
+    }
+    ret.total = evaluation(totalAcc);
+
+    return ret;
+}
+
+void PMatComparator::accumulate(const ProjectionMatrix& P1, const ProjectionMatrix& P2,
+                                Accumulator& acc) const
+{
     uint X = _nbVoxels[0], Y = _nbVoxels[1], Z = _nbVoxels[2]; // abbreviation
 
     // center of the voxel that is at the corner of the volume
@@ -50,10 +123,14 @@ PMatComparator::Eval PMatComparator::operator()(const ProjectionMatrix& P1,
     const double upperBoundX = double(_nbPixels[0]) - 0.5;
     const double upperBoundY = double(_nbPixels[1]) - 0.5;
 
+    // z coordinates of the voxel centers, padded to a multiple of the block size
+    const uint nbBlocks = (Z + BLOCK_SIZE - 1u) / BLOCK_SIZE;
+    std::vector<double> zCoords(nbBlocks * BLOCK_SIZE, 0.0);
+    for(uint z = 0; z < Z; ++z)
+        zCoords[z] = std::fma(double(z), _voxelSize.get<2>(), volCorner.get<2>());
+
     // temp variables within the following loop
-    double norm;
-    Vector3x1 p1_homo, p1_homoX, p1_homoY, p2_homo, p2_homoX, p2_homoY;
-    Matrix<2, 1> diff, p1, p2;
+    Vector3x1 p1_homoX, p1_homoY, p2_homoX, p2_homoY;
     // 3d world coord of voxel center (homog. form)
     Matrix<4, 1> r({ 0.0, 0.0, 0.0, 1.0 });
     // the projection matrices splitted into columns
@@ -66,6 +143,12 @@ PMatComparator::Eval PMatComparator::operator()(const ProjectionMatrix& P1,
     const Vector3x1 P2Column2 = P2.column<2>();
     const Vector3x1 P2Column3 = P2.column<3>();
 
+    // statistical quantities for each lane of a block
+    double laneSum[BLOCK_SIZE] = {}, laneSumSq[BLOCK_SIZE] = {}, laneMax[BLOCK_SIZE] = {};
+    double laneMin[BLOCK_SIZE];
+    uint64_t laneSamples[BLOCK_SIZE] = {};
+    std::fill_n(laneMin, BLOCK_SIZE, DBL_MAX);
+
     // __Iteration over voxels__
     // use separation of matrix product:
     // (P*r)(i) = P(i,0)*r(0) + P(i,1)*r(1) + P(i,2)*r(2) + P(i,3)*r(3)
@@ -83,51 +166,83 @@ PMatComparator::Eval PMatComparator::operator()(const ProjectionMatrix& P1,
             p1_homoY = p1_homoX + P1Column1 * r.get<1>();
             p2_homoY = p2_homoX + P2Column1 * r.get<1>();
 
-            for(uint z = 0; z < Z; ++z)
+            // ... + P(.,2)*r(2) for a block of z coordinates
+            // (branch-free loop body over independent lanes -> vectorizable)
+            for(uint block = 0; block < nbBlocks; ++block)
             {
-                r.get<2>() = std::fma(double(z), _voxelSize.get<2>(), volCorner.get<2>());
-                // ... + P(.,2)*r(2)
-                p1_homo = p1_homoY + P1Column2 * r.get<2>();
-                p2_homo = p2_homoY + P2Column2 * r.get<2>();
-
-                // convert to cartesian coord (divide by w, where p_homo = [x y w])
-                p1 = { p1_homo.get<0>(), p1_homo.get<1>() };
-                p2 = { p2_homo.get<0>(), p2_homo.get<1>() };
-                p1 /= p1_homo.get<2>();
-                p2 /= p2_homo.get<2>();
-
-                // check if p1 or p2 is outside the detector
-                if(_restrictToDetectorArea)
-                    if(p1.get<0>() < -0.5 || p1.get<0>() > upperBoundX ||
-                       p1.get<1>() < -0.5 || p1.get<1>() > upperBoundY ||
-                       p2.get<0>() < -0.5 || p2.get<0>() > upperBoundX ||
-                       p2.get<1>() < -0.5 || p2.get<1>() > upperBoundY)
-                        continue;
-
-                // projection error
-                diff = p1 - p2;
-                norm = diff.norm();
-                // statistical quantities
-                ret.meanError += norm;
-                ret.minError = std::min(ret.minError, norm);
-                ret.maxError = std::max(ret.maxError, norm);
-                if(_enableStandardDeviation)
-                    ret.stdDeviation += norm * norm;
-                ++ret.samples;
+                const double* z = zCoords.data() + block * BLOCK_SIZE;
+                const uint nbValid = std::min(BLOCK_SIZE, Z - block * BLOCK_SIZE);
+
+                for(uint k = 0; k < BLOCK_SIZE; ++k)
+                {
+                    // convert to cartesian coord (divide by w, where p_homo = [x y w])
+                    const double w1Inv = 1.0 / (p1_homoY.get<2>() + P1Column2.get<2>() * z[k]);
+                    const double w2Inv = 1.0 / (p2_homoY.get<2>() + P2Column2.get<2>() * z[k]);
+                    const double p1x = (p1_homoY.get<0>() + P1Column2.get<0>() * z[k]) * w1Inv;
+                    const double p1y = (p1_homoY.get<1>() + P1Column2.get<1>() * z[k]) * w1Inv;
+                    const double p2x = (p2_homoY.get<0>() + P2Column2.get<0>() * z[k]) * w2Inv;
+                    const double p2y = (p2_homoY.get<1>() + P2Column2.get<1>() * z[k]) * w2Inv;
+
+                    // check if lane is used and if p1 or p2 is outside the detector
+                    bool valid = k < nbValid;
+                    if(_restrictToDetectorArea)
+                        valid &= !((p1x < -0.5) | (p1x > upperBoundX) |
+                                   (p1y < -0.5) | (p1y > upperBoundY) |
+                                   (p2x < -0.5) | (p2x > upperBoundX) |
+                                   (p2y < -0.5) | (p2y > upperBoundY));
+
+                    // projection error
+                    const double dx = p1x - p2x;
+                    const double dy = p1y - p2y;
+                    const double norm = std::sqrt(dx * dx + dy * dy);
+
+                    laneSum[k] += valid ? norm : 0.0;
+                    laneSumSq[k] += valid ? norm * norm : 0.0;
+                    laneMin[k] = valid ? std::min(laneMin[k], norm) : laneMin[k];
+                    laneMax[k] = valid ? std::max(laneMax[k], norm) : laneMax[k];
+                    laneSamples[k] += valid;
+                }
             }
         }
     }
-    auto N = double(ret.samples);
+
+    for(uint k = 0; k < BLOCK_SIZE; ++k)
+    {
+        acc.sum += laneSum[k];
+        acc.sumSq += laneSumSq[k];
+        acc.min = std::min(acc.min, laneMin[k]);
+        acc.max = std::max(acc.max, laneMax[k]);
+        acc.samples += laneSamples[k];
+    }
+}
+
+PMatComparator::Eval PMatComparator::evaluation(const Accumulator& acc) const
+{
+    Eval ret;
+    auto N = double(acc.samples);
+    ret.meanError = acc.sum / N;
+    ret.minError = acc.min;
+    ret.maxError = acc.max;
+    ret.samples = acc.samples;
     if(_enableStandardDeviation)
     {
-        ret.stdDeviation -= ret.meanError * ret.meanError / N;
+        // clamp to zero: rounding errors may yield a (tiny) negative variance
+        ret.stdDeviation = std::max(acc.sumSq - acc.sum * acc.sum / N, 0.0);
         ret.stdDeviation = std::sqrt(ret.stdDeviation / N);
     }
-    ret.meanError /= N;
 
     return ret;
 }
 
+void PMatComparator::Accumulator::merge(const Accumulator& other)
+{
+    sum += other.sum;
+    sumSq += other.sumSq;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    samples += other.samples;
+}
+
 bool PMatComparator::computeStandardDeviation() const
 {
     return _enableStandardDeviation;
@@ -14,12 +14,14 @@
 
 #include "matrix_types.h"
 #include <cfloat>
+#include <vector>
 #include <QSize>
 
 typedef unsigned int uint;
 
 namespace CTL {
 
+class FullGeometry;
 template <typename T>
 class VoxelVolume;
 
@@ -36,6 +38,12 @@ public:
         uint64_t samples    = 0;
     };
 
+    // result of a comparison of two full geometries
+    struct BatchEval {
+        std::vector<Eval> views; // evaluation of each view (all modules of a view)
+        Eval total;              // evaluation of all views
+    };
+
     // discretization of test volume
     static const uint DEFAULT_NB_VOXELS = 32;
 
@@ -52,6 +60,9 @@ public:
 
     // comparator function
     Eval operator() (const ProjectionMatrix& P1, const ProjectionMatrix& P2) const;
+    // batch comparison of all views (parallelized over views)
+    BatchEval operator() (const FullGeometry& geometry1, const FullGeometry& geometry2,
+                          uint nbThreads = 0) const;
     
     // config
     bool computeStandardDeviation() const;
@@ -82,6 +93,21 @@ private:
     typedef uint Size3D[3];
     typedef uint Size2D[2];
 
+    // sums of the projection errors of (several) pairs of projection matrices
+    struct Accumulator {
+        double sum      = 0.0;
+        double sumSq    = 0.0;
+        double min      = DBL_MAX;
+        double max      = 0.0;
+        uint64_t samples = 0;
+
+        void merge(const Accumulator& other);
+    };
+
+    void accumulate(const ProjectionMatrix& P1, const ProjectionMatrix& P2,
+                    Accumulator& acc) const;
+    Eval evaluation(const Accumulator& acc) const;
+
     // volume
     Size3D _nbVoxels{ DEFAULT_NB_VOXELS, DEFAULT_NB_VOXELS, DEFAULT_NB_VOXELS };
     Vector3x1 _voxelSize{ 8.0, 8.0, 8.0 };
@@ -7,6 +7,19 @@ namespace CTL {
 // AbstractDataModel
 // =================
 
+/*!
+ * Samples the model at the \a n positions in \a positions and writes the results to \a values.
+ * In-place evaluation is allowed, i.e. \a values may be equal to \a positions.
+ *
+ * The default implementation calls valueAt() for each position. Re-implement this method in
+ * sub-classes if a more efficient (e.g. vectorized) evaluation is possible.
+ */
+void AbstractDataModel::valuesAt(const float* positions, float* values, size_t n) const
+{
+    for(size_t i = 0; i < n; ++i)
+        values[i] = valueAt(positions[i]);
+}
+
 QVariant AbstractDataModel::parameter() const { return QVariant(); }
 
 void AbstractDataModel::setParameter(const QVariant&) {}
@@ -11,6 +11,8 @@ namespace CTL {
  * \brief The AbstractDataModel class is the base class for basic data models.
  *
  * Sub-classes must implement the method to sample a value at a given position (valueAt()).
+ * For the evaluation of many positions at once, valuesAt() can be re-implemented in order to avoid
+ * a virtual call per position and to enable vectorization.
  *
  * Parameters can be set by passing a QVariant that contains all necessary information.
  * Re-implement the setParameter() method to parse the QVariant into your required format within
@@ -61,6 +63,7 @@ class AbstractDataModel : public SerializationInterface
     public:virtual AbstractDataModel* clone() const = 0;
 
 public:
+    virtual void valuesAt(const float* positions, float* values, size_t n) const;
     virtual bool isIntegrable() const final;
     virtual QVariant parameter() const;
     virtual void setParameter(const QVariant& parameter);
@@ -1,6 +1,73 @@
 #include "detectorsaturationmodels.h"
 #include <QDebug>
 
+// SIMD kernels of the batch evaluation (can be disabled by defining `CTL_MODELS_NO_SIMD`)
+#if !defined(CTL_MODELS_NO_SIMD) &&                                                                \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CTL_MODELS_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define CTL_MODELS_SIMD_AVX
+#include <immintrin.h>
+#endif
+#endif
+
+namespace {
+
+#if defined(CTL_MODELS_SIMD_AVX)
+// eight lanes of 'float'
+struct PackF
+{
+    static constexpr size_t size = 8;
+    __m256 v;
+
+    static PackF broadcast(float x) { return { _mm256_set1_ps(x) }; }
+    static PackF load(const float* p) { return { _mm256_loadu_ps(p) }; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+    PackF operator+(const PackF& other) const { return { _mm256_add_ps(v, other.v) }; }
+    PackF operator-(const PackF& other) const { return { _mm256_sub_ps(v, other.v) }; }
+    PackF operator*(const PackF& other) const { return { _mm256_mul_ps(v, other.v) }; }
+
+    // comparison masks (false for NaN)
+    PackF operator<(const PackF& other) const { return { _mm256_cmp_ps(v, other.v, _CMP_LT_OQ) }; }
+    PackF operator>(const PackF& other) const { return { _mm256_cmp_ps(v, other.v, _CMP_GT_OQ) }; }
+
+    // lanes of `a` where `mask` is set, lanes of `b` otherwise
+    static PackF select(const PackF& mask, const PackF& a, const PackF& b)
+    {
+        return { _mm256_blendv_ps(b.v, a.v, mask.v) };
+    }
+};
+#elif defined(CTL_MODELS_SIMD_SSE2)
+// four lanes of 'float'
+struct PackF
+{
+    static constexpr size_t size = 4;
+    __m128 v;
+
+    static PackF broadcast(float x) { return { _mm_set1_ps(x) }; }
+    static PackF load(const float* p) { return { _mm_loadu_ps(p) }; }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+
+    PackF operator+(const PackF& other) const { return { _mm_add_ps(v, other.v) }; }
+    PackF operator-(const PackF& other) const { return { _mm_sub_ps(v, other.v) }; }
+    PackF operator*(const PackF& other) const { return { _mm_mul_ps(v, other.v) }; }
+
+    // comparison masks (false for NaN)
+    PackF operator<(const PackF& other) const { return { _mm_cmplt_ps(v, other.v) }; }
+    PackF operator>(const PackF& other) const { return { _mm_cmpgt_ps(v, other.v) }; }
+
+    // lanes of `a` where `mask` is set, lanes of `b` otherwise
+    static PackF select(const PackF& mask, const PackF& a, const PackF& b)
+    {
+        return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) };
+    }
+};
+#endif
+
+} // unnamed namespace
+
 namespace CTL {
 
 DECLARE_SERIALIZABLE_TYPE(DetectorSaturationLinearModel);
@@ -40,6 +107,36 @@ float DetectorSaturationLinearModel::valueAt(float position) const
         return position;
 }
 
+/*!
+ * Computes the values of the model at the \a n positions in \a positions and writes them to
+ * \a values (in-place evaluation is allowed). If the target supports SSE2 (or AVX), blocks of
+ * positions are evaluated with SIMD instructions; the remaining positions are computed by a
+ * branch-free scalar loop.
+ */
+void DetectorSaturationLinearModel::valuesAt(const float* positions, float* values, size_t n) const
+{
+    const auto a = _a;
+    const auto b = _b;
+
+    size_t i = 0;
+#ifdef CTL_MODELS_SIMD_SSE2
+    const auto aPack = PackF::broadcast(a);
+    const auto bPack = PackF::broadcast(b);
+    for(; i + PackF::size <= n; i += PackF::size)
+    {
+        const auto x = PackF::load(positions + i);
+        const auto val = PackF::select(x > bPack, bPack, x);
+        PackF::select(x < aPack, aPack, val).store(values + i);
+    }
+#endif
+
+    for(; i < n; ++i)
+    {
+        const auto x = positions[i];
+        values[i] = x < a ? a : (x > b ? b : x);
+    }
+}
+
 // Re-use documentation of base class
 AbstractDataModel* DetectorSaturationLinearModel::clone() const
 {
@@ -197,6 +294,72 @@ float DetectorSaturationSplineModel::valueAt(float position) const
         return _b;
 }
 
+/*!
+ * Computes the values of the model at the \a n positions in \a positions and writes them to
+ * \a values (in-place evaluation is allowed). The coefficients of the splines are computed once
+ * and all regimes are evaluated without branches. If the target supports SSE2 (or AVX), blocks of
+ * positions are evaluated with SIMD instructions; the remaining positions are computed by the
+ * scalar loop.
+ */
+void DetectorSaturationSplineModel::valuesAt(const float* positions, float* values, size_t n) const
+{
+    const auto spl1Start = _a - _softA;
+    const auto spl1End   = _a + _softA;
+    const auto spl2Start = _b - _softB;
+    const auto spl2End   = _b + _softB;
+
+    // coefficients of the splines (only used within their regime, i.e. never for a softening
+    // margin of zero)
+    const auto c1_2 = 1.0f/(4.0f*_softA);
+    const auto c1_1 = (_a-_softA)/(2.0f*_softA);
+    const auto c1_0 = (_a+_softA)*(_a+_softA)/(4.0f*_softA);
+    const auto c2_2 = -1.0f/(4.0f*_softB);
+    const auto c2_1 = (_b+_softB)/(2.0f*_softB);
+    const auto c2_0 = (_b-_softB)*(_b-_softB)/(4.0f*_softB);
+
+    const auto a = _a;
+    const auto b = _b;
+
+    size_t i = 0;
+#ifdef CTL_MODELS_SIMD_SSE2
+    const auto aPack = PackF::broadcast(a);
+    const auto bPack = PackF::broadcast(b);
+    const auto spl1StartPack = PackF::broadcast(spl1Start);
+    const auto spl1EndPack = PackF::broadcast(spl1End);
+    const auto spl2StartPack = PackF::broadcast(spl2Start);
+    const auto spl2EndPack = PackF::broadcast(spl2End);
+    const auto c1_2Pack = PackF::broadcast(c1_2);
+    const auto c1_1Pack = PackF::broadcast(c1_1);
+    const auto c1_0Pack = PackF::broadcast(c1_0);
+    const auto c2_2Pack = PackF::broadcast(c2_2);
+    const auto c2_1Pack = PackF::broadcast(c2_1);
+    const auto c2_0Pack = PackF::broadcast(c2_0);
+    for(; i + PackF::size <= n; i += PackF::size)
+    {
+        const auto x = PackF::load(positions + i);
+        const auto spline1 = c1_2Pack*(x*x) - c1_1Pack*x + c1_0Pack;
+        const auto spline2 = c2_2Pack*(x*x) + c2_1Pack*x - c2_0Pack;
+
+        auto val = PackF::select(x < spl2EndPack, spline2, bPack);
+        val = PackF::select(x < spl2StartPack, x, val);
+        val = PackF::select(x < spl1EndPack, spline1, val);
+        PackF::select(x < spl1StartPack, aPack, val).store(values + i);
+    }
+#endif
+
+    for(; i < n; ++i)
+    {
+        const auto x = positions[i];
+        const auto spline1 = c1_2*(x*x) - c1_1*x + c1_0;
+        const auto spline2 = c2_2*(x*x) + c2_1*x - c2_0;
+
+        auto val = x < spl2End ? spline2 : b;
+        val = x < spl2Start ? x : val;
+        val = x < spl1End ? spline1 : val;
+        values[i] = x < spl1Start ? a : val;
+    }
+}
+
 /*!
  * Returns the parameters of this instance as QVariant.
  *
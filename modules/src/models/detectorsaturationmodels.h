@@ -46,6 +46,8 @@ class DetectorSaturationLinearModel : public AbstractDataModel
 public:
     DetectorSaturationLinearModel(float lowerCap = 0.0f, float upperCap = FLT_MAX);
 
+    void valuesAt(const float* positions, float* values, size_t n) const override;
+
     QVariant parameter() const override;
     void setParameter(const QVariant& parameter) override;
 
@@ -68,6 +70,8 @@ public:
     DetectorSaturationSplineModel(float lowerCap = 0.0f, float upperCap = FLT_MAX, float softening = 0.0f);
     DetectorSaturationSplineModel(float lowerCap, float upperCap, float softLower, float softUpper);
 
+    void valuesAt(const float* positions, float* values, size_t n) const override;
+
     QVariant parameter() const override;
     void setParameter(const QVariant& parameter) override;
 
@@ -0,0 +1,166 @@
+#include "lookuptablemodel.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace CTL {
+
+DECLARE_SERIALIZABLE_TYPE(LookupTableModel)
+
+/*!
+ * Constructs a LookupTableModel that samples \a model at \a nbSamples equidistant positions in the
+ * range [\a from, \a to]. A copy of \a model is stored in this instance.
+ *
+ * Throws std::domain_error if \a nbSamples is less than two or the range is empty.
+ */
+LookupTableModel::LookupTableModel(const AbstractDataModel& model, float from, float to,
+                                   uint nbSamples)
+    : _model(model.clone())
+    , _from(from)
+    , _to(to)
+{
+    sampleTable(nbSamples);
+}
+
+/*!
+ * Returns the linearly interpolated value from the lookup table at \a position. Outside of the
+ * tabulated range, the wrapped model is evaluated.
+ */
+float LookupTableModel::valueAt(float position) const
+{
+    if(_table.empty())
+        return 0.0f;
+    if(!(position >= _from && position <= _to))
+        return _model->valueAt(position);
+
+    const auto lastIdx = _table.size() - 1;
+    const auto idxF = (position - _from) * (float(lastIdx) / (_to - _from));
+    const auto idx = std::min(size_t(idxF), lastIdx - 1);
+    const auto weight = idxF - float(idx);
+
+    return (1.0f - weight) * _table[idx] + weight * _table[idx + 1];
+}
+
+/*!
+ * Computes the values at the \a n positions in \a positions and writes them to \a values (in-place
+ * evaluation is allowed). Positions within the tabulated range are interpolated from the lookup
+ * table. The remaining positions are passed to the wrapped model in a second pass.
+ */
+void LookupTableModel::valuesAt(const float* positions, float* values, size_t n) const
+{
+    if(_table.empty())
+    {
+        std::fill(values, values + n, 0.0f);
+        return;
+    }
+
+    const auto lastIdx = _table.size() - 1;
+    const auto scale = float(lastIdx) / (_to - _from);
+    const auto from = _from;
+    const auto to = _to;
+    const auto* table = _table.data();
+
+    std::vector<size_t> outOfRange;
+    for(size_t i = 0; i < n; ++i)
+    {
+        const auto x = positions[i];
+        if(!(x >= from && x <= to))
+        {
+            outOfRange.push_back(i);
+            continue;
+        }
+        const auto idxF = (x - from) * scale;
+        const auto idx = std::min(size_t(idxF), lastIdx - 1);
+        const auto weight = idxF - float(idx);
+        values[i] = (1.0f - weight) * table[idx] + weight * table[idx + 1];
+    }
+
+    for(const auto i : outOfRange)
+        values[i] = _model->valueAt(positions[i]);
+}
+
+AbstractDataModel* LookupTableModel::clone() const { return new LookupTableModel(*this); }
+
+/*!
+ * Returns a pointer to the wrapped model (nullptr for a default constructed instance).
+ */
+const AbstractDataModel* LookupTableModel::model() const { return _model.get(); }
+
+/*!
+ * Returns the start of the tabulated range.
+ */
+float LookupTableModel::from() const { return _from; }
+
+/*!
+ * Returns the end of the tabulated range.
+ */
+float LookupTableModel::to() const { return _to; }
+
+/*!
+ * Returns the number of samples in the lookup table.
+ */
+uint LookupTableModel::nbSamples() const { return uint(_table.size()); }
+
+/*!
+ * Returns the parameters of this instance as QVariant.
+ *
+ * This returns a QVariantMap with four key-value-pairs: ("model", wrapped model), ("from", start of
+ * range), ("to", end of range), ("samples", number of samples). The lookup table itself is not
+ * stored, it is recomputed from the wrapped model in setParameter().
+ */
+QVariant LookupTableModel::parameter() const
+{
+    QVariantMap ret = AbstractDataModel::parameter().toMap();
+    ret.insert("model", _model ? _model->toVariant() : QVariant());
+    ret.insert("from", _from);
+    ret.insert("to", _to);
+    ret.insert("samples", nbSamples());
+
+    return ret;
+}
+
+/*!
+ * Sets the parameters of this instance based on the passed QVariant \a parameter. The parameters
+ * must be passed as a QVariantMap with the keys described in parameter().
+ */
+void LookupTableModel::setParameter(const QVariant& parameter)
+{
+    AbstractDataModel::setParameter(parameter);
+
+    const auto parMap = parameter.toMap();
+    if(!parMap.contains("model"))
+    {
+        qWarning() << "LookupTableModel::setParameter: Could not set parameters! "
+                      "reason: no model specified";
+        return;
+    }
+
+    _model.reset(SerializationHelper::parseDataModel(parMap.value("model")));
+    _from = parMap.value("from").toFloat();
+    _to = parMap.value("to").toFloat();
+    sampleTable(parMap.value("samples", 4096u).toUInt());
+}
+
+void LookupTableModel::sampleTable(uint nbSamples)
+{
+    if(nbSamples < 2)
+        throw std::domain_error("LookupTableModel: number of samples must be at least two.");
+    if(!(_to > _from))
+        throw std::domain_error("LookupTableModel: tabulated range [from, to] must not be empty.");
+    if(!_model)
+        throw std::domain_error("LookupTableModel: no model to be tabulated.");
+
+    const auto positions = [this, nbSamples]
+    {
+        std::vector<float> ret(nbSamples);
+        const auto spacing = (_to - _from) / float(nbSamples - 1);
+        for(uint s = 0; s < nbSamples; ++s)
+            ret[s] = _from + float(s) * spacing;
+        ret.back() = _to;
+        return ret;
+    }();
+
+    _table.resize(nbSamples);
+    _model->valuesAt(positions.data(), _table.data(), nbSamples);
+}
+
+} // namespace CTL
@@ -0,0 +1,54 @@
+#ifndef CTL_LOOKUPTABLEMODEL_H
+#define CTL_LOOKUPTABLEMODEL_H
+
+#include "abstractdatamodel.h"
+#include <vector>
+
+namespace CTL {
+
+/*!
+ * \class LookupTableModel
+ * \brief The LookupTableModel class is a data model that replaces an arbitrary model by a lookup
+ * table with uniform sampling.
+ *
+ * The wrapped model is sampled at `nbSamples` equidistant positions within the range
+ * [\a from, \a to]. Within this range, values are linearly interpolated from the lookup table.
+ * Outside of the range, the wrapped model is evaluated directly.
+ *
+ * This "compiled" representation is useful for models that are expensive to evaluate and need to
+ * be sampled very often (e.g. saturation models applied to each detector pixel). The batch
+ * evaluation valuesAt() is free of virtual calls for positions within the range of the table.
+ */
+class LookupTableModel : public AbstractDataModel
+{
+    CTL_TYPE_ID(60)
+
+    public: float valueAt(float position) const override;
+    public: AbstractDataModel* clone() const override;
+
+public:
+    LookupTableModel() = default;
+    LookupTableModel(const AbstractDataModel& model, float from, float to, uint nbSamples = 4096);
+
+    void valuesAt(const float* positions, float* values, size_t n) const override;
+
+    const AbstractDataModel* model() const;
+    float from() const;
+    float to() const;
+    uint nbSamples() const;
+
+    QVariant parameter() const override;
+    void setParameter(const QVariant& parameter) override;
+
+private:
+    AbstractDataModelPtr _model; //!< wrapped model
+    float _from = 0.0f; //!< start of the tabulated range
+    float _to = 0.0f;   //!< end of the tabulated range
+    std::vector<float> _table; //!< sampled values of `_model` at equidistant positions
+
+    void sampleTable(uint nbSamples);
+};
+
+} // namespace CTL
+
+#endif // CTL_LOOKUPTABLEMODEL_H
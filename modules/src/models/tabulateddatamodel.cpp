@@ -1,5 +1,5 @@
 #include "tabulateddatamodel.h"
-#include <QDebug>
+#include <algorithm>
 
 namespace CTL {
 
@@ -34,7 +34,11 @@ const QMap<float, float> &TabulatedDataModel::lookupTable() const { return _data
 /*!
  * Sets the lookup table of this instance to \a table.
  */
-void TabulatedDataModel::setData(QMap<float, float> table) { _data = std::move(table); }
+void TabulatedDataModel::setData(QMap<float, float> table)
+{
+    _data = std::move(table);
+    invalidateCompiledTable();
+}
 
 /*!
  * Sets the lookup table of this instance to the values given by \a keys and \a values.
@@ -53,6 +57,7 @@ void TabulatedDataModel::setData(const QVector<float>& keys, const QVector<float
     _data.clear();
     for(auto k = 0, length = keys.length(); k < length; ++k)
         _data.insert(keys.at(k), values.at(k));
+    invalidateCompiledTable();
 }
 
 /*!
@@ -60,7 +65,11 @@ void TabulatedDataModel::setData(const QVector<float>& keys, const QVector<float
  *
  * If an entry with the same key already exists, it will be overwritten.
  */
-void TabulatedDataModel::insertDataPoint(float key, float value) { _data.insert(key, value); }
+void TabulatedDataModel::insertDataPoint(float key, float value)
+{
+    _data.insert(key, value);
+    invalidateCompiledTable();
+}
 
 QVariantList TabulatedDataModel::dataAsVariantList() const
 {
@@ -86,6 +95,74 @@ void TabulatedDataModel::setDataFromVariantList(const QVariantList& list)
             continue;
         _data.insert(dataPoint.at(0).toFloat(), dataPoint.at(1).toFloat());
     }
+    invalidateCompiledTable();
+}
+
+/*!
+ * Returns the compiled representation of the lookup table. It is built on first use after the data
+ * has been changed. Building is thread-safe, i.e. concurrent calls of const methods are allowed.
+ */
+const TabulatedDataModel::CompiledTable& TabulatedDataModel::compiledTable() const
+{
+    auto& table = *_compiled;
+    std::call_once(table.built, [this, &table] { table.build(_data); });
+    return table;
+}
+
+/*!
+ * Discards the compiled representation of the lookup table (it might be shared with copies of this
+ * instance) and provides an empty one that is built on next use.
+ */
+void TabulatedDataModel::invalidateCompiledTable() { _compiled = std::make_shared<CompiledTable>(); }
+
+void TabulatedDataModel::CompiledTable::build(const QMap<float, float>& table)
+{
+    const auto nbKeys = size_t(table.size());
+    keys.reserve(nbKeys);
+    values.reserve(nbKeys);
+    cumIntegral.reserve(nbKeys);
+
+    for(auto it = table.constBegin(), end = table.constEnd(); it != end; ++it)
+    {
+        cumIntegral.push_back(keys.empty()
+                              ? 0.0
+                              : cumIntegral.back() + 0.5 * (double(it.value()) + values.back()) *
+                                                           (double(it.key()) - keys.back()));
+        keys.push_back(it.key());
+        values.push_back(it.value());
+    }
+}
+
+/*!
+ * Returns the index of the first key that is not less than \a pos (number of keys if there is no
+ * such key).
+ */
+size_t TabulatedDataModel::CompiledTable::lowerBound(float pos) const
+{
+    return size_t(std::lower_bound(keys.cbegin(), keys.cend(), pos) - keys.cbegin());
+}
+
+/*!
+ * Returns the linearly interpolated value at \a pos, where \a nextIdx must be the index of the
+ * first key that is not less than \a pos (see lowerBound()). Returns zero outside the range of
+ * tabulated data.
+ */
+float TabulatedDataModel::CompiledTable::valueAt(float pos, size_t nextIdx) const
+{
+    // check if data contains an entry for 'pos'
+    if(nextIdx < keys.size() && keys[nextIdx] == pos)
+        return values[nextIdx];
+
+    // check if value is outside of tabulated data --> return 0
+    if(nextIdx == 0 || nextIdx == keys.size())
+        return 0.0f;
+
+    // now it is assured that pos is contained in range of keys of data
+    const auto weight = (keys[nextIdx] - pos) / (keys[nextIdx] - keys[nextIdx - 1]);
+    const auto contribLower = values[nextIdx - 1] * weight;
+    const auto contribUpper = values[nextIdx] * (1.0f - weight);
+
+    return contribLower + contribUpper;
 }
 
 /*!
@@ -105,68 +182,44 @@ void TabulatedDataModel::setDataFromVariantList(const QVariantList& list)
  */
 float TabulatedDataModel::binIntegral(float position, float binWidth) const
 {
+    const auto& table = compiledTable();
+    const auto& keys = table.keys;
+    const auto& values = table.values;
+
     const auto from = position - 0.5f * binWidth;
     const auto to = position + 0.5f * binWidth;
 
-    auto ret = 0.0f;
-
-    const auto lowerEndPosition = _data.lowerBound(from);
-    const auto upperEndPosition = _data.lowerBound(to);
+    const auto lowerEndIdx = table.lowerBound(from);
+    const auto upperEndIdx = table.lowerBound(to);
 
     // check if integration interval is fully outside tabulated data --> return zero
-    if(lowerEndPosition == _data.end() || to < _data.begin().key())
+    if(lowerEndIdx == keys.size() || to < keys.front())
         return 0.0f;
 
     // integration interval lies fully within two tabulated values --> return value * binWidth
-    if(lowerEndPosition == upperEndPosition && upperEndPosition != _data.begin())
-        return valueAt(position) * binWidth;
+    if(lowerEndIdx == upperEndIdx && upperEndIdx != 0)
+        return table.valueAt(position, table.lowerBound(position)) * binWidth;
 
     // if function reaches this point, multiple segments need to be integrated
     // compute contribution of lower end
-    const auto lowerEndValue = valueAt(from);
-    const auto lowerEndContr = 0.5f * (lowerEndValue + lowerEndPosition.value()) *
-                                      (lowerEndPosition.key() - from);
-
-    ret += lowerEndContr;
-
-    qDebug() << "lowerEndContr: Integral from " << lowerEndValue << "(at: " << from << ") to "
-             << lowerEndPosition.value() << "(at: " << lowerEndPosition.key()
-             << ") = " << lowerEndContr;
+    const auto lowerEndValue = table.valueAt(from, lowerEndIdx);
+    auto ret = 0.5f * (lowerEndValue + values[lowerEndIdx]) * (keys[lowerEndIdx] - from);
 
-    if(upperEndPosition == _data.begin())
+    if(upperEndIdx == 0)
         return ret;
 
-    // compute contributions of all 'full segments'
-    auto currentPosition = lowerEndPosition;
-    while(currentPosition != upperEndPosition)
-    {
-        if(currentPosition + 1 == _data.end())
-            break;
-        if((currentPosition + 1).key() > to)
-            break;
-        float width = (currentPosition + 1).key() - currentPosition.key();
-        float height = 0.5f * ((currentPosition + 1).value() + currentPosition.value());
-
-        qDebug() << "contribution for " << currentPosition.key() << "to" << (currentPosition + 1).key()
-                 << ": " << width * height;
-
-        ret += width * height;
-        ++currentPosition;
-    }
+    // contributions of all 'full segments' from precomputed cumulative integral
+    const auto lastFullIdx = size_t(std::upper_bound(keys.cbegin() + lowerEndIdx, keys.cend(), to)
+                                    - keys.cbegin()) - 1;
+    ret += float(table.cumIntegral[lastFullIdx] - table.cumIntegral[lowerEndIdx]);
 
-    if(qFuzzyCompare(currentPosition.key(), to))
+    if(qFuzzyCompare(keys[lastFullIdx], to))
         return ret;
 
     // compute contribution of upper end
-    const auto lastSample = (upperEndPosition - 1);
-    const auto upperEndValue = valueAt(to);
-    const auto upperEndContr = 0.5f * (lastSample.value() + upperEndValue) * (to - lastSample.key());
-
-    ret += upperEndContr;
-
-    qDebug() << "upperEndContr: Integral from " << (upperEndPosition - 1).value()
-             << "(at: " << (upperEndPosition - 1).key() << ") to " << upperEndValue << "(at: " << to
-             << ") = " << upperEndContr;
+    const auto lastSampleIdx = upperEndIdx - 1;
+    const auto upperEndValue = table.valueAt(to, upperEndIdx);
+    ret += 0.5f * (values[lastSampleIdx] + upperEndValue) * (to - keys[lastSampleIdx]);
 
     return ret;
 }
@@ -180,24 +233,35 @@ AbstractDataModel* TabulatedDataModel::clone() const { return new TabulatedDataM
  */
 float TabulatedDataModel::valueAt(float pos) const
 {
-    // check if data contains an entry for 'pos'
-    if(_data.contains(pos))
-        return _data.value(pos);
-
-    // find position of next tabulated entry in data with key > pos
-    const auto nextValidDataPt = _data.lowerBound(pos);
-
-    // check if value is outside of tabulated data --> return 0
-    if(nextValidDataPt == _data.begin() || nextValidDataPt == _data.end())
-        return 0.0f;
+    const auto& table = compiledTable();
+    return table.valueAt(pos, table.lowerBound(pos));
+}
 
-    // now it is assured that pos is contained in range of keys of data
-    const auto weight = (nextValidDataPt.key() - pos) /
-                        (nextValidDataPt.key() - (nextValidDataPt - 1).key());
-    const auto contribLower = (nextValidDataPt - 1).value() * weight;
-    const auto contribUpper = (nextValidDataPt).value() * (1.0f - weight);
+/*!
+ * Computes the linearly interpolated values at the \a n positions in \a positions and writes them
+ * to \a values. The result is the same as calling valueAt() for each position, but the lookup of
+ * tabulated data is done only once. For (partially) ascending positions, the search of the
+ * corresponding table entries is continued from the previous position. In-place evaluation is
+ * allowed, i.e. \a values may be equal to \a positions.
+ */
+void TabulatedDataModel::valuesAt(const float* positions, float* values, size_t n) const
+{
+    const auto& table = compiledTable();
+    const auto& keys = table.keys;
+    const auto nbKeys = keys.size();
 
-    return contribLower + contribUpper;
+    size_t nextIdx = 0;
+    for(size_t i = 0; i < n; ++i)
+    {
+        const auto pos = positions[i];
+        if(nextIdx > 0 && pos > keys[nextIdx - 1])
+            while(nextIdx < nbKeys && keys[nextIdx] < pos)
+                ++nextIdx;
+        else
+            nextIdx = table.lowerBound(pos);
+
+        values[i] = table.valueAt(pos, nextIdx);
+    }
 }
 
 QVariant TabulatedDataModel::parameter() const
@@ -3,6 +3,9 @@
 
 #include "abstractdatamodel.h"
 #include <QMap>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace CTL {
 
@@ -15,6 +18,12 @@ namespace CTL {
  * Parameters can be set by passing a QVariant that contains all necessary information.
  * Re-implement the setParameter() method to parse the QVariant into your required format within
  * sub-classes of TabulatedDataModel.
+ *
+ * For fast evaluation, the lookup table is compiled into contiguous arrays of keys and values
+ * along with the cumulative (trapezoid) integral at each key. This compiled representation is
+ * built lazily on first use of valueAt(), valuesAt() or binIntegral() and is invalidated whenever
+ * the data changes (setData(), insertDataPoint(), setParameter()). Copies of a model share their
+ * compiled representation.
  */
 class TabulatedDataModel : public AbstractIntegrableDataModel
 {
@@ -43,8 +52,27 @@ public:
 
     void insertDataPoint(float key, float value);
 
+    void valuesAt(const float* positions, float* values, size_t n) const override;
+
 private:
+    struct CompiledTable
+    {
+        std::once_flag built;
+        std::vector<float> keys;
+        std::vector<float> values;
+        std::vector<double> cumIntegral; //!< trapezoid integral from the first key to each key
+
+        void build(const QMap<float, float>& table);
+
+        size_t lowerBound(float pos) const;
+        float valueAt(float pos, size_t nextIdx) const;
+    };
+
     QMap<float, float> _data;
+    std::shared_ptr<CompiledTable> _compiled = std::make_shared<CompiledTable>();
+
+    const CompiledTable& compiledTable() const;
+    void invalidateCompiledTable();
 
     QVariantList dataAsVariantList() const;
     void setDataFromVariantList(const QVariantList& list);
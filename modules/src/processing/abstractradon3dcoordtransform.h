@@ -0,0 +1,42 @@
+#ifndef CTL_ABSTRACTRADON3DCOORDTRANSFORM_H
+#define CTL_ABSTRACTRADON3DCOORDTRANSFORM_H
+
+#include "mat/matrix_types.h"
+#include "processing/abstractvolumeresampler.h"
+
+namespace CTL {
+
+/*!
+ * \class AbstractRadon3DCoordTransform
+ * \brief Interface for classes that transform (spherical) 3D Radon coordinates under an Euclidian
+ * transform of the coordinate frame.
+ *
+ * An implementation holds a set of initial coordinates (set by resetIninitialCoords()), which are
+ * transformed by a homography. sampleTransformed() transforms the initial coordinates and samples
+ * the result with a volume resampler (e.g. a sampler of the 3D intermediate space). Implementations
+ * may exploit that the transformed coordinates do not need to leave the backend's memory if the
+ * passed resampler runs on the same backend.
+ */
+class AbstractRadon3DCoordTransform
+{
+    public:virtual std::vector<float> sampleTransformed(const Homography3D& homography,
+                                                        const AbstractVolumeResampler& sampler) const = 0;
+
+public:
+    virtual void resetIninitialCoords(const std::vector<Radon3DCoord>& initialCoords) = 0;
+    virtual std::vector<Radon3DCoord> transformedCoords(const Matrix3x3& rotation,
+                                                        const Vector3x1& translation) const = 0;
+
+    virtual ~AbstractRadon3DCoordTransform() = default;
+
+protected:
+    AbstractRadon3DCoordTransform() = default;
+    AbstractRadon3DCoordTransform(const AbstractRadon3DCoordTransform&) = default;
+    AbstractRadon3DCoordTransform(AbstractRadon3DCoordTransform&&) = default;
+    AbstractRadon3DCoordTransform& operator=(const AbstractRadon3DCoordTransform&) = default;
+    AbstractRadon3DCoordTransform& operator=(AbstractRadon3DCoordTransform&&) = default;
+};
+
+} // namespace CTL
+
+#endif // CTL_ABSTRACTRADON3DCOORDTRANSFORM_H
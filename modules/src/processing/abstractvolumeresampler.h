@@ -0,0 +1,42 @@
+#ifndef CTL_ABSTRACTVOLUMERESAMPLER_H
+#define CTL_ABSTRACTVOLUMERESAMPLER_H
+
+#include "img/voxelvolume.h"
+#include "processing/coordinates.h"
+
+namespace CTL {
+
+/*!
+ * \class AbstractVolumeResampler
+ * \brief Interface for classes that sample (interpolate) volume data at arbitrary coordinates.
+ *
+ * The volume is defined on a regular grid that spans the three sampling ranges rangeDim1(),
+ * rangeDim2() and rangeDim3(). Sampling points that are located outside of the volume are treated
+ * as zero (boundary color).
+ *
+ * This interface allows to implement algorithms (e.g. Grangeat-based consistency conditions)
+ * independently of the backend (OpenCL or CPU) that performs the interpolation.
+ */
+class AbstractVolumeResampler
+{
+    public:virtual std::vector<float> sample(const std::vector<Generic3DCoord>& samplingPts) const = 0;
+
+public:
+    virtual const SamplingRange& rangeDim1() const = 0;
+    virtual const SamplingRange& rangeDim2() const = 0;
+    virtual const SamplingRange& rangeDim3() const = 0;
+    virtual const VoxelVolume<float>::Dimensions& volDim() const = 0;
+
+    virtual ~AbstractVolumeResampler() = default;
+
+protected:
+    AbstractVolumeResampler() = default;
+    AbstractVolumeResampler(const AbstractVolumeResampler&) = default;
+    AbstractVolumeResampler(AbstractVolumeResampler&&) = default;
+    AbstractVolumeResampler& operator=(const AbstractVolumeResampler&) = default;
+    AbstractVolumeResampler& operator=(AbstractVolumeResampler&&) = default;
+};
+
+} // namespace CTL
+
+#endif // CTL_ABSTRACTVOLUMERESAMPLER_H
@@ -6,8 +6,13 @@
 #include "mat/projectionmatrix.h"
 #include "mat/matrix.h"
 #include "mat/mat.h"
+#include "processing/threadpool.h"
 
+#include <QDebug>
+#include <atomic>
 #include <bitset>
+#include <limits>
+#include <map>
 #include <random>
 
 const std::string CL_KERNEL_HOM2RADON = "homToRadon"; //!< name of the OpenCL kernel function
@@ -17,89 +22,12 @@ namespace {
 
 template <class T>
 std::vector<T> randomSubset(std::vector<T>&& fullSamples, uint seed, float subsampleLevel);
+void defaultSamplingDensity(const CTL::Chunk2D<float>::Dimensions& projSize,
+                            uint& nbAngles, uint& nbDist);
 
 } // unnamed namespace
 
 namespace CTL {
-
-// #### IntermediateFctPair ####
-// -----------------------------
-
-IntermediateFctPair::IntermediateFctPair(std::vector<float> first, std::vector<float> second,
-                                         Type secondType)
-    : _first(first.size() == second.size()
-             ? std::make_shared<const std::vector<float>>(std::move(first))
-             : std::make_shared<const std::vector<float>>())
-    , _second(_first->size() == second.size()
-              ? std::make_shared<const std::vector<float>>(std::move(second))
-              : std::make_shared<const std::vector<float>>())
-    , _secondType(secondType)
-{
-}
-
-IntermediateFctPair::IntermediateFctPair(std::shared_ptr<const std::vector<float>> first,
-                                         std::vector<float> second, Type secondType)
-    : _first(first->size() == second.size()
-             ? std::move(first)
-             : std::make_shared<const std::vector<float>>())
-    , _second(_first->size() == second.size()
-              ? std::make_shared<const std::vector<float>>(std::move(second))
-              : std::make_shared<const std::vector<float>>())
-    , _secondType(secondType)
-{
-}
-
-IntermediateFctPair::IntermediateFctPair(std::vector<float> first,
-                                         std::shared_ptr<const std::vector<float>> second,
-                                         Type secondType)
-    : _first(first.size() == second->size()
-             ? std::make_shared<const std::vector<float>>(std::move(first))
-             : std::make_shared<const std::vector<float>>())
-    , _second(_first->size() == second->size()
-              ? std::move(second)
-              : std::make_shared<const std::vector<float>>())
-    , _secondType(secondType)
-{
-}
-
-IntermediateFctPair::IntermediateFctPair(std::shared_ptr<const std::vector<float>> first,
-                                         std::shared_ptr<const std::vector<float>> second,
-                                         Type secondType)
-    : _first(first->size() == second->size()
-             ? std::move(first)
-             : std::make_shared<const std::vector<float>>())
-    , _second(_first->size() == second->size()
-              ? std::move(second)
-              : std::make_shared<const std::vector<float>>())
-    , _secondType(secondType)
-{
-}
-
-double IntermediateFctPair::inconsistency(const imgproc::AbstractErrorMetric& metric, bool swapInput) const
-{
-    Q_ASSERT(!isEmpty());
-    return swapInput ? metric(*_second, *_first) : metric(*_first, *_second);
-}
-
-bool IntermediateFctPair::isEmpty() const
-{
-    return _first->empty();
-}
-
-const std::vector<float>& IntermediateFctPair::first() const { return *_first; }
-
-const std::vector<float>& IntermediateFctPair::second() const { return *_second; }
-
-const std::shared_ptr<const std::vector<float>>& IntermediateFctPair::ptrToFirst() const
-{
-    return _first;
-}
-
-const std::shared_ptr<const std::vector<float>>& IntermediateFctPair::ptrToSecond() const
-{
-    return _second;
-}
-
 namespace OCL {
 
 // #### IntermedGen2D2D ####
@@ -138,6 +66,40 @@ void IntermedGen2D2D::toggleSubsampling(bool enabled)
     _useSubsampling = enabled;
 }
 
+uint IntermedGen2D2D::nbThreads() const
+{
+    return _nbThreads;
+}
+
+/*!
+ * Sets the number of threads that are used by inconsistencyMatrix(). A value of zero defaults to
+ * `std::thread::hardware_concurrency()`.
+ */
+void IntermedGen2D2D::setNbThreads(uint nbThreads)
+{
+    _nbThreads = nbThreads;
+}
+
+size_t IntermedGen2D2D::samplerMemoryLimit() const
+{
+    return _samplerMemoryLimit;
+}
+
+/*!
+ * Sets the maximum amount of (OpenCL device) memory in bytes that is occupied by precomputed
+ * samplers within the non-precomputed versions of inconsistencyMatrix(). If the samplers of all
+ * views do not fit into this budget, the views are split into blocks and the pair graph is
+ * evaluated block pair by block pair, i.e. the samplers of at most two blocks are held at the same
+ * time (at least two samplers, regardless of \a bytes). A value of zero disables the limit.
+ *
+ * A smaller limit reduces the memory footprint at the expense of recomputing the samplers of a
+ * block once per block pair. The default is 2 GiB.
+ */
+void IntermedGen2D2D::setSamplerMemoryLimit(size_t bytes)
+{
+    _samplerMemoryLimit = bytes;
+}
+
 IntermediateFctPair IntermedGen2D2D::intermedFctPair(const Chunk2D<float>& proj1,
                                                      const mat::ProjectionMatrix& P1,
                                                      const Chunk2D<float>& proj2,
@@ -187,6 +149,346 @@ IntermediateFctPair IntermedGen2D2D::intermedFctPair(const ImageResampler& radon
              IntermediateFctPair::ProjectionDomain };
 }
 
+/*!
+ * Returns the inconsistency matrix of all pairs of views in \a projs (with projection matrices
+ * \a Ps). The intermediate function of each view is sampled once using precomputedSamplers() with
+ * default sampling density. See the precomputed version of inconsistencyMatrix() for details.
+ */
+Chunk2D<double> IntermedGen2D2D::inconsistencyMatrix(const std::vector<Chunk2D<float>>& projs,
+                                                     const std::vector<mat::ProjectionMatrix>& Ps,
+                                                     const imgproc::AbstractErrorMetric& metric) const
+{
+    return inconsistencyMatrix(projs, Ps, allPairs(uint(projs.size())), metric);
+}
+
+/*!
+ * Returns the inconsistency matrix of all view pairs in \a pairs (sparse pair graph) of the views
+ * in \a projs (with projection matrices \a Ps). The intermediate function of each view is sampled
+ * using precomputedSamplers() with default sampling density. See the precomputed version of
+ * inconsistencyMatrix() for details.
+ *
+ * If the samplers of all views exceed samplerMemoryLimit(), the views are split into blocks and
+ * only the samplers of the two blocks that are involved in the currently processed pairs are kept
+ * (see setSamplerMemoryLimit()). The result does not depend on the block size.
+ */
+Chunk2D<double> IntermedGen2D2D::inconsistencyMatrix(const std::vector<Chunk2D<float>>& projs,
+                                                     const std::vector<mat::ProjectionMatrix>& Ps,
+                                                     const PairGraph& pairs,
+                                                     const imgproc::AbstractErrorMetric& metric) const
+{
+    if(projs.empty())
+        return Chunk2D<double>(0, 0);
+
+    const auto nbViews = uint(projs.size());
+    if(Ps.size() != nbViews)
+        throw std::runtime_error("IntermedGen2D2D::inconsistencyMatrix: number of projections and "
+                                 "projection matrices do not match.");
+    for(const auto& pair : pairs)
+        if(pair.first >= nbViews || pair.second >= nbViews)
+            throw std::runtime_error("IntermedGen2D2D::inconsistencyMatrix: view index of pair "
+                                     "graph out of range.");
+
+    const auto projSize = projs.front().dimensions();
+    for(const auto& proj : projs)
+        if(proj.dimensions() != projSize)
+            throw std::runtime_error("IntermedGen2D2D::inconsistencyMatrix: size of projections "
+                                     "must match.");
+
+    uint nbAngles = 0, nbDist = 0;
+    defaultSamplingDensity(projSize, nbAngles, nbDist);
+    const auto bytesPerSampler = size_t(nbAngles) * nbDist * sizeof(float);
+    const auto blockSize = _samplerMemoryLimit == 0
+            ? nbViews
+            : uint(std::min(std::max(_samplerMemoryLimit / (2 * bytesPerSampler), size_t(1)),
+                            size_t(nbViews)));
+
+    if(blockSize >= nbViews)
+        return inconsistencyMatrix(precomputedSamplers(projs, Ps), Ps, projSize, pairs, metric);
+
+    // group pairs by the (ordered) pair of blocks that contain their views
+    std::map<std::pair<uint, uint>, PairGraph> blockPairs;
+    for(const auto& pair : pairs)
+    {
+        const auto block1 = pair.first / blockSize;
+        const auto block2 = pair.second / blockSize;
+        blockPairs[{ std::min(block1, block2), std::max(block1, block2) }].push_back(pair);
+    }
+
+    auto blockViews = [&](uint block)
+    {
+        const auto first = block * blockSize;
+        const auto last = std::min(first + blockSize, nbViews);
+        return std::make_pair(
+            std::vector<Chunk2D<float>>(projs.begin() + first, projs.begin() + last),
+            std::vector<mat::ProjectionMatrix>(Ps.begin() + first, Ps.begin() + last));
+    };
+
+    Chunk2D<double> ret(nbViews, nbViews, std::numeric_limits<double>::quiet_NaN());
+
+    // block pairs are ordered by their first block, whose samplers are kept for consecutive entries
+    auto cachedBlock = std::numeric_limits<uint>::max();
+    std::vector<ImageResampler> samplers1;
+    for(const auto& blockPair : blockPairs)
+    {
+        const auto block1 = blockPair.first.first;
+        const auto block2 = blockPair.first.second;
+
+        auto views1 = blockViews(block1);
+        if(block1 != cachedBlock)
+        {
+            samplers1.clear(); // release device memory before computing the next block
+            samplers1 = precomputedSamplers(views1.first, views1.second);
+            cachedBlock = block1;
+        }
+
+        auto samplers = samplers1;
+        auto blockPs = std::move(views1.second);
+        if(block2 != block1)
+        {
+            const auto views2 = blockViews(block2);
+            auto samplers2 = precomputedSamplers(views2.first, views2.second);
+            samplers.insert(samplers.end(), samplers2.begin(), samplers2.end());
+            blockPs.insert(blockPs.end(), views2.second.begin(), views2.second.end());
+        }
+
+        // view index within `samplers`
+        const auto nbViews1 = uint(samplers1.size());
+        auto localIndex = [&](uint view)
+        {
+            return view / blockSize == block1 ? view - block1 * blockSize
+                                              : view - block2 * blockSize + nbViews1;
+        };
+
+        PairGraph localPairs;
+        localPairs.reserve(blockPair.second.size());
+        for(const auto& pair : blockPair.second)
+            localPairs.emplace_back(localIndex(pair.first), localIndex(pair.second));
+
+        const auto blockResult = inconsistencyMatrix(samplers, blockPs, projSize, localPairs, metric);
+
+        for(const auto& pair : blockPair.second)
+            ret(pair.second, pair.first) = blockResult(localIndex(pair.second),
+                                                       localIndex(pair.first));
+    }
+
+    return ret;
+}
+
+/*!
+ * Returns the inconsistency matrix for all view pairs in \a pairs, where the intermediate
+ * functions of the views are given by the precomputed \a radon2dSamplers (see
+ * precomputedSamplers()) and the projection matrices \a Ps.
+ *
+ * The returned matrix has the size `nbViews x nbViews`. The inconsistency of the pair (i, j) is
+ * stored in row `i` and column `j`, i.e. at position `(x = j, y = i)` of the returned Chunk2D.
+ * Entries of pairs that are not part of the pair graph (as well as pairs that could not be
+ * evaluated, e.g. due to coinciding source positions) are NaN.
+ *
+ * The corresponding line pairs are computed in parallel using nbThreads() threads, where each
+ * thread collects the lines of its pairs locally. Afterwards, the lines are merged per view, such
+ * that each sampler is evaluated only once (the OpenCL kernels are shared among all samplers).
+ * Finally, the inconsistencies of all pairs are computed in parallel.
+ */
+Chunk2D<double> IntermedGen2D2D::inconsistencyMatrix(const std::vector<ImageResampler>& radon2dSamplers,
+                                                     const std::vector<mat::ProjectionMatrix>& Ps,
+                                                     const Chunk2D<float>::Dimensions& projSize,
+                                                     const PairGraph& pairs,
+                                                     const imgproc::AbstractErrorMetric& metric) const
+{
+    const auto nbViews = uint(radon2dSamplers.size());
+    if(Ps.size() != nbViews)
+        throw std::runtime_error("IntermedGen2D2D::inconsistencyMatrix: number of samplers and "
+                                 "projection matrices do not match.");
+    for(const auto& pair : pairs)
+        if(pair.first >= nbViews || pair.second >= nbViews)
+            throw std::runtime_error("IntermedGen2D2D::inconsistencyMatrix: view index of pair "
+                                     "graph out of range.");
+
+    Chunk2D<double> ret(nbViews, nbViews, std::numeric_limits<double>::quiet_NaN());
+
+    const auto nbThreads = std::max(std::min(size_t(_nbThreads == 0
+                                                        ? std::thread::hardware_concurrency()
+                                                        : _nbThreads),
+                                             pairs.size()),
+                                    size_t(1));
+
+    // sampling coordinates of a pair on the lines of both views
+    struct PairLines
+    {
+        size_t pair;
+        std::vector<Generic2DCoord> coords1, coords2;
+        size_t nbLines;
+        size_t offset1, offset2; // position of the samples in `viewSamples`
+    };
+
+    // 1. compute line pairs in parallel; each thread accumulates its pairs locally
+    std::vector<std::vector<PairLines>> threadLines(nbThreads);
+    std::atomic<size_t> nextPair{ 0 };
+
+    // dynamic scheduling of pairs (computational cost of a pair depends on its geometry)
+    auto lineWorker = [&](size_t thread)
+    {
+        auto& lines = threadLines[thread];
+        for(auto p = nextPair++; p < pairs.size(); p = nextPair++)
+        {
+            try
+            {
+                auto radon2DCoords = linePairs(Ps[pairs[p].first], Ps[pairs[p].second], projSize);
+                if(radon2DCoords.first.empty())
+                    continue;
+
+                if(_useSubsampling)
+                {
+                    uint seed = std::random_device{}(); // pull random seed for subsampling
+                    radon2DCoords.first = randomSubset(std::move(radon2DCoords.first), seed,
+                                                       _subsampleLevel);
+                    radon2DCoords.second = randomSubset(std::move(radon2DCoords.second), seed,
+                                                        _subsampleLevel);
+                }
+
+                lines.push_back({ p, toGeneric2DCoord(radon2DCoords.first),
+                                  toGeneric2DCoord(radon2DCoords.second),
+                                  radon2DCoords.first.size(), 0, 0 });
+            } catch(const std::exception& e)
+            {
+                qWarning() << "IntermedGen2D2D::inconsistencyMatrix: pair (" << pairs[p].first
+                           << "," << pairs[p].second << ") skipped:" << e.what();
+            }
+        }
+    };
+    {
+        ThreadPool tp(nbThreads);
+        for(size_t t = 0; t < nbThreads; ++t)
+            tp.enqueueThread(lineWorker, t);
+    } // blocking dtor of `tp`
+
+    // 2. merge the coordinates per view and sample each view in a single call
+    std::vector<PairLines*> allLines;
+    for(auto& lines : threadLines)
+        for(auto& line : lines)
+            allLines.push_back(&line);
+
+    std::vector<std::vector<Generic2DCoord>> viewCoords(nbViews);
+    for(auto line : allLines)
+    {
+        auto& coords1 = viewCoords[pairs[line->pair].first];
+        auto& coords2 = viewCoords[pairs[line->pair].second];
+        line->offset1 = coords1.size();
+        coords1.insert(coords1.end(), line->coords1.cbegin(), line->coords1.cend());
+        line->offset2 = coords2.size();
+        coords2.insert(coords2.end(), line->coords2.cbegin(), line->coords2.cend());
+        std::vector<Generic2DCoord>().swap(line->coords1);
+        std::vector<Generic2DCoord>().swap(line->coords2);
+    }
+
+    std::vector<std::vector<float>> viewSamples(nbViews);
+    for(uint v = 0; v < nbViews; ++v)
+        if(!viewCoords[v].empty())
+        {
+            viewSamples[v] = radon2dSamplers[v].sample(viewCoords[v]);
+            std::vector<Generic2DCoord>().swap(viewCoords[v]);
+        }
+
+    // 3. evaluate the inconsistency of all pairs in parallel
+    std::vector<double> inconsistencies(allLines.size(), std::numeric_limits<double>::quiet_NaN());
+    std::atomic<size_t> nextLine{ 0 };
+    auto metricWorker = [&]
+    {
+        for(auto l = nextLine++; l < allLines.size(); l = nextLine++)
+        {
+            const auto& line = *allLines[l];
+            const auto i = pairs[line.pair].first;
+            const auto j = pairs[line.pair].second;
+            const auto first1 = viewSamples[i].cbegin() + line.offset1;
+            const auto first2 = viewSamples[j].cbegin() + line.offset2;
+            try
+            {
+                const IntermediateFctPair pair(
+                    std::vector<float>(first1, first1 + line.nbLines),
+                    std::vector<float>(first2, first2 + line.nbLines),
+                    IntermediateFctPair::ProjectionDomain);
+                inconsistencies[l] = pair.inconsistency(metric);
+            } catch(const std::exception& e)
+            {
+                qWarning() << "IntermedGen2D2D::inconsistencyMatrix: pair (" << i << "," << j
+                           << ") skipped:" << e.what();
+            }
+        }
+    };
+    {
+        ThreadPool tp(std::max(std::min(nbThreads, allLines.size()), size_t(1)));
+        for(size_t t = 0; t < tp.nbThreads(); ++t)
+            tp.enqueueThread(metricWorker);
+    } // blocking dtor of `tp`
+
+    for(size_t l = 0; l < allLines.size(); ++l)
+        ret(pairs[allLines[l]->pair].second, pairs[allLines[l]->pair].first) = inconsistencies[l];
+
+    return ret;
+}
+
+/*!
+ * Computes the intermediate function of each projection in \a projs (with projection matrices
+ * \a Ps) and returns a sampler for each of them. The intermediate functions are sampled on
+ * \a nbAngles angles in [-pi, pi] and \a nbDist distances in [-d/2, d/2], where `d` is the length
+ * of the detector diagonal (in pixels). The origin is the default origin: [(X-1)/2, (Y-1)/2].
+ *
+ * A value of zero for \a nbDist leads to a distance spacing of one pixel; a value of zero for
+ * \a nbAngles leads to an angular spacing that corresponds to one pixel at the detector border.
+ *
+ * The returned samplers can be passed to inconsistencyMatrix() (or the precomputed version of
+ * intermedFctPair()) in order to avoid recomputation of the 2D Radon transform for each pair.
+ */
+std::vector<ImageResampler>
+IntermedGen2D2D::precomputedSamplers(const std::vector<Chunk2D<float>>& projs,
+                                     const std::vector<mat::ProjectionMatrix>& Ps,
+                                     uint nbAngles, uint nbDist,
+                                     imgproc::DiffMethod derivativeMethod)
+{
+    if(projs.size() != Ps.size())
+        throw std::runtime_error("IntermedGen2D2D::precomputedSamplers: number of projections and "
+                                 "projection matrices do not match.");
+
+    std::vector<ImageResampler> ret;
+    if(projs.empty())
+        return ret;
+
+    const auto projSize = projs.front().dimensions();
+    const auto imgDiag = float(mat::Matrix<2, 1>(projSize.width, projSize.height).norm());
+    defaultSamplingDensity(projSize, nbAngles, nbDist);
+
+    const SamplingRange angleRange(-float(PI), float(PI));
+    const SamplingRange distRange(-0.5f * imgDiag, 0.5f * imgDiag);
+
+    ret.reserve(projs.size());
+    for(size_t v = 0; v < projs.size(); ++v)
+    {
+        if(projs[v].dimensions() != projSize)
+            throw std::runtime_error("IntermedGen2D2D::precomputedSamplers: size of projections "
+                                     "must match.");
+
+        const IntermediateProj intermedFct(projs[v], Ps[v].intrinsicMatK());
+        ret.push_back(intermedFct.sampler(angleRange, nbAngles, distRange, nbDist,
+                                          derivativeMethod));
+    }
+
+    return ret;
+}
+
+/*!
+ * Returns the pair graph of all pairs (i, j) with i < j of \a nbViews views.
+ */
+IntermedGen2D2D::PairGraph IntermedGen2D2D::allPairs(uint nbViews)
+{
+    PairGraph ret;
+    ret.reserve(size_t(nbViews) * (nbViews > 0 ? nbViews - 1 : 0) / 2);
+    for(uint i = 0; i < nbViews; ++i)
+        for(uint j = i + 1; j < nbViews; ++j)
+            ret.emplace_back(i, j);
+
+    return ret;
+}
+
 std::pair<IntermedGen2D2D::LineSet, IntermedGen2D2D::LineSet>
 IntermedGen2D2D::linePairs(const mat::ProjectionMatrix& P1, const mat::ProjectionMatrix& P2,
                            const Chunk2D<float>::Dimensions& projSize,
@@ -350,7 +652,7 @@ IntermediateFctPair IntermedGen2D3D::intermedFctPair(const Chunk2D<float>& proj,
 
 IntermediateFctPair IntermedGen2D3D::intermedFctPair(const Chunk2D<float>& proj,
                                                      const mat::ProjectionMatrix& P,
-                                                     const OCL::VolumeResampler& radon3dSampler,
+                                                     const AbstractVolumeResampler& radon3dSampler,
                                                      imgproc::DiffMethod derivativeMethodProj)
 {
     return intermedFctPair(proj, P, radon3dSampler,
@@ -359,7 +661,7 @@ IntermediateFctPair IntermedGen2D3D::intermedFctPair(const Chunk2D<float>& proj,
 
 IntermediateFctPair IntermedGen2D3D::intermedFctPair(const Chunk2D<float>& proj,
                                                      const mat::ProjectionMatrix& P,
-                                                     const VolumeResampler& radon3dSampler,
+                                                     const AbstractVolumeResampler& radon3dSampler,
                                                      imgproc::FiltMethod filterMethodProj)
 {
     mat::Matrix<2, 1> projSize(proj.width(), proj.height());
@@ -402,7 +704,7 @@ IntermediateFctPair IntermedGen2D3D::intermedFctPair(const Chunk2D<float>& proj,
 IntermediateFctPair IntermedGen2D3D::intermedFctPair(const OCL::ImageResampler& radon2dSampler,
                                                      const mat::ProjectionMatrix& P,
                                                      const Chunk2D<float>::Dimensions& projSize,
-                                                     const OCL::VolumeResampler& radon3dSampler)
+                                                     const AbstractVolumeResampler& radon3dSampler)
 {
     const auto imgDiag = mat::Matrix<2, 1>(projSize.width, projSize.height).norm();
     const auto nbS  = uint(ceil(imgDiag / _lineDistance));
@@ -460,46 +762,18 @@ void IntermedGen2D3D::toggleSubsampling(bool enabled)
     _useSubsampling = enabled;
 }
 
- /*!
-  * Constructs a vector that has a list of Radon3DCoord for all combinations of the 2D Radon line
-  * coordinates `mu` (the angle) and `dist` (aka 's'), which is stored in `mu`-major order, i.e.
-  * first all `mu` with the first `dist`, then all `mu` with the second `dist` etc. The 3D Radon
-  * coordinates for a plane are determined by a projection matrix (plane must contain the source
-  * position). The `origin` specifies the placement of the coordinate frame where `mu` and `dist`
-  * are defined.
-  */
+/*!
+ * Constructs a vector that has a list of Radon3DCoord for all combinations of the 2D Radon line
+ * coordinates `mu` (the angle) and `dist` (aka 's'). The computation is shared with the CPU
+ * implementation, see IntermedGen2D3DCPU::intersectionPlanesWCS().
+ */
 std::vector<Radon3DCoord>
 IntermedGen2D3D::intersectionPlanesWCS(const std::vector<float>& mu,
                                        const std::vector<float>& dist,
                                        const mat::ProjectionMatrix& P,
                                        const mat::Matrix<2, 1>& origin) const
 {
-    std::vector<Radon3DCoord> ret;
-    ret.reserve(mu.size() * dist.size());
-
-    mat::Matrix<2, 1> n2D;
-    mat::Matrix<3, 1> n3D;
-    const auto Mtransp = P.M().transposed();
-    const auto srcPosTransp = P.sourcePosition().transposed();
-    const auto originTransp = origin.transposed();
-
-    Radon3DCoord coordWCS;
-    for(const auto& s : dist)
-        for(const auto& angle : mu)
-        {
-            n2D = { std::cos(angle), std::sin(angle) };
-            const auto z = s + originTransp * n2D;
-            n3D = Mtransp * vertcat(n2D, mat::Matrix<1, 1>{ -z });
-            n3D.normalize();
-
-            coordWCS.azimuth() = std::atan2(float(n3D.get<1>()), float(n3D.get<0>()));
-            coordWCS.polar() = std::acos(float(n3D.get<2>()));
-            coordWCS.dist() = float(srcPosTransp * n3D);
-
-            ret.push_back(coordWCS);
-        }
-
-    return ret;
+    return IntermedGen2D3DCPU::intersectionPlanesWCS(mu, dist, P, origin);
 }
 
 // #### IntermediateProj ####
@@ -759,7 +1033,7 @@ Radon3DCoordTransform::Radon3DCoordTransform(const std::vector<Radon3DCoord>& in
     : Radon3DCoordTransform(initialCoords.size(), oclDeviceNb)
 
 {
-    addKernels();
+    initKernels();
 
     _initialPlanesRadonCoord.writeToDev(&initialCoords.front().coord1());
     transformRadonToHom();
@@ -768,7 +1042,7 @@ Radon3DCoordTransform::Radon3DCoordTransform(const std::vector<Radon3DCoord>& in
 Radon3DCoordTransform::Radon3DCoordTransform(const std::vector<HomCoordPlaneNormalized>& initialCoords, uint oclDeviceNb)
     : Radon3DCoordTransform(initialCoords.size(), oclDeviceNb)
 {
-    addKernels();
+    initKernels();
     _q.enqueueWriteBuffer(_initialPlanesHomCoord, CL_TRUE, 0,
                           initialCoords.size() * 4 * sizeof(float), initialCoords.data());
 }
@@ -799,14 +1073,13 @@ const cl::Buffer& Radon3DCoordTransform::transform(const Homography3D& homograph
                    [](double val){ return float(val); });
     _homTransfBuf.transferPinnedMemToDev(false);
 
-    auto kernel = OpenCLConfig::instance().kernel(CL_KERNEL_HOM2RADON);
-    kernel->setArg(0, _homTransfBuf.devBuffer());
-    kernel->setArg(1, _initialPlanesHomCoord);
-    kernel->setArg(2, _transformedCoords);
+    _kernelHom2Radon.setArg(0, _homTransfBuf.devBuffer());
+    _kernelHom2Radon.setArg(1, _initialPlanesHomCoord);
+    _kernelHom2Radon.setArg(2, _transformedCoords);
 
     cl::Event event;
-    _q.enqueueNDRangeKernel(*kernel, cl::NullRange, cl::NDRange(nbCoords()), cl::NullRange, nullptr,
-                            &event);
+    _q.enqueueNDRangeKernel(_kernelHom2Radon, cl::NullRange, cl::NDRange(nbCoords()), cl::NullRange,
+                            nullptr, &event);
     // wait for buffer is ready
     event.wait();
 
@@ -834,6 +1107,32 @@ Radon3DCoordTransform::transformedCoords(const Matrix3x3& rotation,
     return ret;
 }
 
+/*!
+ * Transforms the initial coordinates by \a homography and samples \a sampler at the transformed
+ * coordinates. If \a sampler is a VolumeResampler, the transformed coordinates remain on the OpenCL
+ * device and are sampled using the command queue and an own kernel object of this instance.
+ * Otherwise, they are read back to the host before sampling.
+ */
+std::vector<float> Radon3DCoordTransform::sampleTransformed(const Homography3D& homography,
+                                                            const AbstractVolumeResampler& sampler) const
+{
+    if(const auto oclSampler = dynamic_cast<const VolumeResampler*>(&sampler))
+    {
+        if(_kernelSubsetSampler() == nullptr)
+            _kernelSubsetSampler = oclSampler->subsetSamplerInstance();
+
+        return oclSampler->sample(transform(homography), _kernelSubsetSampler, _q);
+    }
+
+    transform(homography);
+
+    std::vector<Generic3DCoord> coords(nbCoords());
+    _q.enqueueReadBuffer(_transformedCoords, CL_TRUE, 0, coords.size() * 3 * sizeof(float),
+                         coords.data());
+
+    return sampler.sample(coords);
+}
+
 std::vector<HomCoordPlaneNormalized> Radon3DCoordTransform::initialHomCoords() const
 {
     std::vector<HomCoordPlaneNormalized> ret(nbCoords());
@@ -843,7 +1142,7 @@ std::vector<HomCoordPlaneNormalized> Radon3DCoordTransform::initialHomCoords() c
     return ret;
 }
 
-void Radon3DCoordTransform::addKernels() const
+void Radon3DCoordTransform::initKernels()
 {
     OCL::ClFileLoader clFileLoader;
 
@@ -852,6 +1151,14 @@ void Radon3DCoordTransform::addKernels() const
 
     clFileLoader.setFileName("processing/" + CL_KERNEL_RADON2HOM + ".cl");
     OpenCLConfig::instance().addKernel(CL_KERNEL_RADON2HOM, clFileLoader.loadSourceCode());
+
+    // own kernel object for the transformation, since the shared one is not safe to be used
+    // concurrently (kernel arguments)
+    const auto sharedKernel = OpenCLConfig::instance().kernel(CL_KERNEL_HOM2RADON);
+    if(sharedKernel == nullptr)
+        throw std::runtime_error("Radon3DCoordTransform: kernel pointer not valid");
+    _kernelHom2Radon = cl::Kernel(sharedKernel->getInfo<CL_KERNEL_PROGRAM>(),
+                                  CL_KERNEL_HOM2RADON.c_str());
 }
 
 size_t Radon3DCoordTransform::nbCoords() const
@@ -906,4 +1213,16 @@ std::vector<T> randomSubset(std::vector<T>&& fullSamples, uint seed, float subsa
     return ret;
 }
 
+// replaces zero values of `nbAngles` and `nbDist` by the default sampling density of the
+// intermediate function for projections of size `projSize` (see precomputedSamplers())
+void defaultSamplingDensity(const CTL::Chunk2D<float>::Dimensions& projSize,
+                            uint& nbAngles, uint& nbDist)
+{
+    const auto imgDiag = float(CTL::mat::Matrix<2, 1>(projSize.width, projSize.height).norm());
+    if(nbDist == 0)
+        nbDist = uint(std::ceil(imgDiag)) + 1u;
+    if(nbAngles == 0)
+        nbAngles = uint(std::ceil(float(PI) * imgDiag)) + 1u;
+}
+
 } // unnamed namespace
@@ -4,10 +4,13 @@
 #include "img/chunk2d.h"
 #include "img/voxelvolume.h"
 #include "mat/mat.h"
+#include "processing/abstractradon3dcoordtransform.h"
+#include "processing/consistencycpu.h"
 #include "processing/coordinates.h"
 #include "processing/errormetrics.h"
 #include "processing/imageprocessing.h" //<- to be renamed
 #include "processing/imageresampler.h"
+#include "processing/intermediatefctpair.h"
 #include "processing/radontransform2d.h"
 #include "processing/radontransform3d.h"
 #include "processing/volumeresampler.h"
@@ -18,52 +21,17 @@
 
 namespace CTL {
 
-/*!
- * \class IntermediateFctPair
- * \brief Holds a pair of two corresponding intermediate function 'signals' as `shared_ptr`s to
- * `vector`s. The first vector is associated with an intermediate function from a projection image,
- * while the second vector may be computed from a projection or a volume.
- */
-
-class IntermediateFctPair
-{
-public:
-    enum Type{ ProjectionDomain, VolumeDomain };
-
-    IntermediateFctPair(std::vector<float> first, std::vector<float> second, Type secondType);
-    IntermediateFctPair(std::shared_ptr<const std::vector<float>> first, std::vector<float> second,
-                        Type secondType);
-    IntermediateFctPair(std::vector<float> first, std::shared_ptr<const std::vector<float>> second,
-                        Type secondType);
-    IntermediateFctPair(std::shared_ptr<const std::vector<float>> first,
-                        std::shared_ptr<const std::vector<float>> second, Type secondType);
-
-    double inconsistency(const imgproc::AbstractErrorMetric& metric = metric::L2,
-                         bool swapInput = false) const;
-
-    bool isEmpty() const;
-
-    const std::vector<float>& first() const;
-    const std::vector<float>& second() const;
-
-    const std::shared_ptr<const std::vector<float>>& ptrToFirst() const;
-    const std::shared_ptr<const std::vector<float>>& ptrToSecond() const;
-
-    Type firstType() const { return ProjectionDomain; }
-    Type secondType() const { return _secondType; }
-
-private:
-    std::shared_ptr<const std::vector<float>> _first;
-    std::shared_ptr<const std::vector<float>> _second;
-
-    Type _secondType;
-};
-
 namespace OCL {
 
 /*!
  * \class IntermedGen2D2D
  * \brief Generator class that produces intermediate function pairs from two 2D projection images.
+ *
+ * Besides single pairs, the consistency of a whole projection set can be evaluated by means of
+ * inconsistencyMatrix(). To this end, the intermediate function of each view is sampled only once
+ * (see precomputedSamplers()) and all pairs (or a sparse pair graph) are evaluated in parallel.
+ * The memory that is occupied by simultaneously held samplers is bounded by
+ * samplerMemoryLimit(); larger projection sets are processed in blocks of views.
  */
 
 /*!
@@ -86,20 +54,29 @@ namespace OCL {
  * \class Radon3DCoordTransform
  * \brief Helper class that transforms (spherical) 3D Radon coordinates under an Euclidian
  * transform of the coordinate frame.
+ *
+ * Each instance has its own command queue and kernel objects, i.e. different instances can be used
+ * concurrently from different threads (one instance per thread). A single instance must not be
+ * shared across threads.
  */
 
 class IntermedGen2D2D
 {
 public:
     using LineSet = std::vector<Radon2DCoord>;
+    using PairGraph = std::vector<std::pair<uint, uint>>; //!< list of view index pairs
 
     // getter
     double angleIncrement() const;
     float subsampleLevel() const;
+    uint nbThreads() const;
+    size_t samplerMemoryLimit() const;
     // setter
     void setAngleIncrement(double angleIncrement);
     void setSubsampleLevel(float subsampleLevel);
     void toggleSubsampling(bool enabled);
+    void setNbThreads(uint nbThreads);
+    void setSamplerMemoryLimit(size_t bytes);
 
     // # on the fly (using central difference with `plusMinusH`)
     // Grangeat version
@@ -117,6 +94,33 @@ public:
                                         const mat::ProjectionMatrix& P2,
                                         const Chunk2D<float>::Dimensions& projSize) const;
 
+    // # batch evaluation of a projection set (inconsistency matrix, NaN for unevaluated pairs)
+    // all pairs
+    Chunk2D<double> inconsistencyMatrix(const std::vector<Chunk2D<float>>& projs,
+                                        const std::vector<mat::ProjectionMatrix>& Ps,
+                                        const imgproc::AbstractErrorMetric& metric
+                                        = metric::L2) const;
+    // sparse pair graph
+    Chunk2D<double> inconsistencyMatrix(const std::vector<Chunk2D<float>>& projs,
+                                        const std::vector<mat::ProjectionMatrix>& Ps,
+                                        const PairGraph& pairs,
+                                        const imgproc::AbstractErrorMetric& metric
+                                        = metric::L2) const;
+    // precomputed (origin must be the default origin: [(X-1)/2, (Y-1)/2])
+    Chunk2D<double> inconsistencyMatrix(const std::vector<OCL::ImageResampler>& radon2dSamplers,
+                                        const std::vector<mat::ProjectionMatrix>& Ps,
+                                        const Chunk2D<float>::Dimensions& projSize,
+                                        const PairGraph& pairs,
+                                        const imgproc::AbstractErrorMetric& metric
+                                        = metric::L2) const;
+
+    static std::vector<OCL::ImageResampler>
+    precomputedSamplers(const std::vector<Chunk2D<float>>& projs,
+                        const std::vector<mat::ProjectionMatrix>& Ps,
+                        uint nbAngles = 0, uint nbDist = 0,
+                        imgproc::DiffMethod derivativeMethod = imgproc::CentralDifference);
+    static PairGraph allPairs(uint nbViews);
+
     // origin defaults to (projSize-[1,1])/2
     std::pair<LineSet, LineSet> linePairs(const mat::ProjectionMatrix& P1,
                                           const mat::ProjectionMatrix& P2,
@@ -126,6 +130,8 @@ private:
     double _angleIncrement = 0.01_deg; //!< increment rotation angle around the baseline
     float _subsampleLevel = 1.0f;
     bool _useSubsampling = false;
+    uint _nbThreads = 0u; //!< zero: `std::thread::hardware_concurrency()`
+    size_t _samplerMemoryLimit = size_t(1) << 31; //!< bytes of precomputed samplers (zero: no limit)
 
     // compute corresponding line pairs; line pairs intersect the detector with `projSize`
     static std::pair<LineSet, LineSet> linePairs(const mat::ProjectionMatrix& P1,
@@ -161,13 +167,13 @@ public:
     // Grangeat version
     IntermediateFctPair intermedFctPair(const Chunk2D<float>& proj,
                                         const mat::ProjectionMatrix& P,
-                                        const OCL::VolumeResampler& radon3dSampler,
+                                        const AbstractVolumeResampler& radon3dSampler,
                                         imgproc::DiffMethod derivativeMethodProj
                                         = imgproc::CentralDifference);
     // generic or Smith version
     IntermediateFctPair intermedFctPair(const Chunk2D<float>& proj,
                                         const mat::ProjectionMatrix& P,
-                                        const OCL::VolumeResampler& radon3dSampler,
+                                        const AbstractVolumeResampler& radon3dSampler,
                                         imgproc::FiltMethod filterMethodProj);
 
     // # fully precomputed (origin must be the default origin: [(X-1)/2, (Y-1)/2])
@@ -175,7 +181,7 @@ public:
     IntermediateFctPair intermedFctPair(const OCL::ImageResampler& radon2dSampler,
                                         const mat::ProjectionMatrix& P,
                                         const Chunk2D<float>::Dimensions& projSize,
-                                        const OCL::VolumeResampler& radon3dSampler);
+                                        const AbstractVolumeResampler& radon3dSampler);
 
 private:
     std::vector<Radon3DCoord> _lastSampling;
@@ -261,19 +267,22 @@ private:
     OCL::RadonTransform3D _radon3D;
 };
 
-class Radon3DCoordTransform
+class Radon3DCoordTransform : public AbstractRadon3DCoordTransform
 {
 public:
     explicit Radon3DCoordTransform(const std::vector<Radon3DCoord>& initialCoords, uint oclDeviceNb = 0);
     explicit Radon3DCoordTransform(const std::vector<HomCoordPlaneNormalized>& initialCoords, uint oclDeviceNb = 0);
 
-    void resetIninitialCoords(const std::vector<Radon3DCoord>& initialCoords);
+    void resetIninitialCoords(const std::vector<Radon3DCoord>& initialCoords) override;
     void resetIninitialCoords(const std::vector<HomCoordPlaneNormalized>& initialCoords);
 
     const cl::Buffer& transform(const Homography3D& homography) const;
     const cl::Buffer& transform(const Matrix3x3 &rotation, const Vector3x1 &translation) const;
     std::vector<Radon3DCoord> transformedCoords(const Matrix3x3 &rotation,
-                                                const Vector3x1 &translation) const;
+                                                const Vector3x1 &translation) const override;
+
+    std::vector<float> sampleTransformed(const Homography3D& homography,
+                                         const AbstractVolumeResampler& sampler) const override;
 
     std::vector<HomCoordPlaneNormalized> initialHomCoords() const;
 
@@ -285,8 +294,10 @@ private:
     PinnedBufHostWrite<float> _initialPlanesRadonCoord;
     cl::Buffer _initialPlanesHomCoord;
     cl::Buffer _transformedCoords;
+    cl::Kernel _kernelHom2Radon; //!< own kernel object (not shared with other instances)
+    mutable cl::Kernel _kernelSubsetSampler; //!< own sampler kernel object (created on demand)
 
-    void addKernels() const;
+    void initKernels();
     size_t nbCoords() const;
     void recreateBuffers(size_t nbCoords);
     void transformRadonToHom() const;
@@ -0,0 +1,321 @@
+#include "consistencycpu.h"
+#include "mat/mat.h"
+#include "processing/imageprocessing.h"
+
+#include <QDebug>
+#include <random>
+
+namespace {
+
+template <class T>
+std::vector<T> randomSubset(std::vector<T>&& fullSamples, uint seed, float subsampleLevel);
+
+} // unnamed namespace
+
+namespace CTL {
+
+// #### IntermedGen2D3DCPU ####
+// ----------------------------
+
+float IntermedGen2D3DCPU::lineDistance() const { return _lineDistance; }
+
+void IntermedGen2D3DCPU::setLineDistance(float lineDistance)
+{
+    if(qFuzzyIsNull(lineDistance))
+        throw std::domain_error("IntermedGen2D3DCPU::setLineDistance: line distance is close to zero");
+    if(std::abs(lineDistance) < 1.0f)
+        qWarning("Line distance below 1 is not meaningful, due to underlying linear interpolation");
+    if(lineDistance < 0.0f)
+        qWarning("Negative sign of the line distance is ignored");
+
+    _lineDistance = std::abs(lineDistance);
+}
+
+float IntermedGen2D3DCPU::subsampleLevel() const { return _subsampleLevel; }
+
+void IntermedGen2D3DCPU::setSubsampleLevel(float subsampleLevel)
+{
+    if(subsampleLevel <= 0.0f)
+        qCritical("New subsampling level ignored, since it is negative or zero.");
+    else if(subsampleLevel > 1.0f)
+        qCritical("New subsampling level ignored, since it is greater than one.");
+    else
+    {
+        _subsampleLevel = subsampleLevel;
+        _useSubsampling = true;
+    }
+}
+
+void IntermedGen2D3DCPU::toggleSubsampling(bool enabled) { _useSubsampling = enabled; }
+
+const std::vector<Radon3DCoord>& IntermedGen2D3DCPU::lastSampling() const { return _lastSampling; }
+
+IntermediateFctPair IntermedGen2D3DCPU::intermedFctPair(const Chunk2D<float>& proj,
+                                                        const mat::ProjectionMatrix& P,
+                                                        const AbstractVolumeResampler& radon3dSampler,
+                                                        imgproc::DiffMethod derivativeMethodProj)
+{
+    return intermedFctPair(proj, P, radon3dSampler,
+                           static_cast<imgproc::FiltMethod>(derivativeMethodProj));
+}
+
+IntermediateFctPair IntermedGen2D3DCPU::intermedFctPair(const Chunk2D<float>& proj,
+                                                        const mat::ProjectionMatrix& P,
+                                                        const AbstractVolumeResampler& radon3dSampler,
+                                                        imgproc::FiltMethod filterMethodProj)
+{
+    mat::Matrix<2, 1> projSize(proj.width(), proj.height());
+    auto imgDiag = static_cast<float>(projSize.norm());
+
+    const auto nbS  = uint(ceil(imgDiag / _lineDistance));
+    const auto nbMu = uint(ceil(double(nbS) * PI_2));
+
+    SamplingRange sRange{ -0.5f * imgDiag, 0.5f * imgDiag };
+    SamplingRange muRange{ float(0.0_deg), float(180.0_deg) };
+
+    // compute intermediate function from projections
+    IntermediateProjCPU intermedFctOfProj(proj, P.intrinsicMatK());
+    auto intermProj = intermedFctOfProj.sampled(muRange, nbMu, sRange, nbS,
+                                                filterMethodProj).data();
+
+    // compute intermediate function from volume
+    if(_useSubsampling)
+    {
+        uint seed = std::random_device{}(); // pull random seed for subsampling
+        intermProj = randomSubset(std::move(intermProj), seed, _subsampleLevel);
+        _lastSampling = randomSubset(intersectionPlanesWCS(muRange.linspace(nbMu),
+                                                           sRange.linspace(nbS),
+                                                           P,
+                                                           intermedFctOfProj.origin()),
+                                     seed, _subsampleLevel);
+    }
+    else
+        _lastSampling = intersectionPlanesWCS(muRange.linspace(nbMu),
+                                              sRange.linspace(nbS),
+                                              P,
+                                              intermedFctOfProj.origin());
+
+    std::vector<Generic3DCoord> samplingPts(_lastSampling.cbegin(), _lastSampling.cend());
+    auto intermVol = radon3dSampler.sample(samplingPts);
+
+    return IntermediateFctPair(std::move(intermProj), std::move(intermVol),
+                               IntermediateFctPair::VolumeDomain);
+}
+
+/*!
+ * Constructs a vector that has a list of Radon3DCoord for all combinations of the 2D Radon line
+ * coordinates `mu` (the angle) and `dist` (aka 's'), which is stored in `mu`-major order, i.e.
+ * first all `mu` with the first `dist`, then all `mu` with the second `dist` etc. The 3D Radon
+ * coordinates for a plane are determined by a projection matrix (plane must contain the source
+ * position). The `origin` specifies the placement of the coordinate frame where `mu` and `dist`
+ * are defined.
+ */
+std::vector<Radon3DCoord>
+IntermedGen2D3DCPU::intersectionPlanesWCS(const std::vector<float>& mu,
+                                          const std::vector<float>& dist,
+                                          const mat::ProjectionMatrix& P,
+                                          const mat::Matrix<2, 1>& origin)
+{
+    std::vector<Radon3DCoord> ret;
+    ret.reserve(mu.size() * dist.size());
+
+    mat::Matrix<2, 1> n2D;
+    mat::Matrix<3, 1> n3D;
+    const auto Mtransp = P.M().transposed();
+    const auto srcPosTransp = P.sourcePosition().transposed();
+    const auto originTransp = origin.transposed();
+
+    Radon3DCoord coordWCS;
+    for(const auto& s : dist)
+        for(const auto& angle : mu)
+        {
+            n2D = { std::cos(angle), std::sin(angle) };
+            const auto z = s + originTransp * n2D;
+            n3D = Mtransp * vertcat(n2D, mat::Matrix<1, 1>{ -z });
+            n3D.normalize();
+
+            coordWCS.azimuth() = std::atan2(float(n3D.get<1>()), float(n3D.get<0>()));
+            coordWCS.polar() = std::acos(float(n3D.get<2>()));
+            coordWCS.dist() = float(srcPosTransp * n3D);
+
+            ret.push_back(coordWCS);
+        }
+
+    return ret;
+}
+
+// #### IntermediateProjCPU ####
+// -----------------------------
+
+IntermediateProjCPU::IntermediateProjCPU(const Chunk2D<float>& proj, const mat::Matrix<3, 3>& K,
+                                         bool useWeighting)
+    : _intrinsicK(K)
+    , _useWeighting(useWeighting)
+{
+    // perform cosine pre-weighting of projections
+    if(_useWeighting)
+    {
+        Chunk2D<float> projCpy(proj);
+        imgproc::cosWeighting(projCpy, K);
+
+        // construct Radon transform
+        _radon2D.reset(new RadonTransform2DCPU(projCpy));
+    }
+    else
+        _radon2D.reset(new RadonTransform2DCPU(proj));
+}
+
+IntermediateProjCPU::IntermediateProjCPU(const Chunk2D<float>& proj) // Aichert approximation (no weighting)
+    : IntermediateProjCPU(proj, mat::Matrix<3, 3>(), false)
+{
+}
+
+void IntermediateProjCPU::setOrigin(float x, float y) { _radon2D->setOrigin(x, y); }
+
+mat::Matrix<2, 1> IntermediateProjCPU::origin() const { return _radon2D->origin(); }
+
+Chunk2D<float> IntermediateProjCPU::sampled(const SamplingRange& angleRange, uint nbAngles,
+                                            const SamplingRange& distRange, uint nbDist,
+                                            imgproc::DiffMethod derivativeMethod) const
+{
+    return sampled(angleRange, nbAngles, distRange, nbDist,
+                   static_cast<imgproc::FiltMethod>(derivativeMethod));
+}
+
+Chunk2D<float> IntermediateProjCPU::sampled(const SamplingRange& angleRange, uint nbAngles,
+                                            const SamplingRange& distRange, uint nbDist,
+                                            imgproc::FiltMethod filterMethod) const
+{
+    if(nbDist < 2)
+        throw std::runtime_error("IntermediateProjCPU::sampled: nbDist must be greater than 1.");
+
+    const auto angleSamples = angleRange.linspace(nbAngles);
+    const auto distSamples  = distRange.linspace(nbDist);
+
+    // compute 2D Radon transform
+    auto radonTransf = _radon2D->sampleTransform(angleSamples, distSamples);
+
+    // compute filter (or partial derivative) along distance dimension
+    imgproc::filter<1>(radonTransf, filterMethod);
+    radonTransf /= (distSamples[1] - distSamples[0]);
+
+    // perform post-weighting
+    if(_useWeighting)
+        postWeighting(radonTransf, angleSamples, distSamples);
+
+    return radonTransf;
+}
+
+std::vector<float> IntermediateProjCPU::sampled(const std::vector<Radon2DCoord>& samplingPts,
+                                                float plusMinusH) const
+{
+    // sampling points for central difference
+    std::vector<Radon2DCoord> samplingPtsDerivative;
+    samplingPtsDerivative.reserve(2 * samplingPts.size());
+    for(const auto& centralCoord : samplingPts)
+    {
+        samplingPtsDerivative.emplace_back(centralCoord.angle(), centralCoord.dist() - plusMinusH);
+        samplingPtsDerivative.emplace_back(centralCoord.angle(), centralCoord.dist() + plusMinusH);
+    }
+
+    // line integrals
+    auto lineIntegrals = _radon2D->sampleTransform(samplingPtsDerivative);
+    auto* lineItegralPtr = lineIntegrals.data();
+
+    // derivative
+    std::vector<float> ret(samplingPts.size());
+    for(auto& val : ret)
+    {
+        // factor 1/(2h) for central difference
+        val = (lineItegralPtr[1] - lineItegralPtr[0]) / (2.0f * plusMinusH);
+        lineItegralPtr += 2;
+    }
+
+    if(_useWeighting)
+        postWeighting(ret, samplingPts);
+
+    return ret;
+}
+
+void IntermediateProjCPU::postWeighting(Chunk2D<float>& radonTransDerivative,
+                                        const std::vector<float>& theta,
+                                        const std::vector<float>& s) const
+{
+    const auto& K = _intrinsicK;
+    const auto p = mat::Matrix<2, 1>{ K.get<0, 2>(), K.get<1, 2>() };
+    const auto originShiftTransp = (p - _radon2D->origin()).transposed();
+    const auto sSize = s.size();
+    const auto tSize = theta.size();
+
+    for(uint tIdx = 0; tIdx < tSize; ++tIdx)
+    {
+        mat::Matrix<2, 1> n = { std::cos(theta[tIdx]), std::sin(theta[tIdx]) };
+        auto sCorr = originShiftTransp * n;
+
+        for(uint sIdx = 0; sIdx < sSize; ++sIdx)
+        {
+            auto cosPlaneAnlge = cosineOfPlaneAngle((s[sIdx] - sCorr) * n + p, K);
+            radonTransDerivative(tIdx, sIdx) /= float(std::pow(cosPlaneAnlge, 2.0));
+        }
+    }
+}
+
+void IntermediateProjCPU::postWeighting(std::vector<float>& lineIntegralDerivative,
+                                        const std::vector<Radon2DCoord>& samplingPts) const
+{
+    const auto& K = _intrinsicK;
+    const auto p = mat::Matrix<2, 1>{ K.get<0, 2>(), K.get<1, 2>() };
+    const auto originShiftTransp = (p - _radon2D->origin()).transposed();
+
+    std::transform(lineIntegralDerivative.cbegin(), lineIntegralDerivative.cend(), // input 1
+                   samplingPts.cbegin(),                                           // input 2
+                   lineIntegralDerivative.begin(),                                 // output
+                   [&K, &p, &originShiftTransp](float val, const Radon2DCoord& coord)
+                   {
+                       mat::Matrix<2, 1> n{ std::cos(coord.angle()), std::sin(coord.angle()) };
+                       auto sCorr = originShiftTransp * n;
+                       auto cosPlaneAnlge = cosineOfPlaneAngle((coord.dist() - sCorr) * n + p, K);
+                       return val / float(std::pow(cosPlaneAnlge, 2.0));
+                   });
+}
+
+double IntermediateProjCPU::cosineOfPlaneAngle(const mat::Matrix<2, 1>& x, const Matrix3x3 K)
+{
+    // back substitution to find 'd' in K*d = [x,y,1]^t
+    mat::Matrix<3, 1> d;
+    d.get<2>() = 1.0;
+    d.get<1>() = (x.get<1>() - K.get<1, 2>()) / K.get<1, 1>();
+    d.get<0>() = (x.get<0>() - d.get<1>() * K.get<0, 1>() - K.get<0, 2>()) / K.get<0, 0>();
+
+    // cosine to z-axis = <unitDirection, [0 0 1]^t>
+    return d.get<2>() / d.norm();
+}
+
+} // namespace CTL
+
+namespace {
+
+template<class T>
+std::vector<T> randomSubset(std::vector<T>&& fullSamples, uint seed, float subsampleLevel)
+{
+    auto newNbElements = uint(std::ceil(subsampleLevel * fullSamples.size()));
+    std::vector<T> ret(newNbElements);
+
+    std::mt19937 rng;
+    rng.seed(seed);
+
+    std::vector<uint> indices(fullSamples.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::shuffle(indices.begin(), indices.end(), rng);
+
+    indices.resize(newNbElements);
+    std::sort(indices.begin(), indices.end());
+
+    for(uint smpl = 0; smpl < newNbElements; ++smpl)
+        ret[smpl] = fullSamples[indices[smpl]];
+
+    return ret;
+}
+
+} // unnamed namespace
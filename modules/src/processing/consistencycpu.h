@@ -0,0 +1,108 @@
+#ifndef CTL_CONSISTENCYCPU_H
+#define CTL_CONSISTENCYCPU_H
+
+#include "img/chunk2d.h"
+#include "mat/matrix_types.h"
+#include "processing/abstractvolumeresampler.h"
+#include "processing/diff.h"
+#include "processing/filter.h"
+#include "processing/intermediatefctpair.h"
+#include "processing/radontransform2dcpu.h"
+
+/*
+ * This header introduces OpenCL-free classes for applications of Grangeat data consistency
+ * conditions. They are the CPU counterparts of the classes in "processing/consistency.h".
+ */
+
+namespace CTL {
+
+/*!
+ * \class IntermedGen2D3DCPU
+ * \brief Generator class that produces intermediate function pairs from a 2D projection image and a
+ * 3D volume (given as a sampler of its intermediate space) without the need for OpenCL.
+ *
+ * This is the CPU counterpart of OCL::IntermedGen2D3D. The intermediate space of the volume can be
+ * sampled by any AbstractVolumeResampler, e.g. a VolumeResamplerCPU.
+ */
+
+/*!
+ * \class IntermediateProjCPU
+ * \brief Transforms projections to Grangeat's intermediate space (CPU counterpart of
+ * OCL::IntermediateProj).
+ */
+
+class IntermedGen2D3DCPU
+{
+public:
+    float lineDistance() const;
+    void setLineDistance(float lineDistance);
+    float subsampleLevel() const;
+    void setSubsampleLevel(float subsampleLevel);
+    void toggleSubsampling(bool enabled);
+
+    const std::vector<Radon3DCoord>& lastSampling() const;
+
+    // # projection on the fly
+    // Grangeat version
+    IntermediateFctPair intermedFctPair(const Chunk2D<float>& proj,
+                                        const mat::ProjectionMatrix& P,
+                                        const AbstractVolumeResampler& radon3dSampler,
+                                        imgproc::DiffMethod derivativeMethodProj
+                                        = imgproc::CentralDifference);
+    // generic or Smith version
+    IntermediateFctPair intermedFctPair(const Chunk2D<float>& proj,
+                                        const mat::ProjectionMatrix& P,
+                                        const AbstractVolumeResampler& radon3dSampler,
+                                        imgproc::FiltMethod filterMethodProj);
+
+    static std::vector<Radon3DCoord> intersectionPlanesWCS(const std::vector<float>& mu,
+                                                           const std::vector<float>& dist,
+                                                           const mat::ProjectionMatrix& P,
+                                                           const mat::Matrix<2, 1>& origin);
+
+private:
+    std::vector<Radon3DCoord> _lastSampling;
+    float _lineDistance = 1.0f; //!< distance of sampled lines on the detector in Pixel
+    float _subsampleLevel = 1.0f;
+    bool _useSubsampling = false;
+};
+
+class IntermediateProjCPU
+{
+public:
+    IntermediateProjCPU(const Chunk2D<float>& proj, const mat::Matrix<3,3>& K, bool useWeighting = true);
+    explicit IntermediateProjCPU(const Chunk2D<float>& proj);
+
+    void setOrigin(float x, float y);
+
+    mat::Matrix<2, 1> origin() const;
+
+    // Grangeat version
+    Chunk2D<float> sampled(const SamplingRange& angleRange, uint nbAngles,
+                           const SamplingRange& distRange, uint nbDist,
+                           imgproc::DiffMethod derivativeMethod = imgproc::CentralDifference) const;
+    // generic or Smith version
+    Chunk2D<float> sampled(const SamplingRange& angleRange, uint nbAngles,
+                           const SamplingRange& distRange, uint nbDist,
+                           imgproc::FiltMethod filterMethod) const;
+    // Grangeat version
+    std::vector<float> sampled(const std::vector<Radon2DCoord>& samplingPts,
+                               float plusMinusH = 1.0f) const;
+
+private:
+    mat::Matrix<3, 3> _intrinsicK;
+    std::unique_ptr<RadonTransform2DCPU> _radon2D;
+    bool _useWeighting;
+
+    void postWeighting(Chunk2D<float>& radonTransDerivative,
+                       const std::vector<float>& theta,
+                       const std::vector<float>& s) const;
+    void postWeighting(std::vector<float>& lineIntegralDerivative,
+                       const std::vector<Radon2DCoord>& samplingPts) const;
+
+    static double cosineOfPlaneAngle(const mat::Matrix<2, 1>& x, const Matrix3x3 K);
+};
+
+} // namespace CTL
+
+#endif // CTL_CONSISTENCYCPU_H
@@ -36,6 +36,30 @@ struct Generic3DCoord
     float data[3];
 };
 
+struct Radon2DCoord : Generic2DCoord
+{
+    Radon2DCoord() = default;
+    Radon2DCoord(float angle, float distance) : Generic2DCoord (angle, distance) {}
+
+    float& angle() { return data[0]; }
+    float& dist() { return data[1]; }
+    const float& angle() const { return data[0]; }
+    const float& dist() const { return data[1]; }
+};
+
+struct Radon3DCoord : Generic3DCoord
+{
+    Radon3DCoord() = default;
+    Radon3DCoord(float azimuth, float polar, float distance)
+        : Generic3DCoord (azimuth, polar, distance) {}
+
+    float& azimuth() { return data[0]; }
+    float& polar() { return data[1]; }
+    float& dist() { return data[2]; }
+    const float& azimuth() const { return data[0]; }
+    const float& polar() const { return data[1]; }
+    const float& dist() const { return data[2]; }
+};
 
 // Range
 template<typename T>
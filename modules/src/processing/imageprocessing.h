@@ -11,13 +11,13 @@
 namespace CTL {
 
 namespace mat {
-template <uint Rows, uint Cols>
+template <uint Rows, uint Cols, typename T>
 class Matrix;
 }
 
 namespace imgproc
 {
-    void cosWeighting(Chunk2D<float>& proj, const mat::Matrix<3,3>& K);
+    void cosWeighting(Chunk2D<float>& proj, const mat::Matrix<3,3,double>& K);
 
 } // namespace imgproc
 } // namespace CTL
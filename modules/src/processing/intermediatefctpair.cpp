@@ -0,0 +1,85 @@
+#include "intermediatefctpair.h"
+
+#include <QtGlobal>
+
+namespace CTL {
+
+// #### IntermediateFctPair ####
+// -----------------------------
+
+IntermediateFctPair::IntermediateFctPair(std::vector<float> first, std::vector<float> second,
+                                         Type secondType)
+    : _first(first.size() == second.size()
+             ? std::make_shared<const std::vector<float>>(std::move(first))
+             : std::make_shared<const std::vector<float>>())
+    , _second(_first->size() == second.size()
+              ? std::make_shared<const std::vector<float>>(std::move(second))
+              : std::make_shared<const std::vector<float>>())
+    , _secondType(secondType)
+{
+}
+
+IntermediateFctPair::IntermediateFctPair(std::shared_ptr<const std::vector<float>> first,
+                                         std::vector<float> second, Type secondType)
+    : _first(first->size() == second.size()
+             ? std::move(first)
+             : std::make_shared<const std::vector<float>>())
+    , _second(_first->size() == second.size()
+              ? std::make_shared<const std::vector<float>>(std::move(second))
+              : std::make_shared<const std::vector<float>>())
+    , _secondType(secondType)
+{
+}
+
+IntermediateFctPair::IntermediateFctPair(std::vector<float> first,
+                                         std::shared_ptr<const std::vector<float>> second,
+                                         Type secondType)
+    : _first(first.size() == second->size()
+             ? std::make_shared<const std::vector<float>>(std::move(first))
+             : std::make_shared<const std::vector<float>>())
+    , _second(_first->size() == second->size()
+              ? std::move(second)
+              : std::make_shared<const std::vector<float>>())
+    , _secondType(secondType)
+{
+}
+
+IntermediateFctPair::IntermediateFctPair(std::shared_ptr<const std::vector<float>> first,
+                                         std::shared_ptr<const std::vector<float>> second,
+                                         Type secondType)
+    : _first(first->size() == second->size()
+             ? std::move(first)
+             : std::make_shared<const std::vector<float>>())
+    , _second(_first->size() == second->size()
+              ? std::move(second)
+              : std::make_shared<const std::vector<float>>())
+    , _secondType(secondType)
+{
+}
+
+double IntermediateFctPair::inconsistency(const imgproc::AbstractErrorMetric& metric, bool swapInput) const
+{
+    Q_ASSERT(!isEmpty());
+    return swapInput ? metric(*_second, *_first) : metric(*_first, *_second);
+}
+
+bool IntermediateFctPair::isEmpty() const
+{
+    return _first->empty();
+}
+
+const std::vector<float>& IntermediateFctPair::first() const { return *_first; }
+
+const std::vector<float>& IntermediateFctPair::second() const { return *_second; }
+
+const std::shared_ptr<const std::vector<float>>& IntermediateFctPair::ptrToFirst() const
+{
+    return _first;
+}
+
+const std::shared_ptr<const std::vector<float>>& IntermediateFctPair::ptrToSecond() const
+{
+    return _second;
+}
+
+} // namespace CTL
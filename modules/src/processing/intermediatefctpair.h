@@ -0,0 +1,53 @@
+#ifndef CTL_INTERMEDIATEFCTPAIR_H
+#define CTL_INTERMEDIATEFCTPAIR_H
+
+#include "processing/errormetrics.h"
+#include <memory>
+#include <vector>
+
+namespace CTL {
+
+/*!
+ * \class IntermediateFctPair
+ * \brief Holds a pair of two corresponding intermediate function 'signals' as `shared_ptr`s to
+ * `vector`s. The first vector is associated with an intermediate function from a projection image,
+ * while the second vector may be computed from a projection or a volume.
+ */
+
+class IntermediateFctPair
+{
+public:
+    enum Type{ ProjectionDomain, VolumeDomain };
+
+    IntermediateFctPair(std::vector<float> first, std::vector<float> second, Type secondType);
+    IntermediateFctPair(std::shared_ptr<const std::vector<float>> first, std::vector<float> second,
+                        Type secondType);
+    IntermediateFctPair(std::vector<float> first, std::shared_ptr<const std::vector<float>> second,
+                        Type secondType);
+    IntermediateFctPair(std::shared_ptr<const std::vector<float>> first,
+                        std::shared_ptr<const std::vector<float>> second, Type secondType);
+
+    double inconsistency(const imgproc::AbstractErrorMetric& metric = metric::L2,
+                         bool swapInput = false) const;
+
+    bool isEmpty() const;
+
+    const std::vector<float>& first() const;
+    const std::vector<float>& second() const;
+
+    const std::shared_ptr<const std::vector<float>>& ptrToFirst() const;
+    const std::shared_ptr<const std::vector<float>>& ptrToSecond() const;
+
+    Type firstType() const { return ProjectionDomain; }
+    Type secondType() const { return _secondType; }
+
+private:
+    std::shared_ptr<const std::vector<float>> _first;
+    std::shared_ptr<const std::vector<float>> _second;
+
+    Type _secondType;
+};
+
+} // namespace CTL
+
+#endif // CTL_INTERMEDIATEFCTPAIR_H
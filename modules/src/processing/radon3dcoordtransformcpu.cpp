@@ -0,0 +1,147 @@
+#include "radon3dcoordtransformcpu.h"
+#include "processing/threadpool.h"
+
+#include <cmath>
+
+namespace {
+// minimum number of coordinates per thread for parallel transformation
+constexpr size_t MIN_NB_COORDS_PER_THREAD = 8192;
+// number of coordinates that are processed en bloc (fits into L1 cache)
+constexpr size_t BLOCK_SIZE = 256;
+}
+
+namespace CTL {
+
+Radon3DCoordTransformCPU::Radon3DCoordTransformCPU(const std::vector<Radon3DCoord>& initialCoords)
+{
+    resetIninitialCoords(initialCoords);
+}
+
+/*!
+ * Sets the initial coordinates to \a initialCoords, which are converted to homogeneous plane
+ * coordinates internally.
+ */
+void Radon3DCoordTransformCPU::resetIninitialCoords(const std::vector<Radon3DCoord>& initialCoords)
+{
+    const auto nbCoords = initialCoords.size();
+    _nx.resize(nbCoords);
+    _ny.resize(nbCoords);
+    _nz.resize(nbCoords);
+    _w.resize(nbCoords);
+
+    for(size_t i = 0; i < nbCoords; ++i)
+    {
+        const auto& coord = initialCoords[i];
+        const auto sinPol = std::sin(coord.polar());
+        _nx[i] = sinPol * std::cos(coord.azimuth());
+        _ny[i] = sinPol * std::sin(coord.azimuth());
+        _nz[i] = std::cos(coord.polar());
+        _w[i] = -coord.dist();
+    }
+}
+
+/*!
+ * Returns the initial coordinates transformed by \a homography as (generic) 3D Radon coordinates,
+ * i.e. [azimuth, polar, distance].
+ */
+std::vector<Generic3DCoord> Radon3DCoordTransformCPU::transform(const Homography3D& homography) const
+{
+    // planes transform with the transposed homography (same as OCL implementation)
+    float H[16];
+    const auto Ht = homography.transposed();
+    std::transform(Ht.begin(), Ht.end(), H, [](double val) { return float(val); });
+
+    const auto nbCoords = this->nbCoords();
+    std::vector<Generic3DCoord> ret(nbCoords);
+
+    const auto nbThreads = std::min(ThreadBudget::nbThreads(), nbCoords / MIN_NB_COORDS_PER_THREAD);
+    if(nbThreads < 2)
+    {
+        transformRange(H, ret.data(), 0, nbCoords);
+        return ret;
+    }
+
+    ThreadPool tp(nbThreads);
+    const auto coordsPerThread = nbCoords / nbThreads;
+    size_t t = 0;
+    for(; t < nbThreads - 1; ++t)
+        tp.enqueueThread([this, &H, &ret, t, coordsPerThread]
+        {
+            transformRange(H, ret.data(), t * coordsPerThread, (t + 1) * coordsPerThread);
+        });
+    // last thread does the rest
+    tp.enqueueThread([this, &H, &ret, t, coordsPerThread, nbCoords]
+    {
+        transformRange(H, ret.data(), t * coordsPerThread, nbCoords);
+    });
+
+    return ret;
+}
+
+std::vector<Generic3DCoord> Radon3DCoordTransformCPU::transform(const Matrix3x3& rotation,
+                                                                const Vector3x1& translation) const
+{
+    return transform(Homography3D{ rotation, translation });
+}
+
+std::vector<Radon3DCoord>
+Radon3DCoordTransformCPU::transformedCoords(const Matrix3x3& rotation,
+                                            const Vector3x1& translation) const
+{
+    const auto coords = transform(rotation, translation);
+
+    std::vector<Radon3DCoord> ret(coords.size());
+    std::transform(coords.cbegin(), coords.cend(), ret.begin(), [](const Generic3DCoord& coord) {
+        return Radon3DCoord{ coord.coord1(), coord.coord2(), coord.coord3() };
+    });
+
+    return ret;
+}
+
+/*!
+ * Transforms the initial coordinates by \a homography and samples \a sampler at the transformed
+ * coordinates.
+ */
+std::vector<float>
+Radon3DCoordTransformCPU::sampleTransformed(const Homography3D& homography,
+                                            const AbstractVolumeResampler& sampler) const
+{
+    return sampler.sample(transform(homography));
+}
+
+size_t Radon3DCoordTransformCPU::nbCoords() const { return _w.size(); }
+
+void Radon3DCoordTransformCPU::transformRange(const float (&H)[16], Generic3DCoord* dst,
+                                              size_t begin, size_t end) const
+{
+    float x[BLOCK_SIZE], y[BLOCK_SIZE], z[BLOCK_SIZE], w[BLOCK_SIZE];
+
+    for(auto blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE)
+    {
+        const auto n = std::min(BLOCK_SIZE, end - blockBegin);
+        const auto* nx = _nx.data() + blockBegin;
+        const auto* ny = _ny.data() + blockBegin;
+        const auto* nz = _nz.data() + blockBegin;
+        const auto* nw = _w.data() + blockBegin;
+
+        // linear transform of the planes (vectorizable)
+        for(size_t i = 0; i < n; ++i)
+        {
+            x[i] = H[0]  * nx[i] + H[1]  * ny[i] + H[2]  * nz[i] + H[3]  * nw[i];
+            y[i] = H[4]  * nx[i] + H[5]  * ny[i] + H[6]  * nz[i] + H[7]  * nw[i];
+            z[i] = H[8]  * nx[i] + H[9]  * ny[i] + H[10] * nz[i] + H[11] * nw[i];
+            w[i] = H[12] * nx[i] + H[13] * ny[i] + H[14] * nz[i] + H[15] * nw[i];
+        }
+
+        // conversion to spherical coordinates
+        auto* out = dst + blockBegin;
+        for(size_t i = 0; i < n; ++i)
+        {
+            out[i].coord1() = std::atan2(y[i], x[i]);
+            out[i].coord2() = std::acos(std::min(std::max(z[i], -1.0f), 1.0f));
+            out[i].coord3() = -w[i];
+        }
+    }
+}
+
+} // namespace CTL
@@ -0,0 +1,49 @@
+#ifndef CTL_RADON3DCOORDTRANSFORMCPU_H
+#define CTL_RADON3DCOORDTRANSFORMCPU_H
+
+#include "processing/abstractradon3dcoordtransform.h"
+
+namespace CTL {
+
+/*!
+ * \class Radon3DCoordTransformCPU
+ * \brief CPU implementation that transforms (spherical) 3D Radon coordinates under an Euclidian
+ * transform of the coordinate frame.
+ *
+ * This class is the OpenCL-free counterpart of OCL::Radon3DCoordTransform. The initial planes are
+ * stored in homogeneous coordinates as a structure of arrays, such that the (linear) transform of
+ * the planes is computed in a vectorizable loop. The subsequent conversion to spherical
+ * coordinates is carried out in a separate pass. Both passes are parallelized for large sets of
+ * coordinates (limited by the ThreadBudget of the calling thread).
+ */
+class Radon3DCoordTransformCPU : public AbstractRadon3DCoordTransform
+{
+public:
+    explicit Radon3DCoordTransformCPU(const std::vector<Radon3DCoord>& initialCoords);
+
+    void resetIninitialCoords(const std::vector<Radon3DCoord>& initialCoords) override;
+
+    std::vector<Generic3DCoord> transform(const Homography3D& homography) const;
+    std::vector<Generic3DCoord> transform(const Matrix3x3& rotation,
+                                          const Vector3x1& translation) const;
+    std::vector<Radon3DCoord> transformedCoords(const Matrix3x3& rotation,
+                                                const Vector3x1& translation) const override;
+
+    std::vector<float> sampleTransformed(const Homography3D& homography,
+                                         const AbstractVolumeResampler& sampler) const override;
+
+    size_t nbCoords() const;
+
+private:
+    // initial planes in homogeneous coordinates [nx, ny, nz, -d]
+    std::vector<float> _nx;
+    std::vector<float> _ny;
+    std::vector<float> _nz;
+    std::vector<float> _w;
+
+    void transformRange(const float (&H)[16], Generic3DCoord* dst, size_t begin, size_t end) const;
+};
+
+} // namespace CTL
+
+#endif // CTL_RADON3DCOORDTRANSFORMCPU_H
@@ -7,18 +7,6 @@
 #include "processing/coordinates.h"
 
 namespace CTL {
-
-struct Radon2DCoord : Generic2DCoord
-{
-    Radon2DCoord() = default;
-    Radon2DCoord(float angle, float distance) : Generic2DCoord (angle, distance) {}
-
-    float& angle() { return data[0]; }
-    float& dist() { return data[1]; }
-    const float& angle() const { return data[0]; }
-    const float& dist() const { return data[1]; }
-};
-
 namespace OCL {
 
 /*!
@@ -0,0 +1,175 @@
+#include "radontransform2dcpu.h"
+#include "processing/threadpool.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace CTL {
+
+/*!
+ * Creates a RadonTransform2DCPU instance that allows to compute the 2D Radon transform of
+ * \a image.
+ */
+RadonTransform2DCPU::RadonTransform2DCPU(const Chunk2D<float>& image)
+    : _image(image)
+    , _origin{ (image.width() - 1) * 0.5f, (image.height() - 1) * 0.5f }
+    , _accuracy(1.0f)
+{
+    if(!_image.allocatedElements())
+        throw std::runtime_error("RadonTransform2DCPU: image has no data.");
+}
+
+/*!
+ * Sets the resolution for line integration to \a stepLength. This defines the step length for
+ * sampling along the integration lines.
+ */
+void RadonTransform2DCPU::setAccuracy(float stepLength) { _accuracy = stepLength; }
+
+/*!
+ * Sets the origin for the transform to [\a x, \a y] (in pixels).
+ */
+void RadonTransform2DCPU::setOrigin(float x, float y)
+{
+    _origin[0] = x;
+    _origin[1] = y;
+}
+
+/*!
+ * Returns the resolution for line integration, i.e. the step length used for sampling along the
+ * integration lines.
+ */
+float RadonTransform2DCPU::accuracy() const { return _accuracy; }
+
+/*!
+ * Returns the origin of the transform (in pixels).
+ */
+mat::Matrix<2, 1> RadonTransform2DCPU::origin() const
+{
+    return { double(_origin[0]), double(_origin[1]) };
+}
+
+/*!
+ * Returns the 2D Radon transform for all combinations of angles \a theta and distances \a s. The
+ * result has the dimensions (\a theta.size() x \a s.size()).
+ */
+Chunk2D<float> RadonTransform2DCPU::sampleTransform(const std::vector<float>& theta,
+                                                    const std::vector<float>& s) const
+{
+    const auto nbTheta = uint(theta.size());
+    const auto nbS = uint(s.size());
+
+    Chunk2D<float> ret(nbTheta, nbS);
+    ret.allocateMemory();
+
+    auto transformAngles = [&](uint tBegin, uint tEnd)
+    {
+        for(auto t = tBegin; t < tEnd; ++t)
+            for(auto sIdx = 0u; sIdx < nbS; ++sIdx)
+                ret(t, sIdx) = lineIntegral(theta[t], s[sIdx]);
+    };
+
+    if(ThreadBudget::nbThreads() == 1)
+    {
+        transformAngles(0, nbTheta);
+        return ret;
+    }
+
+    ThreadPool tp;
+    const auto anglesPerThread = nbTheta / uint(tp.nbThreads());
+    uint t = 0;
+    for(; t < tp.nbThreads(); ++t)
+        tp.enqueueThread(transformAngles, t * anglesPerThread, (t + 1) * anglesPerThread);
+    // last thread does the rest
+    tp.enqueueThread(transformAngles, t * anglesPerThread, nbTheta);
+
+    return ret;
+}
+
+/*!
+ * Returns the 2D Radon transform for the set of sampling points \a smplPts.
+ */
+std::vector<float> RadonTransform2DCPU::sampleTransform(const std::vector<Radon2DCoord>& smplPts) const
+{
+    const auto nbSmpls = smplPts.size();
+    std::vector<float> ret(nbSmpls);
+
+    auto transformRange = [&](size_t begin, size_t end)
+    {
+        for(auto smpl = begin; smpl < end; ++smpl)
+            ret[smpl] = lineIntegral(smplPts[smpl].angle(), smplPts[smpl].dist());
+    };
+
+    if(ThreadBudget::nbThreads() == 1)
+    {
+        transformRange(0, nbSmpls);
+        return ret;
+    }
+
+    ThreadPool tp;
+    const auto smplsPerThread = nbSmpls / tp.nbThreads();
+    size_t t = 0;
+    for(; t < tp.nbThreads(); ++t)
+        tp.enqueueThread(transformRange, t * smplsPerThread, (t + 1) * smplsPerThread);
+    // last thread does the rest
+    tp.enqueueThread(transformRange, t * smplsPerThread, nbSmpls);
+
+    return ret;
+}
+
+/*!
+ * Returns the integral along the line with angle \a theta and distance \a s to the origin.
+ */
+float RadonTransform2DCPU::lineIntegral(float theta, float s) const
+{
+    const auto imgDiag = std::sqrt(float(_image.width()) * float(_image.width()) +
+                                   float(_image.height()) * float(_image.height()));
+    const auto nbSamples = uint(std::ceil(imgDiag / _accuracy));
+    const auto lineOrigin = 0.5f * float(nbSamples - 1);
+
+    const auto co = std::cos(theta);
+    const auto si = std::sin(theta);
+    // point on the line closest to the origin and direction of the line
+    const auto x0 = s * co + _origin[0];
+    const auto y0 = s * si + _origin[1];
+
+    auto sum = 0.0f;
+    for(auto x = 0u; x < nbSamples; ++x)
+    {
+        const auto t = (float(x) - lineOrigin) * _accuracy;
+        sum += interpolate(x0 + si * t, y0 - co * t);
+    }
+
+    return sum * _accuracy;
+}
+
+/*!
+ * Bilinear interpolation at pixel coordinate [\a x, \a y] (pixel centers at integer values).
+ * Pixels outside the image contribute with zero.
+ */
+float RadonTransform2DCPU::interpolate(float x, float y) const
+{
+    const auto x0f = std::floor(x);
+    const auto y0f = std::floor(y);
+    const auto width = int(_image.width());
+    const auto height = int(_image.height());
+
+    if(!(x0f >= -1.0f && y0f >= -1.0f && x0f <= float(width - 1) && y0f <= float(height - 1)))
+        return 0.0f;
+
+    const auto ax = x - x0f;
+    const auto ay = y - y0f;
+    const auto x0 = int(x0f), y0 = int(y0f);
+    const auto* data = _image.rawData();
+
+    auto value = [&](int xi, int yi)
+    {
+        if(xi < 0 || yi < 0 || xi >= width || yi >= height)
+            return 0.0f;
+        return data[size_t(yi) * size_t(width) + size_t(xi)];
+    };
+
+    return (1.0f - ay) * ((1.0f - ax) * value(x0, y0    ) + ax * value(x0 + 1, y0    )) +
+                   ay  * ((1.0f - ax) * value(x0, y0 + 1) + ax * value(x0 + 1, y0 + 1));
+}
+
+} // namespace CTL
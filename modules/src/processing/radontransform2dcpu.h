@@ -0,0 +1,51 @@
+#ifndef CTL_RADONTRANSFORM2DCPU_H
+#define CTL_RADONTRANSFORM2DCPU_H
+
+#include "img/chunk2d.h"
+#include "mat/matrix.h"
+#include "processing/coordinates.h"
+
+namespace CTL {
+
+/*!
+ * \class RadonTransform2DCPU
+ * \brief Allows to compute the 2D Radon transform of Chunk2D<float> data on the CPU.
+ *
+ * This class is the OpenCL-free counterpart of OCL::RadonTransform2D and follows the same
+ * conventions: the line integrals are computed by summation of bilinearly interpolated samples
+ * along the integration lines (zero outside of the image). By default, the origin of the transform
+ * is the image center [(nbPixels.x - 1) * 0.5, (nbPixels.y - 1) * 0.5] and the step length along
+ * the lines is one pixel.
+ *
+ * Computation is parallelized over the angles (or the sampling points, respectively), limited by
+ * the ThreadBudget of the calling thread.
+ */
+class RadonTransform2DCPU
+{
+public:
+    explicit RadonTransform2DCPU(const Chunk2D<float>& image);
+
+    void setAccuracy(float stepLength);
+    void setOrigin(float x, float y);
+
+    float accuracy() const;
+    mat::Matrix<2, 1> origin() const;
+
+    Chunk2D<float> sampleTransform(const std::vector<float>& theta,
+                                   const std::vector<float>& s) const;
+
+    std::vector<float> sampleTransform(const std::vector<Radon2DCoord>& smplPts) const;
+
+    float lineIntegral(float theta, float s) const;
+
+private:
+    Chunk2D<float> _image; //!< Image data to be transformed
+    float _origin[2]; //!< pixel coordinate of Radon transform's origin
+    float _accuracy; //!< discretization of the line integral (step length in pixels)
+
+    float interpolate(float x, float y) const;
+};
+
+} // namespace CTL
+
+#endif // CTL_RADONTRANSFORM2DCPU_H
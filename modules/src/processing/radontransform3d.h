@@ -9,21 +9,6 @@
 
 namespace CTL {
 
-
-struct Radon3DCoord : Generic3DCoord
-{
-    Radon3DCoord() = default;
-    Radon3DCoord(float azimuth, float polar, float distance)
-        : Generic3DCoord (azimuth, polar, distance) {}
-
-    float& azimuth() { return data[0]; }
-    float& polar() { return data[1]; }
-    float& dist() { return data[2]; }
-    const float& azimuth() const { return data[0]; }
-    const float& polar() const { return data[1]; }
-    const float& dist() const { return data[2]; }
-};
-
 struct HomCoordPlaneNormalized
 {
     mat::Matrix<4, 1> homoVec() const { return { data[0], data[1], data[2], data[3] }; }
@@ -68,15 +68,61 @@ private:
     std::vector<std::thread>::iterator _curThread;
 };
 
+/*!
+ * \class ThreadBudget
+ *
+ * \brief Limits the number of threads that parallel routines use when they are called from the
+ * current thread.
+ *
+ * Parallel routines that are called from a worker thread of a `ThreadPool` would otherwise create
+ * their own pools with `std::thread::hardware_concurrency()` threads each, which oversubscribes the
+ * CPU. A worker can prevent this by creating a `ThreadBudget` with the number of threads that it
+ * may use. The budget applies to the thread that created the instance until the instance is
+ * destroyed. It determines the size of default constructed `ThreadPool`s and is queried by
+ * parallel routines by means of ThreadBudget::nbThreads().
+ *
+ * Example snippet:
+ * \code
+ * ThreadPool tp;
+ * for(auto job = 0u; job < nbJobs; ++job)
+ *     tp.enqueueThread([]
+ *     {
+ *         ThreadBudget budget(1); // nested parallel routines run serially in this worker
+ *         someParallelRoutine();
+ *     });
+ * \endcode
+ *
+ * Budgets can be nested, in which case the innermost budget applies.
+ */
+
+class ThreadBudget
+{
+public:
+    explicit ThreadBudget(size_t nbThreads);
+    ~ThreadBudget();
+
+    // non-copyable
+    ThreadBudget(const ThreadBudget&) = delete;
+    ThreadBudget& operator=(const ThreadBudget&) = delete;
+
+    static size_t nbThreads();
+
+private:
+    size_t _previousBudget;
+
+    static size_t& currentBudget();
+};
+
 /*!
  * Constructs an instance of `ThreadPool` consisting of \a nbThreads threads.
  * If no number is provided by the client (calling the default constructor) or \a nbThreads is zero,
- * the number of threads defaults to `std::thread::hardware_concurrency()`. If this function is not
- * able to compute the supported number of threads (in this case it returns zero), the number of
- * threads is set to one.
+ * the number of threads defaults to ThreadBudget::nbThreads(), i.e.
+ * `std::thread::hardware_concurrency()` unless a ThreadBudget has been set for the calling thread.
+ * If this function is not able to compute the supported number of threads (in this case it returns
+ * zero), the number of threads is set to one.
  */
 inline ThreadPool::ThreadPool(size_t nbThreads)
-    : _pool(nbThreads == 0 ? std::max({ 1u, std::thread::hardware_concurrency() }) : nbThreads)
+    : _pool(nbThreads == 0 ? ThreadBudget::nbThreads() : nbThreads)
     , _curThread(_pool.begin())
 {
 }
@@ -119,6 +165,40 @@ inline void ThreadPool::enqueueThread(Function&& f, Args&&... args)
         _curThread = _pool.begin();
 }
 
+/*!
+ * Sets the budget of the current thread to \a nbThreads threads (at least one). The previous budget
+ * is restored by the destructor.
+ */
+inline ThreadBudget::ThreadBudget(size_t nbThreads)
+    : _previousBudget(currentBudget())
+{
+    currentBudget() = std::max(nbThreads, size_t(1));
+}
+
+/*!
+ * Restores the budget that was valid before the construction of this instance.
+ */
+inline ThreadBudget::~ThreadBudget()
+{
+    currentBudget() = _previousBudget;
+}
+
+/*!
+ * Returns the number of threads that parallel routines may use in the current thread. Without a
+ * budget, this is `std::thread::hardware_concurrency()` (or one if this is not computable).
+ */
+inline size_t ThreadBudget::nbThreads()
+{
+    const auto budget = currentBudget();
+    return budget != 0 ? budget : size_t(std::max({ 1u, std::thread::hardware_concurrency() }));
+}
+
+inline size_t& ThreadBudget::currentBudget()
+{
+    static thread_local size_t budget = 0; // zero: no budget
+    return budget;
+}
+
 } // namespace CTL
 
 #endif // CTL_THREADPOOL_H
@@ -213,6 +213,22 @@ std::vector<float> VolumeResampler::sample(const std::vector<Generic3DCoord> &sa
 }
 
 std::vector<float> VolumeResampler::sample(const cl::Buffer& coord3dBuffer) const
+{
+    return sample(coord3dBuffer, *_kernelSubsetSampler, _q);
+}
+
+/*!
+ * Samples the volume at the coordinates in \a coord3dBuffer using the kernel object
+ * \a subsetSampler, which is dispatched to \a queue.
+ *
+ * In contrast to sample(const cl::Buffer&), which uses the kernel object and command queue that are
+ * shared by all users of this instance, this allows to sample the volume concurrently from
+ * different threads, provided that each thread uses its own kernel object (see
+ * subsetSamplerInstance()). \a queue must belong to the context of the OpenCLConfig.
+ */
+std::vector<float> VolumeResampler::sample(const cl::Buffer& coord3dBuffer,
+                                           cl::Kernel& subsetSampler,
+                                           const cl::CommandQueue& queue) const
 {
     std::vector<float> ret;
 
@@ -231,19 +247,19 @@ std::vector<float> VolumeResampler::sample(const cl::Buffer& coord3dBuffer) cons
                                    CL_MEM_WRITE_ONLY | CL_MEM_HOST_READ_ONLY, volSize);
 
         // set kernel arguments
-        _kernelSubsetSampler->setArg(0, _range1Buf);
-        _kernelSubsetSampler->setArg(1, _range2Buf);
-        _kernelSubsetSampler->setArg(2, _range3Buf);
-        _kernelSubsetSampler->setArg(3, coord3dBuffer);
-        _kernelSubsetSampler->setArg(4, _volImage3D);
-        _kernelSubsetSampler->setArg(5, resampledVolume);
+        subsetSampler.setArg(0, _range1Buf);
+        subsetSampler.setArg(1, _range2Buf);
+        subsetSampler.setArg(2, _range3Buf);
+        subsetSampler.setArg(3, coord3dBuffer);
+        subsetSampler.setArg(4, _volImage3D);
+        subsetSampler.setArg(5, resampledVolume);
 
         // run kernel
-        _q.enqueueNDRangeKernel(*_kernelSubsetSampler, cl::NullRange, cl::NDRange(nbSmpls));
+        queue.enqueueNDRangeKernel(subsetSampler, cl::NullRange, cl::NDRange(nbSmpls));
 
         // read result
         ret.resize(nbSmpls);
-        _q.enqueueReadBuffer(resampledVolume, CL_TRUE, 0, volSize, ret.data());
+        queue.enqueueReadBuffer(resampledVolume, CL_TRUE, 0, volSize, ret.data());
 
     } catch(const cl::Error& err)
     {
@@ -254,6 +270,28 @@ std::vector<float> VolumeResampler::sample(const cl::Buffer& coord3dBuffer) cons
     return ret;
 }
 
+/*!
+ * Returns a new kernel object of the subset sampler kernel for the use with
+ * sample(const cl::Buffer&, cl::Kernel&, const cl::CommandQueue&).
+ *
+ * The kernel object has its own kernel arguments, i.e. it can be used independently from the
+ * (shared) kernel object of this instance. Since all kernel arguments are set by each call of
+ * sample(), it is not bound to this instance and can be used with any VolumeResampler. The program
+ * is taken from the shared kernel object, such that this method does not access the OpenCLConfig.
+ */
+cl::Kernel VolumeResampler::subsetSamplerInstance() const
+{
+    try
+    {
+        return cl::Kernel(_kernelSubsetSampler->getInfo<CL_KERNEL_PROGRAM>(),
+                          CL_KERNEL_NAME_SUBSET_SAMPLER.c_str());
+    } catch(const cl::Error& err)
+    {
+        qCritical() << "OpenCL error:" << err.what() << "(" << err.err() << ")";
+        throw std::runtime_error("OpenCL error");
+    }
+}
+
 VoxelVolume<float> VolumeResampler::volume() const
 {
     VoxelVolume<float> ret(_volDim, volVoxSize());
@@ -3,12 +3,12 @@
 
 #include "img/voxelvolume.h"
 #include "ocl/openclconfig.h"
-#include "processing/coordinates.h"
+#include "processing/abstractvolumeresampler.h"
 
 namespace CTL {
 namespace OCL {
 
-class VolumeResampler
+class VolumeResampler : public AbstractVolumeResampler
 {
 public:
     explicit VolumeResampler(const VoxelVolume<float>& volume, uint oclDeviceNb = 0);
@@ -18,16 +18,20 @@ public:
                     const SamplingRange& rangeDim3,
                     uint oclDeviceNb = 0);
 
-    const SamplingRange& rangeDim1() const;
-    const SamplingRange& rangeDim2() const;
-    const SamplingRange& rangeDim3() const;
+    const SamplingRange& rangeDim1() const override;
+    const SamplingRange& rangeDim2() const override;
+    const SamplingRange& rangeDim3() const override;
 
     VoxelVolume<float> resample(const std::vector<float>& samplingPtsDim1,
                                 const std::vector<float>& samplingPtsDim2,
                                 const std::vector<float>& samplingPtsDim3) const;
 
-    std::vector<float> sample(const std::vector<Generic3DCoord>& samplingPts) const;
+    std::vector<float> sample(const std::vector<Generic3DCoord>& samplingPts) const override;
     std::vector<float> sample(const cl::Buffer& coord3dBuffer) const;
+    std::vector<float> sample(const cl::Buffer& coord3dBuffer,
+                              cl::Kernel& subsetSampler,
+                              const cl::CommandQueue& queue) const;
+    cl::Kernel subsetSamplerInstance() const;
 
     void setSamplingRanges(const SamplingRange& rangeDim1,
                            const SamplingRange& rangeDim2,
@@ -35,7 +39,7 @@ public:
 
     VoxelVolume<float> volume() const;
 
-    const VoxelVolume<float>::Dimensions& volDim() const;
+    const VoxelVolume<float>::Dimensions& volDim() const override;
     VoxelVolume<float>::Offset volOffset() const;
     VoxelVolume<float>::VoxelSize volVoxSize() const;
 
@@ -0,0 +1,237 @@
+#include "volumeresamplercpu.h"
+#include "processing/threadpool.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+// minimum number of sampling points per thread for parallel sampling
+constexpr size_t MIN_NB_SAMPLES_PER_THREAD = 4096;
+}
+
+namespace CTL {
+
+/*!
+ * Creates a VolumeResamplerCPU for \a volume, whose voxel centers are placed on a regular grid that
+ * spans the sampling ranges \a rangeDim1, \a rangeDim2 and \a rangeDim3.
+ */
+VolumeResamplerCPU::VolumeResamplerCPU(const VoxelVolume<float>& volume,
+                                       const SamplingRange& rangeDim1,
+                                       const SamplingRange& rangeDim2,
+                                       const SamplingRange& rangeDim3)
+    : _volDim(volume.dimensions())
+    , _volData(volume.constData())
+    , _rangeDim1(rangeDim1)
+    , _rangeDim2(rangeDim2)
+    , _rangeDim3(rangeDim3)
+{
+    if(_volData.size() != _volDim.totalNbElements())
+        throw std::runtime_error("VolumeResamplerCPU: volume has no data.");
+
+    updateScales();
+}
+
+/*!
+ * Creates a VolumeResamplerCPU for \a volume, where the sampling ranges are determined by the
+ * voxel size and the offset of \a volume (i.e. coordinates are in world coordinates [mm]).
+ */
+VolumeResamplerCPU::VolumeResamplerCPU(const VoxelVolume<float>& volume)
+    : VolumeResamplerCPU(
+          volume,
+          { volume.offset().x - 0.5f * volume.voxelSize().x * (volume.nbVoxels().x - 1),
+            volume.offset().x + 0.5f * volume.voxelSize().x * (volume.nbVoxels().x - 1) },
+          { volume.offset().y - 0.5f * volume.voxelSize().y * (volume.nbVoxels().y - 1),
+            volume.offset().y + 0.5f * volume.voxelSize().y * (volume.nbVoxels().y - 1) },
+          { volume.offset().z - 0.5f * volume.voxelSize().z * (volume.nbVoxels().z - 1),
+            volume.offset().z + 0.5f * volume.voxelSize().z * (volume.nbVoxels().z - 1) })
+{
+}
+
+const SamplingRange& VolumeResamplerCPU::rangeDim1() const { return _rangeDim1; }
+
+const SamplingRange& VolumeResamplerCPU::rangeDim2() const { return _rangeDim2; }
+
+const SamplingRange& VolumeResamplerCPU::rangeDim3() const { return _rangeDim3; }
+
+void VolumeResamplerCPU::setSamplingRanges(const SamplingRange& rangeDim1,
+                                           const SamplingRange& rangeDim2,
+                                           const SamplingRange& rangeDim3)
+{
+    _rangeDim1 = rangeDim1;
+    _rangeDim2 = rangeDim2;
+    _rangeDim3 = rangeDim3;
+
+    updateScales();
+}
+
+/*!
+ * Returns the volume resampled on the grid given by all combinations of \a samplingPtsDim1,
+ * \a samplingPtsDim2 and \a samplingPtsDim3.
+ */
+VoxelVolume<float> VolumeResamplerCPU::resample(const std::vector<float>& samplingPtsDim1,
+                                                const std::vector<float>& samplingPtsDim2,
+                                                const std::vector<float>& samplingPtsDim3) const
+{
+    const auto nbSmpl1 = uint(samplingPtsDim1.size());
+    const auto nbSmpl2 = uint(samplingPtsDim2.size());
+    const auto nbSmpl3 = uint(samplingPtsDim3.size());
+
+    VoxelVolume<float> ret(nbSmpl1, nbSmpl2, nbSmpl3);
+    ret.allocateMemory();
+
+    auto resampleSlices = [&](uint zBegin, uint zEnd)
+    {
+        auto* dst = ret.rawData() + size_t(zBegin) * nbSmpl1 * nbSmpl2;
+        for(auto z = zBegin; z < zEnd; ++z)
+            for(auto y = 0u; y < nbSmpl2; ++y)
+                for(auto x = 0u; x < nbSmpl1; ++x)
+                    *dst++ = sample({ samplingPtsDim1[x], samplingPtsDim2[y], samplingPtsDim3[z] });
+    };
+
+    if(ThreadBudget::nbThreads() == 1)
+    {
+        resampleSlices(0, nbSmpl3);
+        return ret;
+    }
+
+    ThreadPool tp;
+    const auto slicesPerThread = nbSmpl3 / uint(tp.nbThreads());
+    uint t = 0;
+    for(; t < tp.nbThreads(); ++t)
+        tp.enqueueThread(resampleSlices, t * slicesPerThread, (t + 1) * slicesPerThread);
+    // last thread does the rest
+    tp.enqueueThread(resampleSlices, t * slicesPerThread, nbSmpl3);
+
+    return ret;
+}
+
+/*!
+ * Returns the interpolated values of the volume at all \a samplingPts.
+ *
+ * Computation is parallelized over the sampling points.
+ */
+std::vector<float> VolumeResamplerCPU::sample(const std::vector<Generic3DCoord>& samplingPts) const
+{
+    const auto nbSmpls = samplingPts.size();
+    std::vector<float> ret(nbSmpls);
+
+    auto sampleRange = [this, &samplingPts, &ret](size_t begin, size_t end)
+    {
+        for(auto smpl = begin; smpl < end; ++smpl)
+            ret[smpl] = sample(samplingPts[smpl]);
+    };
+
+    const auto nbThreads = std::min(ThreadBudget::nbThreads(), nbSmpls / MIN_NB_SAMPLES_PER_THREAD);
+    if(nbThreads < 2)
+    {
+        sampleRange(0, nbSmpls);
+        return ret;
+    }
+
+    ThreadPool tp(nbThreads);
+    const auto smplsPerThread = nbSmpls / nbThreads;
+    size_t t = 0;
+    for(; t < nbThreads - 1; ++t)
+        tp.enqueueThread(sampleRange, t * smplsPerThread, (t + 1) * smplsPerThread);
+    // last thread does the rest
+    tp.enqueueThread(sampleRange, t * smplsPerThread, nbSmpls);
+
+    return ret;
+}
+
+/*!
+ * Returns the interpolated value of the volume at \a samplingPt.
+ */
+float VolumeResamplerCPU::sample(const Generic3DCoord& samplingPt) const
+{
+    return interpolate(_scale[0] * (samplingPt.coord1() - _rangeDim1.start()),
+                       _scale[1] * (samplingPt.coord2() - _rangeDim2.start()),
+                       _scale[2] * (samplingPt.coord3() - _rangeDim3.start()));
+}
+
+/*!
+ * Returns a copy of the volume managed by this instance (including voxel size and offset w.r.t.
+ * the sampling ranges).
+ */
+VoxelVolume<float> VolumeResamplerCPU::volume() const
+{
+    VoxelVolume<float> ret(_volDim, volVoxSize(), _volData);
+    ret.setVolumeOffset(volOffset());
+
+    return ret;
+}
+
+/*!
+ * Returns the dimensions (i.e. number of voxels) of the volume managed by this instance.
+ */
+const VoxelVolume<float>::Dimensions& VolumeResamplerCPU::volDim() const { return _volDim; }
+
+/*!
+ * Returns the offset (in mm) of the volume managed by this instance.
+ */
+VoxelVolume<float>::Offset VolumeResamplerCPU::volOffset() const
+{
+    return { _rangeDim1.center(), _rangeDim2.center(), _rangeDim3.center() };
+}
+
+/*!
+ * Returns the size of the voxels in the volume managed by this instance.
+ */
+VoxelVolume<float>::VoxelSize VolumeResamplerCPU::volVoxSize() const
+{
+    return { _rangeDim1.spacing(_volDim.x),
+             _rangeDim2.spacing(_volDim.y),
+             _rangeDim3.spacing(_volDim.z) };
+}
+
+void VolumeResamplerCPU::updateScales()
+{
+    _scale[0] = (float(_volDim.x) - 1.0f) / _rangeDim1.width();
+    _scale[1] = (float(_volDim.y) - 1.0f) / _rangeDim2.width();
+    _scale[2] = (float(_volDim.z) - 1.0f) / _rangeDim3.width();
+}
+
+/*!
+ * Trilinear interpolation at the voxel coordinate [\a x, \a y, \a z] (voxel centers at integer
+ * values). Voxels outside the volume contribute with zero (same as `CLK_ADDRESS_CLAMP` in OpenCL).
+ */
+float VolumeResamplerCPU::interpolate(float x, float y, float z) const
+{
+    const auto x0f = std::floor(x);
+    const auto y0f = std::floor(y);
+    const auto z0f = std::floor(z);
+    const auto ax = x - x0f;
+    const auto ay = y - y0f;
+    const auto az = z - z0f;
+
+    const auto dimX = int(_volDim.x);
+    const auto dimY = int(_volDim.y);
+    const auto dimZ = int(_volDim.z);
+
+    // completely outside (including the interpolation margin) or invalid coordinate (NaN)
+    if(!(x0f >= -1.0f && y0f >= -1.0f && z0f >= -1.0f &&
+         x0f <= float(dimX - 1) && y0f <= float(dimY - 1) && z0f <= float(dimZ - 1)))
+        return 0.0f;
+
+    const auto x0 = int(x0f), y0 = int(y0f), z0 = int(z0f);
+    const auto sliceSize = size_t(dimX) * size_t(dimY);
+
+    auto value = [&](int xi, int yi, int zi)
+    {
+        if(xi < 0 || yi < 0 || zi < 0 || xi >= dimX || yi >= dimY || zi >= dimZ)
+            return 0.0f;
+        return _volData[size_t(zi) * sliceSize + size_t(yi) * size_t(dimX) + size_t(xi)];
+    };
+
+    const auto c00 = (1.0f - ax) * value(x0, y0,     z0    ) + ax * value(x0 + 1, y0,     z0    );
+    const auto c10 = (1.0f - ax) * value(x0, y0 + 1, z0    ) + ax * value(x0 + 1, y0 + 1, z0    );
+    const auto c01 = (1.0f - ax) * value(x0, y0,     z0 + 1) + ax * value(x0 + 1, y0,     z0 + 1);
+    const auto c11 = (1.0f - ax) * value(x0, y0 + 1, z0 + 1) + ax * value(x0 + 1, y0 + 1, z0 + 1);
+
+    const auto c0 = (1.0f - ay) * c00 + ay * c10;
+    const auto c1 = (1.0f - ay) * c01 + ay * c11;
+
+    return (1.0f - az) * c0 + az * c1;
+}
+
+} // namespace CTL
@@ -0,0 +1,66 @@
+#ifndef CTL_VOLUMERESAMPLERCPU_H
+#define CTL_VOLUMERESAMPLERCPU_H
+
+#include "processing/abstractvolumeresampler.h"
+
+namespace CTL {
+
+/*!
+ * \class VolumeResamplerCPU
+ * \brief CPU implementation of a (trilinearly) interpolating volume sampler.
+ *
+ * This class is the OpenCL-free counterpart of OCL::VolumeResampler and reproduces its sampling
+ * behavior: the voxel centers of the managed volume are placed on a regular grid that spans the
+ * three sampling ranges and values outside of the volume are interpolated with zero as boundary
+ * value.
+ *
+ * Sampling is parallelized over the sampling points using all available threads (limited by the
+ * ThreadBudget of the calling thread).
+ */
+class VolumeResamplerCPU : public AbstractVolumeResampler
+{
+public:
+    explicit VolumeResamplerCPU(const VoxelVolume<float>& volume);
+    VolumeResamplerCPU(const VoxelVolume<float>& volume,
+                       const SamplingRange& rangeDim1,
+                       const SamplingRange& rangeDim2,
+                       const SamplingRange& rangeDim3);
+
+    const SamplingRange& rangeDim1() const override;
+    const SamplingRange& rangeDim2() const override;
+    const SamplingRange& rangeDim3() const override;
+
+    VoxelVolume<float> resample(const std::vector<float>& samplingPtsDim1,
+                                const std::vector<float>& samplingPtsDim2,
+                                const std::vector<float>& samplingPtsDim3) const;
+
+    std::vector<float> sample(const std::vector<Generic3DCoord>& samplingPts) const override;
+    float sample(const Generic3DCoord& samplingPt) const;
+
+    void setSamplingRanges(const SamplingRange& rangeDim1,
+                           const SamplingRange& rangeDim2,
+                           const SamplingRange& rangeDim3);
+
+    VoxelVolume<float> volume() const;
+
+    const VoxelVolume<float>::Dimensions& volDim() const override;
+    VoxelVolume<float>::Offset volOffset() const;
+    VoxelVolume<float>::VoxelSize volVoxSize() const;
+
+private:
+    VoxelVolume<float>::Dimensions _volDim; //!< Dimensions of the volume
+    std::vector<float> _volData; //!< Volume data
+
+    SamplingRange _rangeDim1;
+    SamplingRange _rangeDim2;
+    SamplingRange _rangeDim3;
+
+    float _scale[3]; //!< scales from unit (defined by range) to voxel number
+
+    void updateScales();
+    float interpolate(float x, float y, float z) const;
+};
+
+} // namespace CTL
+
+#endif // CTL_VOLUMERESAMPLERCPU_H
@@ -4,6 +4,7 @@
 #include "img/compositevolume.h"
 #include "img/projectiondata.h"
 #include "io/serializationinterface.h"
+#include "projectionjob.h"
 
 #include <QObject>
 #include <memory>
@@ -76,6 +77,9 @@ public:
     virtual bool isLinear() const;
     virtual ProjectionData projectComposite(const CompositeVolume& volume);
 
+    ProjectionJob projectAsync(const VolumeData& volume);
+    ProjectionJob projectCompositeAsync(CompositeVolume volume);
+
     void fromVariant(const QVariant& variant) override;
     QVariant toVariant() const override;
     virtual QVariant parameter() const;
@@ -211,6 +215,9 @@ inline ProjectorNotifier* AbstractProjector::notifier() { return &_notifier; }
  *
  * CompositeVolume data can be projected using projectComposite().
  *
+ * This method blocks until all views are computed; use projectAsync() to compute the projections
+ * in the background with the possibility to poll the progress and to cancel the computation.
+ *
  * Note that the functionality of specific ProjectorExtension classes might depend on a passing a
  * certain type of volume data. Please refer to the documentation of the extensions you are using.
  */
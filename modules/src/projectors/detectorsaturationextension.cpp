@@ -1,19 +1,91 @@
 #include "detectorsaturationextension.h"
 #include "acquisition/radiationencoder.h"
+#include "acquisition/setupartifactcache.h"
 #include "components/abstractdetector.h"
 #include "components/abstractsource.h"
+#include "io/tracer.h"
+#include "models/lookuptablemodel.h"
 #include "processing/threadpool.h"
 
+#include <limits>
+#include <stdexcept>
 #include <thread>
 
 namespace CTL {
 
 DECLARE_SERIALIZABLE_TYPE(DetectorSaturationExtension)
 
+namespace {
+
+// minimum number of pixels that are processed by a single job
+constexpr size_t MIN_NB_PIXELS_PER_JOB = 1u << 16;
+
+// enqueues jobs into `tp` that apply `processChunk` to consecutive chunks of `module`
+template <class Function>
+void enqueueChunks(ThreadPool& tp, SingleViewData::ModuleData& module, const Function& processChunk)
+{
+    const auto nbPixels = module.data().size();
+    const auto nbChunks = std::max(size_t(1), std::min(size_t(tp.nbThreads()),
+                                                       nbPixels / MIN_NB_PIXELS_PER_JOB));
+    const auto chunkSize = nbPixels / nbChunks;
+
+    auto* pix = module.rawData();
+    for(size_t c = 0; c < nbChunks; ++c)
+    {
+        const auto n = (c == nbChunks - 1) ? nbPixels - c * chunkSize : chunkSize;
+        tp.enqueueThread(processChunk, pix + c * chunkSize, n);
+    }
+}
+
+// enqueues the processing of `view` in the domain of `scale[module] * exp(-extinction)`
+void enqueueScaledView(ThreadPool& tp, SingleViewData& view,
+                       std::shared_ptr<const AbstractDataModel> saturationModel,
+                       const std::vector<float>& scale)
+{
+    uint mod = 0;
+    for(auto& module : view.data())
+    {
+        const auto s = scale[mod++];
+        enqueueChunks(tp, module, [saturationModel, s](float* pix, size_t n) {
+            // transform extinction to intensity (or photon count)
+            for(size_t i = 0; i < n; ++i)
+                pix[i] = s * std::exp(-pix[i]);
+            // pass values through saturation model
+            saturationModel->valuesAt(pix, pix, n);
+            // back-transform to extinction and overwrite projection pixel values
+            for(size_t i = 0; i < n; ++i)
+                pix[i] = std::log(s / pix[i]);
+        });
+    }
+}
+
+// the incident photon counts are given per detector module; throws if `projections` have a
+// different number of modules (e.g. stacked energy channels of a SpectralEffectsExtension)
+void checkNbModules(const ProjectionData& projections, uint nbDetectorModules)
+{
+    for(const auto& view : projections.data())
+        if(view.nbModules() != nbDetectorModules)
+            throw std::domain_error("DetectorSaturationExtension: number of modules in the "
+                                    "projections does not match the detector (energy channels "
+                                    "are not supported in count or intensity domain).");
+}
+
+} // unnamed namespace
+
 void DetectorSaturationExtension::configure(const AcquisitionSetup& setup)
 {
     _setup = setup;
 
+    // incident photon counts are only required for saturation models in count/intensity domain
+    const auto system = setup.system();
+    const auto saturationModelType = system ? system->detector()->saturationModelType()
+                                            : AbstractDetector::Undefined;
+    if(saturationModelType == AbstractDetector::PhotonCount ||
+       saturationModelType == AbstractDetector::Intensity)
+        _photonsPerPixel = SetupArtifactCache::instance().photonsPerPixel(setup);
+    else
+        _photonsPerPixel.clear();
+
     ProjectorExtension::configure(setup);
 }
 
@@ -42,6 +114,29 @@ bool DetectorSaturationExtension::isLinear() const { return false; }
  */
 void DetectorSaturationExtension::setIntensitySampling(uint nbSamples) { _nbSamples = nbSamples; }
 
+/*!
+ * Sets the number of samples of the lookup table that replaces the saturation model of the detector
+ * to \a nbSamples. The lookup table is created for each view and covers the range of input values
+ * (in the domain of the saturation model) of that view. Values are linearly interpolated from the
+ * table (see LookupTableModel).
+ *
+ * This can speed up the processing for saturation models that are expensive to evaluate. For
+ * simple models, such as DetectorSaturationLinearModel or DetectorSaturationSplineModel, direct
+ * evaluation is recommended.
+ *
+ * A value of zero (default) disables the lookup table.
+ */
+void DetectorSaturationExtension::setLookupTableSize(uint nbSamples)
+{
+    if(nbSamples == 1)
+    {
+        qWarning("DetectorSaturationExtension::setLookupTableSize: lookup table requires at least "
+                 "two samples. Lookup table has been disabled.");
+        nbSamples = 0;
+    }
+    _lutSize = nbSamples;
+}
+
 // Use SerializationInterface::toVariant() documentation.
 QVariant DetectorSaturationExtension::toVariant() const
 {
@@ -55,9 +150,10 @@ QVariant DetectorSaturationExtension::toVariant() const
 /*!
  * Returns the parameters of this instance as QVariant.
  *
- * This returns a QVariantMap with one key-value-pair: ("Intensity sampling points", _nbSamples),
+ * This returns a QVariantMap with two key-value-pairs: ("Intensity sampling points", _nbSamples),
  * which represents the number of sampling points used when (internally) a spectrum needs to be
- * sampled.
+ * sampled, and ("Lookup table size", _lutSize), which is the number of samples of the lookup table
+ * for the saturation model (zero if disabled).
  *
  * This method is used within toVariant() to serialize the object's settings.
  */
@@ -66,6 +162,7 @@ QVariant DetectorSaturationExtension::parameter() const
     QVariantMap ret = ProjectorExtension::parameter().toMap();
 
     ret.insert("Intensity sampling points", _nbSamples);
+    ret.insert("Lookup table size", _lutSize);
 
     return ret;
 }
@@ -78,6 +175,7 @@ void DetectorSaturationExtension::setParameter(const QVariant& parameter)
     QVariantMap map = parameter.toMap();
 
     _nbSamples = map.value("Intensity sampling points", 0u).toUInt();
+    _lutSize = map.value("Lookup table size", 0u).toUInt();
 }
 
 /*!
@@ -89,6 +187,7 @@ ProjectionData DetectorSaturationExtension::extendedProject(const MetaProjector&
 {
     auto ret = nestedProjector.project();
 
+    CTL_TRACE_SPAN("saturation", "DetectorSaturationExtension::saturate");
     emit notifier()->information("Processing detector saturation.");
 
     auto saturationModelType = _setup.system()->detector()->saturationModelType();
@@ -119,39 +218,21 @@ ProjectionData DetectorSaturationExtension::extendedProject(const MetaProjector&
 /*!
  * Applies the detector saturation model to \a projections in the photon count domain.
  * Transformation of input extinction data from \a projections to counts is based on the incident
- * photon count queried from the system (see SimpleCTSystem::photonsPerPixel()).
+ * photon count queried from the system (see SimpleCTSystem::photonsPerPixel()), which is taken
+ * from the SetupArtifactCache.
  */
 void DetectorSaturationExtension::processCounts(ProjectionData& projections)
 {
-    auto detectorPtr = _setup.system()->detector();
-
-    auto processView = [detectorPtr](SingleViewData* view, std::vector<float> n0) {
-        const auto saturationModel = detectorPtr->saturationModel();
-        float count;
-        uint mod = 0;
-        for(auto& module : view->data())
-        {
-            for(auto& pix : module.data())
-            {
-                // transform extinction to photon count
-                count = n0[mod] * std::exp(-pix);
-                // pass intensity through saturation model
-                count = saturationModel->valueAt(count);
-                // back-transform to extinction and overwrite projection pixel value
-                pix = std::log(n0[mod] / count);
-
-            }
-            ++mod;
-        }
-    };
+    checkNbModules(projections, _setup.system()->detector()->nbDetectorModules());
 
     ThreadPool tp;
 
     auto v = 0u;
     for(auto& view : projections.data())
     {
-        _setup.prepareView(v++);
-        tp.enqueueThread(processView, &view, _setup.system()->photonsPerPixel());
+        _setup.prepareView(v); // only required if saturation model is volatile
+        const auto& n0 = _photonsPerPixel[v++];
+        enqueueScaledView(tp, view, viewModel(view, n0), n0);
     }
 }
 
@@ -160,22 +241,17 @@ void DetectorSaturationExtension::processCounts(ProjectionData& projections)
  */
 void DetectorSaturationExtension::processExtinctions(ProjectionData& projections)
 {
-    auto detectorPtr = _setup.system()->detector();
-
-    auto processView = [detectorPtr](SingleViewData* view) {
-        const auto saturationModel = detectorPtr->saturationModel();
-        for(auto& module : view->data())
-            for(auto& pix : module.data())
-                pix = saturationModel->valueAt(pix);
-    };
-
     ThreadPool tp;
 
     auto v = 0u;
     for(auto& view : projections.data())
     {
         _setup.prepareView(v++); // only required if saturation model is volatile
-        tp.enqueueThread(processView, &view);
+        const auto saturationModel = viewModel(view, {});
+        for(auto& module : view.data())
+            enqueueChunks(tp, module, [saturationModel](float* pix, size_t n) {
+                saturationModel->valuesAt(pix, pix, n);
+            });
     }
 }
 
@@ -188,43 +264,67 @@ void DetectorSaturationExtension::processExtinctions(ProjectionData& projections
  */
 void DetectorSaturationExtension::processIntensities(ProjectionData& projections)
 {
-    auto detectorPtr = _setup.system()->detector();
-
-    auto processView = [detectorPtr](SingleViewData* view, std::vector<float> i0) {
-        const auto saturationModel = detectorPtr->saturationModel();
-        float intensity;
-        uint mod = 0;
-        for(auto& module : view->data())
-        {
-            for(auto& pix : module.data())
-            {
-                // transform extinction to intensity
-                intensity = i0[mod] * std::exp(-pix);
-                // pass intensity through saturation model
-                intensity = saturationModel->valueAt(intensity);
-                // back-transform to extinction and overwrite projection pixel value
-                pix = std::log(i0[mod] / intensity);
-            }
-            ++mod;
-        }
-    };
+    checkNbModules(projections, _setup.system()->detector()->nbDetectorModules());
 
     ThreadPool tp;
 
     uint v = 0;
-    std::vector<float> i0(detectorPtr->nbDetectorModules());
+    std::vector<float> i0(_setup.system()->detector()->nbDetectorModules());
     RadiationEncoder enc(_setup.system());
 
     for(auto& view : projections.data())
     {
-        _setup.prepareView(v++);
-        const auto n0 = enc.photonsPerPixel();
+        _setup.prepareView(v);
+        const auto& n0 = _photonsPerPixel[v++];
         const auto meanEnergy = enc.finalSpectrum(_nbSamples).centroid();
         std::transform(n0.begin(), n0.end(), i0.begin(),
                        [meanEnergy](float count) { return count * meanEnergy; });
 
-        tp.enqueueThread(processView, &view, i0);
+        enqueueScaledView(tp, view, viewModel(view, i0), i0);
     }
 }
 
+/*!
+ * Returns the saturation model that is applied to \a view. This is a copy of the (current)
+ * saturation model of the detector, such that subsequent changes of the system (e.g. for volatile
+ * models) do not affect the processing of \a view.
+ *
+ * If a lookup table size has been set, the returned model is a LookupTableModel that covers the
+ * range of input values of \a view. For a non-empty \a scale (one value per module), the input
+ * values are `scale[module] * exp(-extinction)`; otherwise the extinction values are used directly.
+ */
+std::shared_ptr<const AbstractDataModel>
+DetectorSaturationExtension::viewModel(const SingleViewData& view,
+                                       const std::vector<float>& scale) const
+{
+    const auto saturationModel = _setup.system()->detector()->saturationModel();
+    if(_lutSize == 0)
+        return std::shared_ptr<const AbstractDataModel>(saturationModel->clone());
+
+    // determine range of input values
+    auto from = std::numeric_limits<float>::max();
+    auto to = std::numeric_limits<float>::lowest();
+    uint mod = 0;
+    for(const auto& module : view.data())
+    {
+        auto modMin = module.min();
+        auto modMax = module.max();
+        if(!scale.empty())
+        {
+            const auto s = scale[mod++];
+            const auto tmp = s * std::exp(-modMax);
+            modMax = s * std::exp(-modMin);
+            modMin = tmp;
+        }
+        from = std::min(from, modMin);
+        to = std::max(to, modMax);
+    }
+
+    // lookup table requires a non-empty range
+    if(!(to > from))
+        return std::shared_ptr<const AbstractDataModel>(saturationModel->clone());
+
+    return std::make_shared<const LookupTableModel>(*saturationModel, from, to, _lutSize);
+}
+
 } // namespace CTL
@@ -17,6 +17,11 @@ namespace CTL {
  * component (see AbstractDetector::setSaturationModel()). Depending on the specification of the
  * saturation model, the postprocessing will be applied in the domain of extinction values,
  * intensities, or photon counts.
+ *
+ * The projection data is processed in parallel chunks of pixels, each of which is passed to the
+ * saturation model at once (see AbstractDataModel::valuesAt()). For saturation models that are
+ * expensive to evaluate, the model can additionally be replaced by a lookup table that covers the
+ * range of input values of each view (see setLookupTableSize()).
  * 
  * The following example shows how to extend a simple ray caster algorithm to consider detector
  * (over- and under-) saturation:
@@ -69,6 +74,7 @@ public:
     // ProjectorExtension interface
     bool isLinear() const override;
     void setIntensitySampling(uint nbSamples);
+    void setLookupTableSize(uint nbSamples);
 
     // SerializationInterface interface
     QVariant toVariant() const override;
@@ -82,9 +88,13 @@ private:
     void processCounts(ProjectionData& projections);
     void processExtinctions(ProjectionData& projections);
     void processIntensities(ProjectionData& projections);
+    std::shared_ptr<const AbstractDataModel> viewModel(const SingleViewData& view,
+                                                       const std::vector<float>& scale) const;
 
     AcquisitionSetup _setup; //!< A copy of the acquisition setup.
+    std::vector<std::vector<float>> _photonsPerPixel; //!< Incident photon counts (each view/module).
     uint _nbSamples{ 0u };   //!< Number of samples used to extract spectrally resolved information.
+    uint _lutSize{ 0u };     //!< Size of the lookup table for the saturation model (0: disabled).
 };
 
 } // namespace CTL
@@ -45,17 +45,27 @@ ProjectionData DynamicProjectorExtension::project(const VolumeData& volume)
 
     // notifier()->disconnect();
 
-    auto volCopy = static_cast<AbstractDynamicVolumeData*>(dynamicVolPtr->clone());
+    std::unique_ptr<AbstractDynamicVolumeData> volCopy(
+        static_cast<AbstractDynamicVolumeData*>(dynamicVolPtr->clone()));
 
     ProjectionData ret(_setup.system()->detector()->viewDimensions());
 
     for(auto view = 0u, nbViews = _setup.nbViews(); view < nbViews; ++view)
     {
+        // cancellation of asynchronous projection: return the views processed so far
+        ProjectionControl::throwIfCanceled(ret);
+
         volCopy->setTime(_setup.view(view).timeStamp());
         _setup.prepareView(view);
 
         ProjectorExtension::configure({ *_setup.system(), 1 });
-        ret.append(ProjectorExtension::project(*volCopy).view(0));
+        try
+        {
+            ret.append(ProjectorExtension::project(*volCopy).view(0));
+        } catch(const ProjectionCanceled&)
+        {
+            throw ProjectionCanceled(ret);
+        }
 
         // emit notifier()->projectionFinished(static_cast<int>(view));
     }
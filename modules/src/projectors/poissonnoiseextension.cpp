@@ -1,10 +1,11 @@
 #include "poissonnoiseextension.h"
-#include "acquisition/geometryencoder.h"
-#include "acquisition/radiationencoder.h"
+#include "acquisition/setupartifactcache.h"
 #include "components/genericsource.h"
 #include "img/chunk2d.h"
+#include "io/tracer.h"
 
 #include <future>
+#include <stdexcept>
 
 namespace CTL {
 
@@ -12,7 +13,7 @@ DECLARE_SERIALIZABLE_TYPE(PoissonNoiseExtension)
 
 void PoissonNoiseExtension::configure(const AcquisitionSetup& setup)
 {
-    _setup = setup;
+    _photonsPerPixel = SetupArtifactCache::instance().photonsPerPixel(setup);
 
     ProjectorExtension::configure(setup);
 }
@@ -37,6 +38,16 @@ ProjectionData PoissonNoiseExtension::extendedProject(const MetaProjector& neste
     // compute (clean) projections
     auto ret = nestedProjector.project();
 
+    // the incident photon counts are given per detector module (e.g. stacked energy channels of a
+    // SpectralEffectsExtension are not supported)
+    for(uint view = 0; view < ret.nbViews(); ++view)
+        if(view >= _photonsPerPixel.size()
+           || ret.view(view).nbModules() != _photonsPerPixel[view].size())
+            throw std::domain_error("PoissonNoiseExtension::extendedProject: number of modules in "
+                                    "the projections does not match the detector of the "
+                                    "configured system.");
+
+    CTL_TRACE_SPAN("noise", "PoissonNoiseExtension::addNoise");
     emit notifier()->information("Processing Poisson noise.");
 
     if(!_useFixedSeed)
@@ -53,15 +64,10 @@ ProjectionData PoissonNoiseExtension::extendedProject(const MetaProjector& neste
     if(_useParallelization)
         launchMode |= std::launch::async;
 
-    RadiationEncoder radiationEnc(_setup.system());
     std::vector<std::future<void>> futures(ret.nbViews());
     for(uint view = 0; view < ret.nbViews(); ++view)
-    {
-        _setup.prepareView(view);
-
         futures[view] = std::async(launchMode, processViewCompact, std::ref(ret.view(view)),
-                                   radiationEnc.photonsPerPixel(), seed + view);
-    }
+                                   std::cref(_photonsPerPixel[view]), seed + view);
 
     for(const auto& future : futures)
         future.wait();
@@ -90,7 +90,7 @@ private:
     static void processViewCompact(SingleViewData& view, const std::vector<float>& i_0, uint seed);
 
     std::mt19937 _rng;
-    AcquisitionSetup _setup; //!< A copy of the setup used for acquisition.
+    std::vector<std::vector<float>> _photonsPerPixel; //!< Incident photon counts (each view/module).
     bool _useParallelization{ true };
     bool _useFixedSeed{ false };
     uint _seed{ 0u };
@@ -0,0 +1,274 @@
+#include "projectionjob.h"
+#include "abstractprojector.h"
+
+#include <chrono>
+
+namespace CTL {
+
+namespace {
+thread_local ProjectionControl* currentControl = nullptr;
+
+// computes `projection()` in a separate thread in which `control` is installed
+template <class Projection>
+ProjectionJob launchJob(Projection projection)
+{
+    auto control = std::make_shared<ProjectionControl>();
+
+    auto task = [control](Projection projection) {
+        ProjectionControl::Scope scope(control.get());
+        return projection();
+    };
+
+    return { control, std::async(std::launch::async, task, std::move(projection)).share() };
+}
+
+} // unnamed namespace
+
+// ### ProjectionCanceled ###
+
+/*!
+ * Constructs a ProjectionCanceled exception that holds the views in \a partialResult.
+ */
+ProjectionCanceled::ProjectionCanceled(ProjectionData partialResult)
+    : std::runtime_error("Projection has been canceled.")
+    , _partialResult(std::move(partialResult))
+{
+}
+
+/*!
+ * Returns the views that had been completed before the projection was canceled. These are the
+ * leading views of the acquisition, i.e. `partialResult().nbViews()` views starting with view 0.
+ *
+ * If the projection has been canceled within a ProjectorExtension, the partial result is empty
+ * (no views), since the views of its nested projector lack the processing of the extension.
+ */
+const ProjectionData& ProjectionCanceled::partialResult() const { return _partialResult; }
+
+// ### ProjectionControl ###
+
+/*!
+ * Installs \a control as the ProjectionControl of the current thread. The previous one is
+ * restored on destruction.
+ */
+ProjectionControl::Scope::Scope(ProjectionControl* control)
+    : _previous(currentControl)
+{
+    currentControl = control;
+}
+
+ProjectionControl::Scope::~Scope() { currentControl = _previous; }
+
+/*!
+ * Returns the ProjectionControl of the current thread, or `nullptr` if the thread does not compute
+ * an asynchronous projection.
+ */
+ProjectionControl* ProjectionControl::current() { return currentControl; }
+
+/*!
+ * Throws a ProjectionCanceled holding \a partialResult if the ProjectionControl of the current
+ * thread (if any) has been canceled.
+ */
+void ProjectionControl::throwIfCanceled(const ProjectionData& partialResult)
+{
+    if(currentControl && currentControl->isCancelRequested())
+        throw ProjectionCanceled(partialResult);
+}
+
+/*!
+ * Requests cancellation of the projection.
+ */
+void ProjectionControl::cancel() { _cancelRequested.store(true); }
+
+/*!
+ * Returns `true` if cancellation of the projection has been requested.
+ */
+bool ProjectionControl::isCancelRequested() const { return _cancelRequested.load(); }
+
+/*!
+ * Increases the number of views that are going to be computed by \a nbViews.
+ */
+void ProjectionControl::addScheduledViews(uint nbViews) { _nbScheduledViews += nbViews; }
+
+/*!
+ * Reports that the computation of one (scheduled) view has been finished.
+ */
+void ProjectionControl::viewFinished() { ++_nbFinishedViews; }
+
+/*!
+ * Returns the number of views that have been scheduled so far.
+ */
+uint ProjectionControl::nbScheduledViews() const { return _nbScheduledViews.load(); }
+
+/*!
+ * Returns the number of views that have been finished so far.
+ */
+uint ProjectionControl::nbFinishedViews() const { return _nbFinishedViews.load(); }
+
+// ### ProjectionJob ###
+
+/*!
+ * Constructs a ProjectionJob that refers to the projection computed by \a future and controlled by
+ * \a control. Use AbstractProjector::projectAsync() to create jobs.
+ */
+ProjectionJob::ProjectionJob(std::shared_ptr<ProjectionControl> control,
+                             std::shared_future<ProjectionData> future)
+    : _control(std::move(control))
+    , _future(std::move(future))
+{
+}
+
+/*!
+ * Returns `true` if this instance refers to a projection (i.e. it has not been default
+ * constructed).
+ */
+bool ProjectionJob::isValid() const { return _control && _future.valid(); }
+
+/*!
+ * Returns `true` if the projection is finished (successfully, canceled or due to an error).
+ */
+bool ProjectionJob::isFinished() const { return waitFor(0); }
+
+/*!
+ * Blocks until the projection is finished.
+ */
+void ProjectionJob::wait() const
+{
+    if(!isValid())
+        throw std::runtime_error("ProjectionJob::wait: invalid job.");
+
+    _future.wait();
+}
+
+/*!
+ * Blocks until the projection is finished or \a milliseconds have passed. Returns `true` if the
+ * projection is finished.
+ */
+bool ProjectionJob::waitFor(int milliseconds) const
+{
+    if(!isValid())
+        throw std::runtime_error("ProjectionJob::waitFor: invalid job.");
+
+    return _future.wait_for(std::chrono::milliseconds(milliseconds)) == std::future_status::ready;
+}
+
+/*!
+ * Requests cancellation of the projection. This returns immediately; the projectors stop at the
+ * next view boundary. Use wait() to wait for the projection to stop.
+ */
+void ProjectionJob::cancel()
+{
+    if(_control)
+        _control->cancel();
+}
+
+/*!
+ * Returns `true` if cancel() has been called.
+ */
+bool ProjectionJob::isCancelRequested() const { return _control && _control->isCancelRequested(); }
+
+/*!
+ * Returns the fraction of finished views w.r.t. the views scheduled so far.
+ *
+ * Note that extensions which call their nested projector several times (e.g.
+ * ArealFocalSpotExtension or SpectralEffectsExtension) schedule further views during the
+ * projection, such that the progress may decrease when the next nested projection starts.
+ */
+double ProjectionJob::progress() const
+{
+    if(!_control)
+        return 0.0;
+
+    const auto nbScheduled = _control->nbScheduledViews();
+    return nbScheduled ? double(_control->nbFinishedViews()) / double(nbScheduled) : 0.0;
+}
+
+/*!
+ * Returns the number of views that have been computed so far.
+ */
+uint ProjectionJob::nbFinishedViews() const { return _control ? _control->nbFinishedViews() : 0; }
+
+/*!
+ * Returns the number of views that have been scheduled for computation so far.
+ */
+uint ProjectionJob::nbScheduledViews() const
+{
+    return _control ? _control->nbScheduledViews() : 0;
+}
+
+/*!
+ * Blocks until the projection is finished and returns its result.
+ *
+ * Throws ProjectionCanceled if the projection has been canceled. Any other exception that occurred
+ * during the projection is rethrown as well.
+ */
+ProjectionData ProjectionJob::result() const
+{
+    if(!isValid())
+        throw std::runtime_error("ProjectionJob::result: invalid job.");
+
+    return _future.get();
+}
+
+/*!
+ * Blocks until the projection is finished and returns its result. If the projection has been
+ * canceled, the views that had been completed until then are returned (see
+ * ProjectionCanceled::partialResult(); empty for projectors with extensions).
+ *
+ * Exceptions other than ProjectionCanceled that occurred during the projection are rethrown.
+ */
+ProjectionData ProjectionJob::partialResult() const
+{
+    try
+    {
+        return result();
+    } catch(const ProjectionCanceled& canceled)
+    {
+        return canceled.partialResult();
+    }
+}
+
+// ### AbstractProjector ###
+
+/*!
+ * Computes the projections of \a volume (see project()) in a separate thread and returns
+ * immediately. The returned ProjectionJob can be used to poll the progress, to cancel the
+ * projection and to retrieve the result.
+ *
+ * The projector needs to be configured in advance. It must neither be used otherwise nor be
+ * destroyed until the job is finished. A copy of \a volume (see SpectralVolumeData::clone()) is
+ * used for the projection, such that \a volume may be modified or destroyed in the meantime.
+ *
+ * Cancellation is cooperative: RayCasterProjectorCPU and all ProjectorExtension subclasses check
+ * for it at view granularity. Projectors that do not support cancellation run until they are
+ * finished.
+ */
+ProjectionJob AbstractProjector::projectAsync(const VolumeData& volume)
+{
+    struct Projection
+    {
+        AbstractProjector* projector;
+        std::shared_ptr<const VolumeData> volume;
+        ProjectionData operator()() { return projector->project(*volume); }
+    };
+
+    return launchJob(Projection{ this, std::shared_ptr<const VolumeData>(volume.clone()) });
+}
+
+/*!
+ * Computes the projections of the composite \a volume (see projectComposite()) in a separate
+ * thread and returns immediately. The \a volume is passed by value; move it into this function to
+ * avoid a copy. See projectAsync() for details.
+ */
+ProjectionJob AbstractProjector::projectCompositeAsync(CompositeVolume volume)
+{
+    struct Projection
+    {
+        AbstractProjector* projector;
+        CompositeVolume volume;
+        ProjectionData operator()() { return projector->projectComposite(volume); }
+    };
+
+    return launchJob(Projection{ this, std::move(volume) });
+}
+
+} // namespace CTL
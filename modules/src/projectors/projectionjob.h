@@ -0,0 +1,141 @@
+#ifndef CTL_PROJECTIONJOB_H
+#define CTL_PROJECTIONJOB_H
+
+#include "img/projectiondata.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+namespace CTL {
+
+/*!
+ * \class ProjectionCanceled
+ *
+ * \brief Exception that is thrown by a projector when the running projection has been canceled
+ * (see ProjectionJob::cancel()).
+ *
+ * The exception carries the views that had been completed when the cancellation was noticed (see
+ * partialResult()).
+ */
+class ProjectionCanceled : public std::runtime_error
+{
+public:
+    explicit ProjectionCanceled(ProjectionData partialResult);
+
+    const ProjectionData& partialResult() const;
+
+private:
+    ProjectionData _partialResult;
+};
+
+/*!
+ * \class ProjectionControl
+ *
+ * \brief Shared state between a ProjectionJob and the projectors that perform the projection.
+ *
+ * While a projection is computed by AbstractProjector::projectAsync(), the ProjectionControl of the
+ * job is installed for the computing thread (see current() and Scope). Projectors query it at view
+ * granularity to find out whether the job has been canceled and report finished views to it.
+ *
+ * To support cancellation in a custom projector, call `ProjectionControl::current()` at the
+ * beginning of `project()` (it returns `nullptr` for synchronous projections), announce the number
+ * of views with addScheduledViews() and check isCancelRequested() before each view. When canceled,
+ * throw a ProjectionCanceled containing the views completed so far.
+ */
+class ProjectionControl
+{
+public:
+    /*!
+     * Installs a ProjectionControl for the current thread for the lifetime of the Scope object.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(ProjectionControl* control);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ProjectionControl* _previous;
+    };
+
+    static ProjectionControl* current();
+    static void throwIfCanceled(const ProjectionData& partialResult);
+
+    void cancel();
+    bool isCancelRequested() const;
+
+    void addScheduledViews(uint nbViews);
+    void viewFinished();
+    uint nbScheduledViews() const;
+    uint nbFinishedViews() const;
+
+private:
+    std::atomic<bool> _cancelRequested{ false };
+    std::atomic<uint> _nbScheduledViews{ 0 };
+    std::atomic<uint> _nbFinishedViews{ 0 };
+};
+
+/*!
+ * \class ProjectionJob
+ *
+ * \brief Handle to a projection that is computed asynchronously (see
+ * AbstractProjector::projectAsync()).
+ *
+ * The job allows to poll the progress of the projection, to cancel it and to retrieve its result
+ * (or, after cancellation, the partial result). Copies of a ProjectionJob refer to the same
+ * projection.
+ *
+ * Destroying the last handle of a running job blocks until the projection is finished (as for a
+ * std::future obtained from std::async). Cancel the job in advance to return as early as possible.
+ *
+ * Example:
+ * \code
+ * projector->configure(setup);
+ * auto job = projector->projectAsync(volume);
+ *
+ * while(!job.waitFor(1000))
+ * {
+ *     qInfo() << "progress:" << job.progress();
+ *     if(tooSlow())
+ *         job.cancel();
+ * }
+ *
+ * auto projections = job.partialResult(); // all views, or the completed ones after cancellation
+ *                                        // (no views if canceled within an extension)
+ * \endcode
+ */
+class ProjectionJob
+{
+public:
+    ProjectionJob() = default;
+    ProjectionJob(std::shared_ptr<ProjectionControl> control,
+                  std::shared_future<ProjectionData> future);
+
+    bool isValid() const;
+    bool isFinished() const;
+    void wait() const;
+    bool waitFor(int milliseconds) const;
+
+    void cancel();
+    bool isCancelRequested() const;
+
+    double progress() const;
+    uint nbFinishedViews() const;
+    uint nbScheduledViews() const;
+
+    ProjectionData result() const;
+    ProjectionData partialResult() const;
+
+private:
+    std::shared_ptr<ProjectionControl> _control;
+    std::shared_future<ProjectionData> _future;
+};
+
+} // namespace CTL
+
+#endif // CTL_PROJECTIONJOB_H
@@ -1,4 +1,5 @@
 #include "projectorextension.h"
+#include "io/tracer.h"
 #include <QDebug>
 
 namespace CTL {
@@ -26,10 +27,33 @@ bool ProjectorExtension::MetaProjector::isComposite() const
     return _compositeVolume;
 }
 
+/*!
+ * Computes the projections of the volume using the nested projector.
+ *
+ * In case of an asynchronous projection (see AbstractProjector::projectAsync()), this throws
+ * ProjectionCanceled if the projection has been canceled before or during the nested projection,
+ * such that the calling extension skips its post-processing. The exception carries an empty
+ * partial result, since the projections of the nested projector lack the processing of the
+ * extension.
+ */
 ProjectionData ProjectorExtension::MetaProjector::project() const
 {
-    return isComposite() ? _projector->projectComposite(*_compositeVolume)
-                         : _projector->project(*_simpleVolume);
+    const ProjectionData noViews(0, 0, 0);
+    ProjectionControl::throwIfCanceled(noViews);
+
+    ProjectionData ret(0, 0, 0);
+    try
+    {
+        ret = isComposite() ? _projector->projectComposite(*_compositeVolume)
+                            : _projector->project(*_simpleVolume);
+    } catch(const ProjectionCanceled&)
+    {
+        throw ProjectionCanceled(noViews);
+    }
+
+    ProjectionControl::throwIfCanceled(noViews);
+
+    return ret;
 }
 
 /*!
@@ -103,6 +127,7 @@ void ProjectorExtension::configure(const AcquisitionSetup& setup)
     if(!_projector)
         throw std::runtime_error("ProjectorExtension::configure(): no nested projector set.");
 
+    CTL_TRACE_SPAN("configure", typeid(*this));
     _projector->configure(setup);
 }
 
@@ -121,6 +146,7 @@ ProjectionData ProjectorExtension::project(const VolumeData& volume)
     if(!_projector)
         throw std::runtime_error("ProjectorExtension::project(): no nested projector set.");
 
+    CTL_TRACE_SPAN("project", typeid(*this));
     qDebug() << "build MetaProjector";
     MetaProjector p(volume, _projector);
     qDebug() << "MetaProjector rdy";
@@ -134,6 +160,7 @@ ProjectionData ProjectorExtension::projectComposite(const CompositeVolume& volum
     if(!_projector)
         throw std::runtime_error("ProjectorExtension::projectComposite(): no nested projector set.");
 
+    CTL_TRACE_SPAN("project", typeid(*this));
     MetaProjector p(volume, _projector);
 
     return extendedProject(p);
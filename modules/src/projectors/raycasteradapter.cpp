@@ -1,6 +1,6 @@
 #include "raycasteradapter.h"
 #include "components/genericdetector.h"
-#include "acquisition/geometryencoder.h"
+#include "acquisition/setupartifactcache.h"
 
 #include <iostream>
 
@@ -10,7 +10,7 @@ namespace OCL {
 void RayCasterAdapter::configure(const AcquisitionSetup &setup)
 {
     // get projection matrices
-    FullGeometry pMats = GeometryEncoder::encodeFullGeometry(setup);
+    FullGeometry pMats = SetupArtifactCache::instance().fullGeometry(setup);
     _pMatsVectorized.clear();
     for(const auto& viewPMats : pMats)
         for(const auto& modPMats : viewPMats)
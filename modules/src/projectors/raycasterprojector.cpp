@@ -1,5 +1,7 @@
 #include "raycasterprojector.h"
+#include "acquisition/setupartifactcache.h"
 #include "components/abstractdetector.h"
+#include "io/tracer.h"
 #include "mat/matrix_algorithm.h"
 #include "ocl/openclconfig.h"
 #include "ocl/clfileloader.h"
@@ -96,8 +98,10 @@ void RayCasterProjector::setParameter(const QVariant& parameter)
  */
 void RayCasterProjector::configure(const AcquisitionSetup& setup)
 {
+    CTL_TRACE_SPAN("configure", "RayCasterProjector::configure");
+
     // get projection matrices
-    _pMats = GeometryEncoder::encodeFullGeometry(setup);
+    _pMats = SetupArtifactCache::instance().fullGeometry(setup);
 
     // extract required system geometry
     auto detectorPixels = setup.system()->detector()->nbPixelPerModule();
@@ -138,6 +142,8 @@ RayCasterProjector::Settings& RayCasterProjector::settings()
  */
 ProjectionData RayCasterProjector::project(const VolumeData& volume)
 {
+    CTL_TRACE_SPAN("project", "RayCasterProjector::project");
+
     // prepare the device list to be used by OpenCL
     prepareOpenCLDeviceList();
 
@@ -267,6 +273,15 @@ ProjectionData RayCasterProjector::project(const VolumeData& volume)
             _volDim[2] = uint(volDim[2]);
             volumeDimensionsBufs = mkInitBufs(&_volDim);
         }
+#ifndef CTL_DISABLE_TRACING
+        // the transfer is non-blocking; only when tracing, wait for it to make it visible in traces
+        if(Tracer::instance().isEnabled())
+        {
+            CTL_TRACE_SPAN("ocl", "RayCasterProjector::volumeUpload");
+            for(auto dev = 0u; dev < nbUsedDevs; ++dev)
+                queues[dev].finish();
+        }
+#endif
 
         // Allocate output buffer: pinned (page-locked) projection buffer for each device
         std::vector<PinnedBufHostRead<float>> projectionBuffers;
@@ -303,6 +318,7 @@ ProjectionData RayCasterProjector::project(const VolumeData& volume)
             const auto viewDim = ret.dimensions();
             const auto pixelPerModule = viewDim.nbRows * viewDim.nbChannels;
 
+            CTL_TRACE_SPAN_ARG("ocl", "RayCasterProjector::readback", view);
             event->wait();
 
             for(auto module = 0u; module < viewDim.nbModules; ++module)
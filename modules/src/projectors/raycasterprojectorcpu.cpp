@@ -1,6 +1,7 @@
 #include "raycasterprojectorcpu.h"
-#include "acquisition/geometryencoder.h"
+#include "acquisition/setupartifactcache.h"
 #include "components/abstractdetector.h"
+#include "io/tracer.h"
 #include "mat/matrix_algorithm.h"
 #include "processing/threadpool.h"
 
@@ -45,8 +46,10 @@ float nonInterpolatedRead(const VolumeData& volume,
  */
 void RayCasterProjectorCPU::configure(const AcquisitionSetup& setup)
 {
+    CTL_TRACE_SPAN("configure", "RayCasterProjectorCPU::configure");
+
     // get projection matrices
-    _pMats = GeometryEncoder::encodeFullGeometry(setup);
+    _pMats = SetupArtifactCache::instance().fullGeometry(setup);
 
     // extract required system geometry
     _viewDim = setup.system()->detector()->viewDimensions();
@@ -58,6 +61,8 @@ void RayCasterProjectorCPU::configure(const AcquisitionSetup& setup)
  */
 ProjectionData RayCasterProjectorCPU::project(const VolumeData& volume)
 {
+    CTL_TRACE_SPAN("project", "RayCasterProjectorCPU::project");
+
     // the returned object
     ProjectionData ret(_viewDim);
     // check for a valid volume
@@ -77,16 +82,38 @@ ProjectionData RayCasterProjectorCPU::project(const VolumeData& volume)
     // Prepare input data
     auto volCorner = volumeCorner(volume);
 
+    // cancellation and progress (for asynchronous projections only)
+    auto control = ProjectionControl::current();
+    if(control)
+        control->addScheduledViews(uint(nbViews));
+
     // define projection task for each view
-    ThreadPool tp;
-    auto threadTask = [&volume, &volCorner, this] (SingleViewData* proj, uint view) {
+    auto threadTask = [&volume, &volCorner, control, this] (SingleViewData* proj, uint view) {
+        CTL_TRACE_SPAN_ARG("view", "RayCasterProjectorCPU::computeView", view);
         *proj = computeView(volume, volCorner, view);
+        if(control)
+            control->viewFinished();
     };
     // loop over all views
-    for(auto view = 0u; view < nbViews; ++view)
+    auto nbEnqueuedViews = 0u;
+    {
+        ThreadPool tp;
+        for(; nbEnqueuedViews < nbViews; ++nbEnqueuedViews)
+        {
+            if(control && control->isCancelRequested())
+                break;
+
+            tp.enqueueThread(threadTask, &ret.view(nbEnqueuedViews), nbEnqueuedViews);
+            emit notifier()->projectionFinished(int(nbEnqueuedViews));
+        }
+    } // waits for all enqueued views
+
+    if(nbEnqueuedViews < nbViews)
     {
-        tp.enqueueThread(threadTask, &ret.view(view), view);
-        emit notifier()->projectionFinished(int(view));
+        ProjectionData partialResult(_viewDim);
+        for(auto view = 0u; view < nbEnqueuedViews; ++view)
+            partialResult.append(std::move(ret.view(view)));
+        throw ProjectionCanceled(std::move(partialResult));
     }
 
     return ret;
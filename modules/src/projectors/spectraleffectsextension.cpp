@@ -1,10 +1,12 @@
 #include "spectraleffectsextension.h"
 #include "acquisition/preparesteps.h"
-#include "acquisition/radiationencoder.h"
+#include "acquisition/setupartifactcache.h"
 #include "components/abstractdetector.h"
 #include "components/abstractsource.h"
 #include "models/stepfunctionmodels.h"
+#include <algorithm>
 #include <limits>
+#include <string>
 
 namespace CTL {
 
@@ -87,7 +89,14 @@ ProjectionData SpectralEffectsExtension::projectComposite(const CompositeVolume&
     if(canBypassExtension(volume))
     {
         qInfo() << "Bypassing SpectralEffectsExtension.";
-        return ProjectorExtension::projectComposite(volume);
+        auto proj = ProjectorExtension::projectComposite(volume);
+        if(nbEnergyChannels() == 1)
+            return proj;
+
+        // energy-independent attenuation: all energy channels are identical
+        std::vector<ProjectionData> channelProjs(nbEnergyChannels() - 1, proj);
+        channelProjs.push_back(std::move(proj));
+        return stackedChannels(std::move(channelProjs));
     }
 
     if(ProjectorExtension::isLinear())
@@ -114,8 +123,11 @@ QVariant SpectralEffectsExtension::toVariant() const
 /*!
  * Returns the parameters of this instance as QVariant.
  *
- * This returns a QVariantMap with one key-value-pair: ("Sampling resolution", _deltaE),
- * which represents the energy resolution (in keV per bin) used for sampling of spectral effects:
+ * This returns a QVariantMap with two key-value-pairs:
+ * - ("Sampling resolution", _deltaE), which represents the energy resolution (in keV per bin) used
+ * for sampling of spectral effects,
+ * - ("Energy thresholds", [thresholds]), the energy thresholds of a photon-counting detector (see
+ * setEnergyThresholds(); empty for an energy-integrating detector).
  *
  * This method is used within toVariant() to serialize the object's settings.
  */
@@ -125,6 +137,11 @@ QVariant SpectralEffectsExtension::parameter() const
 
     ret.insert("Sampling resolution", _deltaE);
 
+    QVariantList thresholds;
+    for(auto threshold : _energyThresholds)
+        thresholds.append(threshold);
+    ret.insert("Energy thresholds", thresholds);
+
     return ret;
 }
 
@@ -135,28 +152,175 @@ void SpectralEffectsExtension::setParameter(const QVariant& parameter)
 
     auto deltaE = parameter.toMap().value("Sampling resolution", 0.0f).toFloat();
     setSpectralSamplingResolution(deltaE);
+
+    std::vector<float> thresholds;
+    for(const auto& threshold : parameter.toMap().value("Energy thresholds").toList())
+        thresholds.push_back(threshold.toFloat());
+    setEnergyThresholds(std::move(thresholds));
 }
 
 /*!
  * Sets the energy resolution for sampling of spectral effects to \a energyBinWidth (in keV). This
  * represents the bin width used for (spectrally) sub-sampling the projections.
+ *
+ * Throws std::domain_error if, with the new resolution, an energy channel would not contain photons
+ * (see setEnergyThresholds()). In case of an exception, the previous resolution remains.
  */
 void SpectralEffectsExtension::setSpectralSamplingResolution(float energyBinWidth)
 {
-    _deltaE = energyBinWidth;
+    if(!_setup.isValid())
+    {
+        _deltaE = energyBinWidth;
+        return;
+    }
 
-    if(_setup.isValid())
+    // keep previous resolution and spectral information on failure
+    const auto previousDeltaE = _deltaE;
+    auto previousSpectralInfo = _spectralInfo;
+    _deltaE = energyBinWidth;
+    try
+    {
         updateSpectralInformation();
+    }
+    catch(...)
+    {
+        _deltaE = previousDeltaE;
+        _spectralInfo = std::move(previousSpectralInfo);
+        throw;
+    }
 }
 
 /*!
- * Causes an update of the spectral information to take place.
+ * Sets the energy thresholds (in keV) of a photon-counting detector to \a thresholds. This switches
+ * the output of project() and projectComposite() to energy-resolved projections with one energy
+ * channel per threshold. Channel \f$c\f$ contains all photons with energies within
+ * [\a thresholds[c], \a thresholds[c+1]); the last channel contains all photons above the highest
+ * threshold. Photons below the lowest threshold are not counted. The thresholds are sorted in
+ * ascending order. Passing an empty vector (default) restores the energy-integrating mode.
+ *
+ * All channels are computed in a single pass over the energy bins (see
+ * setSpectralSamplingResolution()); with a linear nested projector, the projections of the
+ * material densities are shared by all channels. Each energy bin is assigned to a channel by its
+ * center energy. Hence, the sampling resolution should be chosen such that the thresholds coincide
+ * with bin boundaries.
+ *
+ * Each channel contains extinction values w.r.t. the unattenuated number of photons within that
+ * channel, i.e. for a specific pixel:
+ *
+ * \f$
+ * \epsilon_{c}=\ln\frac{\sum_{E\in c}n_{0}(E)r(E)}{\sum_{E\in c}n_{0}(E)r(E)
+ * \exp\left[-\sum_{k}m_{k}(E)\mathcal{F}(\rho_{k})\right]},
+ * \f$
+ *
+ * where \f$n_{0}(E)\f$ denotes the fraction of photons with energy \f$E\f$ and \f$r(E)\f$ is the
+ * spectral response of the detector. In contrast to the energy-integrating mode, photons are not
+ * weighted with their energy.
+ *
+ * The channels are stored as additional modules of each view: module \f$m\f$ of channel \f$c\f$
+ * is module `c * nbModules + m` of the resulting projections, where `nbModules` is the number of
+ * detector modules. Use energyChannel() to extract the projections of a particular channel. Note
+ * that extensions that rely on the module count of the detector (PoissonNoiseExtension and
+ * DetectorSaturationExtension in count or intensity domain) throw std::domain_error when applied
+ * to the resulting projections. In case the extension is bypassed (no spectral information
+ * available; see canBypassExtension()), all channels contain the same projections.
+ *
+ * Throws std::domain_error if \a thresholds contains duplicates or if, for the setup this instance
+ * has been configured with, any channel would not contain photons in some view (e.g. a threshold
+ * above the tube voltage). Such a channel would result in undefined (NaN) extinction values. In
+ * case of an exception, the previous thresholds remain. If the extension has not been configured
+ * yet, this check is done in configure().
+ */
+void SpectralEffectsExtension::setEnergyThresholds(std::vector<float> thresholds)
+{
+    std::sort(thresholds.begin(), thresholds.end());
+    if(std::adjacent_find(thresholds.cbegin(), thresholds.cend()) != thresholds.cend())
+        throw std::domain_error("SpectralEffectsExtension::setEnergyThresholds: Energy thresholds "
+                                "must be distinct.");
+
+    if(!_setup.isValid())
+    {
+        _energyThresholds = std::move(thresholds);
+        return;
+    }
+
+    // validate against the spectrum of the configured setup; keep previous thresholds on failure
+    std::swap(_energyThresholds, thresholds);
+    try
+    {
+        checkEnergyChannels();
+    }
+    catch(...)
+    {
+        std::swap(_energyThresholds, thresholds);
+        throw;
+    }
+}
+
+/*!
+ * Returns the energy thresholds (in keV) of a photon-counting detector, sorted in ascending order.
+ * Returns an empty vector in case of an energy-integrating detector (default).
+ *
+ * \sa setEnergyThresholds().
+ */
+const std::vector<float>& SpectralEffectsExtension::energyThresholds() const
+{
+    return _energyThresholds;
+}
+
+/*!
+ * Returns the number of energy channels in the projections computed by this instance. This is the
+ * number of energy thresholds (see setEnergyThresholds()) or one for an energy-integrating
+ * detector.
+ */
+uint SpectralEffectsExtension::nbEnergyChannels() const
+{
+    return std::max(uint(_energyThresholds.size()), 1u);
+}
+
+/*!
+ * Returns the projections of energy channel \a channel extracted from the energy-resolved
+ * \a projections computed by this instance (see setEnergyThresholds()).
+ *
+ * Throws std::domain_error if \a channel is out of range or the number of modules in
+ * \a projections is not a multiple of the number of energy channels.
+ */
+ProjectionData SpectralEffectsExtension::energyChannel(const ProjectionData& projections,
+                                                       uint channel) const
+{
+    const auto nbChannels = nbEnergyChannels();
+    if(channel >= nbChannels)
+        throw std::domain_error("SpectralEffectsExtension::energyChannel: Channel index out of "
+                                "range.");
+
+    auto viewDim = projections.viewDimensions();
+    if(viewDim.nbModules % nbChannels != 0)
+        throw std::domain_error("SpectralEffectsExtension::energyChannel: Number of modules does "
+                                "not match the number of energy channels.");
+    viewDim.nbModules /= nbChannels;
+
+    ProjectionData ret(viewDim);
+    for(const auto& view : projections.constData())
+    {
+        SingleViewData channelView(view.first().dimensions());
+        for(auto module = 0u; module < viewDim.nbModules; ++module)
+            channelView.append(view.module(channel * viewDim.nbModules + module));
+        ret.append(std::move(channelView));
+    }
+
+    return ret;
+}
+
+/*!
+ * Causes an update of the spectral information to take place. The information is queried from the
+ * SetupArtifactCache, such that it is computed only once for a particular setup.
  *
  * \sa RadiationEncoder::spectralInformation().
  */
 void SpectralEffectsExtension::updateSpectralInformation()
 {
-    _spectralInfo = RadiationEncoder::spectralInformation(_setup, _deltaE);
+    _spectralInfo = SetupArtifactCache::instance().spectralInformation(_setup, _deltaE);
+
+    checkEnergyChannels();
 }
 
 /*!
@@ -211,6 +375,9 @@ void SpectralEffectsExtension::applyDetectorResponse(ProjectionData& intensity,
  * 2. For each energy bin: compute intensity using singleBinIntensityLinear() and add result to
  * total sum.
  * 3. Transform final result to extinction domain.
+ *
+ * In case of a photon-counting detector (see setEnergyThresholds()), the intensities are summed up
+ * separately for each energy channel in step 2; all channels share the projections from step 1.
  */
 ProjectionData SpectralEffectsExtension::projectLinear(const CompositeVolume& volume)
 {
@@ -249,14 +416,20 @@ ProjectionData SpectralEffectsExtension::projectLinear(const CompositeVolume& vo
         }
     }
 
-    // process all energy bins and sum up intensities
-    ProjectionData sumProj(_setup.system()->detector()->viewDimensions());
-    sumProj.allocateMemory(_setup.nbViews(), 0.0f);
+    // process all energy bins and sum up intensities (for each energy channel)
+    std::vector<ProjectionData> channelSums(
+        nbEnergyChannels(), ProjectionData(_setup.system()->detector()->viewDimensions()));
+    for(auto& sumProj : channelSums)
+        sumProj.allocateMemory(_setup.nbViews(), 0.0f);
     std::vector<float> massAttenuationCoeffs(nbSubVolumes);
     const auto binWidth = _spectralInfo.binWidth();
 
     for(auto bin = 0u, nbEnergyBins = _spectralInfo.nbEnergyBins(); bin < nbEnergyBins; ++bin)
     {
+        const auto channel = channelOfBin(bin);
+        if(channel < 0) // not detected
+            continue;
+
         emit notifier()->information("Processing energy bin " + QString::number(bin+1) +
                                      "/" + QString::number(nbEnergyBins) + ".");
 
@@ -271,12 +444,11 @@ ProjectionData SpectralEffectsExtension::projectLinear(const CompositeVolume& vo
                            return subVolume->meanMassAttenuationCoeff(binEnergy, binWidth) * cm2mm;
                        });
 
-        sumProj += singleBinIntensityLinear(materialProjs, massAttenuationCoeffs, binInfo);
+        channelSums[channel] += singleBinIntensityLinear(materialProjs, massAttenuationCoeffs,
+                                                         channelBinInformation(binInfo));
     }
 
-    sumProj.transformToExtinction(_spectralInfo.totalIntensity());
-
-    return sumProj;
+    return combinedChannels(std::move(channelSums));
 }
 
 /*!
@@ -288,6 +460,9 @@ ProjectionData SpectralEffectsExtension::projectLinear(const CompositeVolume& vo
  * total sum.
  * 3. Transform final result to extinction domain.
  * 4. Remove dummy prepare steps to restore original setup.
+ *
+ * In case of a photon-counting detector (see setEnergyThresholds()), the intensities are summed up
+ * separately for each energy channel in step 2.
  */
 ProjectionData SpectralEffectsExtension::projectNonLinear(const CompositeVolume &volume)
 {
@@ -295,23 +470,28 @@ ProjectionData SpectralEffectsExtension::projectNonLinear(const CompositeVolume
 
     addDummyPrepareSteps(); // dummy prepare step for source -> replaced in energy bin loop
 
-    // process all energy bins and sum up intensities
-    ProjectionData sumProj(_setup.system()->detector()->viewDimensions());
-    sumProj.allocateMemory(_setup.nbViews(), 0.0f);
+    // process all energy bins and sum up intensities (for each energy channel)
+    std::vector<ProjectionData> channelSums(
+        nbEnergyChannels(), ProjectionData(_setup.system()->detector()->viewDimensions()));
+    for(auto& sumProj : channelSums)
+        sumProj.allocateMemory(_setup.nbViews(), 0.0f);
 
     for(auto bin = 0u, nbEnergyBins = _spectralInfo.nbEnergyBins(); bin < nbEnergyBins; ++bin)
     {
+        const auto channel = channelOfBin(bin);
+        if(channel < 0) // not detected
+            continue;
+
         emit notifier()->information("Processing energy bin " + QString::number(bin+1) +
                                      "/" + QString::number(nbEnergyBins) + ".");
 
-        sumProj += singleBinIntensityNonLinear(volume, _spectralInfo.bin(bin));
+        channelSums[channel] += singleBinIntensityNonLinear(
+            volume, channelBinInformation(_spectralInfo.bin(bin)));
     }
 
-    sumProj.transformToExtinction(_spectralInfo.totalIntensity());
-
     removeDummyPrepareSteps();
 
-    return sumProj;
+    return combinedChannels(std::move(channelSums));
 }
 
 /*!
@@ -438,4 +618,124 @@ void SpectralEffectsExtension::replaceDummyPrepareSteps(const BinInformation& bi
     }
 }
 
+/*!
+ * Returns the index of the energy channel that energy bin \a bin (of the spectral information)
+ * contributes to, or -1 if the bin is below the lowest energy threshold. For an energy-integrating
+ * detector, all bins contribute to channel zero.
+ */
+int SpectralEffectsExtension::channelOfBin(uint bin) const
+{
+    if(_energyThresholds.empty())
+        return 0;
+
+    const auto upper = std::upper_bound(_energyThresholds.cbegin(), _energyThresholds.cend(),
+                                        _spectralInfo.bin(bin).energy);
+    return int(upper - _energyThresholds.cbegin()) - 1;
+}
+
+/*!
+ * Throws std::domain_error if the (unattenuated) intensity of any energy channel is zero in any
+ * view, since the extinction of such a channel is undefined.
+ */
+void SpectralEffectsExtension::checkEnergyChannels() const
+{
+    if(_energyThresholds.empty())
+        return;
+
+    for(auto channel = 0u, nbChannels = nbEnergyChannels(); channel < nbChannels; ++channel)
+    {
+        const auto intensities = channelIntensity(channel);
+        if(std::any_of(intensities.cbegin(), intensities.cend(),
+                       [](double intensity) { return !(intensity > 0.0); }))
+            throw std::domain_error("SpectralEffectsExtension: Energy channel "
+                                    + std::to_string(channel) + " (threshold: "
+                                    + QString::number(_energyThresholds[channel]).toStdString()
+                                    + " keV) does not contain any photons.");
+    }
+}
+
+/*!
+ * Returns the bin information \a binInfo adjusted to the type of detector. For a photon-counting
+ * detector, the intensities are replaced by the fraction of photons in the bin (i.e. the
+ * intensities are no longer weighted with the bin energy); otherwise, \a binInfo is returned
+ * unchanged.
+ */
+SpectralEffectsExtension::BinInformation
+SpectralEffectsExtension::channelBinInformation(const BinInformation& binInfo) const
+{
+    auto ret = binInfo;
+    if(!_energyThresholds.empty())
+        for(auto& intensity : ret.intensities)
+            intensity /= double(binInfo.energy);
+
+    return ret;
+}
+
+/*!
+ * Returns the (view-dependent) unattenuated intensity in energy channel \a channel, including the
+ * spectral response of the detector. For an energy-integrating detector, this is the total
+ * intensity of the spectral information.
+ */
+std::vector<double> SpectralEffectsExtension::channelIntensity(uint channel) const
+{
+    if(_energyThresholds.empty())
+        return _spectralInfo.totalIntensity();
+
+    const auto detector = _setup.system()->detector();
+    std::vector<double> ret(_setup.nbViews(), 0.0);
+    for(auto bin = 0u, nbEnergyBins = _spectralInfo.nbEnergyBins(); bin < nbEnergyBins; ++bin)
+    {
+        if(channelOfBin(bin) != int(channel))
+            continue;
+
+        const auto binInfo = channelBinInformation(_spectralInfo.bin(bin));
+        const auto response = detector->hasSpectralResponseModel()
+                ? double(detector->spectralResponseModel()->valueAt(binInfo.energy))
+                : 1.0;
+        for(auto view = 0u, nbViews = _setup.nbViews(); view < nbViews; ++view)
+            ret[view] += binInfo.intensities[view] * response;
+    }
+
+    return ret;
+}
+
+/*!
+ * Transforms the intensities in \a channelSums (one entry for each energy channel) to extinction
+ * and returns the combined projections (see stackedChannels()).
+ */
+ProjectionData
+SpectralEffectsExtension::combinedChannels(std::vector<ProjectionData> channelSums) const
+{
+    for(auto channel = 0u, nbChannels = uint(channelSums.size()); channel < nbChannels; ++channel)
+        channelSums[channel].transformToExtinction(channelIntensity(channel));
+
+    return stackedChannels(std::move(channelSums));
+}
+
+/*!
+ * Returns the projections of all energy channels in \a channelProjs combined into a single
+ * ProjectionData object, in which the channels are stored as consecutive sets of modules (see
+ * setEnergyThresholds()).
+ */
+ProjectionData SpectralEffectsExtension::stackedChannels(std::vector<ProjectionData> channelProjs)
+{
+    if(channelProjs.size() == 1)
+        return std::move(channelProjs.front());
+
+    auto viewDim = channelProjs.front().viewDimensions();
+    viewDim.nbModules *= uint(channelProjs.size());
+
+    ProjectionData ret(viewDim);
+    for(auto view = 0u, nbViews = channelProjs.front().nbViews(); view < nbViews; ++view)
+    {
+        SingleViewData stackedView(channelProjs.front().view(view).first().dimensions());
+        for(auto& channelProj : channelProjs)
+            for(auto& module : channelProj.view(view).data())
+                stackedView.append(std::move(module));
+        ret.append(std::move(stackedView));
+    }
+
+    return ret;
+}
+
 } // namespace CTL
@@ -72,6 +72,12 @@ namespace CTL {
  *
  * The following plot shows a comparison of the normalized absorption profiles shown in the figures above.
  * ![Normalized absorption profiles without (red) and with spectral effects (black) considered.](SpectralEffectsExtension_comparison.png)
+ *
+ * By default, the detector is energy-integrating, i.e. all energy bins are collapsed into a single
+ * extinction image. For photon-counting (energy-resolving) detectors, energy thresholds can be set
+ * with setEnergyThresholds(). The projections then contain one energy channel per threshold,
+ * computed from a single pass over the (material) projections; see setEnergyThresholds() for the
+ * layout of the resulting data and energyChannel() to extract individual channels.
  */
 class SpectralEffectsExtension : public ProjectorExtension
 {
@@ -95,6 +101,11 @@ public:
     void setParameter(const QVariant& parameter) override;
 
     void setSpectralSamplingResolution(float energyBinWidth);
+    void setEnergyThresholds(std::vector<float> thresholds);
+
+    const std::vector<float>& energyThresholds() const;
+    uint nbEnergyChannels() const;
+    ProjectionData energyChannel(const ProjectionData& projections, uint channel) const;
 
 private:  
     void updateSpectralInformation();
@@ -115,9 +126,17 @@ private:
     void removeDummyPrepareSteps();
     void replaceDummyPrepareSteps(const BinInformation& binInfo, float binWidth);
 
+    void checkEnergyChannels() const;
+    int channelOfBin(uint bin) const;
+    BinInformation channelBinInformation(const BinInformation& binInfo) const;
+    std::vector<double> channelIntensity(uint channel) const;
+    ProjectionData combinedChannels(std::vector<ProjectionData> channelSums) const;
+    static ProjectionData stackedChannels(std::vector<ProjectionData> channelProjs);
+
     SpectralInformation _spectralInfo;
     AcquisitionSetup _setup; //!< A copy of the setup used for acquisition.
     float _deltaE{ 0.0f };
+    std::vector<float> _energyThresholds; //!< Lower bounds of the energy channels (ascending).
 };
 
 
@@ -13,6 +13,8 @@ DEFINES += CTL_CORE_MODULE_AVAILABLE
 DEFINES += QT_MESSAGELOGCONTEXT
 # disable min/max macros in Windows headers
 DEFINES += NOMINMAX
+# remove all tracing instrumentation (see Tracer)
+# DEFINES += CTL_DISABLE_TRACING
 
 INCLUDEPATH += $$PWD/../src
 
@@ -27,6 +29,7 @@ HEADERS += \
     $$PWD/../src/acquisition/preparationprotocols.h \
     $$PWD/../src/acquisition/preparesteps.h \
     $$PWD/../src/acquisition/radiationencoder.h \
+    $$PWD/../src/acquisition/setupartifactcache.h \
     $$PWD/../src/acquisition/simplectsystem.h \
     $$PWD/../src/acquisition/systemblueprints.h \
     $$PWD/../src/acquisition/trajectories.h \
@@ -51,11 +54,15 @@ HEADERS += \
     $$PWD/../src/components/xraytube.h \
     $$PWD/../src/img/abstractdynamicvolumedata.h \
     $$PWD/../src/img/basisfunctionvolume.h \
+    $$PWD/../src/img/bufferpool.h \
     $$PWD/../src/img/chunk2d.h \
     $$PWD/../src/img/compositevolume.h \
+    $$PWD/../src/img/datastatistics.h \
+    $$PWD/../src/img/elementwise.h \
     $$PWD/../src/img/lineardynamicvolume.h \
     $$PWD/../src/img/modulelayout.h \
     $$PWD/../src/img/projectiondata.h \
+    $$PWD/../src/img/reduction.h \
     $$PWD/../src/img/singleviewdata.h \
     $$PWD/../src/img/spectralvolumedata.h \
     $$PWD/../src/img/voxelvolume.h \
@@ -68,8 +75,10 @@ HEADERS += \
     $$PWD/../src/io/jsonserializer.h \
     $$PWD/../src/io/messagehandler.h \
     $$PWD/../src/io/metainfokeys.h \
+    $$PWD/../src/io/rawfilewriter.h \
     $$PWD/../src/io/serializationhelper.h \
     $$PWD/../src/io/serializationinterface.h \
+    $$PWD/../src/io/tracer.h \
     $$PWD/../src/mat/homography.h \
     $$PWD/../src/mat/mat.h \
     $$PWD/../src/mat/matrix_algorithm.h \
@@ -83,23 +92,32 @@ HEADERS += \
     $$PWD/../src/models/datamodeloperations.h \
     $$PWD/../src/models/detectorsaturationmodels.h \
     $$PWD/../src/models/intervaldataseries.h \
+    $$PWD/../src/models/lookuptablemodel.h \
     $$PWD/../src/models/pointseriesbase.h \
     $$PWD/../src/models/stepfunctionmodels.h \
     $$PWD/../src/models/tabulateddatamodel.h \
     $$PWD/../src/models/xrayspectrummodels.h \
     $$PWD/../src/models/xydataseries.h \
+    $$PWD/../src/processing/abstractradon3dcoordtransform.h \
     $$PWD/../src/processing/abstractvolumedecomposer.h \
+    $$PWD/../src/processing/abstractvolumeresampler.h \
+    $$PWD/../src/processing/consistencycpu.h \
     $$PWD/../src/processing/errormetrics.h \
     $$PWD/../src/processing/diff.h \
     $$PWD/../src/processing/filter.h \
     $$PWD/../src/processing/imageprocessing.h \
+    $$PWD/../src/processing/intermediatefctpair.h \
     $$PWD/../src/processing/modelbasedvolumedecomposer.h \
+    $$PWD/../src/processing/radon3dcoordtransformcpu.h \
+    $$PWD/../src/processing/radontransform2dcpu.h \
     $$PWD/../src/processing/threadpool.h \
+    $$PWD/../src/processing/volumeresamplercpu.h \
     $$PWD/../src/projectors/abstractprojector.h \
     $$PWD/../src/projectors/arealfocalspotextension.h \
     $$PWD/../src/projectors/detectorsaturationextension.h \
     $$PWD/../src/projectors/dynamicprojectorextension.h \
     $$PWD/../src/projectors/poissonnoiseextension.h \
+    $$PWD/../src/projectors/projectionjob.h \
     $$PWD/../src/projectors/projectionpipeline.h \
     $$PWD/../src/projectors/projectorextension.h \
     $$PWD/../src/projectors/raycasterprojectorcpu.h \
@@ -114,6 +132,7 @@ SOURCES += \
     $$PWD/../src/acquisition/preparationprotocols.cpp \
     $$PWD/../src/acquisition/preparesteps.cpp \
     $$PWD/../src/acquisition/radiationencoder.cpp \
+    $$PWD/../src/acquisition/setupartifactcache.cpp \
     $$PWD/../src/acquisition/simplectsystem.cpp \
     $$PWD/../src/acquisition/trajectories.cpp \
     $$PWD/../src/acquisition/viewgeometry.cpp \
@@ -130,19 +149,27 @@ SOURCES += \
     $$PWD/../src/components/xraylaser.cpp \
     $$PWD/../src/components/xraytube.cpp \
     $$PWD/../src/img/basisfunctionvolume.cpp \
+    $$PWD/../src/img/bufferpool.tpp \
     $$PWD/../src/img/chunk2d.tpp \
     $$PWD/../src/img/compositevolume.cpp \
+    $$PWD/../src/img/datastatistics.cpp \
+    $$PWD/../src/img/datastatistics.tpp \
+    $$PWD/../src/img/elementwise.tpp \
     $$PWD/../src/img/lineardynamicvolume.cpp \
     $$PWD/../src/img/projectiondata.cpp \
+    $$PWD/../src/img/reduction.tpp \
     $$PWD/../src/img/singleviewdata.cpp \
     $$PWD/../src/img/spectralvolumedata.cpp \
     $$PWD/../src/img/voxelvolume.tpp \
     $$PWD/../src/io/basetypeio.tpp \
+    $$PWD/../src/io/prefetchingreader.tpp \
     $$PWD/../src/io/jsonserializer.cpp \
     $$PWD/../src/io/serializationhelper.cpp \
     $$PWD/../src/io/binaryserializer.cpp \
     $$PWD/../src/io/ctldatabase.cpp \
     $$PWD/../src/io/messagehandler.cpp \
+    $$PWD/../src/io/rawfilewriter.cpp \
+    $$PWD/../src/io/tracer.cpp \
     $$PWD/../src/mat/homography.cpp \
     $$PWD/../src/mat/matrix_utils.tpp \
     $$PWD/../src/mat/matrix_algorithm.cpp \
@@ -153,18 +180,25 @@ SOURCES += \
     $$PWD/../src/models/datamodeloperations.cpp \
     $$PWD/../src/models/detectorsaturationmodels.cpp \
     $$PWD/../src/models/intervaldataseries.cpp \
+    $$PWD/../src/models/lookuptablemodel.cpp \
     $$PWD/../src/models/stepfunctionmodels.cpp \
     $$PWD/../src/models/tabulateddatamodel.cpp \
     $$PWD/../src/models/xrayspectrummodels.cpp \
     $$PWD/../src/models/xydataseries.cpp \
+    $$PWD/../src/processing/consistencycpu.cpp \
     $$PWD/../src/processing/errormetrics.cpp \
     $$PWD/../src/processing/filter.cpp \
     $$PWD/../src/processing/imageprocessing.cpp \
+    $$PWD/../src/processing/intermediatefctpair.cpp \
     $$PWD/../src/processing/modelbasedvolumedecomposer.cpp \
+    $$PWD/../src/processing/radon3dcoordtransformcpu.cpp \
+    $$PWD/../src/processing/radontransform2dcpu.cpp \
+    $$PWD/../src/processing/volumeresamplercpu.cpp \
     $$PWD/../src/projectors/arealfocalspotextension.cpp \
     $$PWD/../src/projectors/detectorsaturationextension.cpp \
     $$PWD/../src/projectors/dynamicprojectorextension.cpp \
     $$PWD/../src/projectors/poissonnoiseextension.cpp \
+    $$PWD/../src/projectors/projectionjob.cpp \
     $$PWD/../src/projectors/projectionpipeline.cpp \
     $$PWD/../src/projectors/projectorextension.cpp \
     $$PWD/../src/projectors/raycasterprojectorcpu.cpp \
@@ -174,6 +208,7 @@ SOURCES += \
 HEADERS += \
     $$PWD/../src/mat/deg.h \
     $$PWD/../src/mat/matrix.h \
+    $$PWD/../src/mat/matrix_simd.h \
     $$PWD/../src/models/copyableuniqueptr.h \
     $$PWD/../src/processing/coordinates.h
 
@@ -1,7 +1,6 @@
 # dependency
 !CTL_CORE_MODULE: error("GRANGEAT_2D3D_REGIST_MODULE needs CTL_CORE_MODULE -> include ctl_core.pri before grangeat_2d3d_regist.pri")
-!OCL_CONFIG_MODULE: error("GRANGEAT_2D3D_REGIST_MODULE needs OCL_CONFIG_MODULE -> include ocl_config.pri before grangeat_2d3d_regist.pri")
-!OCL_ROUTINES_MODULE: error("GRANGEAT_2D3D_REGIST_MODULE needs OCL_ROUTINES_MODULE -> include ocl_routines.pri before grangeat_2d3d_regist.pri")
+# optional: OCL_ROUTINES_MODULE (enables the OpenCL implementation, otherwise the CPU is used)
 
 # declare module
 CONFIG += GRANGEAT_2D3D_REGIST_MODULE
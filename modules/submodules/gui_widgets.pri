@@ -9,6 +9,7 @@ QT += gui widgets
 
 HEADERS += \
     $$PWD/../src/gui/util/qttype_utils.h \
+    $$PWD/../src/gui/util/slicecache.h \
     $$PWD/../src/gui/widgets/chunk2dview.h \
     $$PWD/../src/gui/widgets/extensionchainwidget.h \
     $$PWD/../src/gui/widgets/projectionviewer.h \
@@ -17,6 +18,7 @@ HEADERS += \
     $$PWD/../src/gui/widgets/zoomcontrolwidget.h
 
 SOURCES += \
+    $$PWD/../src/gui/util/slicecache.cpp \
     $$PWD/../src/gui/widgets/chunk2dview.cpp \
     $$PWD/../src/gui/widgets/projectionviewer.cpp \
     $$PWD/../src/gui/widgets/volumeviewer.cpp \
@@ -8,3 +8,18 @@ DEFINES += NRRD_FILE_IO_MODULE_AVAILABLE
 HEADERS += $$PWD/../src/io/nrrd/nrrdfileio.h
 
 SOURCES += $$PWD/../src/io/nrrd/nrrdfileio.tpp
+
+# gzip encoding (optional, requires zlib); can be disabled by CONFIG += CTL_NO_ZLIB
+!CTL_NO_ZLIB {
+    win32 {
+        # no system zlib available: use the copy that is bundled with Qt
+        QT += zlib-private
+        DEFINES += CTL_USE_QT_ZLIB NRRD_GZIP_ENCODING_AVAILABLE
+    } else:packagesExist(zlib) {
+        CONFIG += link_pkgconfig
+        PKGCONFIG += zlib
+        DEFINES += NRRD_GZIP_ENCODING_AVAILABLE
+    } else {
+        message("zlib not found: gzip encoding of NRRD files is unsupported")
+    }
+}
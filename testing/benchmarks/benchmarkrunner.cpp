@@ -0,0 +1,257 @@
+#include "benchmarkrunner.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iostream>
+
+/*!
+ * Registers a benchmark with the name \a name in the group \a group. Each run processes
+ * \a workUnits units of work (given in \a unit), which is used to compute the throughput.
+ */
+void BenchmarkRunner::add(const QString& group, const QString& name, double workUnits,
+                          const QString& unit, Setup setup)
+{
+    _benchmarks.push_back({ group, name, workUnits, unit,
+                            [setup] { return PreparedBody{ Body(), setup() }; } });
+}
+
+/*!
+ * Registers a benchmark like add(). In addition to the timed function, \a setup returns a
+ * preparation function that is called before each (warm-up and timed) run outside of the
+ * measurement, e.g. to restore the input data of an in-place operation.
+ */
+void BenchmarkRunner::addWithPreparation(const QString& group, const QString& name,
+                                         double workUnits, const QString& unit,
+                                         PreparedSetup setup)
+{
+    _benchmarks.push_back({ group, name, workUnits, unit, std::move(setup) });
+}
+
+/*!
+ * Runs all benchmarks whose id (group/name) matches \a filter and returns their results.
+ */
+std::vector<BenchmarkRunner::Result> BenchmarkRunner::run(const QRegularExpression& filter,
+                                                          uint repetitions, uint warmUp) const
+{
+    std::vector<Result> ret;
+    for(const auto& benchmark : _benchmarks)
+    {
+        if(!filter.match(benchmark.group + '/' + benchmark.name).hasMatch())
+            continue;
+
+        std::cout << qPrintable(benchmark.group + '/' + benchmark.name) << " ... " << std::flush;
+        ret.push_back(measure(benchmark, repetitions, warmUp));
+
+        const auto& res = ret.back();
+        if(res.error.isEmpty())
+            std::cout << res.medianMs << " ms (median), " << res.throughput() << ' '
+                      << qPrintable(res.unit) << "/s" << std::endl;
+        else
+            std::cout << "failed: " << qPrintable(res.error) << std::endl;
+    }
+
+    return ret;
+}
+
+/*!
+ * Returns the ids (group/name) of all registered benchmarks.
+ */
+QStringList BenchmarkRunner::benchmarkIds() const
+{
+    QStringList ret;
+    for(const auto& benchmark : _benchmarks)
+        ret.append(benchmark.group + '/' + benchmark.name);
+    return ret;
+}
+
+/*!
+ * Returns information about the system and the build, which is stored with the results to judge
+ * whether two result files are comparable.
+ */
+QJsonObject BenchmarkRunner::environment()
+{
+    QJsonObject ret;
+    ret.insert("cpu architecture", QSysInfo::currentCpuArchitecture());
+    ret.insert("operating system", QSysInfo::prettyProductName());
+    ret.insert("ideal thread count", QThread::idealThreadCount());
+    ret.insert("qt version", qVersion());
+#if defined(__clang__)
+    ret.insert("compiler", QStringLiteral("clang " __clang_version__));
+#elif defined(__GNUC__)
+    ret.insert("compiler", QStringLiteral("gcc " __VERSION__));
+#elif defined(_MSC_VER)
+    ret.insert("compiler", QStringLiteral("msvc %1").arg(_MSC_VER));
+#endif
+#ifdef QT_DEBUG
+    ret.insert("build type", QStringLiteral("debug"));
+#else
+    ret.insert("build type", QStringLiteral("release"));
+#endif
+    return ret;
+}
+
+/*!
+ * Writes \a results (together with the environment()) to the JSON file \a fileName.
+ */
+bool BenchmarkRunner::writeJson(const std::vector<Result>& results, const QString& fileName)
+{
+    QJsonArray benchmarks;
+    for(const auto& res : results)
+    {
+        QJsonObject obj;
+        obj.insert("id", res.id());
+        obj.insert("group", res.group);
+        obj.insert("name", res.name);
+        obj.insert("repetitions", int(res.repetitions));
+        obj.insert("min ms", res.minMs);
+        obj.insert("median ms", res.medianMs);
+        obj.insert("mean ms", res.meanMs);
+        obj.insert("std dev ms", res.stdDevMs);
+        obj.insert("work units", res.workUnits);
+        obj.insert("unit", res.unit);
+        obj.insert("throughput", res.throughput());
+        if(!res.error.isEmpty())
+            obj.insert("error", res.error);
+        benchmarks.append(obj);
+    }
+
+    QJsonObject root;
+    root.insert("environment", environment());
+    root.insert("benchmarks", benchmarks);
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+
+    return file.write(QJsonDocument(root).toJson()) >= 0;
+}
+
+/*!
+ * Writes \a results to the CSV file \a fileName (one line per benchmark).
+ */
+bool BenchmarkRunner::writeCsv(const std::vector<Result>& results, const QString& fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QTextStream out(&file);
+    out << "id,repetitions,min ms,median ms,mean ms,std dev ms,work units,unit,throughput,error\n";
+    for(const auto& res : results)
+        out << res.id() << ',' << res.repetitions << ',' << res.minMs << ',' << res.medianMs << ','
+            << res.meanMs << ',' << res.stdDevMs << ',' << res.workUnits << ',' << res.unit << ','
+            << res.throughput() << ',' << QString(res.error).replace(',', ';') << '\n';
+
+    return out.status() == QTextStream::Ok;
+}
+
+/*!
+ * Compares the median times of \a results with those in the JSON file \a baselineFileName
+ * (written by writeJson()). A benchmark is a regression if its median time exceeds the baseline by
+ * more than the fraction \a tolerance (e.g. 0.1 for 10%). Benchmarks that are missing in either set
+ * or that failed are not compared.
+ */
+std::vector<BenchmarkRunner::Comparison>
+BenchmarkRunner::compareToBaseline(const std::vector<Result>& results,
+                                   const QString& baselineFileName,
+                                   double tolerance)
+{
+    std::vector<Comparison> ret;
+
+    QFile file(baselineFileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        std::cerr << "unable to open baseline file " << qPrintable(baselineFileName) << std::endl;
+        return ret;
+    }
+
+    QJsonObject baseline;
+    for(const auto& val : QJsonDocument::fromJson(file.readAll()).object().value("benchmarks")
+                                                                         .toArray())
+    {
+        const auto obj = val.toObject();
+        if(!obj.contains("error"))
+            baseline.insert(obj.value("id").toString(), obj.value("median ms"));
+    }
+
+    for(const auto& res : results)
+    {
+        if(!res.error.isEmpty() || !baseline.contains(res.id()))
+            continue;
+
+        const auto baselineMs = baseline.value(res.id()).toDouble();
+        if(baselineMs <= 0.0)
+            continue;
+
+        const auto change = (res.medianMs - baselineMs) / baselineMs;
+        ret.push_back({ res.id(), baselineMs, res.medianMs, change, change > tolerance });
+    }
+
+    return ret;
+}
+
+/*!
+ * Measures a single benchmark. Exceptions thrown by the setup or the body are reported as errors.
+ */
+BenchmarkRunner::Result BenchmarkRunner::measure(const Benchmark& benchmark, uint repetitions,
+                                                 uint warmUp)
+{
+    Result ret{ benchmark.group, benchmark.name, benchmark.workUnits, benchmark.unit, 0,
+                0.0, 0.0, 0.0, 0.0, QString() };
+
+    std::vector<double> times;
+    try
+    {
+        const auto run = benchmark.setup();
+
+        for(uint i = 0; i < warmUp; ++i)
+        {
+            if(run.prepare)
+                run.prepare();
+            run.body();
+        }
+
+        for(uint i = 0; i < repetitions; ++i)
+        {
+            if(run.prepare)
+                run.prepare();
+            const auto start = std::chrono::steady_clock::now();
+            run.body();
+            const auto stop = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+        }
+    } catch(const std::exception& e)
+    {
+        ret.error = e.what();
+        return ret;
+    }
+
+    if(times.empty())
+        return ret;
+
+    std::sort(times.begin(), times.end());
+    const auto n = times.size();
+
+    ret.repetitions = uint(n);
+    ret.minMs = times.front();
+    ret.medianMs = n % 2 ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+
+    double sum = 0.0, sumSq = 0.0;
+    for(const auto t : times)
+    {
+        sum += t;
+        sumSq += t * t;
+    }
+    ret.meanMs = sum / n;
+    ret.stdDevMs = std::sqrt(std::max(0.0, sumSq / n - ret.meanMs * ret.meanMs));
+
+    return ret;
+}
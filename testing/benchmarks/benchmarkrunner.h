@@ -0,0 +1,103 @@
+#ifndef CTL_BENCHMARKRUNNER_H
+#define CTL_BENCHMARKRUNNER_H
+
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QString>
+#include <functional>
+#include <vector>
+
+/*!
+ * \class BenchmarkRunner
+ *
+ * \brief Runs a set of registered benchmarks and reports their timings.
+ *
+ * Each benchmark consists of a setup function and the code under test. The setup function is
+ * called once (not timed) and returns the function whose execution time is measured. This function
+ * is executed `warmUp` times without measurement, followed by `repetitions` timed runs. The result
+ * holds the minimum, median, mean and standard deviation of the timed runs as well as the
+ * throughput (work units per second, based on the median).
+ *
+ * Benchmarks that modify their input (e.g. in-place operations) are registered with
+ * addWithPreparation(): their setup function additionally returns a preparation function (e.g.
+ * restoring the input), which is called before each run outside of the measurement.
+ *
+ * Results can be written as JSON or CSV. A JSON result file can later be used as a baseline: the
+ * median times of a new run are compared to the baseline and a benchmark is reported as a
+ * regression if it is slower by more than a given (relative) tolerance.
+ */
+class BenchmarkRunner
+{
+public:
+    typedef std::function<void()> Body;
+    typedef std::function<Body()> Setup;
+
+    struct PreparedBody
+    {
+        Body prepare; //!< called before each run of `body` (not timed)
+        Body body;    //!< timed
+    };
+    typedef std::function<PreparedBody()> PreparedSetup;
+
+    struct Result
+    {
+        QString group;     //!< e.g. "projector"
+        QString name;      //!< e.g. "RayCasterProjectorCPU/vol64/det64x64"
+        double workUnits;  //!< amount of work per run (e.g. number of rays)
+        QString unit;      //!< unit of the work (e.g. "rays")
+        uint repetitions;  //!< number of timed runs
+        double minMs;      //!< minimum run time [ms]
+        double medianMs;   //!< median run time [ms]
+        double meanMs;     //!< mean run time [ms]
+        double stdDevMs;   //!< standard deviation of the run time [ms]
+        QString error;     //!< non-empty if the benchmark failed
+
+        QString id() const { return group + '/' + name; }
+        double throughput() const { return medianMs > 0.0 ? workUnits / medianMs * 1000.0 : 0.0; }
+    };
+
+    struct Comparison
+    {
+        QString id;
+        double baselineMs;
+        double currentMs;
+        double relativeChange; //!< (current - baseline) / baseline
+        bool isRegression;
+    };
+
+    void add(const QString& group, const QString& name, double workUnits, const QString& unit,
+             Setup setup);
+    void addWithPreparation(const QString& group, const QString& name, double workUnits,
+                            const QString& unit, PreparedSetup setup);
+
+    std::vector<Result> run(const QRegularExpression& filter, uint repetitions, uint warmUp) const;
+    QStringList benchmarkIds() const;
+
+    static QJsonObject environment();
+    static bool writeJson(const std::vector<Result>& results, const QString& fileName);
+    static bool writeCsv(const std::vector<Result>& results, const QString& fileName);
+    static std::vector<Comparison> compareToBaseline(const std::vector<Result>& results,
+                                                     const QString& baselineFileName,
+                                                     double tolerance);
+
+private:
+    struct Benchmark
+    {
+        QString group;
+        QString name;
+        double workUnits;
+        QString unit;
+        PreparedSetup setup;
+    };
+
+    std::vector<Benchmark> _benchmarks;
+
+    static Result measure(const Benchmark& benchmark, uint repetitions, uint warmUp);
+};
+
+// registration of the individual benchmark groups
+void registerProjectorBenchmarks(BenchmarkRunner& runner);
+void registerProcessingBenchmarks(BenchmarkRunner& runner);
+void registerIOBenchmarks(BenchmarkRunner& runner);
+
+#endif // CTL_BENCHMARKRUNNER_H
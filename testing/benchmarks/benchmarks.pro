@@ -0,0 +1,30 @@
+# Qt specific
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+DEFINES += QT_DEPRECATED_WARNINGS \
+           QT_NO_DEBUG_OUTPUT
+
+TARGET = benchmarks
+
+# Compiler optimization
+CONFIG += optimize_full
+
+# Warnings as errors
+CONFIG += warn_on
+win32-g++|!win32: QMAKE_CXXFLAGS += -Werror
+win32-msvc*: QMAKE_CXXFLAGS += /WX
+
+# CTL MODULES (CPU only, no OpenCL required)
+include(../../modules/ctl.pri)
+
+# Source code of benchmarks
+SOURCES += \
+    main.cpp \
+    benchmarkrunner.cpp \
+    iobenchmarks.cpp \
+    processingbenchmarks.cpp \
+    projectorbenchmarks.cpp
+
+HEADERS += \
+    benchmarkrunner.h
@@ -0,0 +1,104 @@
+#include "benchmarkrunner.h"
+
+#include "img/projectiondata.h"
+#include "img/voxelvolume.h"
+#include "io/den/denfileio.h"
+#include "io/nrrd/nrrdfileio.h"
+
+#include <QTemporaryDir>
+#include <memory>
+#include <stdexcept>
+
+using namespace CTL;
+
+namespace {
+
+const uint VOLUME_SIZE = 256;
+const uint NB_CHANNELS = 512;
+const uint NB_ROWS = 384;
+const uint NB_VIEWS = 100;
+
+const double VOLUME_MB = double(VOLUME_SIZE) * VOLUME_SIZE * VOLUME_SIZE * sizeof(float) / 1.0e6;
+const double VIEW_MB = double(NB_CHANNELS) * NB_ROWS * sizeof(float) / 1.0e6;
+
+std::shared_ptr<VoxelVolume<float>> testVolume()
+{
+    auto ret = std::make_shared<VoxelVolume<float>>(VOLUME_SIZE, VOLUME_SIZE, VOLUME_SIZE,
+                                                    1.0f, 1.0f, 1.0f);
+    ret->fill(0.02f);
+    return ret;
+}
+
+std::shared_ptr<ProjectionData> testProjections()
+{
+    auto ret = std::make_shared<ProjectionData>(NB_CHANNELS, NB_ROWS, 1);
+    ret->allocateMemory(NB_VIEWS, 1.0f);
+    return ret;
+}
+
+// temporary directory that lives as long as the benchmark body
+std::shared_ptr<QTemporaryDir> tempDir()
+{
+    auto ret = std::make_shared<QTemporaryDir>();
+    if(!ret->isValid())
+        throw std::runtime_error("unable to create temporary directory");
+    return ret;
+}
+
+void check(bool ok)
+{
+    if(!ok)
+        throw std::runtime_error("writing failed");
+}
+
+template <class FileIOImplementer>
+void addFormat(BenchmarkRunner& runner, const QString& format, const QString& suffix)
+{
+    typedef io::BaseTypeIO<FileIOImplementer> IO;
+
+    runner.add("io", format + "/write/volume", VOLUME_MB, "MB", [suffix] {
+        auto dir = tempDir();
+        auto vol = testVolume();
+        return BenchmarkRunner::Body([dir, vol, suffix] {
+            check(IO().write(*vol, dir->filePath("vol." + suffix)));
+        });
+    });
+    runner.add("io", format + "/read/volume", VOLUME_MB, "MB", [suffix] {
+        auto dir = tempDir();
+        check(IO().write(*testVolume(), dir->filePath("vol." + suffix)));
+        return BenchmarkRunner::Body([dir, suffix] {
+            IO().template readVolume<float>(dir->filePath("vol." + suffix));
+        });
+    });
+    runner.add("io", format + "/write/projections", NB_VIEWS * VIEW_MB, "MB", [suffix] {
+        auto dir = tempDir();
+        auto projs = testProjections();
+        return BenchmarkRunner::Body([dir, projs, suffix] {
+            check(IO().write(*projs, dir->filePath("projs." + suffix)));
+        });
+    });
+    runner.add("io", format + "/writeParallel/projections", NB_VIEWS * VIEW_MB, "MB", [suffix] {
+        auto dir = tempDir();
+        auto projs = testProjections();
+        return BenchmarkRunner::Body([dir, projs, suffix] {
+            check(IO().writeParallel(*projs, dir->filePath("projs." + suffix)));
+        });
+    });
+    runner.add("io", format + "/read/singleViews", NB_VIEWS * VIEW_MB, "MB", [suffix] {
+        auto dir = tempDir();
+        check(IO().write(*testProjections(), dir->filePath("projs." + suffix)));
+        return BenchmarkRunner::Body([dir, suffix] {
+            const auto fileName = dir->filePath("projs." + suffix);
+            for(uint view = 0; view < NB_VIEWS; ++view)
+                IO().readSingleView(fileName, view, 1);
+        });
+    });
+}
+
+} // unnamed namespace
+
+void registerIOBenchmarks(BenchmarkRunner& runner)
+{
+    addFormat<io::DenFileIO>(runner, "DEN", "den");
+    addFormat<io::NrrdFileIO>(runner, "NRRD", "nrrd");
+}
@@ -0,0 +1,91 @@
+#include "benchmarkrunner.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <algorithm>
+#include <iostream>
+
+/*
+ * Usage examples:
+ *   ./benchmarks                                   run all benchmarks, write results.json
+ *   ./benchmarks --filter "^io/" --csv io.csv      run I/O benchmarks only, write CSV
+ *   ./benchmarks --baseline old.json               compare with a previous run (exit code 1 on
+ *                                                  regression)
+ *   ./benchmarks --list                            list all benchmarks
+ *
+ * For reproducible results, all input data is deterministic (fixed seeds) and each benchmark
+ * reports the median of several runs after a warm-up. Compare only results with the same
+ * "environment" (see result file).
+ */
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("benchmarks");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Performance benchmarks of the CTL");
+    parser.addHelpOption();
+    parser.addOptions({
+        { "filter", "Runs only benchmarks whose id (group/name) matches <regex>.", "regex", ".*" },
+        { "repetitions", "Number of timed runs per benchmark.", "n", "5" },
+        { "warmup", "Number of untimed runs per benchmark.", "n", "1" },
+        { "json", "Writes the results to the JSON file <file>.", "file", "results.json" },
+        { "csv", "Writes the results to the CSV file <file>.", "file" },
+        { "baseline", "Compares the results with the JSON file <file> of a previous run.",
+          "file" },
+        { "tolerance", "Relative slowdown w.r.t. the baseline that is reported as regression.",
+          "fraction", "0.1" },
+        { "list", "Lists all benchmarks and exits." },
+    });
+    parser.process(app);
+
+    BenchmarkRunner runner;
+    registerProjectorBenchmarks(runner);
+    registerProcessingBenchmarks(runner);
+    registerIOBenchmarks(runner);
+
+    if(parser.isSet("list"))
+    {
+        for(const auto& id : runner.benchmarkIds())
+            std::cout << qPrintable(id) << '\n';
+        return 0;
+    }
+
+    const QRegularExpression filter(parser.value("filter"));
+    if(!filter.isValid())
+    {
+        std::cerr << "invalid filter: " << qPrintable(filter.errorString()) << std::endl;
+        return 2;
+    }
+
+    const auto results = runner.run(filter, std::max(1u, parser.value("repetitions").toUInt()),
+                                    parser.value("warmup").toUInt());
+
+    if(!BenchmarkRunner::writeJson(results, parser.value("json")))
+        std::cerr << "unable to write " << qPrintable(parser.value("json")) << std::endl;
+    if(parser.isSet("csv") && !BenchmarkRunner::writeCsv(results, parser.value("csv")))
+        std::cerr << "unable to write " << qPrintable(parser.value("csv")) << std::endl;
+
+    if(!parser.isSet("baseline"))
+        return 0;
+
+    const auto comparisons = BenchmarkRunner::compareToBaseline(results, parser.value("baseline"),
+                                                                parser.value("tolerance").toDouble());
+    uint nbRegressions = 0;
+    std::cout << "\n ##### Comparison with baseline #####" << std::endl;
+    for(const auto& cmp : comparisons)
+    {
+        std::cout << (cmp.isRegression ? "REGRESSION " : "           ") << qPrintable(cmp.id)
+                  << ": " << cmp.baselineMs << " ms -> " << cmp.currentMs << " ms ("
+                  << (cmp.relativeChange >= 0.0 ? "+" : "") << 100.0 * cmp.relativeChange << "%)"
+                  << std::endl;
+        nbRegressions += cmp.isRegression;
+    }
+
+    if(nbRegressions)
+        std::cout << "\n ##### Number of regressions: " << nbRegressions << " #####" << std::endl;
+    else
+        std::cout << "\n ##### No regressions. #####" << std::endl;
+
+    return nbRegressions ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+#include "benchmarkrunner.h"
+
+#include "acquisition/acquisitionsetup.h"
+#include "acquisition/ctsystembuilder.h"
+#include "acquisition/geometryencoder.h"
+#include "acquisition/systemblueprints.h"
+#include "acquisition/trajectories.h"
+#include "img/chunk2d.h"
+#include "img/voxelvolume.h"
+#include "models/tabulateddatamodel.h"
+#include "processing/diff.h"
+#include "processing/filter.h"
+
+#include <QVector>
+#include <memory>
+#include <random>
+
+using namespace CTL;
+
+namespace {
+
+const uint VOLUME_SIZE = 128;
+const uint IMAGE_SIZE = 1024;
+const uint NB_BINS = 100000;
+const uint NB_GEOMETRY_VIEWS = 720;
+
+const double NB_VOXELS = double(VOLUME_SIZE) * VOLUME_SIZE * VOLUME_SIZE;
+const double NB_PIXELS = double(IMAGE_SIZE) * IMAGE_SIZE;
+
+// reproducible random data in [0, 1)
+std::vector<float> randomData(size_t nbElements)
+{
+    std::mt19937 rng(42u);
+    std::uniform_real_distribution<float> dist;
+
+    std::vector<float> ret(nbElements);
+    for(auto& val : ret)
+        val = dist(rng);
+    return ret;
+}
+
+std::shared_ptr<VoxelVolume<float>> randomVolume()
+{
+    return std::make_shared<VoxelVolume<float>>(VOLUME_SIZE, VOLUME_SIZE, VOLUME_SIZE,
+                                                randomData(size_t(NB_VOXELS)));
+}
+
+std::shared_ptr<Chunk2D<float>> randomImage()
+{
+    auto ret = std::make_shared<Chunk2D<float>>(IMAGE_SIZE, IMAGE_SIZE);
+    ret->setData(randomData(size_t(NB_PIXELS)));
+    return ret;
+}
+
+// filters operate in-place: each run processes a fresh copy of the original data (the copy is not
+// timed)
+template <class Data, class Operation>
+BenchmarkRunner::PreparedBody inPlace(std::shared_ptr<Data> original, Operation op)
+{
+    auto data = std::make_shared<Data>(*original);
+    return { [original, data] { *data = *original; }, [data, op] { op(*data); } };
+}
+
+template <uint dim>
+void addVolumeFilter(BenchmarkRunner& runner, const QString& name, imgproc::FiltMethod method)
+{
+    runner.addWithPreparation("imgproc", QStringLiteral("filter/volume/dim%1/").arg(dim) + name,
+                              NB_VOXELS, "voxels", [method] {
+        return inPlace(randomVolume(), [method](VoxelVolume<float>& vol) {
+            imgproc::filter<dim>(vol, method);
+        });
+    });
+}
+
+template <uint dim>
+void addVolumeDiff(BenchmarkRunner& runner, const QString& name, imgproc::DiffMethod method)
+{
+    runner.addWithPreparation("imgproc", QStringLiteral("diff/volume/dim%1/").arg(dim) + name,
+                              NB_VOXELS, "voxels", [method] {
+        return inPlace(randomVolume(), [method](VoxelVolume<float>& vol) {
+            imgproc::diff<dim>(vol, method);
+        });
+    });
+}
+
+AcquisitionSetup makeCarmSetup(uint nbViews)
+{
+    AcquisitionSetup setup(CTSystemBuilder::createFromBlueprint(blueprints::GenericCarmCT()),
+                           nbViews);
+    setup.applyPreparationProtocol(protocols::ShortScanTrajectory(750.0));
+    return setup;
+}
+
+} // unnamed namespace
+
+void registerProcessingBenchmarks(BenchmarkRunner& runner)
+{
+    // image processing: filters and derivatives
+    addVolumeFilter<0>(runner, "Gauss3", imgproc::Gauss3);
+    addVolumeFilter<2>(runner, "Gauss3", imgproc::Gauss3);
+    addVolumeFilter<0>(runner, "Median3", imgproc::Median3);
+    addVolumeFilter<0>(runner, "RamLak", imgproc::RamLak);
+    addVolumeDiff<0>(runner, "CentralDifference", imgproc::CentralDifference);
+    addVolumeDiff<2>(runner, "CentralDifference", imgproc::CentralDifference);
+    addVolumeDiff<0>(runner, "SavitzkyGolay7", imgproc::SavitzkyGolay7);
+
+    runner.addWithPreparation("imgproc", "filter/image/dim0/Gauss5", NB_PIXELS, "pixels", [] {
+        return inPlace(randomImage(), [](Chunk2D<float>& img) {
+            imgproc::filter<0>(img, imgproc::Gauss5);
+        });
+    });
+    runner.addWithPreparation("imgproc", "diff/image/dim1/SpectralGauss3", NB_PIXELS, "pixels",
+                              [] {
+        return inPlace(randomImage(), [](Chunk2D<float>& img) {
+            imgproc::diff<1>(img, imgproc::SpectralGauss3);
+        });
+    });
+
+    // bin integrals of a tabulated model (spectrum-like table with 1 keV sampling)
+    for(const float binWidth : { 0.5f, 10.0f })
+    {
+        runner.add("model", QStringLiteral("TabulatedDataModel/binIntegral/width%1").arg(binWidth),
+                   NB_BINS, "integrals", [binWidth] {
+            QVector<float> keys, values;
+            for(uint e = 0; e <= 150; ++e)
+            {
+                keys.append(float(e));
+                values.append(float(e) * float(150 - e));
+            }
+            auto model = std::make_shared<TabulatedDataModel>(keys, values);
+            model->binIntegral(75.0f, binWidth); // builds the internal representation
+
+            return BenchmarkRunner::Body([model, binWidth] {
+                volatile float sum = 0.0f;
+                for(uint b = 0; b < NB_BINS; ++b)
+                    sum = sum + model->binIntegral(float(b % 1500) * 0.1f, binWidth);
+            });
+        });
+    }
+
+    // geometry encoding (single thread and all available threads)
+    for(const uint nbThreads : { 1u, 0u })
+    {
+        runner.add("geometry",
+                   QStringLiteral("GeometryEncoder/encodeFullGeometry/threads%1").arg(nbThreads),
+                   NB_GEOMETRY_VIEWS, "views", [nbThreads] {
+            auto setup = std::make_shared<AcquisitionSetup>(makeCarmSetup(NB_GEOMETRY_VIEWS));
+            return BenchmarkRunner::Body([setup, nbThreads] {
+                GeometryEncoder::encodeFullGeometry(*setup, nbThreads);
+            });
+        });
+    }
+}
@@ -0,0 +1,138 @@
+#include "benchmarkrunner.h"
+
+#include "acquisition/acquisitionsetup.h"
+#include "acquisition/trajectories.h"
+#include "components/allcomponents.h"
+#include "img/spectralvolumedata.h"
+#include "img/voxelvolume.h"
+#include "io/ctldatabase.h"
+#include "models/detectorsaturationmodels.h"
+#include "projectors/arealfocalspotextension.h"
+#include "projectors/detectorsaturationextension.h"
+#include "projectors/dynamicprojectorextension.h"
+#include "projectors/poissonnoiseextension.h"
+#include "projectors/projectionpipeline.h"
+#include "projectors/raycasterprojectorcpu.h"
+#include "projectors/spectraleffectsextension.h"
+
+#include <memory>
+
+using namespace CTL;
+
+namespace {
+
+const uint NB_VIEWS = 10;
+
+// flat panel C-arm system with a short scan trajectory
+AcquisitionSetup makeSetup(uint nbPixels)
+{
+    CTSystem system;
+    system.addComponent(makeComponent<FlatPanelDetector>(QSize(nbPixels, nbPixels),
+                                                         QSizeF(1.0 * 256.0 / nbPixels,
+                                                                1.0 * 256.0 / nbPixels)));
+    system.addComponent(makeComponent<XrayTube>(QSizeF(1.0, 1.0), 80.0, 1000.0));
+    system.addComponent(makeComponent<CarmGantry>(1200.0));
+
+    AcquisitionSetup setup(system, NB_VIEWS);
+    setup.applyPreparationProtocol(protocols::ShortScanTrajectory(750.0));
+    return setup;
+}
+
+std::unique_ptr<RayCasterProjectorCPU> makeRayCaster()
+{
+    auto ret = makeProjector<RayCasterProjectorCPU>();
+    ret->settings().interpolate = true;
+    return ret;
+}
+
+// number of rays (pixels of all views) of a setup created by makeSetup()
+double nbRays(uint nbPixels) { return double(nbPixels) * nbPixels * NB_VIEWS; }
+
+// registers the extension created by `makeExt` (on top of a RayCasterProjectorCPU)
+template <class MakeExtension>
+void addExtension(BenchmarkRunner& runner, const QString& name, MakeExtension makeExt,
+                  bool spectralVolume = false)
+{
+    const uint nbPixels = 64;
+    runner.add("projector extension", name, nbRays(nbPixels), "rays", [=] {
+        auto setup = makeSetup(nbPixels);
+        auto projector = makeRayCaster() | makeExt(setup);
+        projector->configure(setup);
+
+        auto volume = spectralVolume
+            ? std::make_shared<VolumeData>(VolumeData::ball(
+                  40.0f, 1.0f, 1.0f, database::attenuationModel(database::Composite::Water)))
+            : std::make_shared<VolumeData>(VoxelVolume<float>::ball(40.0f, 1.0f, 0.02f));
+
+        std::shared_ptr<ProjectorExtension> ext(std::move(projector));
+        return BenchmarkRunner::Body([ext, volume] { ext->project(*volume); });
+    });
+}
+
+} // unnamed namespace
+
+void registerProjectorBenchmarks(BenchmarkRunner& runner)
+{
+    // ray caster at several volume and detector sizes
+    for(const uint nbVoxels : { 64u, 128u, 256u })
+        for(const uint nbPixels : { 64u, 128u, 256u })
+        {
+            const auto name = QStringLiteral("RayCasterProjectorCPU/vol%1/det%2x%2")
+                                  .arg(nbVoxels).arg(nbPixels);
+            runner.add("projector", name, nbRays(nbPixels), "rays", [=] {
+                std::shared_ptr<RayCasterProjectorCPU> projector(makeRayCaster());
+                projector->configure(makeSetup(nbPixels));
+
+                auto volume = std::make_shared<VolumeData>(
+                    VoxelVolume<float>::cube(nbVoxels, 128.0f / nbVoxels, 0.02f));
+
+                return BenchmarkRunner::Body([projector, volume] { projector->project(*volume); });
+            });
+        }
+
+    // projector extensions
+    addExtension(runner, "ArealFocalSpotExtension/2x2", [](const AcquisitionSetup&) {
+        return std::unique_ptr<ArealFocalSpotExtension>(new ArealFocalSpotExtension(QSize(2, 2)));
+    });
+    addExtension(runner, "ArealFocalSpotExtension/3x3", [](const AcquisitionSetup&) {
+        return std::unique_ptr<ArealFocalSpotExtension>(new ArealFocalSpotExtension(QSize(3, 3)));
+    });
+    addExtension(runner, "DetectorSaturationExtension", [](AcquisitionSetup& setup) {
+        setup.system()->detector()->setSaturationModel(new DetectorSaturationLinearModel(0.1f, 2.5f),
+                                                       AbstractDetector::Extinction);
+        return makeExtension<DetectorSaturationExtension>();
+    });
+    addExtension(runner, "DynamicProjectorExtension", [](const AcquisitionSetup&) {
+        return makeExtension<DynamicProjectorExtension>(); // static volume: forwards all views
+    });
+    addExtension(runner, "PoissonNoiseExtension", [](const AcquisitionSetup&) {
+        return std::unique_ptr<PoissonNoiseExtension>(new PoissonNoiseExtension(1337u));
+    });
+    addExtension(runner, "SpectralEffectsExtension", [](const AcquisitionSetup&) {
+        return std::unique_ptr<SpectralEffectsExtension>(new SpectralEffectsExtension(10.0f));
+    }, true);
+
+    // end-to-end simulation: composition of a fully-enabled StandardPipeline (default
+    // approximation), but with RayCasterProjectorCPU as the projector
+    const uint nbPixels = 64;
+    runner.add("pipeline", "ProjectionPipeline/standard/det64x64", nbRays(nbPixels), "rays", [=] {
+        auto setup = makeSetup(nbPixels);
+        setup.system()->detector()->setSaturationModel(new DetectorSaturationLinearModel(0.1f, 2.5f),
+                                                       AbstractDetector::Extinction);
+
+        auto pipeline = std::make_shared<ProjectionPipeline>(makeRayCaster());
+        pipeline->appendExtension(
+            std::unique_ptr<ArealFocalSpotExtension>(new ArealFocalSpotExtension(QSize(2, 2))));
+        pipeline->appendExtension(
+            std::unique_ptr<SpectralEffectsExtension>(new SpectralEffectsExtension(10.0f)));
+        pipeline->appendExtension(
+            std::unique_ptr<PoissonNoiseExtension>(new PoissonNoiseExtension(1337u)));
+        pipeline->appendExtension(makeExtension<DetectorSaturationExtension>());
+        pipeline->configure(setup);
+
+        auto volume = std::make_shared<VolumeData>(VolumeData::ball(
+            40.0f, 1.0f, 1.0f, database::attenuationModel(database::Composite::Water)));
+
+        return BenchmarkRunner::Body([pipeline, volume] { pipeline->project(*volume); });
+    });
+}
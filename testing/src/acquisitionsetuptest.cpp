@@ -2,7 +2,13 @@
 #include "components/allcomponents.h"
 #include "acquisition/acquisitionsetup.h"
 #include "acquisition/preparationprotocols.h"
+#include "acquisition/preparesteps.h"
+#include "acquisition/setupartifactcache.h"
 #include "acquisition/trajectories.h"
+#include "io/binaryserializer.h"
+#include "projectors/poissonnoiseextension.h"
+#include "projectors/projectionpipeline.h"
+#include "projectors/raycasterprojectorcpu.h"
 
 Q_DECLARE_METATYPE(CTL::AbstractPreparationProtocol*)
 
@@ -81,6 +87,214 @@ void AcquisitionSetupTest::testFlyingFocalSpotProtocol()
     QVERIFY(setup.system()->source()->focalSpotPosition() == pos2);
 }
 
+void AcquisitionSetupTest::testSetupArtifactCache()
+{
+    auto& cache = CTL::SetupArtifactCache::instance();
+    cache.clear();
+
+    CTL::AcquisitionSetup setup(_testSetup);
+    setup.applyPreparationProtocol(CTL::protocols::HelicalTrajectory(10.0));
+
+    const auto nbComputationsStart = cache.nbComputations();
+    const auto nbHashesStart = cache.nbContentHashes();
+    const auto geo = cache.fullGeometry(setup);
+    QCOMPARE(cache.nbComputations(), nbComputationsStart + 1u);
+    QCOMPARE(cache.nbContentHashes(), nbHashesStart + 1u);
+
+    // same revision -> served from cache without hashing the content
+    const auto& constSetup = setup;
+    cache.fullGeometry(setup);
+    QCOMPARE(cache.nbComputations(), nbComputationsStart + 1u);
+    QCOMPARE(cache.nbContentHashes(), nbHashesStart + 1u);
+    QCOMPARE(constSetup.revision(), CTL::AcquisitionSetup(setup).revision());
+
+    // equal content (copy of setup) -> served from cache (copies share the revision)
+    const auto geoCopy = cache.fullGeometry(CTL::AcquisitionSetup(setup));
+    QCOMPARE(cache.nbComputations(), nbComputationsStart + 1u);
+    QCOMPARE(cache.nbContentHashes(), nbHashesStart + 1u);
+    QCOMPARE(cache.nbEntries(), 1u);
+    QCOMPARE(geoCopy.length(), geo.length());
+    QVERIFY(geoCopy.at(0).at(0) == geo.at(0).at(0));
+
+    // non-const access renews the revision -> identified by the content hash
+    const auto oldRevision = constSetup.revision();
+    setup.system();
+    QVERIFY(constSetup.revision() != oldRevision);
+    cache.fullGeometry(setup);
+    QCOMPARE(cache.nbComputations(), nbComputationsStart + 1u);
+    QCOMPARE(cache.nbContentHashes(), nbHashesStart + 2u);
+    QCOMPARE(cache.nbEntries(), 1u);
+
+    // changed content -> new entry
+    setup.applyPreparationProtocol(CTL::protocols::HelicalTrajectory(20.0));
+    cache.fullGeometry(setup);
+    QCOMPARE(cache.nbComputations(), nbComputationsStart + 2u);
+    QCOMPARE(cache.nbContentHashes(), nbHashesStart + 3u);
+    QCOMPARE(cache.nbEntries(), 2u);
+
+    // modification through a pointer obtained earlier (no new revision) -> detected
+    auto system = setup.system();
+    auto gantry = static_cast<CTL::TubularGantry*>(system->gantry());
+    auto laser = static_cast<CTL::XrayLaser*>(system->source());
+    const auto geoUntilted = cache.fullGeometry(setup);
+    QCOMPARE(cache.nbComputations(), nbComputationsStart + 2u);
+    QCOMPARE(cache.nbContentHashes(), nbHashesStart + 4u);
+    gantry->setTiltAngle(0.1);
+    const auto geoTilted = cache.fullGeometry(setup);
+    QCOMPARE(cache.nbComputations(), nbComputationsStart + 3u);
+    QCOMPARE(cache.nbContentHashes(), nbHashesStart + 5u);
+    QCOMPARE(cache.nbEntries(), 3u);
+    QVERIFY(!(geoTilted.at(0).at(0) == geoUntilted.at(0).at(0)));
+
+    // spectral properties of the source do not affect the geometry
+    laser->setPhotonEnergy(50.0);
+    cache.fullGeometry(setup);
+    QCOMPARE(cache.nbContentHashes(), nbHashesStart + 5u);
+    for(auto view = 0u; view < setup.nbViews(); ++view)
+    {
+        auto sourcePrep = std::make_shared<CTL::prepare::SourceParam>();
+        sourcePrep->setFluxModifier(0.5 + view);
+        sourcePrep->setEnergyRangeRestriction({ 10.0f, 20.0f });
+        setup.view(view).addPrepareStep(sourcePrep);
+    }
+    cache.fullGeometry(setup);
+    QCOMPARE(cache.nbComputations(), nbComputationsStart + 3u);
+    QCOMPARE(cache.nbContentHashes(), nbHashesStart + 6u);
+
+    // ...but they affect the content hash
+    const auto hash = CTL::SetupArtifactCache::contentHash(setup);
+    auto otherRange = std::make_shared<CTL::prepare::SourceParam>();
+    otherRange->setFluxModifier(0.5);
+    otherRange->setEnergyRangeRestriction({ 10.0f, 30.0f });
+    setup.view(0).replacePrepareStep(int(setup.view(0).nbPrepareSteps()) - 1, otherRange);
+    QVERIFY(CTL::SetupArtifactCache::contentHash(setup) != hash);
+
+    // least recently used entries are discarded
+    cache.setCapacity(1);
+    QCOMPARE(cache.nbEntries(), 1u);
+    cache.fullGeometry(setup);
+    QCOMPARE(cache.nbComputations(), nbComputationsStart + 3u);
+
+    // disabled cache
+    cache.setCapacity(0);
+    cache.fullGeometry(setup);
+    QCOMPARE(cache.nbComputations(), nbComputationsStart + 4u);
+    QCOMPARE(cache.nbEntries(), 0u);
+
+    cache.setCapacity(4);
+}
+
+void AcquisitionSetupTest::testPrepareStepTable()
+{
+    CTL::AcquisitionSetup setup(CTL::SimpleCTSystem(CTL::FlatPanelDetector(QSize(100,100), QSizeF(1.0,1.0)),
+                                                    CTL::TubularGantry(1000.0, 600.0),
+                                                    CTL::XrayTube()), 50);
+
+    const CTL::protocols::HelicalTrajectory helical(3.0_deg, 1.5, 10.0, 5.0_deg);
+    std::vector<double> currents(setup.nbViews());
+    for(auto v = 0u; v < setup.nbViews(); ++v)
+        currents[v] = 1.0 + 0.1 * v;
+    const CTL::protocols::TubeCurrentModulation tcm(currents);
+
+    // setup with individual prepare steps for each view
+    CTL::AcquisitionSetup individualSetup(setup);
+    for(auto v = 0u; v < setup.nbViews(); ++v)
+        for(const auto& protocol : std::vector<const CTL::AbstractPreparationProtocol*>{ &helical, &tcm })
+            for(auto& step : protocol->prepareSteps(v, individualSetup))
+                individualSetup.view(v).addPrepareStep(std::move(step));
+
+    // setup with compact representation
+    setup.applyPreparationProtocol(helical);
+    setup.applyPreparationProtocol(tcm);
+    QCOMPARE(setup.view(7).nbPrepareSteps(), size_t(2));
+    QVERIFY(dynamic_cast<const CTL::AbstractPrepareStepTable::Row*>(
+                setup.view(7).prepareSteps().front().get()) != nullptr);
+    QVERIFY(setup.isValid());
+
+    // rows report the type of their expanded step
+    QCOMPARE(setup.view(7).prepareSteps().front()->type(),
+             int(CTL::prepare::TubularGantryParam::Type));
+    QCOMPARE(setup.view(7).prepareSteps().back()->type(), int(CTL::prepare::XrayTubeParam::Type));
+
+    // equivalent system states
+    for(auto v = 0u; v < setup.nbViews(); ++v)
+    {
+        setup.prepareView(v);
+        individualSetup.prepareView(v);
+        QCOMPARE(setup.system()->gantry()->toVariant(), individualSetup.system()->gantry()->toVariant());
+        QCOMPARE(setup.system()->source()->toVariant(), individualSetup.system()->source()->toVariant());
+    }
+
+    // equivalent serialization
+    QCOMPARE(setup.toVariant(), individualSetup.toVariant());
+
+    // type-based lookup and replacement of rows
+    auto& view = setup.view(7);
+    QVERIFY(view.prepareStep(CTL::prepare::XrayTubeParam::Type) == view.prepareSteps().back());
+    QCOMPARE(view.indexOfPrepareStep(CTL::prepare::TubularGantryParam::Type), 0);
+    QCOMPARE(view.indexOfPrepareStep(CTL::prepare::XrayTubeParam::Type), 1);
+
+    auto tubeParam = std::make_shared<CTL::prepare::XrayTubeParam>();
+    tubeParam->setEmissionCurrent(42.0);
+    QVERIFY(view.replacePrepareStep(tubeParam));
+    QCOMPARE(view.nbPrepareSteps(), size_t(2));
+    QVERIFY(view.prepareStep(CTL::prepare::XrayTubeParam::Type) == tubeParam);
+    setup.prepareView(7);
+    QCOMPARE(static_cast<CTL::XrayTube*>(setup.system()->source())->mAs(), 42.0);
+
+    view.removeAllPrepareSteps(CTL::prepare::TubularGantryParam::Type);
+    QCOMPARE(view.nbPrepareSteps(), size_t(1));
+    QCOMPARE(view.indexOfPrepareStep(CTL::prepare::TubularGantryParam::Type), -1);
+}
+
+void AcquisitionSetupTest::testCompactBinarySerialization()
+{
+    CTL::AcquisitionSetup setup(_testSetup);
+    setup.applyPreparationProtocol(CTL::protocols::HelicalTrajectory(10.0));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto compactFile = dir.filePath("setup_compact.bin");
+    const auto legacyFile = dir.filePath("setup_legacy.bin");
+
+    // legacy format by default, compact format is opt-in
+    CTL::BinarySerializer serializer;
+    QVERIFY(!serializer.isCompactFormat());
+    serializer.serialize(setup, legacyFile);
+    serializer.setCompactFormat(true);
+    serializer.serialize(setup, compactFile);
+
+    // both formats are read (format is detected automatically)
+    const auto fromCompact = serializer.deserializeAquisitionSetup(compactFile);
+    const auto fromLegacy = serializer.deserializeAquisitionSetup(legacyFile);
+    QVERIFY(fromCompact != nullptr);
+    QVERIFY(fromLegacy != nullptr);
+    QCOMPARE(fromCompact->toVariant(), setup.toVariant());
+    QCOMPARE(fromLegacy->toVariant(), setup.toVariant());
+    QVERIFY(QFileInfo(compactFile).size() < QFileInfo(legacyFile).size());
+
+    // system
+    serializer.serialize(*setup.system(), compactFile);
+    const auto system = serializer.deserializeSystem(compactFile);
+    QVERIFY(system != nullptr);
+    QCOMPARE(system->toVariant(), setup.system()->toVariant());
+
+    // pipeline (streaming interface)
+    CTL::ProjectionPipeline pipe(new CTL::RayCasterProjectorCPU);
+    pipe.appendExtension(new CTL::PoissonNoiseExtension);
+    QVERIFY(CTL::BinarySerializer::supportsCompactFormat(pipe));
+
+    QByteArray buffer;
+    {
+        QDataStream out(&buffer, QIODevice::WriteOnly);
+        QVERIFY(CTL::BinarySerializer::writeCompact(out, pipe));
+    }
+    QDataStream in(buffer);
+    const auto pipeRead = CTL::BinarySerializer::readCompact(in);
+    QVERIFY(pipeRead != nullptr);
+    QCOMPARE(pipeRead->toVariant(), pipe.toVariant());
+}
+
 AcquisitionSetupTest::AcquisitionSetupTest()
     : _testSetup(CTL::SimpleCTSystem(CTL::FlatPanelDetector(QSize(100,100),QSizeF(1.0,1.0)),
                                      CTL::TubularGantry(1000.0, 600.0),
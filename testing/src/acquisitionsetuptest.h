@@ -16,6 +16,9 @@ private Q_SLOTS:
     void testProtocolValidityChecks();
     void testProtocolValidityChecks_data();
     void testFlyingFocalSpotProtocol();
+    void testSetupArtifactCache();
+    void testPrepareStepTable();
+    void testCompactBinarySerialization();
 
 private:
     CTL::AcquisitionSetup _testSetup;
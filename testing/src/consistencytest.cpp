@@ -0,0 +1,462 @@
+#include "consistencytest.h"
+#include "acquisition/acquisitionsetup.h"
+#include "acquisition/geometryencoder.h"
+#include "acquisition/trajectories.h"
+#include "components/allcomponents.h"
+#include "processing/consistency.h"
+#include "processing/consistencycpu.h"
+#include "processing/diff.h"
+#include "processing/radon3dcoordtransformcpu.h"
+#include "processing/radontransform2dcpu.h"
+#include "processing/threadpool.h"
+#include "processing/volumeresamplercpu.h"
+#include "projectors/raycasterprojectorcpu.h"
+
+#ifdef GRANGEAT_2D3D_REGIST_MODULE_AVAILABLE
+#include "app/registration/grangeatregistration2d3d.h"
+#endif
+
+#include <algorithm>
+#include <random>
+
+using namespace CTL;
+
+namespace {
+// synthetic pose: the projection shows the phantom shifted by `SHIFT` [mm]
+const mat::Matrix<3, 1> SHIFT{ 3.0, -2.0, 1.5 };
+// sampling of the 3D Radon space
+const SamplingRange PHI_RANGE(-PI, PI), THETA_RANGE(0.0, PI), DIST_RANGE(-60.0, 60.0);
+const uint NB_PHI = 64, NB_THETA = 32, NB_DIST = 61;
+
+double relativeDifference(const std::vector<float>& values, const std::vector<float>& reference);
+}
+
+void ConsistencyTest::initTestCase()
+{
+    CTSystem theSystem;
+    theSystem << new FlatPanelDetector(QSize(128, 128), QSizeF(1.0, 1.0))
+              << new CarmGantry(1200.0) << new XrayTube(80.0, 1.0);
+
+    AcquisitionSetup setup(theSystem);
+    setup.setNbViews(1);
+    setup.applyPreparationProtocol(protocols::ShortScanTrajectory(750.0));
+
+    RayCasterProjectorCPU projector;
+    projector.configure(setup);
+    const auto proj = projector.project(phantom({ float(SHIFT.get<0>()),
+                                                  float(SHIFT.get<1>()),
+                                                  float(SHIFT.get<2>()) }));
+    _projection = proj.view(0).module(0);
+    _pMat = GeometryEncoder::encodeFullGeometry(setup).view(0).module(0);
+
+    _radon3dDiff = OCL::RadonTransform3D(phantom({ 0.0f, 0.0f, 0.0f }))
+                       .sampleTransform(PHI_RANGE.linspace(NB_PHI), THETA_RANGE.linspace(NB_THETA),
+                                        DIST_RANGE.linspace(NB_DIST));
+    imgproc::diff<2>(_radon3dDiff);
+    _radon3dDiff /= DIST_RANGE.spacing(NB_DIST);
+}
+
+void ConsistencyTest::testRadonTransform2DCPU()
+{
+    // Gaussian blob centered at the (default) origin of the transform
+    constexpr uint size = 64;
+    constexpr float sigma = 6.0f;
+    Chunk2D<float> blob(size, size);
+    blob.allocateMemory();
+    const auto center = 0.5f * float(size - 1);
+    for(uint y = 0; y < size; ++y)
+        for(uint x = 0; x < size; ++x)
+        {
+            const auto dx = float(x) - center;
+            const auto dy = float(y) - center;
+            blob(x, y) = std::exp(-(dx * dx + dy * dy) / (2.0f * sigma * sigma));
+        }
+
+    const std::vector<float> theta{ 0.0f, 0.4f, 1.3f, 2.9f };
+    const std::vector<float> s{ -12.0f, 0.0f, 3.0f, 8.0f, 15.0f };
+
+    const RadonTransform2DCPU radonCPU(blob);
+    const auto transformCPU = radonCPU.sampleTransform(theta, s);
+
+    // analytic line integrals of the blob: sqrt(2 pi) * sigma * exp(-s^2 / (2 sigma^2))
+    for(uint t = 0; t < theta.size(); ++t)
+        for(uint sIdx = 0; sIdx < s.size(); ++sIdx)
+        {
+            const auto expected = std::sqrt(2.0f * float(PI)) * sigma *
+                                  std::exp(-s[sIdx] * s[sIdx] / (2.0f * sigma * sigma));
+            QVERIFY(std::abs(transformCPU(t, sIdx) - expected) < 0.1f);
+        }
+
+    // OpenCL implementation
+    const OCL::RadonTransform2D radonOCL(blob);
+    const auto transformOCL = radonOCL.sampleTransform(theta, s);
+    QVERIFY(relativeDifference(transformCPU.data(), transformOCL.data()) < 1.0e-2);
+
+    // evaluation of single sampling points
+    std::vector<Radon2DCoord> smplPts;
+    for(uint t = 0; t < theta.size(); ++t)
+        for(uint sIdx = 0; sIdx < s.size(); ++sIdx)
+            smplPts.emplace_back(theta[t], s[sIdx]);
+    const auto lineIntegrals = radonCPU.sampleTransform(smplPts);
+    for(uint t = 0; t < theta.size(); ++t)
+        for(uint sIdx = 0; sIdx < s.size(); ++sIdx)
+            QCOMPARE(lineIntegrals[t * s.size() + sIdx], transformCPU(t, sIdx));
+
+    // serial evaluation within a thread budget of one thread
+    {
+        ThreadBudget budget(1);
+        QCOMPARE(ThreadBudget::nbThreads(), size_t(1));
+        QVERIFY(radonCPU.sampleTransform(theta, s).data() == transformCPU.data());
+        QVERIFY(radonCPU.sampleTransform(smplPts) == lineIntegrals);
+    }
+}
+
+void ConsistencyTest::testVolumeResamplerCPU()
+{
+    // linear function (of the voxel index), which is reproduced exactly by trilinear interpolation
+    constexpr uint nbX = 16, nbY = 12, nbZ = 8;
+    auto linearFct = [](float x, float y, float z) { return 1.0f + 0.5f * x + 0.25f * y - 0.125f * z; };
+    VoxelVolume<float> volume(nbX, nbY, nbZ);
+    volume.allocateMemory();
+    for(uint z = 0; z < nbZ; ++z)
+        for(uint y = 0; y < nbY; ++y)
+            for(uint x = 0; x < nbX; ++x)
+                volume(x, y, z) = linearFct(float(x), float(y), float(z));
+
+    const SamplingRange range1(-1.0, 1.0), range2(0.0, 11.0), range3(-3.5, 3.5);
+    const VolumeResamplerCPU samplerCPU(volume, range1, range2, range3);
+    const OCL::VolumeResampler samplerOCL(volume, range1, range2, range3);
+
+    // sampling points inside of the ranges (more than required for the parallel evaluation)
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> idx1(0.0f, float(nbX - 1)), idx2(0.0f, float(nbY - 1)),
+                                          idx3(0.0f, float(nbZ - 1));
+    std::vector<Generic3DCoord> smplPts(20000);
+    std::vector<float> expected(smplPts.size());
+    for(size_t smpl = 0; smpl < smplPts.size(); ++smpl)
+    {
+        const auto x = idx1(rng), y = idx2(rng), z = idx3(rng);
+        smplPts[smpl] = { range1.start() + x * range1.spacing(nbX),
+                          range2.start() + y * range2.spacing(nbY),
+                          range3.start() + z * range3.spacing(nbZ) };
+        expected[smpl] = linearFct(x, y, z);
+    }
+
+    const auto valuesCPU = samplerCPU.sample(smplPts);
+    QVERIFY(relativeDifference(valuesCPU, expected) < 1.0e-5);
+    QVERIFY(relativeDifference(valuesCPU, samplerOCL.sample(smplPts)) < 1.0e-2);
+
+    // zero outside of the volume (including the interpolation margin)
+    const Generic3DCoord outside(range1.start() - 2.0f * range1.spacing(nbX), range2.center(),
+                                 range3.center());
+    QCOMPARE(samplerCPU.sample(outside), 0.0f);
+    QCOMPARE(samplerOCL.sample(std::vector<Generic3DCoord>(1, outside)).front(), 0.0f);
+
+    // resampling of a grid
+    const std::vector<float> grid1{ -1.0f, 0.0f, 0.5f }, grid2{ 2.0f, 7.5f }, grid3{ 0.0f, 1.0f };
+    const auto resampled = samplerCPU.resample(grid1, grid2, grid3);
+    for(uint z = 0; z < grid3.size(); ++z)
+        for(uint y = 0; y < grid2.size(); ++y)
+            for(uint x = 0; x < grid1.size(); ++x)
+                QCOMPARE(resampled(x, y, z),
+                         samplerCPU.sample(Generic3DCoord(grid1[x], grid2[y], grid3[z])));
+
+    // serial evaluation within a thread budget of one thread
+    {
+        ThreadBudget budget(1);
+        QVERIFY(samplerCPU.sample(smplPts) == valuesCPU);
+        QVERIFY(samplerCPU.resample(grid1, grid2, grid3).data() == resampled.data());
+    }
+}
+
+void ConsistencyTest::testRadon3DCoordTransformCPU()
+{
+    // random planes (more than required for the parallel evaluation)
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> azimuth(-3.0f, 3.0f), polar(0.2f, 2.9f), dist(-40.0f, 40.0f);
+    std::vector<Radon3DCoord> coords(20000);
+    for(auto& coord : coords)
+        coord = { azimuth(rng), polar(rng), dist(rng) };
+
+    const Radon3DCoordTransformCPU transfCPU(coords);
+    QCOMPARE(transfCPU.nbCoords(), coords.size());
+
+    // translation: angles are invariant, distances are shifted by -n^T * t
+    const mat::Matrix<3, 1> translation{ 5.0, -3.0, 2.0 };
+    const auto translated = transfCPU.transformedCoords(mat::eye<3>(), translation);
+    for(size_t i = 0; i < coords.size(); ++i)
+    {
+        const auto& c = coords[i];
+        const auto nDotT = std::sin(c.polar()) * std::cos(c.azimuth()) * translation.get<0>() +
+                           std::sin(c.polar()) * std::sin(c.azimuth()) * translation.get<1>() +
+                           std::cos(c.polar()) * translation.get<2>();
+        QVERIFY(std::abs(translated[i].azimuth() - c.azimuth()) < 1.0e-4f);
+        QVERIFY(std::abs(translated[i].polar() - c.polar()) < 1.0e-4f);
+        QVERIFY(std::abs(translated[i].dist() - (c.dist() - float(nDotT))) < 1.0e-3f);
+    }
+
+    // OpenCL implementation (Euclidian transform)
+    const auto rotation = mat::rotationMatrix(mat::Matrix<3, 1>{ 0.1, -0.2, 0.05 });
+    const OCL::Radon3DCoordTransform transfOCL(coords);
+    const auto transformedCPU = transfCPU.transformedCoords(rotation, translation);
+    const auto transformedOCL = transfOCL.transformedCoords(rotation, translation);
+    for(size_t i = 0; i < coords.size(); ++i)
+    {
+        const auto& cpu = transformedCPU[i];
+        const auto& ocl = transformedOCL[i];
+        QVERIFY(std::abs(cpu.polar() - ocl.polar()) < 1.0e-3f);
+        QVERIFY(std::abs(cpu.dist() - ocl.dist()) < 1.0e-3f);
+        // azimuth is ill-conditioned at the poles and wraps around at +-pi
+        if(std::sin(cpu.polar()) > 0.1f)
+            QVERIFY(std::abs(std::remainder(cpu.azimuth() - ocl.azimuth(), 2.0f * float(PI)))
+                    < 1.0e-3f);
+    }
+
+    // serial evaluation within a thread budget of one thread
+    {
+        ThreadBudget budget(1);
+        const auto serial = transfCPU.transformedCoords(rotation, translation);
+        for(size_t i = 0; i < coords.size(); ++i)
+            QVERIFY(serial[i].data[0] == transformedCPU[i].data[0] &&
+                    serial[i].data[1] == transformedCPU[i].data[1] &&
+                    serial[i].data[2] == transformedCPU[i].data[2]);
+    }
+}
+
+void ConsistencyTest::testIntermedGen2D3DCPU()
+{
+    const VolumeResamplerCPU samplerCPU(_radon3dDiff, PHI_RANGE, THETA_RANGE, DIST_RANGE);
+    const OCL::VolumeResampler samplerOCL(_radon3dDiff, PHI_RANGE, THETA_RANGE, DIST_RANGE);
+
+    IntermedGen2D3DCPU genCPU;
+    const auto pairCPU = genCPU.intermedFctPair(_projection, _pMat, samplerCPU);
+    QVERIFY(!pairCPU.isEmpty());
+    QCOMPARE(pairCPU.first().size(), genCPU.lastSampling().size());
+    QCOMPARE(pairCPU.second().size(), genCPU.lastSampling().size());
+
+    // same planes as the OpenCL implementation
+    OCL::IntermedGen2D3D genOCL;
+    const auto pairOCL = genOCL.intermedFctPair(_projection, _pMat, samplerOCL);
+    QCOMPARE(genCPU.lastSampling().size(), genOCL.lastSampling().size());
+    for(size_t i = 0; i < genCPU.lastSampling().size(); ++i)
+    {
+        QVERIFY(std::abs(genCPU.lastSampling()[i].polar() - genOCL.lastSampling()[i].polar())
+                < 1.0e-3f);
+        QVERIFY(std::abs(genCPU.lastSampling()[i].dist() - genOCL.lastSampling()[i].dist())
+                < 1.0e-3f);
+    }
+
+    // intermediate functions of projection and volume agree with the OpenCL implementation
+    QVERIFY(relativeDifference(pairCPU.first(), pairOCL.first()) < 0.05);
+    QVERIFY(relativeDifference(pairCPU.second(), pairOCL.second()) < 0.05);
+
+    // consistent pose is more consistent than an inconsistent one
+    const auto translation = mat::Homography3D(SHIFT);
+    const Radon3DCoordTransformCPU transf(genCPU.lastSampling());
+    const IntermediateFctPair posedPair(pairCPU.ptrToFirst(),
+                                        transf.sampleTransformed(translation, samplerCPU),
+                                        IntermediateFctPair::VolumeDomain);
+    QVERIFY(posedPair.inconsistency() < pairCPU.inconsistency());
+
+    // subsampling
+    genCPU.setSubsampleLevel(0.25f);
+    const auto subsampledPair = genCPU.intermedFctPair(_projection, _pMat, samplerCPU);
+    QCOMPARE(subsampledPair.first().size(), genCPU.lastSampling().size());
+    QVERIFY(subsampledPair.first().size() < pairCPU.first().size());
+}
+
+void ConsistencyTest::testInconsistencyMatrix()
+{
+    CTSystem theSystem;
+    theSystem << new FlatPanelDetector(QSize(64, 64), QSizeF(2.0, 2.0))
+              << new CarmGantry(1200.0) << new XrayTube(80.0, 1.0);
+
+    AcquisitionSetup setup(theSystem);
+    setup.setNbViews(5);
+    setup.applyPreparationProtocol(protocols::ShortScanTrajectory(750.0));
+
+    RayCasterProjectorCPU projector;
+    projector.configure(setup);
+    const auto projData = projector.project(phantom({ 0.0f, 0.0f, 0.0f }));
+    const auto geometry = GeometryEncoder::encodeFullGeometry(setup);
+
+    std::vector<Chunk2D<float>> projs;
+    std::vector<mat::ProjectionMatrix> Ps;
+    for(uint v = 0; v < setup.nbViews(); ++v)
+    {
+        projs.push_back(projData.view(v).module(0));
+        Ps.push_back(geometry.view(v).module(0));
+    }
+    const auto projSize = projs.front().dimensions();
+
+    // sparse pair graph (incl. a pair with descending view indices)
+    const OCL::IntermedGen2D2D::PairGraph pairs{ { 0, 1 }, { 0, 3 }, { 2, 4 }, { 1, 4 }, { 3, 2 } };
+    auto isInGraph = [&pairs](uint i, uint j)
+    {
+        return std::find(pairs.cbegin(), pairs.cend(), std::make_pair(i, j)) != pairs.cend();
+    };
+
+    OCL::IntermedGen2D2D gen;
+    const auto samplers = OCL::IntermedGen2D2D::precomputedSamplers(projs, Ps);
+    const auto matrix = gen.inconsistencyMatrix(projs, Ps, pairs);
+    QCOMPARE(matrix.width(), 5u);
+    QCOMPARE(matrix.height(), 5u);
+
+    // values of the pairs in the graph; NaN for all other pairs
+    for(uint i = 0; i < 5; ++i)
+        for(uint j = 0; j < 5; ++j)
+        {
+            if(isInGraph(i, j))
+            {
+                const auto pair = gen.intermedFctPair(samplers[i], Ps[i], samplers[j], Ps[j],
+                                                      projSize);
+                QVERIFY(!std::isnan(matrix(j, i)));
+                QCOMPARE(matrix(j, i), pair.inconsistency(metric::L2));
+            }
+            else
+                QVERIFY(std::isnan(matrix(j, i)));
+        }
+
+    // precomputed version
+    const auto matrixPrecomp = gen.inconsistencyMatrix(samplers, Ps, projSize, pairs);
+    for(uint i = 0; i < 5; ++i)
+        for(uint j = 0; j < 5; ++j)
+            if(isInGraph(i, j))
+                QCOMPARE(matrixPrecomp(j, i), matrix(j, i));
+
+    // memory limit for two samplers per block (three blocks) yields the same result
+    const auto bytesPerSampler = size_t(samplers.front().imgDim().width)
+                                 * samplers.front().imgDim().height * sizeof(float);
+    gen.setSamplerMemoryLimit(4 * bytesPerSampler);
+    const auto matrixBlocked = gen.inconsistencyMatrix(projs, Ps, pairs);
+    for(uint i = 0; i < 5; ++i)
+        for(uint j = 0; j < 5; ++j)
+            if(isInGraph(i, j))
+                QCOMPARE(matrixBlocked(j, i), matrix(j, i));
+            else
+                QVERIFY(std::isnan(matrixBlocked(j, i)));
+
+    // all pairs
+    gen.setSamplerMemoryLimit(0);
+    const auto matrixAll = gen.inconsistencyMatrix(projs, Ps);
+    for(uint i = 0; i < 5; ++i)
+        for(uint j = 0; j < 5; ++j)
+            QCOMPARE(std::isnan(matrixAll(j, i)), i >= j);
+
+    // error paths
+    const OCL::IntermedGen2D2D::PairGraph invalidPairs{ { 0, 1 }, { 2, 5 } };
+    QVERIFY_EXCEPTION_THROWN(gen.inconsistencyMatrix(projs, Ps, invalidPairs), std::runtime_error);
+    QVERIFY_EXCEPTION_THROWN(gen.inconsistencyMatrix(samplers, Ps, projSize, invalidPairs),
+                             std::runtime_error);
+    auto tooFewPs = Ps;
+    tooFewPs.pop_back();
+    QVERIFY_EXCEPTION_THROWN(gen.inconsistencyMatrix(projs, tooFewPs, pairs), std::runtime_error);
+    QVERIFY_EXCEPTION_THROWN(gen.inconsistencyMatrix(samplers, tooFewPs, projSize, pairs),
+                             std::runtime_error);
+    auto mismatchingProjs = projs;
+    mismatchingProjs.back() = Chunk2D<float>(32, 32, 0.0f);
+    QVERIFY_EXCEPTION_THROWN(gen.inconsistencyMatrix(mismatchingProjs, Ps, pairs),
+                             std::runtime_error);
+}
+
+void ConsistencyTest::testRegistration()
+{
+#ifdef GRANGEAT_2D3D_REGIST_MODULE_AVAILABLE
+    const OCL::VolumeResampler oclSampler(_radon3dDiff, PHI_RANGE, THETA_RANGE, DIST_RANGE);
+    const VolumeResamplerCPU cpuSampler(_radon3dDiff, PHI_RANGE, THETA_RANGE, DIST_RANGE);
+
+    NLOPT::GrangeatRegistration2D3D reg;
+    reg.optObject().set_initial_step(1.0);
+    reg.optObject().set_xtol_abs(0.01);
+    reg.optObject().set_maxeval(500);
+    reg.optObject().set_lower_bounds(-10.0);
+    reg.optObject().set_upper_bounds(10.0);
+    reg.setSubSamplingLevel(0.25f);
+    reg.setNbStarts(3);
+    reg.setStartSpread(2.0);
+
+    // the translation is recovered (except for the component along the principal ray, which is
+    // hardly observable in a single projection)
+    const auto principalRay = _pMat.principalRayDirection().normalized();
+    auto verifyPose = [&principalRay](const mat::Homography3D& H)
+    {
+        const mat::Matrix<3, 1> translation{ H.get<0, 3>(), H.get<1, 3>(), H.get<2, 3>() };
+        auto error = translation - SHIFT;
+        const double errorAlongRay = principalRay.transposed() * error;
+        error -= errorAlongRay * principalRay;
+        QVERIFY(error.norm() < 1.0);
+    };
+
+    // concurrent starts (each with own OpenCL resources) yield the result of a serial evaluation
+    reg.setNbThreads(3);
+    const auto oclParallel = reg.optimize(_projection, oclSampler, _pMat);
+    reg.setNbThreads(1);
+    const auto oclSerial = reg.optimize(_projection, oclSampler, _pMat);
+    QVERIFY(std::equal(oclParallel.begin(), oclParallel.end(), oclSerial.begin()));
+    verifyPose(oclParallel);
+
+    // CPU implementation of the consistency chain
+    reg.setNbThreads(3);
+    verifyPose(reg.optimize(_projection, cpuSampler, _pMat));
+
+    // batch registration of several frames (concurrent frames)
+    const auto batch = reg.optimize(std::vector<Chunk2D<float>>(2, _projection), oclSampler,
+                                    std::vector<mat::ProjectionMatrix>(2, _pMat));
+    QCOMPARE(batch.size(), size_t(2));
+    QVERIFY(std::equal(batch[0].begin(), batch[0].end(), batch[1].begin()));
+    verifyPose(batch[0]);
+#else
+    QSKIP("Grangeat 2D/3D registration module (NLopt) not available");
+#endif
+}
+
+// asymmetric phantom (ball with an eccentric insert) centered at `offset`
+VoxelVolume<float> ConsistencyTest::phantom(const VoxelVolume<float>::Offset& offset)
+{
+    constexpr uint nbVox = 32;
+    constexpr float voxSize = 2.0f;
+
+    VoxelVolume<float> ret(nbVox, nbVox, nbVox, voxSize, voxSize, voxSize);
+    ret.setVolumeOffset(offset);
+    ret.allocateMemory();
+
+    const auto center = 0.5f * float(nbVox - 1);
+    for(uint z = 0; z < nbVox; ++z)
+        for(uint y = 0; y < nbVox; ++y)
+            for(uint x = 0; x < nbVox; ++x)
+            {
+                const auto posX = (float(x) - center) * voxSize;
+                const auto posY = (float(y) - center) * voxSize;
+                const auto posZ = (float(z) - center) * voxSize;
+
+                auto value = 0.0f;
+                if(posX * posX + posY * posY + posZ * posZ < 25.0f * 25.0f)
+                    value = 0.02f;
+                if(std::abs(posX - 10.0f) < 6.0f && std::abs(posY + 5.0f) < 4.0f &&
+                   std::abs(posZ - 8.0f) < 5.0f)
+                    value = 0.05f;
+
+                ret(x, y, z) = value;
+            }
+
+    return ret;
+}
+
+namespace {
+
+// returns ||values - reference|| / ||reference|| (L2 norm)
+double relativeDifference(const std::vector<float>& values, const std::vector<float>& reference)
+{
+    Q_ASSERT(values.size() == reference.size());
+    double diffSq = 0.0, refSq = 0.0;
+    for(size_t i = 0; i < values.size(); ++i)
+    {
+        const auto diff = double(values[i]) - double(reference[i]);
+        diffSq += diff * diff;
+        refSq += double(reference[i]) * double(reference[i]);
+    }
+
+    return std::sqrt(diffSq / refSq);
+}
+
+} // unnamed namespace
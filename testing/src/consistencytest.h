@@ -0,0 +1,37 @@
+#ifndef CONSISTENCYTEST_H
+#define CONSISTENCYTEST_H
+
+#include "img/chunk2d.h"
+#include "img/voxelvolume.h"
+#include "mat/projectionmatrix.h"
+
+#include <QtTest>
+
+class ConsistencyTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    ConsistencyTest() = default;
+
+private Q_SLOTS:
+    void initTestCase();
+    void testRadonTransform2DCPU();
+    void testVolumeResamplerCPU();
+    void testRadon3DCoordTransformCPU();
+    void testIntermedGen2D3DCPU();
+    void testInconsistencyMatrix();
+    void testRegistration();
+
+private:
+    // projection of the phantom with a known pose
+    CTL::Chunk2D<float> _projection = CTL::Chunk2D<float>(0, 0);
+    CTL::mat::ProjectionMatrix _pMat;
+    // derivative of the 3D Radon transform of the phantom in its reference pose
+    CTL::VoxelVolume<float> _radon3dDiff = CTL::VoxelVolume<float>(0, 0, 0);
+
+    // helper methods
+    static CTL::VoxelVolume<float> phantom(const CTL::VoxelVolume<float>::Offset& offset);
+};
+
+#endif // CONSISTENCYTEST_H
@@ -4,6 +4,10 @@
 #include "img/voxelvolume.h"
 #include "img/projectiondata.h"
 #include "img/compositevolume.h"
+#include "img/elementwise.h"
+#include "img/reduction.h"
+#include "models/detectorsaturationmodels.h"
+#include "models/lookuptablemodel.h"
 #include "models/tabulateddatamodel.h"
 
 using namespace CTL;
@@ -56,6 +60,47 @@ void DataTypeTest::testChunkMemAlloc()
     QCOMPARE(preallocChunk.allocatedElements(), size_t(100));
 }
 
+void DataTypeTest::testBufferPool()
+{
+    QCOMPARE(BufferPool<double>::sizeClass(100), size_t(104));
+    QCOMPARE(BufferPool<double>::sizeClass(104), size_t(104));
+
+    auto& pool = BufferPool<double>::instance();
+    pool.clear();
+    pool.setEnabled(true);
+    pool.resetStatistics();
+
+    // repeated allocation of same-sized data
+    for(auto rep = 0; rep < 5; ++rep)
+    {
+        VoxelVolume<double> volume(32, 32, 32);
+        volume.allocateMemory();
+        QCOMPARE(volume(1, 2, 3), 0.0);
+
+        volume.fill(2.0);
+        const auto sum = volume + volume;
+        QCOMPARE(sum(1, 2, 3), 4.0);
+
+        Chunk2D<double> chunk(64, 64, 1.0);
+        auto copy = chunk;
+        QCOMPARE(copy(10, 10), 1.0);
+    }
+
+    const auto stats = pool.statistics();
+    QCOMPARE(stats.nbRequests, size_t(20));
+    QCOMPARE(stats.nbMisses, size_t(4)); // only during first repetition
+    QCOMPARE(stats.nbHits, size_t(16));
+    QVERIFY(stats.pooledBytes > 0);
+
+    // disabled pool frees memory as usual
+    pool.setEnabled(false);
+    pool.clear();
+    {
+        Chunk2D<double> chunk(64, 64, 1.0);
+    }
+    QCOMPARE(pool.statistics().pooledBytes, size_t(0));
+}
+
 void DataTypeTest::testSetData()
 {
     Chunk2D<float> testChunk(10,10);
@@ -330,6 +375,97 @@ void DataTypeTest::testVoxelOperations()
 
 }
 
+void DataTypeTest::testElementwise()
+{
+    VoxelVolume<float> x(100, 100, 100, 1.0f, 2.0f, 3.0f);
+    x.fill(1.0f);
+    x.setVolumeOffset(0.0f, 0.0f, 5.0f);
+    VoxelVolume<float> y(100, 100, 100);
+    y.fill(2.0f);
+
+    // fused evaluation of several sources
+    const auto res = elementwise::transformed(
+        [](float xi, float yi) { return 2.0f * xi + 0.5f * yi; }, x, y);
+    QCOMPARE(res.totalVoxelCount(), x.totalVoxelCount());
+    QCOMPARE(res.voxelSize().z, 3.0f);
+    QCOMPARE(res.offset().z, 5.0f);
+    QCOMPARE(res.min(), 3.0f);
+    QCOMPARE(res.max(), 3.0f);
+
+    // result type follows the function
+    const auto resDouble = elementwise::transformed([](float xi) { return double(xi) / 4.0; }, x);
+    QCOMPARE(resDouble(99, 99, 99), 0.25);
+
+    // in-place operation
+    elementwise::apply(x, [](float xi) { return xi - 3.0f; });
+    QCOMPARE(x(42, 0, 7), -2.0f);
+
+    // dimension mismatch
+    VoxelVolume<float> small(10, 10, 10);
+    QVERIFY_EXCEPTION_THROWN(elementwise::transform(small, [](float xi) { return xi; }, x),
+                             std::domain_error);
+
+    // projection data (several views and modules)
+    ProjectionData proj(10, 20, 3);
+    proj.allocateMemory(50, 1.0f);
+    ProjectionData weights(10, 20, 3);
+    weights.allocateMemory(50, 4.0f);
+    elementwise::transform(proj, [](float p, float w) { return p * w + 1.0f; }, proj, weights);
+    QCOMPARE(proj.view(49).module(2)(9, 19), 5.0f);
+    QCOMPARE(proj.min(), 5.0f);
+
+    weights.allocateMemory(49);
+    QVERIFY_EXCEPTION_THROWN(
+        elementwise::transform(proj, [](float p, float w) { return p * w; }, proj, weights),
+        std::domain_error);
+}
+
+void DataTypeTest::testReduction()
+{
+    // values 0, 1, ..., 999999
+    VoxelVolume<float> volume(100, 100, 100);
+    volume.allocateMemory();
+    for(size_t i = 0; i < volume.totalVoxelCount(); ++i)
+        volume.data()[i] = float(i);
+
+    const auto stats = reduction::statistics(volume);
+    QCOMPARE(stats.nbElements, size_t(1000000));
+    QCOMPARE(stats.min, 0.0);
+    QCOMPARE(stats.max, 999999.0);
+    QVERIFY(qFuzzyCompare(stats.mean, 499999.5));
+    QVERIFY(qFuzzyCompare(stats.variance, (1.0e12 - 1.0) / 12.0));
+    QCOMPARE(volume.max(), 999999.0f);
+
+    QCOMPARE(reduction::percentile(volume, 0.0), 0.0);
+    QCOMPARE(reduction::percentile(volume, 50.0), 500000.0); // rank round(499999.5)
+    QCOMPARE(reduction::percentile(volume, 100.0), 999999.0);
+
+    const auto hist = reduction::histogram(volume, 10, 0.0, 1000000.0);
+    QCOMPARE(hist.size(), size_t(10));
+    QCOMPARE(hist[0], size_t(100000));
+    QCOMPARE(hist[9], size_t(100000));
+
+    // caching and invalidation on mutation
+    QCOMPARE(reduction::cachedStatistics(volume).max, 999999.0);
+    volume(0, 0, 0) = 2.0e6f;
+    QCOMPARE(reduction::cachedStatistics(volume).max, 2.0e6);
+    volume *= 0.5f;
+    QCOMPARE(reduction::cachedStatistics(volume).max, 1.0e6);
+
+    // projection data (per-module caches)
+    ProjectionData proj(10, 20, 2);
+    proj.allocateMemory(100, 1.0f);
+    proj.view(42).module(1)(3, 4) = -5.0f;
+    QCOMPARE(proj.min(), -5.0f);
+    const auto projStats = reduction::cachedStatistics(proj);
+    QCOMPARE(projStats.nbElements, size_t(40000));
+    QCOMPARE(projStats.min, -5.0);
+    QVERIFY(qFuzzyCompare(projStats.mean, (39999.0 - 5.0) / 40000.0));
+    proj.view(7).module(0)(0, 0) = 10.0f;
+    QCOMPARE(reduction::cachedStatistics(proj).max, 10.0);
+    QCOMPARE(reduction::percentile(proj, 0.0), -5.0);
+}
+
 void DataTypeTest::testProjectionData()
 {
     SingleViewData::Dimensions svDim = { 10, 10, 5 };
@@ -397,3 +533,70 @@ void DataTypeTest::testCompositeVolume()
     QCOMPARE(compositeVol.muVolume(0, 1.5f, 1.0f)->max(), 0.15f);
     QCOMPARE(compositeVol.muVolume(1, 1.5f, 1.0f)->max(), 0.30f);
 }
+
+void DataTypeTest::testTabulatedDataModel()
+{
+    TabulatedDataModel model(QVector<float>{ 1.0f, 2.0f, 4.0f }, QVector<float>{ 1.0f, 3.0f, 3.0f });
+
+    // interpolation, tabulated keys and outside range
+    QCOMPARE(model.valueAt(1.5f), 2.0f);
+    QCOMPARE(model.valueAt(2.0f), 3.0f);
+    QCOMPARE(model.valueAt(4.0f), 3.0f);
+    QCOMPARE(model.valueAt(0.5f), 0.0f);
+    QCOMPARE(model.valueAt(4.5f), 0.0f);
+
+    // bin integrals: within one segment, over several segments and outside range
+    QCOMPARE(model.binIntegral(1.5f, 0.5f), 1.0f);
+    QCOMPARE(model.binIntegral(2.5f, 3.0f), 8.0f);
+    QCOMPARE(model.binIntegral(10.0f, 1.0f), 0.0f);
+
+    // batch evaluation
+    const std::vector<float> positions{ 0.5f, 1.0f, 1.5f, 3.0f, 1.5f, 5.0f };
+    std::vector<float> values(positions.size());
+    model.valuesAt(positions.data(), values.data(), positions.size());
+    for(size_t i = 0; i < positions.size(); ++i)
+        QCOMPARE(values[i], model.valueAt(positions[i]));
+
+    // changes of the data invalidate the compiled table (also for copies)
+    const auto copy = model;
+    model.insertDataPoint(1.5f, 5.0f);
+    QCOMPARE(model.valueAt(1.5f), 5.0f);
+    QCOMPARE(copy.valueAt(1.5f), 2.0f);
+    model.setData(QVector<float>{ 0.0f, 1.0f }, QVector<float>{ 0.0f, 2.0f });
+    QCOMPARE(model.valueAt(0.5f), 1.0f);
+    QCOMPARE(model.binIntegral(0.5f, 1.0f), 1.0f);
+}
+
+void DataTypeTest::testDataModelBatchEvaluation()
+{
+    std::vector<float> positions;
+    for(int i = -40; i <= 140; ++i)
+        positions.push_back(0.1f * float(i));
+    std::vector<float> values(positions.size());
+
+    auto compareToSingleEvaluation = [&](const AbstractDataModel& model)
+    {
+        model.valuesAt(positions.data(), values.data(), positions.size());
+        for(size_t i = 0; i < positions.size(); ++i)
+            QCOMPARE(values[i], model.valueAt(positions[i]));
+    };
+
+    compareToSingleEvaluation(DetectorSaturationLinearModel(2.0f, 8.0f));
+    compareToSingleEvaluation(DetectorSaturationSplineModel(2.0f, 8.0f, 0.5f, 2.0f));
+    compareToSingleEvaluation(DetectorSaturationSplineModel(2.0f, 8.0f));
+
+    // in-place evaluation
+    const DetectorSaturationSplineModel spline(2.0f, 8.0f, 0.5f, 2.0f);
+    values = positions;
+    spline.valuesAt(values.data(), values.data(), values.size());
+    for(size_t i = 0; i < positions.size(); ++i)
+        QCOMPARE(values[i], spline.valueAt(positions[i]));
+
+    // lookup table: interpolation within range, wrapped model outside
+    const LookupTableModel lut(spline, 0.0f, 10.0f, 1001);
+    compareToSingleEvaluation(lut);
+    QCOMPARE(lut.valueAt(-2.0f), spline.valueAt(-2.0f));
+    QCOMPARE(lut.valueAt(12.0f), spline.valueAt(12.0f));
+    QVERIFY(std::abs(lut.valueAt(6.55f) - spline.valueAt(6.55f)) < 1.0e-4f);
+    QVERIFY_EXCEPTION_THROWN(LookupTableModel(spline, 1.0f, 1.0f), std::domain_error);
+}
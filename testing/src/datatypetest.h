@@ -12,6 +12,7 @@ public:
 private Q_SLOTS:
     void testChunkOperations();
     void testChunkMemAlloc();
+    void testBufferPool();
     void testSetData();
     void testVoxelVolume();
     void testVoxelSlicing();
@@ -20,8 +21,12 @@ private Q_SLOTS:
     void testVoxelSizeChecks();
     void testVoxelMinMax();
     void testVoxelOperations();
+    void testElementwise();
+    void testReduction();
     void testProjectionData();
     void testCompositeVolume();
+    void testTabulatedDataModel();
+    void testDataModelBatchEvaluation();
 };
 
 #endif // DATATYPETEST_H
@@ -6,6 +6,7 @@
 #include "components/allcomponents.h"
 
 #include "acquisition/ctsystem.h"
+#include "acquisition/preparesteps.h"
 #include "acquisition/trajectories.h"
 
 #include "io/basetypeio.h"
@@ -55,6 +56,48 @@ void GeometryTest::testGeometryEncoder()
     verifyPmatDiff(loadedCarmGeo, geo);
 }
 
+void GeometryTest::testParallelGeometryEncoder()
+{
+    AcquisitionSetup setup(*_tubeTestSystem);
+    setup.setNbViews(200);
+    setup.applyPreparationProtocol(protocols::HelicalTrajectory(1.8_deg, 0.5));
+
+    // views prepared by table rows only are processed in parallel
+    const auto sequentialHelix = GeometryEncoder::encodeFullGeometry(setup, 1);
+    const auto parallelHelix = GeometryEncoder::encodeFullGeometry(setup, 7);
+    QCOMPARE(parallelHelix.length(), sequentialHelix.length());
+    verifyPmatDiff(parallelHelix, sequentialHelix);
+
+    auto helixSetup = setup;
+    helixSetup.forEachView([](const SimpleCTSystem&, uint) {}, 7);
+    FullGeometry helixFinalState, helixLastView;
+    helixFinalState.append(GeometryEncoder::encodeSingleViewGeometry(*helixSetup.system()));
+    helixLastView.append(sequentialHelix.at(sequentialHelix.length() - 1));
+    verifyPmatDiff(helixFinalState, helixLastView);
+
+    // incremental prepare steps: state of a view depends on all preceding views
+    for(auto view = 0u; view < setup.nbViews(); ++view)
+    {
+        auto displacement = std::make_shared<prepare::GantryDisplacementParam>();
+        displacement->incrementDetectorDisplacement(mat::Location({ 0.1, 0.0, 0.05 }, mat::eye<3>()));
+        setup.view(view).addPrepareStep(displacement);
+    }
+
+    const auto sequentialGeo = GeometryEncoder::encodeFullGeometry(setup, 1);
+    const auto parallelGeo = GeometryEncoder::encodeFullGeometry(setup, 7);
+
+    QCOMPARE(parallelGeo.length(), sequentialGeo.length());
+    verifyPmatDiff(parallelGeo, sequentialGeo);
+
+    // the system of the setup ends up in the state of the last view (sequential fallback)
+    auto parallelSetup = setup;
+    parallelSetup.forEachView([](const SimpleCTSystem&, uint) {}, 7);
+    FullGeometry finalState, lastView;
+    finalState.append(GeometryEncoder::encodeSingleViewGeometry(*parallelSetup.system()));
+    lastView.append(sequentialGeo.at(sequentialGeo.length() - 1));
+    verifyPmatDiff(finalState, lastView);
+}
+
 void GeometryTest::testDecoderEncoderConsistency()
 {
     // define a random projection matrix
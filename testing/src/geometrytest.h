@@ -19,6 +19,7 @@ private Q_SLOTS:
     void initTestCase();
     void testGeometryDecoder();
     void testGeometryEncoder();
+    void testParallelGeometryEncoder();
     void testDecoderEncoderConsistency();
     void cleanupTestCase();
 
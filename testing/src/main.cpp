@@ -9,6 +9,7 @@
 #include "projectortest.h"
 #include "spectrumtest.h"
 #include "acquisitionsetuptest.h"
+#include "consistencytest.h"
 
 int main(int argc, char* argv[])
 {
@@ -33,6 +34,7 @@ int main(int argc, char* argv[])
     ProjectorTest projectorTest;
     SpectrumTest spectrumTest;
     AcquisitionSetupTest acqSetupTest;
+    ConsistencyTest consistencyTest;
 
     int failedTests = 0;
     failedTests += QTest::qExec(&pMat, argc, argv);
@@ -44,6 +46,7 @@ int main(int argc, char* argv[])
     failedTests += QTest::qExec(&projectorTest, argc, argv);
     failedTests += QTest::qExec(&spectrumTest, argc, argv);
     failedTests += QTest::qExec(&acqSetupTest, argc, argv);
+    failedTests += QTest::qExec(&consistencyTest, argc, argv);
 
     if(failedTests)
         std::cout << "\n ##### Total number of failed tests: " << failedTests << " #####" << std::endl;
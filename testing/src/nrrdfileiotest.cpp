@@ -1,5 +1,6 @@
 #include "nrrdfileiotest.h"
 #include "io/nrrd/nrrdfileio.h"
+#include <cmath>
 
 typedef CTL::io::BaseTypeIO<CTL::io::NrrdFileIO> IOtype;
 
@@ -58,6 +59,161 @@ void NrrdFileIOtest::testHeaderProperties()
     QCOMPARE(headerSize, 118);
 }
 
+void NrrdFileIOtest::testGzipEncoding()
+{
+    using namespace CTL;
+    if(!io::NrrdFileIO::isGzipSupported())
+        QSKIP("gzip encoding not available (built without zlib)");
+
+    std::vector<float> data(20 * 10 * 15);
+    for(size_t i = 0; i < data.size(); ++i)
+        data[i] = std::sin(0.01f * float(i));
+    const VoxelVolume<float> vol(20, 10, 15, std::move(data));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    IOtype io;
+    for(const auto& encoding : { io::meta_info::encoding_type::gzip,
+                                 io::meta_info::encoding_type::gzipBlocks })
+    {
+        const auto fileName = dir.filePath("vol_" + encoding + ".nrrd");
+        QVERIFY(io.write(vol, fileName, { { io::meta_info::encoding, encoding } }));
+
+        // the file is gzip encoded (the block layout is stored as standard gzip stream)
+        QCOMPARE(io.metaInfo(fileName).value(io::meta_info::encoding).toString(),
+                 io::meta_info::encoding_type::gzip);
+        QCOMPARE(io.metaInfo(fileName).contains("ctl gzip block sizes"),
+                 encoding == io::meta_info::encoding_type::gzipBlocks);
+
+        // entire volume and individual slices
+        QVERIFY(io.readVolume<float>(fileName).constData() == vol.constData());
+        for(const auto slice : { 0u, 7u, 14u })
+            QVERIFY(io.readSlice<float>(fileName, slice).constData() ==
+                    vol.sliceZ(slice).constData());
+    }
+}
+
+void NrrdFileIOtest::testPrefetchingReader()
+{
+    using namespace CTL;
+
+    std::vector<float> data(8 * 6 * 20);
+    for(size_t i = 0; i < data.size(); ++i)
+        data[i] = float(i);
+    const VoxelVolume<float> vol(8, 6, 20, std::move(data));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    IOtype io;
+    for(const auto& encoding : { io::meta_info::encoding_type::raw,
+                                 io::meta_info::encoding_type::gzipBlocks })
+    {
+        if(encoding != io::meta_info::encoding_type::raw && !io::NrrdFileIO::isGzipSupported())
+            continue;
+        const auto fileName = dir.filePath("vol_" + encoding + ".nrrd");
+        QVERIFY(io.write(vol, fileName, { { io::meta_info::encoding, encoding } }));
+
+        auto reader = IOtype::makePrefetchingReader<float>(fileName, 3);
+        QCOMPARE(reader->nbChunks(), 20u);
+
+        // sequential access
+        for(uint slice = 0; slice < 20u; ++slice)
+            QVERIFY(reader->readSlice(slice).constData() == vol.sliceZ(slice).constData());
+
+        // non-sequential access
+        for(const auto slice : { 13u, 2u, 2u, 19u, 0u })
+            QVERIFY(reader->readSlice(slice).constData() == vol.sliceZ(slice).constData());
+
+        QVERIFY_EXCEPTION_THROWN(reader->readSlice(20), std::runtime_error);
+    }
+}
+
+void NrrdFileIOtest::testParallelWriter()
+{
+    using namespace CTL;
+
+    auto fileContent = [](const QString& fileName) {
+        QFile file(fileName);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    };
+
+    std::vector<float> data(8 * 6 * 20);
+    for(size_t i = 0; i < data.size(); ++i)
+        data[i] = float(i);
+    VoxelVolume<float> vol(8, 6, 20, std::move(data));
+    vol.setVoxelSize(0.5f, 0.5f, 1.0f);
+
+    ProjectionData projs(7, 5, 3);
+    projs.allocateMemory(10);
+    for(uint view = 0; view < 10u; ++view)
+        for(uint mod = 0; mod < 3u; ++mod)
+            projs.view(view).module(mod).fill(float(mod + 3 * view));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // volume that spans several blocks, whose size is not a multiple of the block size
+    std::vector<float> bigData(61 * 47 * 33);
+    for(size_t i = 0; i < bigData.size(); ++i)
+        bigData[i] = float(i);
+    const VoxelVolume<float> bigVol(61, 47, 33, std::move(bigData));
+
+    IOtype io;
+    QVERIFY(io.write(vol, dir.filePath("vol.nrrd")));
+    QVERIFY(io.write(projs, dir.filePath("projs.nrrd")));
+    QVERIFY(io.write(bigVol, dir.filePath("bigVol.nrrd")));
+
+    // identical files (independent of the number of threads and direct I/O); a minimum of one
+    // block per thread splits the files into several regions (incl. an unaligned last region)
+    for(const auto directIO : { false, true })
+        for(const auto nbThreads : { 1u, 3u })
+        {
+            io::RawFileWriter writer(nbThreads, directIO);
+            writer.setMinNbBytesPerThread(io::RawFileWriter::blockSize());
+            QCOMPARE(writer.minNbBytesPerThread(), io::RawFileWriter::blockSize());
+            QVERIFY(io.writeParallel(vol, dir.filePath("volPar.nrrd"), {}, writer));
+            QVERIFY(io.writeParallel(projs, dir.filePath("projsPar.nrrd"), {}, writer));
+            QVERIFY(io.writeParallel(bigVol, dir.filePath("bigVolPar.nrrd"), {}, writer));
+            QCOMPARE(fileContent(dir.filePath("volPar.nrrd")), fileContent(dir.filePath("vol.nrrd")));
+            QCOMPARE(fileContent(dir.filePath("projsPar.nrrd")),
+                     fileContent(dir.filePath("projs.nrrd")));
+            QCOMPARE(fileContent(dir.filePath("bigVolPar.nrrd")),
+                     fileContent(dir.filePath("bigVol.nrrd")));
+        }
+
+    // fallback for compressed data
+    if(io::NrrdFileIO::isGzipSupported())
+    {
+        QVERIFY(io.writeParallel(vol, dir.filePath("volGz.nrrd"),
+                                 { { io::meta_info::encoding,
+                                     io::meta_info::encoding_type::gzip } }));
+        QVERIFY(io.readVolume<float>(dir.filePath("volGz.nrrd")).constData() == vol.constData());
+    }
+
+    // sharded projection data
+    const auto shards = io.writeSharded(projs, dir.filePath("projs.nrrd"), 4);
+    QCOMPARE(shards, QStringList({ dir.filePath("projs_0000.nrrd"), dir.filePath("projs_0001.nrrd"),
+                                   dir.filePath("projs_0002.nrrd") }));
+
+    const std::vector<uint> nbViews{ 4, 4, 2 };
+    for(uint shard = 0; shard < 3u; ++shard)
+    {
+        QCOMPARE(io.metaInfo(shards.at(shard)).value(io::meta_info::firstView).toUInt(), 4 * shard);
+
+        const auto shardProjs = io.readProjections(shards.at(shard));
+        QCOMPARE(shardProjs.nbViews(), nbViews[shard]);
+        for(uint view = 0; view < nbViews[shard]; ++view)
+            for(uint mod = 0; mod < 3u; ++mod)
+                QVERIFY(shardProjs.view(view).module(mod).constData()
+                        == projs.view(4 * shard + view).module(mod).constData());
+    }
+
+    QVERIFY_EXCEPTION_THROWN(io.writeSharded(projs, dir.filePath("projs.nrrd"), 0),
+                             std::domain_error);
+}
+
 /*
 void NrrdFileIOtest::initTestCase()
 {
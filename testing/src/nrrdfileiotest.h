@@ -18,6 +18,9 @@ private Q_SLOTS:
     void testMetaInfo();
     void testFields();
     void testHeaderProperties();
+    void testGzipEncoding();
+    void testPrefetchingReader();
+    void testParallelWriter();
 
 private:
 
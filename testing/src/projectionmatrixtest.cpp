@@ -1,6 +1,7 @@
 #include "projectionmatrixtest.h"
 #include "mat/mat.h"
 #include "img/voxelvolume.h"
+#include "acquisition/viewgeometry.h"
 
 using namespace CTL::mat;
 
@@ -171,6 +172,44 @@ void ProjectionMatrixTest::comparatorTest()
     QCOMPARE(compare(P3, P4).meanError, 42.0);
 }
 
+void ProjectionMatrixTest::batchComparatorTest()
+{
+    CTL::FullGeometry geo1, geo2;
+    for(uint view = 0; view < 20; ++view)
+    {
+        auto P1 = P;
+        P1.shiftDetectorOrigin(double(view), 2.0);
+        auto P2 = P1;
+        P2.shiftDetectorOrigin(0.1 * double(view % 5), 0.0);
+        geo1.append(CTL::SingleViewGeometry{ { P1, P1 } });
+        geo2.append(CTL::SingleViewGeometry{ { P2, P1 } });
+    }
+
+    PMatComparator compare;
+    compare.setRestrictionToDetectorArea(false);
+    const auto res = compare(geo1, geo2, 4);
+    const auto resSingleThread = compare(geo1, geo2, 1);
+
+    QCOMPARE(res.views.size(), size_t(20));
+    uint64_t totalSamples = 0;
+    for(uint view = 0; view < 20; ++view)
+    {
+        // module 0 has a shift of 0.1 * (view % 5) pixels, module 1 has no error
+        const auto single = compare(geo1.at(view).at(0), geo2.at(view).at(0));
+        QVERIFY(std::abs(2.0 * res.views[view].meanError - single.meanError) < 1.0e-9);
+        QCOMPARE(res.views[view].samples, 2 * single.samples);
+        QCOMPARE(res.views[view].maxError, single.maxError);
+        QCOMPARE(res.views[view].minError, 0.0);
+        totalSamples += res.views[view].samples;
+    }
+    QCOMPARE(res.total.samples, totalSamples);
+    QCOMPARE(res.total.meanError, resSingleThread.total.meanError);
+    QVERIFY(std::abs(res.total.maxError - 0.4) < 1.0e-9);
+
+    geo2.append(geo2.first());
+    QVERIFY_EXCEPTION_THROWN(compare(geo1, geo2), std::domain_error);
+}
+
 void ProjectionMatrixTest::subMatExtraction()
 {
     ProjectionMatrix Pmat{ 1, 2, 3, 4,
@@ -212,3 +251,37 @@ void ProjectionMatrixTest::subMatExtraction()
     const auto cornerElem = Pmat.subMat<2,2, 3,3>().ref();
     QCOMPARE(cornerElem, 12.0);
 }
+
+void ProjectionMatrixTest::singlePrecisionProducts()
+{
+    const Matrix<4, 4> H{ 0.0, -1.0, 0.0, 10.0,
+                          1.0,  0.0, 0.0, 20.0,
+                          0.0,  0.0, 1.0, 30.0,
+                          0.0,  0.0, 0.0,  1.0 };
+    const Matrix<4, 1> X{ 1.0, 4.0, 8.0, 1.0 };
+
+    // double: compare (SIMD) products with the generic implementation
+    const Matrix<3, 4> PH = P * H;
+    const Matrix<3, 1> PX = P * X;
+    Matrix<3, 4> PH_ref;
+    Matrix<3, 1> PX_ref;
+    details::MatMul<3, 4, 4, double, int>::apply(P.constBegin(), H.constBegin(), PH_ref.begin());
+    details::MatMul<3, 4, 1, double, int>::apply(P.constBegin(), X.constBegin(), PX_ref.begin());
+    QVERIFY((PH - PH_ref).norm() <= 1.0e-14 * PH_ref.norm());
+    QVERIFY((PX - PX_ref).norm() <= 1.0e-14 * PX_ref.norm());
+
+    // float: compare with double precision results
+    const Matrix<3, 4, float> Pf(P);
+    const Matrix<4, 4, float> Hf(H);
+    const Matrix<4, 1, float> Xf(X);
+    QVERIFY((Matrix<3, 4>(Pf * Hf) - PH).norm() < 1.0e-5 * PH.norm());
+    QVERIFY((Matrix<3, 1>(Pf * Xf) - PX).norm() < 1.0e-5 * PX.norm());
+
+    // 3x3 matrices and vectors
+    const Matrix<3, 3> M = P.M();
+    const Matrix<3, 3, float> Mf(M);
+    const Matrix<3, 1> v{ 1.0, 2.0, 3.0 };
+    const Matrix<3, 1, float> vf(v);
+    QVERIFY((Matrix<3, 1>(Mf * vf) - M * v).norm() < 1.0e-5 * (M * v).norm());
+    QVERIFY((Matrix<3, 3>(Mf * Mf) - M * M).norm() < 1.0e-5 * (M * M).norm());
+}
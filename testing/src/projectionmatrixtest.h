@@ -23,7 +23,9 @@ private Q_SLOTS:
     void projectionOntoDetector();
     void equalityTest();
     void comparatorTest();
+    void batchComparatorTest();
     void subMatExtraction();
+    void singlePrecisionProducts();
 
 private:
     CTL::mat::ProjectionMatrix P;
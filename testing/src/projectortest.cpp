@@ -7,9 +7,13 @@
 #include "projectors/arealfocalspotextension.h"
 #include "projectors/poissonnoiseextension.h"
 #include "projectors/raycasterprojector.h"
+#include "projectors/raycasterprojectorcpu.h"
 #include "projectors/spectraleffectsextension.h"
 
 #include "io/ctldatabase.h"
+#include "io/tracer.h"
+
+#include <QJsonDocument>
 
 using namespace CTL;
 
@@ -146,6 +150,155 @@ void ProjectorTest::testSpectralExtension()
     delete spectralExt;
 }
 
+void ProjectorTest::testEnergyResolvedProjection()
+{
+    if(!CTLDatabaseHandler::instance().hasAllNecessaryFiles())
+        QSKIP("CTL database not available");
+
+    CTSystem theSystem;
+    theSystem << new FlatPanelDetector(QSize(40, 40), QSizeF(1.0, 1.0))
+              << new CarmGantry(1200.0) << new XrayTube(80.0, 1.0);
+
+    AcquisitionSetup setup(theSystem);
+    setup.setNbViews(3);
+    setup.applyPreparationProtocol(protocols::ShortScanTrajectory(750.0));
+
+    const auto volume = SpectralVolumeData::ball(20.0f, 1.0f, 1.0f,
+                                                 database::attenuationModel(database::Composite::Water));
+
+    SpectralEffectsExtension extension(10.0f);
+    extension.use(new RayCasterProjectorCPU);
+    extension.setEnergyThresholds({ 50.0f, 20.0f });
+    extension.configure(setup);
+    QCOMPARE(extension.nbEnergyChannels(), 2u);
+    QCOMPARE(extension.energyThresholds().front(), 20.0f);
+
+    const auto proj = extension.project(volume);
+    QCOMPARE(proj.nbViews(), setup.nbViews());
+    QCOMPARE(proj.viewDimensions().nbModules, 2u);
+
+    const auto lowEnergy = extension.energyChannel(proj, 0);
+    const auto highEnergy = extension.energyChannel(proj, 1);
+    QCOMPARE(lowEnergy.viewDimensions().nbModules, 1u);
+    QVERIFY(projectionMean(lowEnergy) > projectionMean(highEnergy));
+    QVERIFY_EXCEPTION_THROWN(extension.energyChannel(proj, 2), std::domain_error);
+
+    // a channel does not depend on other channels
+    extension.setEnergyThresholds({ 50.0f });
+    const auto singleChannel = extension.project(volume);
+    QCOMPARE(singleChannel.viewDimensions().nbModules, 1u);
+    const auto diff = singleChannel - highEnergy;
+    QVERIFY(std::abs(diff.max()) < 1.0e-5f);
+    QVERIFY(std::abs(diff.min()) < 1.0e-5f);
+
+    // invalid thresholds are rejected and the previous thresholds remain
+    QVERIFY_EXCEPTION_THROWN(extension.setEnergyThresholds({ 20.0f, 20.0f }), std::domain_error);
+    QVERIFY_EXCEPTION_THROWN(extension.setEnergyThresholds({ 20.0f, 90.0f }), std::domain_error);
+    QCOMPARE(extension.energyThresholds(), std::vector<float>{ 50.0f });
+
+    // same for a sampling resolution that leaves a channel without photons (single bin [0, 80] keV)
+    QVERIFY_EXCEPTION_THROWN(extension.setSpectralSamplingResolution(80.0f), std::domain_error);
+    QVERIFY(extension.project(volume) == singleChannel);
+
+    SpectralEffectsExtension unconfigured(10.0f);
+    unconfigured.use(new RayCasterProjectorCPU);
+    unconfigured.setEnergyThresholds({ 90.0f }); // above the tube voltage
+    QVERIFY_EXCEPTION_THROWN(unconfigured.configure(setup), std::domain_error);
+
+    // extensions that require one module per detector module reject energy-resolved projections
+    auto channels = new SpectralEffectsExtension(10.0f);
+    channels->use(new RayCasterProjectorCPU);
+    channels->setEnergyThresholds({ 20.0f, 50.0f });
+    PoissonNoiseExtension noise;
+    noise.use(channels);
+    noise.configure(setup);
+    QVERIFY_EXCEPTION_THROWN(noise.project(volume), std::domain_error);
+}
+
+void ProjectorTest::testTracing()
+{
+    CTSystem theSystem;
+    theSystem << new FlatPanelDetector(QSize(20, 20), QSizeF(2.0, 2.0))
+              << new CarmGantry(1200.0) << new XrayLaser(75.0, 1.0);
+
+    AcquisitionSetup setup(theSystem);
+    setup.setNbViews(4);
+    setup.applyPreparationProtocol(protocols::ShortScanTrajectory(750.0));
+
+    auto projector = makeProjector<RayCasterProjectorCPU>() | makeExtension<PoissonNoiseExtension>();
+
+    auto& tracer = Tracer::instance();
+    tracer.clear();
+    tracer.setEnabled(true);
+    projector->configure(setup);
+    projector->project(_testVolume);
+    tracer.setEnabled(false);
+
+    QVERIFY(tracer.nbEvents() > 0);
+
+    const auto stages = tracer.summary();
+    auto stageCount = [&stages](const QString& category) {
+        uint count = 0;
+        for(const auto& stage : stages)
+            if(stage.category == category)
+                count += stage.count;
+        return count;
+    };
+    QCOMPARE(stageCount("view"), setup.nbViews());
+    QCOMPARE(stageCount("noise"), 1u);
+    QCOMPARE(stageCount("configure"), 2u);
+
+    const auto json = QJsonDocument::fromJson(tracer.chromeTraceJson());
+    QVERIFY(json.isObject());
+    QVERIFY(json.object().value("traceEvents").isArray());
+
+    // nothing is recorded while disabled
+    tracer.clear();
+    projector->project(_testVolume);
+    QCOMPARE(tracer.nbEvents(), size_t(0));
+}
+
+void ProjectorTest::testAsyncProjection()
+{
+    CTSystem theSystem;
+    theSystem << new FlatPanelDetector(QSize(100, 100), QSizeF(1.0, 1.0))
+              << new CarmGantry(1200.0) << new XrayLaser(75.0, 1.0);
+
+    AcquisitionSetup setup(theSystem);
+    setup.setNbViews(200);
+    setup.applyPreparationProtocol(protocols::ShortScanTrajectory(750.0));
+
+    RayCasterProjectorCPU projector;
+    projector.configure(setup);
+    const auto syncProjections = projector.project(_testVolume);
+
+    // completed job
+    auto job = projector.projectAsync(_testVolume);
+    QVERIFY(job.result() == syncProjections);
+    QVERIFY(job.isFinished());
+    QCOMPARE(job.nbFinishedViews(), setup.nbViews());
+    QCOMPARE(job.progress(), 1.0);
+
+    // canceled job: partial result contains the leading views
+    job = projector.projectAsync(_testVolume);
+    job.cancel();
+    QVERIFY_EXCEPTION_THROWN(job.result(), ProjectionCanceled);
+
+    const auto partial = job.partialResult();
+    QVERIFY(partial.nbViews() < setup.nbViews());
+    for(uint view = 0; view < partial.nbViews(); ++view)
+        QVERIFY(partial.view(view) == syncProjections.view(view));
+
+    // canceled job with extensions: unprocessed views of the nested projector are discarded
+    auto pipeline = makeProjector<RayCasterProjectorCPU>() | makeExtension<PoissonNoiseExtension>();
+    pipeline->configure(setup);
+    job = pipeline->projectAsync(_testVolume);
+    job.cancel();
+    QVERIFY_EXCEPTION_THROWN(job.result(), ProjectionCanceled);
+    QVERIFY(job.nbFinishedViews() < setup.nbViews());
+    QCOMPARE(job.partialResult().nbViews(), 0u);
+}
+
 void ProjectorTest::poissonSimulation(double meanPhotons,
                                       double projAngle,
                                       uint nbRepetitions) const
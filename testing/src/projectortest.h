@@ -19,6 +19,9 @@ private Q_SLOTS:
     void initTestCase();
     void testPoissonExtension();
     void testSpectralExtension();
+    void testEnergyResolvedProjection();
+    void testTracing();
+    void testAsyncProjection();
 
 private:
     CTL::VoxelVolume<float> _testVolume = CTL::VoxelVolume<float>(0,0,0);
@@ -2,9 +2,8 @@
 #include <QDebug>
 #include <QTime>
 
-#include "components/attenuationfilter.h"
-#include "components/xraylaser.h"
-#include "components/xraytube.h"
+#include "acquisition/radiationencoder.h"
+#include "components/allcomponents.h"
 #include "io/ctldatabase.h"
 #include "models/xrayspectrummodels.h"
 
@@ -73,6 +72,104 @@ void SpectrumTest::testAttenuationFilter()
 
 }
 
+void SpectrumTest::testSpectrumCache()
+{
+    CTL::SimpleCTSystem system(CTL::FlatPanelDetector(QSize(10, 10), QSizeF(1.0, 1.0)),
+                               CTL::TubularGantry(1000.0, 600.0),
+                               CTL::XrayTube(80.0, 1.0));
+    system.addBeamModifier(new CTL::AttenuationFilter(CTL::database::Element::Al, 2.0f));
+
+    CTL::SpectrumCache cache;
+    const CTL::RadiationEncoder uncached(&system);
+    const CTL::RadiationEncoder cached(&system, &cache);
+
+    const CTL::EnergyRange range(0.0f, 120.0f);
+    const auto reference = uncached.finalSpectrum(range, 60);
+    for(auto rep = 0; rep < 2; ++rep) // second repetition uses cached values
+    {
+        const auto spectrum = cached.finalSpectrum(range, 60);
+        for(auto smp = 0u; smp < 60u; ++smp)
+            QCOMPARE(spectrum.value(smp), reference.value(smp));
+        QVERIFY(qFuzzyCompare(cached.finalPhotonFlux(), uncached.finalPhotonFlux()));
+    }
+    QCOMPARE(cache.nbMisses(), 2u);
+    QCOMPARE(cache.nbHits(), 2u);
+
+    // a change of the flux only (e.g. tube current modulation) reuses the cached transmission
+    auto tube = static_cast<CTL::XrayTube*>(system.source());
+    tube->setMilliampereSeconds(3.0);
+    QVERIFY(qFuzzyCompare(cached.finalPhotonFlux(), uncached.finalPhotonFlux()));
+    QCOMPARE(cache.nbMisses(), 2u);
+    QCOMPARE(cache.nbHits(), 3u);
+
+    // a change of the spectrum requires new entries
+    tube->setTubeVoltage(120.0);
+    const auto spectrum = cached.finalSpectrum(range, 60);
+    QCOMPARE(spectrum.centroid(), uncached.finalSpectrum(range, 60).centroid());
+    QVERIFY(spectrum.centroid() > reference.centroid());
+    QVERIFY(qFuzzyCompare(cached.finalPhotonFlux(), uncached.finalPhotonFlux()));
+    QCOMPARE(cache.nbMisses(), 4u);
+    QCOMPARE(cache.nbHits(), 3u);
+
+    // sub classes of components with a known spectral state disable caching
+    struct DerivedTube : CTL::XrayTube
+    {
+        DerivedTube() : CTL::XrayTube(80.0, 1.0) {}
+    };
+    struct DerivedFilter : CTL::AttenuationFilter
+    {
+        DerivedFilter() : CTL::AttenuationFilter(CTL::database::Element::Al, 2.0f) {}
+    };
+    QVERIFY(CTL::XrayTube(80.0, 1.0).spectralState().isValid());
+    QVERIFY(!DerivedTube().spectralState().isValid());
+    QVERIFY(!DerivedFilter().spectralState().isValid());
+
+    system.replaceSource(new DerivedTube);
+    cache.clear();
+    QCOMPARE(cached.finalSpectrum(range, 60).centroid(), reference.centroid());
+    QCOMPARE(cache.nbMisses() + cache.nbHits(), 0u);
+}
+
+void SpectrumTest::testDatabaseCache()
+{
+    using CTL::database::Composite;
+
+    auto& handler = CTL::CTLDatabaseHandler::instance();
+    if(!handler.hasAllNecessaryFiles())
+        QSKIP("CTL database not available");
+
+    const auto parsed = handler.loadAttenuationModel(Composite::Water);
+    QVERIFY(parsed != nullptr);
+
+    // repeated requests return independent copies
+    auto copy = handler.loadAttenuationModel(Composite::Water);
+    QVERIFY(copy != parsed);
+    static_cast<CTL::TabulatedDataModel&>(*copy).insertDataPoint(55.0f, 0.0f);
+    QCOMPARE(handler.loadAttenuationModel(Composite::Water)->valueAt(55.0f),
+             parsed->valueAt(55.0f));
+
+    // round trip through the binary cache
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto fileName = dir.path() + QStringLiteral("/attenuation_spectra.bin");
+    const auto written = handler.writeAttenuationCache(fileName);
+    const auto read = handler.readAttenuationCache(fileName);
+    const auto cached = handler.loadAttenuationModel(Composite::Water);
+    const auto cachedDensity = handler.loadDensity(Composite::Water);
+
+    // reset the handler, such that other tests use models parsed from the database files again
+    const auto dbRoot = QFileInfo(handler.attenuationCacheFile()).absolutePath();
+    QVERIFY(handler.setDatabaseRoot(dbRoot));
+
+    QVERIFY(written);
+    QVERIFY(read);
+    QCOMPARE(cached->name(), parsed->name());
+    QCOMPARE(static_cast<const CTL::TabulatedDataModel&>(*cached).lookupTable(),
+             static_cast<const CTL::TabulatedDataModel&>(*parsed).lookupTable());
+    QCOMPARE(cached->meanValue(60.0f, 10.0f), parsed->meanValue(60.0f, 10.0f));
+    QCOMPARE(cachedDensity, 1.0f);
+}
+
 void SpectrumTest::testXrayLaserSpectrum()
 {
     CTL::XrayLaser laser;
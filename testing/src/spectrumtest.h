@@ -23,6 +23,8 @@ private Q_SLOTS:
     void testSpectrumSampling();
     void cleanupTestCase();
     void testAttenuationFilter();
+    void testSpectrumCache();
+    void testDatabaseCache();
 
 private:
     CTL::XrayTube* _tube;
@@ -17,10 +17,15 @@ win32-msvc*: QMAKE_CXXFLAGS += /WX
 include(../../modules/ctl.pri)
 include(../../modules/ctl_ocl.pri)
 
+# optional: 2D/3D registration (requires NLopt)
+CONFIG += link_pkgconfig
+packagesExist(nlopt): include(../../modules/ctl_nlopt.pri)
+
 # Source code of unit tests
 SOURCES += \
     main.cpp \
     acquisitionsetuptest.cpp \
+    consistencytest.cpp \
     ctsystemtest.cpp \
     datatypetest.cpp \
     denfileiotest.cpp \
@@ -32,6 +37,7 @@ SOURCES += \
 
 HEADERS += \
     acquisitionsetuptest.h \
+    consistencytest.h \
     ctsystemtest.h \
     datatypetest.h \
     denfileiotest.h \